@@ -87,6 +87,16 @@ class endpoint {
     }
   };
 
+  // strict weak ordering consistent with operator==, for ordered containers
+  bool operator<(const endpoint& e) const {
+    if (addr_storage_len != e.addr_storage_len) {
+      return addr_storage_len < e.addr_storage_len;
+    }
+    return memcmp(
+               (const void*) &addr_storage, (const void*) &e.addr_storage,
+               addr_storage_len) < 0;
+  };
+
   std::string toString() const {
     std::string str;
     if (addr_storage.ss_family == AF_INET) {
@@ -102,4 +112,44 @@ class endpoint {
   }
 };
 
+// Request received from a peer: its address, port and sequence number, the
+// key of the hash indexes of the requests in progress
+class request_key {
+ public:
+  uint8_t addr[16];
+  uint32_t seq_num;
+  uint16_t port;
+  sa_family_t family;
+
+  request_key() : addr(), seq_num(0), port(0), family(AF_UNSPEC){};
+  request_key(const endpoint& e, const uint32_t seq)
+      : addr(), seq_num(seq), port(e.port()), family(e.family()) {
+    if (family == AF_INET) {
+      memcpy(
+          addr, &((const struct sockaddr_in*) &e.addr_storage)->sin_addr,
+          sizeof(struct in_addr));
+    } else if (family == AF_INET6) {
+      memcpy(
+          addr, &((const struct sockaddr_in6*) &e.addr_storage)->sin6_addr,
+          sizeof(struct in6_addr));
+    }
+  };
+
+  bool operator==(const request_key& k) const {
+    return (seq_num == k.seq_num) && (port == k.port) &&
+           (family == k.family) && (memcmp(addr, k.addr, sizeof(addr)) == 0);
+  };
+
+  struct hash {
+    // FNV-1a over the address, folded with the port and sequence number
+    uint64_t operator()(const request_key& k) const {
+      uint64_t h = 0xCBF29CE484222325ULL;
+      for (unsigned int i = 0; i < sizeof(k.addr); i++) {
+        h = (h ^ k.addr[i]) * 0x100000001B3ULL;
+      }
+      return h ^ (((uint64_t) k.port << 32) | k.seq_num);
+    }
+  };
+};
+
 #endif
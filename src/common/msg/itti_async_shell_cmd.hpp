@@ -56,4 +56,6 @@ class itti_async_shell_cmd : public itti_msg {
   int src_line;
 };
 
+ITTI_MSG_CLASS(ASYNC_SHELL_CMD, itti_async_shell_cmd);
+
 #endif /* FILE_ITTI_ASYNC_SHELL_CMD_SEEN */
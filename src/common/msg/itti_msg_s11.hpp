@@ -564,4 +564,30 @@ class itti_s11_downlink_data_notification_failure_indication
   gtpv2c::gtpv2c_downlink_data_notification_failure_indication gtp_ies;
 };
 
+ITTI_MSG_CLASS(
+    S11_REMOTE_PEER_NOT_RESPONDING, itti_s11_remote_peer_not_responding);
+ITTI_MSG_CLASS(S11_CREATE_SESSION_REQUEST, itti_s11_create_session_request);
+ITTI_MSG_CLASS(S11_CREATE_SESSION_RESPONSE, itti_s11_create_session_response);
+ITTI_MSG_CLASS(S11_CREATE_BEARER_REQUEST, itti_s11_create_bearer_request);
+ITTI_MSG_CLASS(S11_CREATE_BEARER_RESPONSE, itti_s11_create_bearer_response);
+ITTI_MSG_CLASS(S11_MODIFY_BEARER_REQUEST, itti_s11_modify_bearer_request);
+ITTI_MSG_CLASS(S11_MODIFY_BEARER_RESPONSE, itti_s11_modify_bearer_response);
+ITTI_MSG_CLASS(S11_DELETE_SESSION_REQUEST, itti_s11_delete_session_request);
+ITTI_MSG_CLASS(S11_DELETE_SESSION_RESPONSE, itti_s11_delete_session_response);
+ITTI_MSG_CLASS(
+    S11_RELEASE_ACCESS_BEARERS_REQUEST,
+    itti_s11_release_access_bearers_request);
+ITTI_MSG_CLASS(
+    S11_RELEASE_ACCESS_BEARERS_RESPONSE,
+    itti_s11_release_access_bearers_response);
+ITTI_MSG_CLASS(S11_DELETE_BEARER_COMMAND, itti_s11_delete_bearer_command);
+ITTI_MSG_CLASS(
+    S11_DOWNLINK_DATA_NOTIFICATION, itti_s11_downlink_data_notification);
+ITTI_MSG_CLASS(
+    S11_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE,
+    itti_s11_downlink_data_notification_acknowledge);
+ITTI_MSG_CLASS(
+    S11_DOWNLINK_DATA_NOTIFICATION_FAILURE_INDICATION,
+    itti_s11_downlink_data_notification_failure_indication);
+
 #endif /* ITTI_MSG_S11_HPP_INCLUDED_ */
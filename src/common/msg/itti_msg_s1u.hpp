@@ -183,4 +183,12 @@ class itti_s1u_end_marker : public itti_s1u_msg {
   gtpv1u::gtpv1u_end_marker gtp_ies;
 };
 
+ITTI_MSG_CLASS(S1U_ECHO_REQUEST, itti_s1u_echo_request);
+ITTI_MSG_CLASS(S1U_ECHO_RESPONSE, itti_s1u_echo_response);
+ITTI_MSG_CLASS(S1U_ERROR_INDICATION, itti_s1u_error_indication);
+ITTI_MSG_CLASS(
+    S1U_SUPPORTED_EXTENSION_HEADERS_NOTIFICATION,
+    itti_s1u_supported_extension_headers_notification);
+ITTI_MSG_CLASS(S1U_END_MARKER, itti_s1u_end_marker);
+
 #endif /* ITTI_MSG_S1U_HPP_INCLUDED_ */
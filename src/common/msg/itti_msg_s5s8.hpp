@@ -499,4 +499,32 @@ class itti_s5s8_downlink_data_notification_failure_indication
 
   gtpv2c::gtpv2c_downlink_data_notification_failure_indication gtp_ies;
 };
+
+// Message type to message class bindings, see itti_msg_class
+ITTI_MSG_CLASS(
+    S5S8_REMOTE_PEER_NOT_RESPONDING, itti_s5s8_remote_peer_not_responding);
+ITTI_MSG_CLASS(S5S8_CREATE_SESSION_REQUEST, itti_s5s8_create_session_request);
+ITTI_MSG_CLASS(S5S8_CREATE_SESSION_RESPONSE, itti_s5s8_create_session_response);
+ITTI_MSG_CLASS(S5S8_CREATE_BEARER_REQUEST, itti_s5s8_create_bearer_request);
+ITTI_MSG_CLASS(S5S8_CREATE_BEARER_RESPONSE, itti_s5s8_create_bearer_response);
+ITTI_MSG_CLASS(S5S8_MODIFY_BEARER_REQUEST, itti_s5s8_modify_bearer_request);
+ITTI_MSG_CLASS(S5S8_MODIFY_BEARER_RESPONSE, itti_s5s8_modify_bearer_response);
+ITTI_MSG_CLASS(S5S8_DELETE_SESSION_REQUEST, itti_s5s8_delete_session_request);
+ITTI_MSG_CLASS(S5S8_DELETE_SESSION_RESPONSE, itti_s5s8_delete_session_response);
+ITTI_MSG_CLASS(
+    S5S8_RELEASE_ACCESS_BEARERS_REQUEST,
+    itti_s5s8_release_access_bearers_request);
+ITTI_MSG_CLASS(
+    S5S8_RELEASE_ACCESS_BEARERS_RESPONSE,
+    itti_s5s8_release_access_bearers_response);
+ITTI_MSG_CLASS(S5S8_DELETE_BEARER_COMMAND, itti_s5s8_delete_bearer_command);
+ITTI_MSG_CLASS(
+    S5S8_DOWNLINK_DATA_NOTIFICATION, itti_s5s8_downlink_data_notification);
+ITTI_MSG_CLASS(
+    S5S8_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE,
+    itti_s5s8_downlink_data_notification_acknowledge);
+ITTI_MSG_CLASS(
+    S5S8_DOWNLINK_DATA_NOTIFICATION_FAILURE_INDICATION,
+    itti_s5s8_downlink_data_notification_failure_indication);
+
 #endif /* ITTI_MSG_S5S8_HPP_INCLUDED_ */
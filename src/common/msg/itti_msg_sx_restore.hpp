@@ -50,4 +50,6 @@ class itti_sx_restore : public itti_msg {
   std::set<pfcp::fseid_t> sessions;
 };
 
+ITTI_MSG_CLASS(RESTORE_SX_SESSIONS, itti_sx_restore);
+
 #endif /* ITTI_MSG_SX_RESTORE_HPP_INCLUDED_ */
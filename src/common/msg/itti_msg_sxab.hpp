@@ -42,12 +42,14 @@ class itti_sxab_msg : public itti_msg {
     l_endpoint = {};
     r_endpoint = {};
     seid       = UNASSIGNED_SEID;
+    l_seid     = UNASSIGNED_SEID;
     trxn_id    = 0;
   }
   itti_sxab_msg(const itti_sxab_msg& i) : itti_msg(i) {
     l_endpoint = i.l_endpoint;
     r_endpoint = i.r_endpoint;
     seid       = i.seid;
+    l_seid     = i.l_seid;
     trxn_id    = i.trxn_id;
   }
   itti_sxab_msg(
@@ -60,9 +62,34 @@ class itti_sxab_msg : public itti_msg {
   endpoint l_endpoint;
   endpoint r_endpoint;
   seid_t seid;
+  seid_t l_seid;  // of a session request, for peer not responding
   uint64_t trxn_id;
 };
 
+//-----------------------------------------------------------------------------
+class itti_sxab_remote_peer_not_responding : public itti_sxab_msg {
+ public:
+  itti_sxab_remote_peer_not_responding(
+      const task_id_t origin, const task_id_t destination)
+      : itti_sxab_msg(SXAB_REMOTE_PEER_NOT_RESPONDING, origin, destination) {
+    message_type = 0;
+  }
+  itti_sxab_remote_peer_not_responding(
+      const itti_sxab_remote_peer_not_responding& i)
+      : itti_sxab_msg(i) {
+    message_type = i.message_type;
+  }
+  itti_sxab_remote_peer_not_responding(
+      const itti_sxab_remote_peer_not_responding& i, const task_id_t orig,
+      const task_id_t dest)
+      : itti_sxab_msg(i, orig, dest) {
+    message_type = i.message_type;
+  }
+  const char* get_msg_name() { return "SXAB_REMOTE_PEER_NOT_RESPONDING"; };
+
+  uint8_t message_type;  // of the request that got no response
+};
+
 //-----------------------------------------------------------------------------
 class itti_sxab_heartbeat_request : public itti_sxab_msg {
  public:
@@ -606,4 +633,52 @@ class itti_sxab_session_report_response : public itti_sxab_msg {
   pfcp::pfcp_session_report_response pfcp_ies;
 };
 
+ITTI_MSG_CLASS(
+    SXAB_REMOTE_PEER_NOT_RESPONDING, itti_sxab_remote_peer_not_responding);
+ITTI_MSG_CLASS(SXAB_HEARTBEAT_REQUEST, itti_sxab_heartbeat_request);
+ITTI_MSG_CLASS(SXAB_HEARTBEAT_RESPONSE, itti_sxab_heartbeat_response);
+ITTI_MSG_CLASS(
+    SXAB_PFCP_PFD_MANAGEMENT_REQUEST, itti_sxab_pfcp_pfd_management_request);
+ITTI_MSG_CLASS(
+    SXAB_PFCP_PFD_MANAGEMENT_RESPONSE, itti_sxab_pfcp_pfd_management_response);
+ITTI_MSG_CLASS(
+    SXAB_ASSOCIATION_SETUP_REQUEST, itti_sxab_association_setup_request);
+ITTI_MSG_CLASS(
+    SXAB_ASSOCIATION_SETUP_RESPONSE, itti_sxab_association_setup_response);
+ITTI_MSG_CLASS(
+    SXAB_ASSOCIATION_UPDATE_REQUEST, itti_sxab_association_update_request);
+ITTI_MSG_CLASS(
+    SXAB_ASSOCIATION_UPDATE_RESPONSE, itti_sxab_association_update_response);
+ITTI_MSG_CLASS(
+    SXAB_ASSOCIATION_RELEASE_REQUEST, itti_sxab_association_release_request);
+ITTI_MSG_CLASS(
+    SXAB_ASSOCIATION_RELEASE_RESPONSE, itti_sxab_association_release_response);
+ITTI_MSG_CLASS(
+    SXAB_VERSION_NOT_SUPPORTED_RESPONSE,
+    itti_sxab_version_not_supported_response);
+ITTI_MSG_CLASS(SXAB_NODE_REPORT_REQUEST, itti_sxab_node_report_request);
+ITTI_MSG_CLASS(SXAB_NODE_REPORT_RESPONSE, itti_sxab_node_report_response);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_SET_DELETION_REQUEST, itti_sxab_session_set_deletion_request);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_SET_DELETION_RESPONSE,
+    itti_sxab_session_set_deletion_response);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_ESTABLISHMENT_REQUEST,
+    itti_sxab_session_establishment_request);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_ESTABLISHMENT_RESPONSE,
+    itti_sxab_session_establishment_response);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_MODIFICATION_REQUEST, itti_sxab_session_modification_request);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_MODIFICATION_RESPONSE,
+    itti_sxab_session_modification_response);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_DELETION_REQUEST, itti_sxab_session_deletion_request);
+ITTI_MSG_CLASS(
+    SXAB_SESSION_DELETION_RESPONSE, itti_sxab_session_deletion_response);
+ITTI_MSG_CLASS(SXAB_SESSION_REPORT_REQUEST, itti_sxab_session_report_request);
+ITTI_MSG_CLASS(SXAB_SESSION_REPORT_RESPONSE, itti_sxab_session_report_response);
+
 #endif /* ITTI_MSG_SXAB_HPP_INCLUDED_ */
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file alloc_stats.cpp
+  \brief
+*/
+
+#include "alloc_stats.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+// constant initialized, usable from operator new before any constructor
+thread_local uint64_t thread_allocations = 0;
+thread_local uint64_t thread_bytes       = 0;
+}  // namespace
+
+//------------------------------------------------------------------------------
+util::alloc_stats util::alloc_stats::thread_totals() {
+  return alloc_stats(thread_allocations, thread_bytes);
+}
+
+#if ALLOC_STATS
+// The array and nothrow forms of the standard library forward to these
+//------------------------------------------------------------------------------
+void* operator new(std::size_t size) {
+  thread_allocations++;
+  thread_bytes += size;
+  void* p = std::malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+//------------------------------------------------------------------------------
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+//------------------------------------------------------------------------------
+void operator delete(void* p, std::size_t size) noexcept {
+  std::free(p);
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file alloc_stats.hpp
+  \brief Heap allocations counted per thread, to follow the cost of a
+  procedure. Counting is built in with the ALLOC_STATS option only.
+*/
+
+#ifndef FILE_ALLOC_STATS_HPP_SEEN
+#define FILE_ALLOC_STATS_HPP_SEEN
+
+#include <stdint.h>
+
+namespace util {
+
+class alloc_stats {
+ public:
+  uint64_t allocations;
+  uint64_t bytes;
+
+  alloc_stats() : allocations(0), bytes(0) {}
+  alloc_stats(const uint64_t a, const uint64_t b) : allocations(a), bytes(b) {}
+
+  /** \brief Counters of the calling thread, stay 0 without ALLOC_STATS
+   **/
+  static alloc_stats thread_totals();
+};
+
+//------------------------------------------------------------------------------
+// Allocations made by the calling thread since the scope was opened
+class alloc_scope {
+ public:
+  alloc_scope() : start(alloc_stats::thread_totals()) {}
+
+  alloc_stats elapsed() const {
+    alloc_stats now = alloc_stats::thread_totals();
+    return alloc_stats(
+        now.allocations - start.allocations, now.bytes - start.bytes);
+  }
+
+ private:
+  alloc_stats start;
+};
+
+}  // namespace util
+#endif /* FILE_ALLOC_STATS_HPP_SEEN */
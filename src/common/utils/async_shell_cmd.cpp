@@ -60,52 +60,29 @@ void async_cmd_task(void* args_p) {
 
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case ASYNC_SHELL_CMD:
-        if (itti_async_shell_cmd* to =
-                dynamic_cast<itti_async_shell_cmd*>(msg)) {
-          int rc = system((const char*) to->system_command.c_str());
-
-          if (rc) {
+  itti_dispatcher dispatcher(task_id, Logger::async_cmd());
+  dispatcher
+      .on<ASYNC_SHELL_CMD>([](auto to) {
+        int rc = system((const char*) to->system_command.c_str());
+
+        if (rc) {
+          Logger::async_cmd().error(
+              "Failed cmd from %d: %s ", to->origin,
+              (const char*) to->system_command.c_str());
+          if (to->is_abort_on_error) {
             Logger::async_cmd().error(
-                "Failed cmd from %d: %s ", to->origin,
-                (const char*) to->system_command.c_str());
-            if (to->is_abort_on_error) {
-              Logger::async_cmd().error(
-                  "Terminate cause failed cmd %s at %s:%d",
-                  to->system_command.c_str(), to->src_file.c_str(),
-                  to->src_line);
-              itti_inst->send_terminate_msg(to->origin);
-            }
+                "Terminate cause failed cmd %s at %s:%d",
+                to->system_command.c_str(), to->src_file.c_str(),
+                to->src_line);
+            itti_inst->send_terminate_msg(to->origin);
           }
         }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::async_cmd().info("TIME-OUT event timer id %d", to->timer_id);
-        }
-        break;
-
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::async_cmd().info("Received terminate message");
-          return;
-        }
-        break;
-
-      case HEALTH_PING:
-        break;
-
-      default:
-        Logger::sgwc_app().info("no handler for msg type %d", msg->msg_type);
-    }
-
-  } while (true);
+      })
+      .on<TIME_OUT>([](auto to) {
+        Logger::async_cmd().info("TIME-OUT event timer id %d", to->timer_id);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
 }
 
 //------------------------------------------------------------------------------
@@ -128,7 +105,7 @@ int async_shell_cmd::run_command(
       sender_itti_task, TASK_ASYNC_SHELL_CMD, cmd_str, is_abort_on_error,
       src_file, src_line);
   std::shared_ptr<itti_async_shell_cmd> msg =
-      std::make_shared<itti_async_shell_cmd>(cmd);
+      itti_make_msg<itti_async_shell_cmd>(cmd);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::async_cmd().error(
@@ -0,0 +1,244 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file bitmap_allocator.hpp
+  \brief Allocator of the integers of a range, the lowest free one is given
+  in O(log64(range)), optionally split in shards locked independently
+*/
+#ifndef FILE_BITMAP_ALLOCATOR_HPP_SEEN
+#define FILE_BITMAP_ALLOCATOR_HPP_SEEN
+
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace util {
+
+//------------------------------------------------------------------------------
+// Blocks start on a cache line and are rounded up to whole cache lines, no
+// other heap object shares the cache lines of a block.
+template <class T>
+class cache_line_allocator {
+ public:
+  typedef T value_type;
+  static const std::size_t kCacheLine = 64;
+
+  cache_line_allocator() = default;
+  template <class U>
+  cache_line_allocator(const cache_line_allocator<U>&) {}
+
+  T* allocate(const std::size_t n) {
+    const std::size_t bytes =
+        ((n * sizeof(T) + kCacheLine - 1) / kCacheLine) * kCacheLine;
+    return static_cast<T*>(
+        ::operator new(bytes, std::align_val_t(kCacheLine)));
+  }
+  void deallocate(T* p, std::size_t) {
+    ::operator delete(p, std::align_val_t(kCacheLine));
+  }
+
+  template <class U>
+  bool operator==(const cache_line_allocator<U>&) const {
+    return true;
+  }
+  template <class U>
+  bool operator!=(const cache_line_allocator<U>&) const {
+    return false;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Level 0 has one bit per integer of the range, set when allocated. Each level
+// above has one bit per word of the level below, set when that word is full,
+// up to a single word. A /8 pool needs 4 levels and 2 MB, the lowest free
+// integer is found by reading one word per level. Each level is a cache line
+// aligned and padded block.
+class bitmap_allocator {
+ public:
+  explicit bitmap_allocator(const uint32_t range = 0)
+      : num(range), allocated(0) {
+    uint64_t bits = range;
+    uint64_t words;
+    do {
+      words = bits ? (bits + 63) >> 6 : 1;
+      levels.push_back(level(words, 0));
+      // bits past the end of the level are never free
+      const uint64_t tail = bits - ((words - 1) << 6);
+      if (tail < 64) {
+        levels.back().back() = ~uint64_t(0) << tail;
+      }
+      bits = words;
+    } while (words > 1);
+  }
+
+  uint32_t capacity() const { return num; }
+  uint32_t size() const { return allocated; }
+  bool full() const { return levels.back()[0] == ~uint64_t(0); }
+
+  /** \brief Allocate the lowest free integer of the range
+   *  @returns false if every integer is allocated
+   **/
+  bool alloc(uint32_t& pos) {
+    if (full()) return false;
+    uint64_t i = 0;
+    for (std::size_t l = levels.size(); l-- > 0;) {
+      i = (i << 6) | __builtin_ctzll(~levels[l][i]);
+    }
+    pos = i;
+    set(i);
+    return true;
+  }
+
+  /** \brief Allocate a given integer of the range, e.g. to restore a state
+   *  @returns false if out of range or already allocated
+   **/
+  bool alloc_at(const uint32_t pos) {
+    if ((pos >= num) || test(pos)) return false;
+    set(pos);
+    return true;
+  }
+
+  /** \brief Release an allocated integer
+   *  @returns false if out of range or not allocated
+   **/
+  bool free(const uint32_t pos) {
+    if (not test(pos)) return false;
+    uint64_t i = pos;
+    for (std::size_t l = 0; l < levels.size(); l++) {
+      uint64_t& word      = levels[l][i >> 6];
+      const bool was_full = (word == ~uint64_t(0));
+      word &= ~(uint64_t(1) << (i & 63));
+      if (not was_full) break;
+      i >>= 6;
+    }
+    allocated--;
+    return true;
+  }
+
+  /** \brief @returns true if pos is in the range and allocated
+   **/
+  bool test(const uint32_t pos) const {
+    if (pos >= num) return false;
+    return (levels[0][pos >> 6] >> (pos & 63)) & 1;
+  }
+
+ private:
+  void set(uint64_t i) {
+    for (std::size_t l = 0; l < levels.size(); l++) {
+      uint64_t& word = levels[l][i >> 6];
+      word |= uint64_t(1) << (i & 63);
+      if (word != ~uint64_t(0)) break;
+      i >>= 6;
+    }
+    allocated++;
+  }
+
+  typedef std::vector<uint64_t, cache_line_allocator<uint64_t>> level;
+
+  uint32_t num;
+  uint32_t allocated;
+  std::vector<level, cache_line_allocator<level>> levels;
+};
+
+//------------------------------------------------------------------------------
+// The range is cut in slices, one per shard, each with its own lock and
+// bitmap_allocator. A thread allocates in the slice of its shard, and only
+// once that slice is full in the slices of the other shards. Slices are a
+// multiple of 512 integers, i.e. 64 bytes of bitmap, the state of a shard and
+// the levels of its bitmap_allocator are cache line aligned and padded, so
+// that threads of different shards do not write to the same cache lines. An
+// integer is released in the slice it belongs to.
+class sharded_bitmap_allocator {
+ public:
+  explicit sharded_bitmap_allocator(
+      const uint32_t range = 0, const uint32_t num_shards = 1)
+      : num(range), slice(0) {
+    const uint32_t n         = (num_shards) ? num_shards : 1;
+    const uint64_t per_shard = (uint64_t(range) + n - 1) / n;
+    slice = ((per_shard + kSliceAlign - 1) / kSliceAlign) * kSliceAlign;
+    if (not slice) slice = kSliceAlign;
+    uint64_t first = 0;
+    do {
+      const uint64_t len = (range - first < slice) ? range - first : slice;
+      shards.push_back(std::unique_ptr<shard>(new shard(first, len)));
+      first += len;
+    } while (first < range);
+  }
+
+  uint32_t capacity() const { return num; }
+  uint32_t num_shards() const { return shards.size(); }
+
+  /** \brief Allocate an integer, in the slice of the shard if possible
+   *  @returns false if every integer is allocated
+   **/
+  bool alloc(const uint32_t shard_id, uint32_t& pos) {
+    const uint32_t n = shards.size();
+    for (uint32_t i = 0; i < n; i++) {
+      shard& s = *shards[(shard_id + i) % n];
+      std::lock_guard<std::mutex> lock(s.m);
+      if (s.bits.alloc(pos)) {
+        pos += s.first;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool alloc_at(const uint32_t pos) {
+    if (pos >= num) return false;
+    shard& s = *shards[pos / slice];
+    std::lock_guard<std::mutex> lock(s.m);
+    return s.bits.alloc_at(pos - s.first);
+  }
+
+  bool free(const uint32_t pos) {
+    if (pos >= num) return false;
+    shard& s = *shards[pos / slice];
+    std::lock_guard<std::mutex> lock(s.m);
+    return s.bits.free(pos - s.first);
+  }
+
+  bool test(const uint32_t pos) {
+    if (pos >= num) return false;
+    shard& s = *shards[pos / slice];
+    std::lock_guard<std::mutex> lock(s.m);
+    return s.bits.test(pos - s.first);
+  }
+
+ private:
+  static const uint32_t kSliceAlign = 512;
+
+  struct alignas(64) shard {
+    shard(const uint32_t f, const uint32_t n) : m(), first(f), bits(n) {}
+    std::mutex m;
+    uint32_t first;
+    bitmap_allocator bits;
+  };
+
+  uint32_t num;
+  uint32_t slice;
+  std::vector<std::unique_ptr<shard>> shards;
+};
+
+}  // namespace util
+#endif /* FILE_BITMAP_ALLOCATOR_HPP_SEEN */
@@ -0,0 +1,427 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file transaction_table.hpp
+  \brief Bounded table of the procedures of a signalling stack, indexed by
+  sequence number, transaction id, timer id and request of the peer, slots
+  are recycled
+*/
+#ifndef FILE_TRANSACTION_TABLE_HPP_SEEN
+#define FILE_TRANSACTION_TABLE_HPP_SEEN
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+//------------------------------------------------------------------------------
+// Integer ids are their own hash, slot_index spreads them
+struct id_hash {
+  template <class ID>
+  uint64_t operator()(const ID& id) const {
+    return (uint64_t) id;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Open addressing map from a non zero id to a slot number, linear probing.
+// Erased entries leave tombstones, the array is rehashed once they reach a
+// quarter of it. The array is twice the number of ids it is sized for, so
+// that probes stay short, and nothing is allocated after construction.
+// H hashes an id to 64 bits, ids of equal hash are told apart by operator==.
+template <class ID, class H = id_hash>
+class slot_index {
+ public:
+  explicit slot_index(const uint32_t max_ids) : used(0), erased(0) {
+    uint32_t size = 16;
+    bits          = 4;
+    while (size < 2 * max_ids) {
+      size <<= 1;
+      bits++;
+    }
+    entries.resize(size);
+    spare.resize(size);
+  }
+
+  void insert(const ID& id, const uint32_t slot) {
+    uint32_t i         = home(id);
+    uint32_t tombstone = kNone;
+    while (entries[i].state != EMPTY) {
+      if ((entries[i].state == USED) && (entries[i].id == id)) {
+        entries[i].slot = slot;
+        return;
+      }
+      if ((entries[i].state == ERASED) && (tombstone == kNone)) {
+        tombstone = i;
+      }
+      i = (i + 1) & mask();
+    }
+    if (tombstone != kNone) {
+      i = tombstone;
+      erased--;
+    }
+    entries[i] = {id, slot, USED};
+    used++;
+  }
+
+  bool find(const ID& id, uint32_t& slot) const {
+    uint32_t i = lookup(id);
+    if (i == kNone) return false;
+    slot = entries[i].slot;
+    return true;
+  }
+
+  bool erase(const ID& id) {
+    uint32_t i = lookup(id);
+    if (i == kNone) return false;
+    entries[i].state = ERASED;
+    used--;
+    erased++;
+    if (erased > (entries.size() >> 2)) rehash();
+    return true;
+  }
+
+  uint32_t size() const { return used; }
+
+ private:
+  enum entry_state_e : uint8_t { EMPTY = 0, USED, ERASED };
+  struct entry {
+    ID id;
+    uint32_t slot;
+    entry_state_e state;
+  };
+  static const uint32_t kNone = UINT32_MAX;
+
+  std::vector<entry> entries;
+  std::vector<entry> spare;  // rehash target, swapped with entries
+  uint32_t bits;
+  uint32_t used;
+  uint32_t erased;
+
+  uint32_t mask() const { return entries.size() - 1; }
+  // Fibonacci hashing, spreads the sequential ids over the array
+  uint32_t home(const ID& id) const {
+    return (uint32_t)((H()(id) * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+  }
+  uint32_t lookup(const ID& id) const {
+    uint32_t i = home(id);
+    while (entries[i].state != EMPTY) {
+      if ((entries[i].state == USED) && (entries[i].id == id)) return i;
+      i = (i + 1) & mask();
+    }
+    return kNone;
+  }
+  void rehash() {
+    for (auto& e : spare) e.state = EMPTY;
+    for (const auto& e : entries) {
+      if (e.state != USED) continue;
+      uint32_t i = home(e.id);
+      while (spare[i].state != EMPTY) i = (i + 1) & mask();
+      spare[i] = e;
+    }
+    entries.swap(spare);
+    erased = 0;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Slab of at most max_procedures procedures. The sequence number of a
+// procedure is its slot number in the low bits and the number of times the
+// slot was opened (epoch) in the high bits, so finding a procedure from a
+// received sequence number is an array access, and a late message for a
+// procedure already closed does not match the procedure reusing the slot.
+// Free slots are reused in FIFO order, a sequence number comes back only
+// after every slot went through all its epochs.
+//
+// A procedure kept only to answer duplicated requests can be retired, when
+// the table is full the oldest retired procedure is the one to reclaim.
+// A request received from a peer is bound to the procedure answering it by a
+// key R of the peer and its sequence number, hashed by RH, so that a duplicate
+// of the request finds the procedure without a node allocated per request.
+// Transaction ids, timer ids and requests bound to a procedure are unbound by
+// close().
+//
+// Not thread safe, the owner serializes the calls.
+template <class P, class R = uint64_t, class RH = id_hash>
+class transaction_table {
+ public:
+  static const uint32_t kNoSlot   = UINT32_MAX;
+  static const int kTimersPerSlot = 2;
+
+  /**
+   * @param[in] max_procedures procedures open at the same time
+   * @param[in] seq_num_bits width of the sequence numbers of the protocol
+   * @param[in] first_epoch seeds the sequence numbers, i.e. from the clock
+   */
+  transaction_table(
+      const uint32_t max_procedures, const uint32_t seq_num_bits,
+      const uint32_t first_epoch)
+      : tx_index(max_procedures),
+        timer_index(kTimersPerSlot * max_procedures),
+        request_index(max_procedures),
+        max_open(max_procedures),
+        open_count(0),
+        free_head(kNoSlot),
+        free_tail(kNoSlot),
+        retired_head(kNoSlot),
+        retired_tail(kNoSlot) {
+    uint32_t size = 1;
+    slot_bits     = 0;
+    while (size < max_procedures) {
+      size <<= 1;
+      slot_bits++;
+    }
+    seq_num_mask = (seq_num_bits < 32) ? ((1U << seq_num_bits) - 1) : ~0U;
+    slots.resize(size);
+    for (uint32_t s = 0; s < size; s++) {
+      slots[s].seq_num = ((first_epoch << slot_bits) | s) & seq_num_mask;
+      if (s < max_procedures) push_free(s);
+    }
+  }
+
+  transaction_table(transaction_table const&) = delete;
+  void operator=(transaction_table const&) = delete;
+
+  uint32_t capacity() const { return max_open; }
+  uint32_t size() const { return open_count; }
+  bool full() const { return free_head == kNoSlot; }
+  uint32_t requests() const { return request_index.size(); }
+
+  /** \brief Open a procedure in a free slot
+   *  @param[out] seq_num sequence number of the procedure
+   *  @returns the procedure, nullptr if every slot is in use
+   **/
+  P* open(uint32_t& seq_num) {
+    if (free_head == kNoSlot) return nullptr;
+    uint32_t s = free_head;
+    free_head  = slots[s].next;
+    if (free_head == kNoSlot) free_tail = kNoSlot;
+    slot& sl = slots[s];
+    // next epoch of the slot
+    sl.seq_num = (sl.seq_num + (1U << slot_bits)) & seq_num_mask;
+    sl.open    = true;
+    sl.retired = false;
+    sl.next    = kNoSlot;
+    open_count++;
+    seq_num = sl.seq_num;
+    return &sl.proc;
+  }
+
+  P* find(const uint32_t seq_num) {
+    slot* sl = lookup(seq_num);
+    return (sl) ? &sl->proc : nullptr;
+  }
+
+  /** \brief Close a procedure, its slot is free again
+   **/
+  void close(const uint32_t seq_num) {
+    slot* sl = lookup(seq_num);
+    if (not sl) return;
+    if (sl->tx_id) tx_index.erase(sl->tx_id);
+    for (int t = 0; t < kTimersPerSlot; t++) {
+      if (sl->timer_ids[t]) timer_index.erase(sl->timer_ids[t]);
+      sl->timer_ids[t] = 0;
+    }
+    if (sl->has_request) unbind_request(*sl, slot_of(seq_num));
+    if (sl->retired) unlink_retired(slot_of(seq_num));
+    sl->tx_id = 0;
+    sl->open  = false;
+    sl->proc  = P{};  // move assigned
+    open_count--;
+    push_free(slot_of(seq_num));
+  }
+
+  /** \brief The procedure is only kept to answer duplicated requests
+   **/
+  void retire(const uint32_t seq_num) {
+    slot* sl = lookup(seq_num);
+    if ((not sl) || (sl->retired)) return;
+    uint32_t s  = slot_of(seq_num);
+    sl->retired = true;
+    sl->prev    = retired_tail;
+    sl->next    = kNoSlot;
+    if (retired_tail != kNoSlot) {
+      slots[retired_tail].next = s;
+    } else {
+      retired_head = s;
+    }
+    retired_tail = s;
+  }
+
+  /** \brief Sequence number of the procedure retired first
+   *  @returns false if no procedure is retired
+   **/
+  bool oldest_retired(uint32_t& seq_num) const {
+    if (retired_head == kNoSlot) return false;
+    seq_num = slots[retired_head].seq_num;
+    return true;
+  }
+
+  void bind_tx_id(const uint32_t seq_num, const uint64_t tx_id) {
+    slot* sl = lookup(seq_num);
+    if ((not sl) || (tx_id == 0)) return;
+    if (sl->tx_id) tx_index.erase(sl->tx_id);
+    sl->tx_id = tx_id;
+    tx_index.insert(tx_id, slot_of(seq_num));
+  }
+  void unbind_tx_id(const uint64_t tx_id) {
+    uint32_t s = 0;
+    if (tx_index.find(tx_id, s)) {
+      slots[s].tx_id = 0;
+      tx_index.erase(tx_id);
+    }
+  }
+  bool find_tx_id(const uint64_t tx_id, uint32_t& seq_num) const {
+    uint32_t s = 0;
+    if (not tx_index.find(tx_id, s)) return false;
+    seq_num = slots[s].seq_num;
+    return true;
+  }
+
+  void bind_timer(const uint32_t seq_num, const uint32_t timer_id) {
+    slot* sl = lookup(seq_num);
+    if ((not sl) || (timer_id == 0)) return;
+    for (int t = 0; t < kTimersPerSlot; t++) {
+      if (sl->timer_ids[t] == 0) {
+        sl->timer_ids[t] = timer_id;
+        timer_index.insert(timer_id, slot_of(seq_num));
+        return;
+      }
+    }
+  }
+  void unbind_timer(const uint32_t timer_id) {
+    uint32_t s = 0;
+    if (not timer_index.find(timer_id, s)) return;
+    for (int t = 0; t < kTimersPerSlot; t++) {
+      if (slots[s].timer_ids[t] == timer_id) slots[s].timer_ids[t] = 0;
+    }
+    timer_index.erase(timer_id);
+  }
+  bool find_timer(const uint32_t timer_id, uint32_t& seq_num) const {
+    uint32_t s = 0;
+    if (not timer_index.find(timer_id, s)) return false;
+    seq_num = slots[s].seq_num;
+    return true;
+  }
+
+  /** \brief Bind the request of a peer to the procedure answering it
+   **/
+  void bind_request(const uint32_t seq_num, const R& request) {
+    slot* sl = lookup(seq_num);
+    if (not sl) return;
+    if (sl->has_request) unbind_request(*sl, slot_of(seq_num));
+    sl->request     = request;
+    sl->has_request = true;
+    request_index.insert(request, slot_of(seq_num));
+  }
+  /** \brief Procedure answering a request of a peer, i.e. its duplicate
+   *  @returns false if no procedure is bound to the request
+   **/
+  bool find_request(const R& request, uint32_t& seq_num) const {
+    uint32_t s = 0;
+    if (not request_index.find(request, s)) return false;
+    seq_num = slots[s].seq_num;
+    return true;
+  }
+
+ private:
+  struct slot {
+    P proc;
+    R request;
+    uint64_t tx_id;
+    uint32_t seq_num;
+    uint32_t timer_ids[kTimersPerSlot];
+    uint32_t next;  // free or retired list
+    uint32_t prev;  // retired list
+    bool open;
+    bool retired;
+    bool has_request;
+    slot()
+        : proc(),
+          request(),
+          tx_id(0),
+          seq_num(0),
+          timer_ids(),
+          next(kNoSlot),
+          prev(kNoSlot),
+          open(false),
+          retired(false),
+          has_request(false) {}
+  };
+
+  std::vector<slot> slots;
+  slot_index<uint64_t> tx_index;
+  slot_index<uint32_t> timer_index;
+  slot_index<R, RH> request_index;
+  uint32_t slot_bits;
+  uint32_t seq_num_mask;
+  uint32_t max_open;
+  uint32_t open_count;
+  uint32_t free_head;
+  uint32_t free_tail;
+  uint32_t retired_head;
+  uint32_t retired_tail;
+
+  uint32_t slot_of(const uint32_t seq_num) const {
+    return seq_num & (slots.size() - 1);
+  }
+  slot* lookup(const uint32_t seq_num) {
+    slot& sl = slots[slot_of(seq_num & seq_num_mask)];
+    return (sl.open && (sl.seq_num == seq_num)) ? &sl : nullptr;
+  }
+  void push_free(const uint32_t s) {
+    slots[s].next = kNoSlot;
+    if (free_tail != kNoSlot) {
+      slots[free_tail].next = s;
+    } else {
+      free_head = s;
+    }
+    free_tail = s;
+  }
+  void unbind_request(slot& sl, const uint32_t s) {
+    uint32_t bound = 0;
+    // the peer may have reused the sequence number for a newer request
+    if (request_index.find(sl.request, bound) && (bound == s)) {
+      request_index.erase(sl.request);
+    }
+    sl.has_request = false;
+  }
+  void unlink_retired(const uint32_t s) {
+    slot& sl = slots[s];
+    if (sl.prev != kNoSlot) {
+      slots[sl.prev].next = sl.next;
+    } else {
+      retired_head = sl.next;
+    }
+    if (sl.next != kNoSlot) {
+      slots[sl.next].prev = sl.prev;
+    } else {
+      retired_tail = sl.prev;
+    }
+    sl.retired = false;
+    sl.prev    = kNoSlot;
+    sl.next    = kNoSlot;
+  }
+};
+
+}  // namespace util
+#endif /* FILE_TRANSACTION_TABLE_HPP_SEEN */
@@ -36,55 +36,35 @@ using namespace std;
 
 extern itti_mw* itti_inst;
 
-static std::string string_to_hex(const std::string& input) {
-  static const char* const lut = "0123456789ABCDEF";
-  size_t len                   = input.length();
-
-  std::string output;
-  output.reserve(2 * len);
-  for (size_t i = 0; i < len; ++i) {
-    const unsigned char c = input[i];
-    output.push_back(lut[c >> 4]);
-    output.push_back(lut[c & 15]);
-  }
-  return output;
-}
-
 //------------------------------------------------------------------------------
 gtpv2c_stack::gtpv2c_stack(
     const uint32_t t3_milli_seconds, const uint32_t n3_retransmit,
     const string& ip_address, const unsigned short port_num,
-    const util::thread_sched_params& sched_params)
+    const util::thread_sched_params& sched_params, const uint32_t num_workers,
+    const uint32_t udp_batch_size, const bool io_uring,
+    const uint32_t max_concurrent_procedures)
     : t3_ms(t3_milli_seconds),
       n3(n3_retransmit),
       udp_s(udp_server(ip_address.c_str(), port_num)),
       udp_s_allocated(ip_address.c_str(), 0),
-      m_seq_num(),
-      gtpc_tx_id2seq_num(512),
-      proc_cleanup_timers(1024),
-      msg_out_retry_timers(512),
-      pending_procedures(512) {
-  timespec ts;
-  clock_gettime(CLOCK_REALTIME, &ts);
-  seq_num = (uint32_t) ts.tv_nsec & 0x7FFFFFFF;
-
+      m_transactions(),
+      transactions(max_concurrent_procedures, 24, (uint32_t) time(nullptr)) {
   Logger::gtpv2_c().info(
-      "gtpv2c_stack created listening to %s:%d initial seq num %d",
-      ip_address.c_str(), port_num, seq_num);
+      "gtpv2c_stack created listening to %s:%d, %u worker(s), %u procedures "
+      "max",
+      ip_address.c_str(), port_num, num_workers, max_concurrent_procedures);
 
   id              = 0;
   restart_counter = 0;
-  udp_s.start_receive(this, sched_params);
-  udp_s_allocated.start_receive(this, sched_params);
+  udp_s.start_receive(
+      this, sched_params, num_workers, udp_batch_size, io_uring);
+  udp_s_allocated.start_receive(
+      this, sched_params, num_workers, udp_batch_size, io_uring);
 }
 //------------------------------------------------------------------------------
-uint32_t gtpv2c_stack::get_next_seq_num() {
-  std::unique_lock lock(m_seq_num);
-  seq_num++;
-  if (seq_num & 0x80000000) {
-    seq_num = 0;
-  }
-  return seq_num;
+void gtpv2c_stack::stop() {
+  udp_s.stop();
+  udp_s_allocated.stop();
 }
 //------------------------------------------------------------------------------
 void gtpv2c_stack::handle_receive(
@@ -214,8 +194,7 @@ void gtpv2c_stack::start_msg_retry_timer(
       time_out_milli_seconds / 1000, (time_out_milli_seconds % 1000) * 1000,
       task_id);
   if (p.retry_timer_id != ITTI_INVALID_TIMER_ID) {
-    msg_out_retry_timers.insert(
-        std::pair<timer_id_t, uint32_t>(p.retry_timer_id, seq_num));
+    transactions.bind_timer(seq_num, p.retry_timer_id);
 #if TRACE_IS_ON
     Logger::gtpv2_c().trace(
         "Started Msg retry timer %d, proc " PROC_ID_FMT ", seq %d",
@@ -231,11 +210,11 @@ void gtpv2c_stack::start_msg_retry_timer(
 void gtpv2c_stack::stop_msg_retry_timer(gtpv2c_procedure& p) {
   if (p.retry_timer_id != ITTI_INVALID_TIMER_ID) {
     itti_inst->timer_remove(p.retry_timer_id);
-    msg_out_retry_timers.erase(p.retry_timer_id);
+    transactions.unbind_timer(p.retry_timer_id);
 #if TRACE_IS_ON
     Logger::gtpv2_c().trace(
-        "Stopped Msg retry timer %d, proc " PROC_ID_FMT ", seq %d",
-        p.retry_timer_id, p.gtpc_tx_id, p.retry_msg->get_sequence_number());
+        "Stopped Msg retry timer %d, proc " PROC_ID_FMT, p.retry_timer_id,
+        p.gtpc_tx_id);
 #endif
     p.retry_timer_id = ITTI_INVALID_TIMER_ID;
   }
@@ -243,7 +222,7 @@ void gtpv2c_stack::stop_msg_retry_timer(gtpv2c_procedure& p) {
 //------------------------------------------------------------------------------
 void gtpv2c_stack::stop_msg_retry_timer(timer_id_t& t) {
   itti_inst->timer_remove(t);
-  msg_out_retry_timers.erase(t);
+  transactions.unbind_timer(t);
 #if TRACE_IS_ON
   Logger::gtpv2_c().trace("Stopped Msg retry timer %d", t);
 #endif
@@ -256,8 +235,7 @@ void gtpv2c_stack::start_proc_cleanup_timer(
     p.proc_cleanup_timer_id = itti_inst->timer_setup(
         time_out_milli_seconds / 1000, (time_out_milli_seconds % 1000) * 1000,
         task_id);
-    proc_cleanup_timers.insert(
-        std::pair<timer_id_t, uint32_t>(p.proc_cleanup_timer_id, seq_num));
+    transactions.bind_timer(seq_num, p.proc_cleanup_timer_id);
 #if TRACE_IS_ON
     Logger::gtpv2_c().trace(
         "Started proc cleanup timer %d, proc " PROC_ID_FMT " t-out %" PRIu32
@@ -279,578 +257,369 @@ void gtpv2c_stack::stop_proc_cleanup_timer(gtpv2c_procedure& p) {
       "Stopped proc cleanup timer %d, proc " PROC_ID_FMT "",
       p.proc_cleanup_timer_id, p.gtpc_tx_id);
 #endif
-  msg_out_retry_timers.erase(p.proc_cleanup_timer_id);
+  transactions.unbind_timer(p.proc_cleanup_timer_id);
   p.proc_cleanup_timer_id = ITTI_INVALID_TIMER_ID;
 }
 //------------------------------------------------------------------------------
+gtpv2c_procedure* gtpv2c_stack::open_procedure(uint32_t& seq_num) {
+  uint32_t oldest = 0;
+  if (transactions.full() && transactions.oldest_retired(oldest)) {
+    close_procedure(oldest);
+  }
+  return transactions.open(seq_num);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_stack::close_procedure(const uint32_t seq_num) {
+  gtpv2c_procedure* proc = transactions.find(seq_num);
+  if (not proc) return;
+  if (proc->retry_timer_id != ITTI_INVALID_TIMER_ID) {
+    stop_msg_retry_timer(*proc);
+  }
+  if (proc->proc_cleanup_timer_id != ITTI_INVALID_TIMER_ID) {
+    stop_proc_cleanup_timer(*proc);
+  }
+  if (proc->gtpc_tx_id) {
+    free_gtpc_tx_id(proc->gtpc_tx_id);
+  }
+  transactions.close(seq_num);
+}
+//------------------------------------------------------------------------------
 void gtpv2c_stack::handle_receive_message_cb(
     const gtpv2c_msg& msg, const endpoint& r_endpoint, const task_id_t& task_id,
     bool& error, uint64_t& gtpc_tx_id) {
-  gtpc_tx_id = 0;
-  error      = true;
-  auto it    = pending_procedures.find(msg.get_sequence_number());
-  // If no procedure found concerning this message
-  if (it == pending_procedures.end()) {
-    // If procedure type is a request-like procedure
-    if (gtpv2c_stack::check_initial_message_type(msg.get_message_type())) {
-      gtpv2c_procedure proc = {};
-      proc.gtpc_tx_id       = generate_gtpc_tx_id();
-      proc.initial_msg_type = msg.get_message_type();
-      // TODO later 13.3 Detection and handling of requests which have timed out
-      // at the originating entity if (msg_has_timestamp()) {
-      // start_proc_cleanup_timer(proc, (N3+1) x T3, task_id,
-      // msg.get_sequence_number()); } else
-      start_proc_cleanup_timer(
-          proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-          msg.get_sequence_number());
-      pending_procedures.insert(std::pair<uint32_t, gtpv2c_procedure>(
-          msg.get_sequence_number(), proc));
-      gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-          proc.gtpc_tx_id, msg.get_sequence_number()));
-      error      = false;
-      gtpc_tx_id = proc.gtpc_tx_id;
-      Logger::gtpv2_c().info(
-          "Received Initial GTPV2-C msg type %d, seq %d, proc " PROC_ID_FMT "",
-          msg.get_message_type(), msg.get_sequence_number(), proc.gtpc_tx_id);
-    } else {
-      Logger::gtpv2_c().info(
-          "Failed to check Initial message type, Silently discarding GTPV2-C "
-          "msg type %d, seq %d",
-          msg.get_message_type(), msg.get_sequence_number());
-      error = true;
-    }
-    return;
-  } else {
-    // Found procedure concerning this message
-
-    //    Logger::gtpv2_c().info( "gtpv2c_procedure retry_timer_id        %d",
-    //    it->second.retry_timer_id); Logger::gtpv2_c().info( "gtpv2c_procedure
-    //    proc_cleanup_timer_id %d", it->second.proc_cleanup_timer_id);
-    //    Logger::gtpv2_c().info( "gtpv2c_procedure gtpc_tx_id            %ld",
-    //    it->second.gtpc_tx_id); Logger::gtpv2_c().info( "gtpv2c_procedure
-    //    initial_msg_type      %d", it->second.initial_msg_type);
-    //    Logger::gtpv2_c().info( "gtpv2c_procedure triggered_msg_type    %d",
-    //    it->second.triggered_msg_type); Logger::gtpv2_c().info(
-    //    "gtpv2c_procedure retry_count           %d", it->second.retry_count);
-
-    uint8_t check_initial_msg_type = it->second.triggered_msg_type;
-    if (!it->second.triggered_msg_type) {
-      check_initial_msg_type = it->second.initial_msg_type;
+  std::unique_lock lock(m_transactions);
+  gtpc_tx_id             = 0;
+  error                  = true;
+  gtpv2c_procedure* sent = transactions.find(msg.get_sequence_number());
+  // Found a procedure we initiated concerning this message
+  if ((sent) && (not sent->received_request)) {
+    uint8_t check_initial_msg_type = sent->triggered_msg_type;
+    if (!sent->triggered_msg_type) {
+      check_initial_msg_type = sent->initial_msg_type;
     }
     // check_initial_msg_type now contains the Request type.
     if (gtpv2c_stack::check_triggered_message_type(
             check_initial_msg_type, msg.get_message_type())) {
       // The msg response type is a valid response or triggered message
-      if (!it->second.triggered_msg_type) {
-        it->second.triggered_msg_type = msg.get_message_type();
-      }
       error      = false;
-      gtpc_tx_id = it->second.gtpc_tx_id;
-      if (it->second.retry_timer_id) {
-        stop_msg_retry_timer(it->second);
-      }
-      stop_proc_cleanup_timer(it->second);
-      gtpc_tx_id2seq_num.erase(gtpc_tx_id);
-      free_gtpc_tx_id(gtpc_tx_id);
-      pending_procedures.erase(it->first);
+      gtpc_tx_id = sent->gtpc_tx_id;
+      close_procedure(msg.get_sequence_number());
       Logger::gtpv2_c().info(
           "Received Triggered GTPV2-C msg type %d, seq %d, proc " PROC_ID_FMT
           "",
           msg.get_message_type(), msg.get_sequence_number(), gtpc_tx_id);
+      return;
+    }
+  }
+  // If procedure type is a request-like procedure
+  if (not gtpv2c_stack::check_initial_message_type(msg.get_message_type())) {
+    Logger::gtpv2_c().info(
+        "Failed to check message type, Silently discarding GTPV2-C msg type "
+        "%d, seq %d",
+        msg.get_message_type(), msg.get_sequence_number());
+    return;
+  }
+  // TS 29.274 7.6: a request is identified by its sender and sequence number,
+  // a retransmitted request is answered with the response already sent
+  const request_key request(r_endpoint, msg.get_sequence_number());
+  uint32_t received_seq_num = 0;
+  if (transactions.find_request(request, received_seq_num)) {
+    gtpv2c_procedure* received = transactions.find(received_seq_num);
+    if ((received) && (received->retry_bytes.size())) {
+      const std::vector<uint8_t>& bytes = received->retry_bytes;
+      udp_s.async_send_to(
+          reinterpret_cast<const char*>(bytes.data()), bytes.size(),
+          r_endpoint);
+      Logger::gtpv2_c().info(
+          "Received duplicated GTPV2-C msg type %d, seq %d from %s, response "
+          "sent again",
+          msg.get_message_type(), msg.get_sequence_number(),
+          r_endpoint.toString().c_str());
     } else {
       Logger::gtpv2_c().info(
-          "Failed to check Triggered message type, Silently discarding GTPV2-C "
-          "msg type %d, seq %d",
-          msg.get_message_type(), msg.get_sequence_number());
-      error = true;
+          "Received duplicated GTPV2-C msg type %d, seq %d from %s, in "
+          "progress, discarded",
+          msg.get_message_type(), msg.get_sequence_number(),
+          r_endpoint.toString().c_str());
     }
+    return;
+  }
+
+  uint32_t seq_num       = 0;
+  gtpv2c_procedure* proc = open_procedure(seq_num);
+  if (not proc) {
+    // the peer retransmits the request, it may be accepted then
+    Logger::gtpv2_c().warn(
+        "Received Initial GTPV2-C msg type %d, seq %d, %u procedures in "
+        "progress, discarded",
+        msg.get_message_type(), msg.get_sequence_number(),
+        transactions.size());
+    return;
   }
+  proc->gtpc_tx_id       = generate_gtpc_tx_id();
+  proc->initial_msg_type = msg.get_message_type();
+  proc->remote_endpoint  = r_endpoint;
+  proc->remote_seq_num   = msg.get_sequence_number();
+  proc->received_request = true;
+  // TODO later 13.3 Detection and handling of requests which have timed out
+  // at the originating entity if (msg_has_timestamp()) {
+  // start_proc_cleanup_timer(proc, (N3+1) x T3, task_id,
+  // msg.get_sequence_number()); } else
+  start_proc_cleanup_timer(
+      *proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id, seq_num);
+  transactions.bind_tx_id(seq_num, proc->gtpc_tx_id);
+  transactions.bind_request(seq_num, request);
+  error      = false;
+  gtpc_tx_id = proc->gtpc_tx_id;
+  Logger::gtpv2_c().info(
+      "Received Initial GTPV2-C msg type %d, seq %d, proc " PROC_ID_FMT "",
+      msg.get_message_type(), msg.get_sequence_number(), proc->gtpc_tx_id);
 }
 
+//------------------------------------------------------------------------------
+template <class M>
+uint32_t gtpv2c_stack::send_initial_bytes(
+    const endpoint& dest, gtpv2c_msg_header& h, const M& gtp_ies,
+    const teid_t l_teid, const task_id_t& task_id, const uint64_t gtp_tx_id) {
+  std::unique_lock lock(m_transactions);
+  uint32_t seq_num       = 0;
+  gtpv2c_procedure* proc = open_procedure(seq_num);
+  if (not proc) {
+    Logger::gtpv2_c().error(
+        "Sending %s, proc " PROC_ID_FMT " refused, %u procedures in progress",
+        gtp_ies.get_msg_name(), gtp_tx_id, transactions.size());
+    // the application aborts its procedure as if the peer was not responding
+    notify_ul_error(
+        dest, l_teid, cause_value_e::REMOTE_PEER_NOT_RESPONDING, gtp_tx_id);
+    return 0;
+  }
+  h.set_sequence_number(seq_num);
+  // kept by the procedure until answered, retransmitted as is on T3 expiry
+  try {
+    gtpv2c_encoder::encode(gtp_ies, h, proc->retry_bytes);
+  } catch (...) {
+    transactions.close(seq_num);
+    throw;
+  }
+  if (h.has_teid()) {
+    Logger::gtpv2_c().trace(
+        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
+        gtp_ies.get_msg_name(), seq_num, h.get_teid(), gtp_tx_id);
+  } else {
+    Logger::gtpv2_c().trace(
+        "Sending %s, seq %d, proc " PROC_ID_FMT " ", gtp_ies.get_msg_name(),
+        seq_num, gtp_tx_id);
+  }
+  proc->initial_msg_type = M::msg_id;
+  proc->gtpc_tx_id       = gtp_tx_id;
+  proc->local_teid       = l_teid;
+  proc->remote_endpoint  = dest;
+  start_msg_retry_timer(*proc, t3_ms, task_id, seq_num);
+  start_proc_cleanup_timer(
+      *proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id, seq_num);
+  transactions.bind_tx_id(seq_num, gtp_tx_id);
+  udp_s_allocated.async_send_to(
+      reinterpret_cast<const char*>(proc->retry_bytes.data()),
+      proc->retry_bytes.size(), dest);
+  return seq_num;
+}
 //------------------------------------------------------------------------------
 uint32_t gtpv2c_stack::send_initial_message(
     const endpoint& dest, const gtpv2c_echo_request& gtp_ies,
     const task_id_t& task_id, const uint64_t gtp_tx_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  gtpv2c_msg msg(gtp_ies);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::gtpv2_c().trace(
-      "Sending %s, seq %d, proc " PROC_ID_FMT " ", gtp_ies.get_msg_name(),
-      msg.get_sequence_number(), gtp_tx_id);
-  gtpv2c_procedure proc = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.gtpc_tx_id       = gtp_tx_id;
-  proc.retry_msg        = std::make_shared<gtpv2c_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t3_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, gtpv2c_procedure>(msg.get_sequence_number(), proc));
-  gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-      proc.gtpc_tx_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  gtpv2c_msg_header h;
+  return send_initial_bytes(dest, h, gtp_ies, 0, task_id, gtp_tx_id);
 }
 //------------------------------------------------------------------------------
 uint32_t gtpv2c_stack::send_initial_message(
     const endpoint& dest, const teid_t r_teid, const teid_t l_teid,
     const gtpv2c_create_session_request& gtp_ies, const task_id_t& task_id,
     const uint64_t gtp_tx_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  gtpv2c_msg msg(gtp_ies);
-  msg.set_teid(r_teid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::gtpv2_c().trace(
-      "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-      gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-      gtp_tx_id);
-  gtpv2c_procedure proc = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.gtpc_tx_id       = gtp_tx_id;
-  proc.local_teid       = l_teid;
-  proc.retry_msg        = std::make_shared<gtpv2c_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t3_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, gtpv2c_procedure>(msg.get_sequence_number(), proc));
-  gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-      proc.gtpc_tx_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  return send_initial_bytes(dest, h, gtp_ies, l_teid, task_id, gtp_tx_id);
 }
 //------------------------------------------------------------------------------
 uint32_t gtpv2c_stack::send_initial_message(
     const endpoint& dest, const teid_t r_teid, const teid_t l_teid,
     const gtpv2c_delete_session_request& gtp_ies, const task_id_t& task_id,
     const uint64_t gtp_tx_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  gtpv2c_msg msg(gtp_ies);
-  msg.set_teid(r_teid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  std::string bstream = oss.str();
-
-  Logger::gtpv2_c().trace(
-      "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-      gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-      gtp_tx_id);
-  gtpv2c_procedure proc = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.gtpc_tx_id       = gtp_tx_id;
-  proc.local_teid       = l_teid;
-  proc.retry_msg        = std::make_shared<gtpv2c_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t3_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, gtpv2c_procedure>(msg.get_sequence_number(), proc));
-  gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-      proc.gtpc_tx_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  return send_initial_bytes(dest, h, gtp_ies, l_teid, task_id, gtp_tx_id);
 }
 //------------------------------------------------------------------------------
 uint32_t gtpv2c_stack::send_initial_message(
     const endpoint& dest, const teid_t r_teid, const teid_t l_teid,
     const gtpv2c_modify_bearer_request& gtp_ies, const task_id_t& task_id,
     const uint64_t gtp_tx_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  gtpv2c_msg msg(gtp_ies);
-  msg.set_teid(r_teid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  std::string bstream = oss.str();
-
-  Logger::gtpv2_c().trace(
-      "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-      gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-      gtp_tx_id);
-  gtpv2c_procedure proc = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.gtpc_tx_id       = gtp_tx_id;
-  proc.local_teid       = l_teid;
-  proc.retry_msg        = std::make_shared<gtpv2c_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t3_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, gtpv2c_procedure>(msg.get_sequence_number(), proc));
-  gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-      proc.gtpc_tx_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  return send_initial_bytes(dest, h, gtp_ies, l_teid, task_id, gtp_tx_id);
 }
 //------------------------------------------------------------------------------
 uint32_t gtpv2c_stack::send_initial_message(
     const endpoint& dest, const teid_t r_teid, const teid_t l_teid,
     const gtpv2c_release_access_bearers_request& gtp_ies,
     const task_id_t& task_id, const uint64_t gtp_tx_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  gtpv2c_msg msg(gtp_ies);
-  msg.set_teid(r_teid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  std::string bstream = oss.str();
-
-  Logger::gtpv2_c().trace(
-      "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-      gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-      gtp_tx_id);
-  gtpv2c_procedure proc = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.gtpc_tx_id       = gtp_tx_id;
-  proc.local_teid       = l_teid;
-  proc.retry_msg        = std::make_shared<gtpv2c_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t3_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, gtpv2c_procedure>(msg.get_sequence_number(), proc));
-  gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-      proc.gtpc_tx_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  return send_initial_bytes(dest, h, gtp_ies, l_teid, task_id, gtp_tx_id);
 }
 //------------------------------------------------------------------------------
 uint32_t gtpv2c_stack::send_initial_message(
     const endpoint& dest, const teid_t r_teid, const teid_t l_teid,
     const gtpv2c_downlink_data_notification& gtp_ies, const task_id_t& task_id,
     const uint64_t gtp_tx_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  gtpv2c_msg msg(gtp_ies);
-  msg.set_teid(r_teid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  std::string bstream = oss.str();
-
-  Logger::gtpv2_c().trace(
-      "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-      gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-      gtp_tx_id);
-  gtpv2c_procedure proc = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.gtpc_tx_id       = gtp_tx_id;
-  proc.local_teid       = l_teid;
-  proc.retry_msg        = std::make_shared<gtpv2c_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t3_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, GTPV2C_PROC_TIME_OUT_MS(t3_ms, n3), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, gtpv2c_procedure>(msg.get_sequence_number(), proc));
-  gtpc_tx_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-      proc.gtpc_tx_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  return send_initial_bytes(dest, h, gtp_ies, l_teid, task_id, gtp_tx_id);
 }
 //------------------------------------------------------------------------------
-void gtpv2c_stack::send_triggered_message(
-    const endpoint& dest, const gtpv2c_echo_response& gtp_ies,
+template <class M>
+void gtpv2c_stack::send_triggered_bytes(
+    const endpoint& dest, gtpv2c_msg_header& h, const M& gtp_ies,
     const uint64_t gtp_tx_id, const gtpv2c_transaction_action& a) {
-  auto it = gtpc_tx_id2seq_num.find(gtp_tx_id);
-  if (it != gtpc_tx_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    gtpv2c_msg msg(gtp_ies);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
+  std::unique_lock lock(m_transactions);
+  uint32_t seq_num       = 0;
+  gtpv2c_procedure* proc = nullptr;
+  if (transactions.find_tx_id(gtp_tx_id, seq_num)) {
+    proc = transactions.find(seq_num);
+  }
+  if (not proc) {
+    Logger::gtpv2_c().error(
+        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
+        gtp_ies.get_msg_name(), gtp_tx_id);
+    return;
+  }
+  if (not proc->received_request) {
+    // the bytes of the procedure may still be retransmitted
+    h.set_sequence_number(seq_num);
+    std::vector<uint8_t> bytes;
+    gtpv2c_encoder::encode(gtp_ies, h, bytes);
     Logger::gtpv2_c().trace(
-        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-        gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-        gtp_tx_id);
+        "Sending %s, seq %d, proc " PROC_ID_FMT "", gtp_ies.get_msg_name(),
+        seq_num, gtp_tx_id);
     udp_s.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
+        reinterpret_cast<const char*>(bytes.data()), bytes.size(), dest);
     if (a == DELETE_TX) {
-      auto it_proc = pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_gtpc_tx_id(gtp_tx_id);
-        pending_procedures.erase(it_proc->first);
-      }
-      gtpc_tx_id2seq_num.erase(it->first);
+      close_procedure(seq_num);
     }
-  } else {
-    Logger::gtpv2_c().error(
-        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
-        gtp_ies.get_msg_name(), gtp_tx_id);
+    return;
   }
+  h.set_sequence_number(proc->remote_seq_num);
+  gtpv2c_encoder::encode(gtp_ies, h, proc->retry_bytes);
+  Logger::gtpv2_c().trace(
+      "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
+      gtp_ies.get_msg_name(), h.get_sequence_number(), h.get_teid(),
+      gtp_tx_id);
+  udp_s.async_send_to(
+      reinterpret_cast<const char*>(proc->retry_bytes.data()),
+      proc->retry_bytes.size(), dest);
+  // answered, from now on only kept for duplicated requests
+  transactions.retire(seq_num);
+  if (a == DELETE_TX) {
+    // the response stays for duplicated requests until the cleanup timer
+    transactions.unbind_tx_id(gtp_tx_id);
+    free_gtpc_tx_id(gtp_tx_id);
+    proc->gtpc_tx_id = 0;
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_stack::send_triggered_message(
+    const endpoint& dest, const gtpv2c_echo_response& gtp_ies,
+    const uint64_t gtp_tx_id, const gtpv2c_transaction_action& a) {
+  gtpv2c_msg_header h;
+  send_triggered_bytes(dest, h, gtp_ies, gtp_tx_id, a);
 }
 //------------------------------------------------------------------------------
 void gtpv2c_stack::send_triggered_message(
     const endpoint& r_endpoint, const teid_t r_teid,
     const gtpv2c_create_session_response& gtp_ies, const uint64_t gtp_tx_id,
     const gtpv2c_transaction_action& a) {
-  auto it = gtpc_tx_id2seq_num.find(gtp_tx_id);
-  if (it != gtpc_tx_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    gtpv2c_msg msg(gtp_ies);
-    msg.set_teid(r_teid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::gtpv2_c().trace(
-        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-        gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-        gtp_tx_id);
-    udp_s.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-        r_endpoint);
-
-    if (a == DELETE_TX) {
-      auto it_proc = pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_gtpc_tx_id(gtp_tx_id);
-        pending_procedures.erase(it_proc->first);
-      }
-      gtpc_tx_id2seq_num.erase(it->first);
-    }
-  } else {
-    Logger::gtpv2_c().error(
-        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
-        gtp_ies.get_msg_name(), gtp_tx_id);
-  }
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  send_triggered_bytes(r_endpoint, h, gtp_ies, gtp_tx_id, a);
 }
 //------------------------------------------------------------------------------
 void gtpv2c_stack::send_triggered_message(
     const endpoint& r_endpoint, const teid_t r_teid,
     const gtpv2c_delete_session_response& gtp_ies, const uint64_t gtp_tx_id,
     const gtpv2c_transaction_action& a) {
-  auto it = gtpc_tx_id2seq_num.find(gtp_tx_id);
-  if (it != gtpc_tx_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    gtpv2c_msg msg(gtp_ies);
-    msg.set_teid(r_teid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::gtpv2_c().trace(
-        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-        gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-        gtp_tx_id);
-    udp_s.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-        r_endpoint);
-
-    if (a == DELETE_TX) {
-      auto it_proc = pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_gtpc_tx_id(gtp_tx_id);
-        pending_procedures.erase(it_proc->first);
-      }
-      gtpc_tx_id2seq_num.erase(it->first);
-    }
-  } else {
-    Logger::gtpv2_c().error(
-        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
-        gtp_ies.get_msg_name(), gtp_tx_id);
-  }
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  send_triggered_bytes(r_endpoint, h, gtp_ies, gtp_tx_id, a);
 }
 //------------------------------------------------------------------------------
 void gtpv2c_stack::send_triggered_message(
     const endpoint& r_endpoint, const teid_t r_teid,
     const gtpv2c_modify_bearer_response& gtp_ies, const uint64_t gtp_tx_id,
     const gtpv2c_transaction_action& a) {
-  auto it = gtpc_tx_id2seq_num.find(gtp_tx_id);
-  if (it != gtpc_tx_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    gtpv2c_msg msg(gtp_ies);
-    msg.set_teid(r_teid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::gtpv2_c().trace(
-        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-        gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-        gtp_tx_id);
-    udp_s.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-        r_endpoint);
-
-    if (a == DELETE_TX) {
-      auto it_proc = pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_gtpc_tx_id(gtp_tx_id);
-        pending_procedures.erase(it_proc->first);
-      }
-      gtpc_tx_id2seq_num.erase(it->first);
-    }
-  } else {
-    Logger::gtpv2_c().error(
-        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
-        gtp_ies.get_msg_name(), gtp_tx_id);
-  }
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  send_triggered_bytes(r_endpoint, h, gtp_ies, gtp_tx_id, a);
 }
 //------------------------------------------------------------------------------
 void gtpv2c_stack::send_triggered_message(
     const endpoint& r_endpoint, const teid_t r_teid,
     const gtpv2c_release_access_bearers_response& gtp_ies,
     const uint64_t gtp_tx_id, const gtpv2c_transaction_action& a) {
-  auto it = gtpc_tx_id2seq_num.find(gtp_tx_id);
-  if (it != gtpc_tx_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    gtpv2c_msg msg(gtp_ies);
-    msg.set_teid(r_teid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::gtpv2_c().trace(
-        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-        gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-        gtp_tx_id);
-    udp_s.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-        r_endpoint);
-
-    if (a == DELETE_TX) {
-      auto it_proc = pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_gtpc_tx_id(gtp_tx_id);
-        pending_procedures.erase(it_proc->first);
-      }
-      gtpc_tx_id2seq_num.erase(it->first);
-    }
-  } else {
-    Logger::gtpv2_c().error(
-        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
-        gtp_ies.get_msg_name(), gtp_tx_id);
-  }
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  send_triggered_bytes(r_endpoint, h, gtp_ies, gtp_tx_id, a);
 }
 //------------------------------------------------------------------------------
 void gtpv2c_stack::send_triggered_message(
     const endpoint& r_endpoint, const teid_t r_teid,
     const gtpv2c_downlink_data_notification_acknowledge& gtp_ies,
     const uint64_t gtp_tx_id, const gtpv2c_transaction_action& a) {
-  auto it = gtpc_tx_id2seq_num.find(gtp_tx_id);
-  if (it != gtpc_tx_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    gtpv2c_msg msg(gtp_ies);
-    msg.set_teid(r_teid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::gtpv2_c().trace(
-        "Sending %s, seq %d, teid " TEID_FMT ", proc " PROC_ID_FMT "",
-        gtp_ies.get_msg_name(), msg.get_sequence_number(), msg.get_teid(),
-        gtp_tx_id);
-    udp_s.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-        r_endpoint);
-
-    if (a == DELETE_TX) {
-      auto it_proc = pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_gtpc_tx_id(gtp_tx_id);
-        pending_procedures.erase(it_proc->first);
-      }
-      gtpc_tx_id2seq_num.erase(it->first);
-    }
-  } else {
-    Logger::gtpv2_c().error(
-        "Sending %s, gtp_tx_id " PROC_ID_FMT " proc not found, discarded!",
-        gtp_ies.get_msg_name(), gtp_tx_id);
-  }
+  gtpv2c_msg_header h;
+  h.set_teid(r_teid);
+  send_triggered_bytes(r_endpoint, h, gtp_ies, gtp_tx_id, a);
 }
-
 //------------------------------------------------------------------------------
 void gtpv2c_stack::time_out_event(
     const uint32_t timer_id, const task_id_t& task_id, bool& handled) {
-  handled = false;
-  auto it = msg_out_retry_timers.find(timer_id);
-  if (it != msg_out_retry_timers.end()) {
-    auto it_proc = pending_procedures.find(it->second);
-    msg_out_retry_timers.erase(it->first);
-    handled = true;
-    if (it_proc != pending_procedures.end()) {
-      if (it_proc->second.retry_count < n3) {
-        it_proc->second.retry_count++;
-        it_proc->second.retry_timer_id = 0;
-        start_msg_retry_timer(
-            it_proc->second, t3_ms, task_id,
-            it_proc->second.retry_msg->get_sequence_number());
-        // send again message
-        Logger::gtpv2_c().trace(
-            "Retry %d Sending msg type %d, seq %d", it_proc->second.retry_count,
-            it_proc->second.retry_msg->get_message_type(),
-            it_proc->second.retry_msg->get_sequence_number());
-        std::ostringstream oss(std::ostringstream::binary);
-        it_proc->second.retry_msg->dump_to(oss);
-        std::string bstream = oss.str();
-        udp_s.async_send_to(
-            reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-            it_proc->second.remote_endpoint);
-      } else {
-        // abort procedure
-        notify_ul_error(
-            it_proc->second.remote_endpoint, it_proc->second.local_teid,
-            cause_value_e::REMOTE_PEER_NOT_RESPONDING,
-            it_proc->second.gtpc_tx_id);
-        handled                               = true;
-        it_proc->second.proc_cleanup_timer_id = 0;
-        Logger::gtpv2_c().trace(
-            "Delete proc " PROC_ID_FMT " Retry %d seq %d timer id %u",
-            it_proc->second.gtpc_tx_id, it_proc->second.retry_count,
-            it_proc->first, timer_id);
-        pending_procedures.erase(it_proc->first);
-      }
+  std::unique_lock lock(m_transactions);
+  handled          = false;
+  uint32_t seq_num = 0;
+  if (not transactions.find_timer(timer_id, seq_num)) {
+    return;
+  }
+  gtpv2c_procedure* proc = transactions.find(seq_num);
+  if (not proc) {
+    return;
+  }
+  handled = true;
+  transactions.unbind_timer(timer_id);
+  if (timer_id == proc->retry_timer_id) {
+    proc->retry_timer_id = ITTI_INVALID_TIMER_ID;
+    if (proc->retry_count < n3) {
+      proc->retry_count++;
+      start_msg_retry_timer(*proc, t3_ms, task_id, seq_num);
+      // send again the bytes of the first transmission
+      Logger::gtpv2_c().trace(
+          "Retry %d Sending msg type %d, seq %d", proc->retry_count,
+          proc->initial_msg_type, seq_num);
+      const std::vector<uint8_t>& bytes = proc->retry_bytes;
+      udp_s.async_send_to(
+          reinterpret_cast<const char*>(bytes.data()), bytes.size(),
+          proc->remote_endpoint);
+    } else {
+      // abort procedure
+      notify_ul_error(
+          proc->remote_endpoint, proc->local_teid,
+          cause_value_e::REMOTE_PEER_NOT_RESPONDING, proc->gtpc_tx_id);
+      Logger::gtpv2_c().trace(
+          "Delete proc " PROC_ID_FMT " Retry %d seq %d timer id %u",
+          proc->gtpc_tx_id, proc->retry_count, seq_num, timer_id);
+      close_procedure(seq_num);
     }
   } else {
-    it = proc_cleanup_timers.find(timer_id);
-    if (it != proc_cleanup_timers.end()) {
-      auto it_proc = pending_procedures.find(it->second);
-      gtpc_tx_id2seq_num.erase(it_proc->second.gtpc_tx_id);
-      free_gtpc_tx_id(it_proc->second.gtpc_tx_id);
-      proc_cleanup_timers.erase(it->first);
-      handled = true;
-      if (it_proc != pending_procedures.end()) {
-        it_proc->second.proc_cleanup_timer_id = 0;
-        Logger::gtpv2_c().trace(
-            "Delete proc " PROC_ID_FMT " Retry %d seq %d timer id %u",
-            it_proc->second.gtpc_tx_id, it_proc->second.retry_count,
-            it_proc->first, timer_id);
-        pending_procedures.erase(it_proc->first);
-      }
-    }
+    proc->proc_cleanup_timer_id = ITTI_INVALID_TIMER_ID;
+    Logger::gtpv2_c().trace(
+        "Delete proc " PROC_ID_FMT " Retry %d seq %d timer id %u",
+        proc->gtpc_tx_id, proc->retry_count, seq_num, timer_id);
+    close_procedure(seq_num);
   }
 }
@@ -31,17 +31,19 @@
 #include "3gpp_29.274.hpp"
 #include "endpoint.hpp"
 #include "itti.hpp"
+#include "transaction_table.hpp"
 #include "udp.hpp"
 #include "uint_generator.hpp"
 
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
+#include "gtpv2c_encoder.hpp"
 #include "msg_gtpv2c.hpp"
 
-#include <folly/AtomicHashMap.h>
 
 namespace gtpv2c {
 
@@ -49,8 +51,9 @@ static const uint16_t default_port = 2123;
 
 class gtpv2c_procedure {
  public:
-  std::shared_ptr<gtpv2c_msg> retry_msg;
+  std::vector<uint8_t> retry_bytes;  // message as sent, or response to replay
   endpoint remote_endpoint;
+  uint32_t remote_seq_num;  // of the request received from remote_endpoint
   teid_t local_teid;  // for peer not responding
   timer_id_t retry_timer_id;
   timer_id_t proc_cleanup_timer_id;
@@ -58,6 +61,7 @@ class gtpv2c_procedure {
   uint8_t initial_msg_type;    // sent or received
   uint8_t triggered_msg_type;  // sent or received
   uint8_t retry_count;
+  bool received_request;  // initial message sent by the peer
   // Could add customized N3, and customized T3:
   // T3-RESPONSE timer and N3-REQUESTS counter setting is implementation
   // dependent. That is, the timers and counters may be configurable per
@@ -65,26 +69,33 @@ class gtpv2c_procedure {
   // Responses) however require longer timer values and possibly a higher number
   // of retransmission attempts compared to single leg communication.
   gtpv2c_procedure()
-      : retry_msg(),
+      : retry_bytes(),
         remote_endpoint(),
+        remote_seq_num(0),
         local_teid(0),
         retry_timer_id(0),
         proc_cleanup_timer_id(0),
         gtpc_tx_id(0),
         initial_msg_type(0),
         triggered_msg_type(0),
-        retry_count(0) {}
+        retry_count(0),
+        received_request(false) {}
 
   gtpv2c_procedure(const gtpv2c_procedure& p)
-      : retry_msg(p.retry_msg),
+      : retry_bytes(p.retry_bytes),
         remote_endpoint(p.remote_endpoint),
+        remote_seq_num(p.remote_seq_num),
         local_teid(p.local_teid),
         retry_timer_id(p.retry_timer_id),
         proc_cleanup_timer_id(p.proc_cleanup_timer_id),
         gtpc_tx_id(p.gtpc_tx_id),
         initial_msg_type(p.initial_msg_type),
         triggered_msg_type(p.triggered_msg_type),
-        retry_count(p.retry_count) {}
+        retry_count(p.retry_count),
+        received_request(p.received_request) {}
+  gtpv2c_procedure(gtpv2c_procedure&& p) = default;
+  gtpv2c_procedure& operator=(const gtpv2c_procedure& p) = default;
+  gtpv2c_procedure& operator=(gtpv2c_procedure&& p) = default;
 };
 
 enum gtpv2c_transaction_action { DELETE_TX = 0, CONTINUE_TX };
@@ -99,22 +110,20 @@ class gtpv2c_stack : public UdpApplication {
   udp_server udp_s;
   udp_server udp_s_allocated;
 
-  // seems no need for atomic
-  uint32_t seq_num;
-  std::mutex m_seq_num;
   uint32_t restart_counter;
 
-  // key is transaction id
-  folly::AtomicHashMap<uint64_t, uint32_t> gtpc_tx_id2seq_num;
-  folly::AtomicHashMap<timer_id_t, uint32_t> proc_cleanup_timers;
-  folly::AtomicHashMap<timer_id_t, uint32_t> msg_out_retry_timers;
-  // key is message sequence number
-  folly::AtomicHashMap<uint32_t, gtpv2c_procedure> pending_procedures;
+  // Serializes the transaction tables below, they are shared by the UDP
+  // reader threads, the ITTI task of the stack and the application workers
+  std::mutex m_transactions;
+  // procedures by (24 bits) sequence number, also found by transaction id,
+  // timer id and (peer, sequence number of the peer) of a received request.
+  // A request received is given a local sequence number so that peers never
+  // collide.
+  util::transaction_table<gtpv2c_procedure, request_key, request_key::hash>
+      transactions;
 
   static const char* msg_type2cstr[256];
 
-  uint32_t get_next_seq_num();
-
   static uint64_t generate_gtpc_tx_id() {
     return util::uint_uid_generator<uint64_t>::get_instance().get_uid();
   }
@@ -136,13 +145,41 @@ class gtpv2c_stack : public UdpApplication {
   void stop_msg_retry_timer(timer_id_t& t);
   void stop_proc_cleanup_timer(gtpv2c_procedure& p);
   void notify_ul_error(const gtpv2c_procedure& p, const cause_value_e cause);
+  /** \brief Open a procedure, once the table is full the oldest procedure
+   *  kept only for duplicated requests is reclaimed
+   *  @returns nullptr if every procedure is in progress
+   **/
+  gtpv2c_procedure* open_procedure(uint32_t& seq_num);
+  /** \brief Stop the timers of a procedure, release its ids and close it
+   **/
+  void close_procedure(const uint32_t seq_num);
+  /** \brief Open the procedure of an initial message, encode and send it
+   *  @returns the sequence number of the message
+   **/
+  template <class M>
+  uint32_t send_initial_bytes(
+      const endpoint& r_endpoint, gtpv2c_msg_header& h, const M& gtp_ies,
+      const teid_t l_teid, const task_id_t& task_id, const uint64_t gtp_tx_id);
+  /** \brief Send the triggered message of a procedure, the bytes are kept by
+   *  the procedure to answer a retransmission of the request
+   **/
+  template <class M>
+  void send_triggered_bytes(
+      const endpoint& r_endpoint, gtpv2c_msg_header& h, const M& gtp_ies,
+      const uint64_t gtp_tx_id, const gtpv2c_transaction_action& a);
 
  public:
   static const uint8_t version = 2;
   gtpv2c_stack(
       const uint32_t t1_milli_seconds, const uint32_t n1_retransmit,
       const std::string& ip_address, const unsigned short port_num,
-      const util::thread_sched_params& sched_param);
+      const util::thread_sched_params& sched_param,
+      const uint32_t num_workers = 1, const uint32_t udp_batch_size = 1,
+      const bool io_uring = false,
+      const uint32_t max_concurrent_procedures = 256);
+  /** \brief Stop the UDP endpoints, once the owner task is terminating
+   **/
+  void stop();
   virtual void handle_receive(
       char* recv_buffer, const std::size_t bytes_transferred,
       const endpoint& r_endpoint);
@@ -0,0 +1,923 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file gtpv2c_decoder.cpp
+  \brief Single pass GTPv2-C decoder
+*/
+#include "gtpv2c_decoder.hpp"
+
+#include <algorithm>
+
+namespace gtpv2c {
+namespace {
+
+//------------------------------------------------------------------------------
+// MCC/MNC octets shared by the Serving Network IE, the ULI fields and the UCI
+template <class T>
+inline void decode_plmn(gtpv2c_view& v, T& t) {
+  uint8_t b     = v.u8();
+  t.mcc_digit_1 = b & 0x0F;
+  t.mcc_digit_2 = b >> 4;
+  b             = v.u8();
+  t.mcc_digit_3 = b & 0x0F;
+  t.mnc_digit_3 = b >> 4;
+  b             = v.u8();
+  t.mnc_digit_1 = b & 0x0F;
+  t.mnc_digit_2 = b >> 4;
+}
+//------------------------------------------------------------------------------
+// TBCD digits of IMSI, MSISDN and MEI, a trailing 0xF filler is not a digit
+template <class T>
+inline void decode_tbcd(gtpv2c_view& v, T& t, const unsigned max_digits) {
+  const size_t len = v.size();
+  if (len == 0) throw gtpc_tlv_bad_length_exception(v.type(), 0);
+  const bool filler = (v.data()[len - 1] & 0xF0) == 0xF0;
+  v.copy(t.u1.b, std::min(len, sizeof(t.u1.b)));
+  t.num_digits = std::min(len * 2 - (filler ? 1 : 0), (size_t) max_digits);
+}
+
+//------------------------------------------------------------------------------
+// IE values, one overload per core type
+void decode_value(gtpv2c_view& v, imsi_t& i) {
+  decode_tbcd(v, i, 15);
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, msisdn_t& m) {
+  decode_tbcd(v, m, MSISDN_MAX_LENGTH);
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, mei_t& m) {
+  decode_tbcd(v, m, MEI_MAX_LENGTH);
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, cause_t& c) {
+  c.cause_value   = v.u8();
+  const uint8_t b = v.u8();
+  c.cs            = b & 0x01;
+  c.bce           = (b >> 1) & 0x01;
+  c.pce           = (b >> 2) & 0x01;
+  if (v.size() >= 4) {
+    c.offending_ie_type     = v.u8();
+    c.offending_ie_length   = v.be16();
+    c.offending_ie_instance = v.u8() & 0x0F;
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, recovery_t& r) {
+  r.restart_counter = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, apn_t& a) {
+  // length prefixed labels to dotted name, bytes that cannot be a label
+  // length are kept as is (same leniency as gtpv2c_ie::dotted_to_string)
+  a.access_point_name.clear();
+  while (not v.empty()) {
+    const uint8_t l = v.u8();
+    if (l < 64) {
+      const size_t n = std::min((size_t) l, v.size());
+      if (n == l) {
+        if (not a.access_point_name.empty()) a.access_point_name.push_back('.');
+        a.access_point_name.append(reinterpret_cast<const char*>(v.data()), l);
+      }
+      v.skip(n);
+    } else {
+      a.access_point_name.push_back(l);
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, ambr_t& a) {
+  a.br_ul = v.be32();
+  a.br_dl = v.be32();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, ebi_t& e) {
+  e.ebi = v.u8() & 0x0F;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, indication_t& i) {
+  // 1 to 7 octets depending on the release of the sender
+  uint8_t o[7] = {};
+  v.need(1);
+  v.copy(o, std::min(v.size(), sizeof(o)));
+  i.sgwci   = o[0] & 0x01;
+  i.israi   = (o[0] >> 1) & 0x01;
+  i.isrsi   = (o[0] >> 2) & 0x01;
+  i.oi      = (o[0] >> 3) & 0x01;
+  i.dfi     = (o[0] >> 4) & 0x01;
+  i.hi      = (o[0] >> 5) & 0x01;
+  i.dtf     = (o[0] >> 6) & 0x01;
+  i.daf     = (o[0] >> 7) & 0x01;
+  i.msv     = o[1] & 0x01;
+  i.si      = (o[1] >> 1) & 0x01;
+  i.pt      = (o[1] >> 2) & 0x01;
+  i.p       = (o[1] >> 3) & 0x01;
+  i.crsi    = (o[1] >> 4) & 0x01;
+  i.cfsi    = (o[1] >> 5) & 0x01;
+  i.uimsi   = (o[1] >> 6) & 0x01;
+  i.sqci    = (o[1] >> 7) & 0x01;
+  i.ccrsi   = o[2] & 0x01;
+  i.israu   = (o[2] >> 1) & 0x01;
+  i.mbmdt   = (o[2] >> 2) & 0x01;
+  i.s4af    = (o[2] >> 3) & 0x01;
+  i.s6af    = (o[2] >> 4) & 0x01;
+  i.srni    = (o[2] >> 5) & 0x01;
+  i.pbic    = (o[2] >> 6) & 0x01;
+  i.retloc  = (o[2] >> 7) & 0x01;
+  i.cpsr    = o[3] & 0x01;
+  i.clii    = (o[3] >> 1) & 0x01;
+  i.csfbi   = (o[3] >> 2) & 0x01;
+  i.ppsi    = (o[3] >> 3) & 0x01;
+  i.ppon    = (o[3] >> 4) & 0x01;
+  i.ppof    = (o[3] >> 5) & 0x01;
+  i.arrl    = (o[3] >> 6) & 0x01;
+  i.cprai   = (o[3] >> 7) & 0x01;
+  i.aopi    = o[4] & 0x01;
+  i.aosi    = (o[4] >> 1) & 0x01;
+  i.pcri    = (o[4] >> 2) & 0x01;
+  i.psci    = (o[4] >> 3) & 0x01;
+  i.bdwi    = (o[4] >> 4) & 0x01;
+  i.dtci    = (o[4] >> 5) & 0x01;
+  i.uasi    = (o[4] >> 6) & 0x01;
+  i.nsi     = (o[4] >> 7) & 0x01;
+  i.wpmsi   = o[5] & 0x01;
+  i.unaccsi = (o[5] >> 1) & 0x01;
+  i.pnsi    = (o[5] >> 2) & 0x01;
+  i.s11tf   = (o[5] >> 3) & 0x01;
+  i.pmtsmi  = (o[5] >> 4) & 0x01;
+  i.cpopci  = (o[5] >> 5) & 0x01;
+  i.epcosi  = (o[5] >> 6) & 0x01;
+  i.roaai   = (o[5] >> 7) & 0x01;
+  i.tspcmi  = o[6] & 0x01;
+  i.enbcpi  = (o[6] >> 1) & 0x01;
+  i.ltempi  = (o[6] >> 2) & 0x01;
+  i.ltemui  = (o[6] >> 3) & 0x01;
+  i.eevrsi  = (o[6] >> 4) & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, protocol_configuration_options_t& p) {
+  const uint8_t b          = v.u8();
+  p.configuration_protocol = b & 0x07;
+  p.ext                    = b >> 7;
+  p.num_protocol_or_container_id = 0;
+  while (not v.empty()) {
+    const uint16_t id = v.be16();
+    const uint8_t l   = v.u8();
+    v.need(l);
+    // ids past the capacity of the core type are dropped
+    if (p.num_protocol_or_container_id <
+        PCO_UNSPEC_MAXIMUM_PROTOCOL_ID_OR_CONTAINER_ID) {
+      pco_protocol_or_container_id_t& c =
+          p.protocol_or_container_ids[p.num_protocol_or_container_id++];
+      c.protocol_id                    = id;
+      c.length_of_protocol_id_contents = l;
+      c.protocol_id_contents.assign(
+          reinterpret_cast<const char*>(v.data()), l);
+    }
+    v.skip(l);
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(
+    gtpv2c_view& v, extended_protocol_configuration_options_t& e) {
+  e.extended_protocol_configuration_options.assign(
+      reinterpret_cast<const char*>(v.data()), v.size());
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, traffic_flow_template_t& t) {
+  // packet filters and parameters are not used by the core type users
+  const uint8_t b         = v.u8();
+  t.tftoperationcode      = b >> 5;
+  t.ebit                  = (b >> 4) & 0x01;
+  t.numberofpacketfilters = b & 0x0F;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, pdn_type_t& p) {
+  p.pdn_type = v.u8() & 0x07;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, paa_t& p) {
+  const size_t len      = v.size();
+  p.pdn_type.pdn_type   = v.u8() & 0x07;
+  p.ipv6_prefix_length  = 0;
+  p.ipv6_address        = in6addr_any;
+  p.ipv4_address.s_addr = INADDR_ANY;
+  switch (p.pdn_type.pdn_type) {
+    case PDN_TYPE_E_IPV4:
+      if (len != 5) throw gtpc_tlv_bad_length_exception(v.type(), len);
+      v.copy(&p.ipv4_address, sizeof(p.ipv4_address));
+      break;
+    case PDN_TYPE_E_IPV6:
+      if (len != 18) throw gtpc_tlv_bad_length_exception(v.type(), len);
+      p.ipv6_prefix_length = v.u8();
+      v.copy(&p.ipv6_address, sizeof(p.ipv6_address));
+      break;
+    case PDN_TYPE_E_IPV4V6:
+      if (len != 22) throw gtpc_tlv_bad_length_exception(v.type(), len);
+      p.ipv6_prefix_length = v.u8();
+      v.copy(&p.ipv6_address, sizeof(p.ipv6_address));
+      v.copy(&p.ipv4_address, sizeof(p.ipv4_address));
+      break;
+    case PDN_TYPE_E_NON_IP:
+      if (len != 1) throw gtpc_tlv_bad_length_exception(v.type(), len);
+      break;
+    default:
+      throw gtpc_ie_value_exception(v.type(), "pdn_type");
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, bearer_qos_t& q) {
+  const uint8_t b                   = v.u8();
+  q.pvi                             = b & 0x01;
+  q.pl                              = (b >> 2) & 0x0F;
+  q.pci                             = (b >> 6) & 0x01;
+  q.label_qci                       = v.u8();
+  q.maximum_bit_rate_for_uplink     = v.be40();
+  q.maximum_bit_rate_for_downlink   = v.be40();
+  q.guaranted_bit_rate_for_uplink   = v.be40();
+  q.guaranted_bit_rate_for_downlink = v.be40();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, arp_t& a) {
+  const uint8_t b = v.u8();
+  a.pvi           = b & 0x01;
+  a.pl            = (b >> 2) & 0x0F;
+  a.pci           = (b >> 6) & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, rat_type_t& r) {
+  r.rat_type = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, serving_network_t& s) {
+  decode_plmn(v, s);
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, uli_t& u) {
+  const uint8_t flags = v.u8();
+  auto& h             = u.user_location_information_ie_hdr;
+  h.cgi                      = flags & 0x01;
+  h.sai                      = (flags >> 1) & 0x01;
+  h.rai                      = (flags >> 2) & 0x01;
+  h.tai                      = (flags >> 3) & 0x01;
+  h.ecgi                     = (flags >> 4) & 0x01;
+  h.lai                      = (flags >> 5) & 0x01;
+  h.macro_enodeb_id          = (flags >> 6) & 0x01;
+  h.extended_macro_enodeb_id = (flags >> 7) & 0x01;
+  if (h.cgi) {
+    decode_plmn(v, u.cgi1);
+    u.cgi1.location_area_code = v.be16();
+    u.cgi1.cell_identity      = v.be16();
+  }
+  if (h.sai) {
+    decode_plmn(v, u.sai1);
+    u.sai1.location_area_code = v.be16();
+    u.sai1.service_area_code  = v.be16();
+  }
+  if (h.rai) {
+    decode_plmn(v, u.rai1);
+    u.rai1.location_area_code = v.be16();
+    u.rai1.routing_area_code  = v.be16();
+  }
+  if (h.tai) {
+    decode_plmn(v, u.tai1);
+    u.tai1.tracking_area_code = v.be16();
+  }
+  if (h.ecgi) {
+    decode_plmn(v, u.ecgi1);
+    const uint8_t b = v.u8();
+    u.ecgi1.eci     = b & 0x0F;
+    u.ecgi1.spare   = b >> 4;
+    v.copy(u.ecgi1.e_utran_cell_identifier, 3);
+  }
+  if (h.lai) {
+    decode_plmn(v, u.lai1);
+    u.lai1.location_area_code = v.be16();
+  }
+  if (h.macro_enodeb_id) {
+    decode_plmn(v, u.macro_enodeb_id1);
+    const uint32_t id = v.be24();
+    u.macro_enodeb_id1.spare           = id >> 20;
+    u.macro_enodeb_id1.macro_enodeb_id = id & 0x0FFFFF;
+    u.macro_enodeb_id1.lost_bits       = 0;
+  }
+  if (h.extended_macro_enodeb_id) {
+    decode_plmn(v, u.extended_macro_enodeb_id1);
+    const uint32_t id = v.be24();
+    u.extended_macro_enodeb_id1.smenb = id >> 23;
+    u.extended_macro_enodeb_id1.spare = (id >> 20) & 0x03;
+    u.extended_macro_enodeb_id1.extended_macro_enodeb_id = id & 0x0FFFFF;
+    u.extended_macro_enodeb_id1.lost_bits                = 0;
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, fteid_t& f) {
+  const uint8_t b  = v.u8();
+  f.interface_type = b & 0x3F;
+  f.v6             = (b >> 6) & 0x01;
+  f.v4             = b >> 7;
+  f.teid_gre_key   = v.be32();
+  if (f.v4) v.copy(&f.ipv4_address, sizeof(f.ipv4_address));
+  if (f.v6) v.copy(&f.ipv6_address, sizeof(f.ipv6_address));
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, delay_value_t& d) {
+  d.delay_value = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, charging_id_t& c) {
+  c.charging_id_value = v.be32();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, bearer_flags_t& f) {
+  const uint8_t b = v.u8();
+  f.ppc           = b & 0x01;
+  f.vb            = (b >> 1) & 0x01;
+  f.vind          = (b >> 2) & 0x01;
+  f.asi           = (b >> 3) & 0x01;
+  f.spare1        = b >> 4;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, ue_time_zone_t& t) {
+  t.time_zone            = v.u8();
+  t.daylight_saving_time = v.u8() & 0x03;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, apn_restriction_t& a) {
+  a.restriction_type_value = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, selection_mode_t& s) {
+  s.selec_mode = v.u8() & 0x03;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, fq_csid_t& f) {
+  auto& h             = f.fq_csid_ie_hdr;
+  const uint8_t b     = v.u8();
+  h.number_of_csids   = b & 0x0F;
+  h.node_id_type      = b >> 4;
+  switch (h.node_id_type) {
+    case GLOBAL_UNICAST_IPv4:
+      v.copy(&h.node_id.unicast_ipv4, sizeof(h.node_id.unicast_ipv4));
+      break;
+    case GLOBAL_UNICAST_IPv6:
+      v.copy(&h.node_id.unicast_ipv6, sizeof(h.node_id.unicast_ipv6));
+      break;
+    case TYPE_EXOTIC: {
+      uint32_t exotic                        = v.be32();
+      h.node_id.exotic.operator_specific_id = exotic & 0x00000FFF;
+      exotic                                 = exotic >> 12;
+      h.node_id.exotic.mnc                   = exotic % 1000;
+      h.node_id.exotic.mcc                   = exotic / 1000;
+    } break;
+    default:
+      throw gtpc_ie_value_exception(v.type(), "node_id_type");
+  }
+  for (int i = 0; i < h.number_of_csids; i++) {
+    f.pdn_connection_set_identifier[i] = v.be16();
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, node_type_t& n) {
+  n.node_type = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, node_features_t& n) {
+  const uint8_t b = v.u8();
+  n.prn           = b & 0x01;
+  n.mabr          = (b >> 1) & 0x01;
+  n.ntsr          = (b >> 2) & 0x01;
+  n.ciot          = (b >> 3) & 0x01;
+  n.s1un          = (b >> 4) & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, uci_t& u) {
+  decode_plmn(v, u);
+  u.csg_id        = v.be32() & 0x07FFFFFF;
+  const uint8_t b = v.u8();
+  u.cmi           = b & 0x01;
+  u.lcsg          = (b >> 1) & 0x01;
+  u.access_mode   = b >> 6;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, epc_timer_t& t) {
+  const uint8_t b = v.u8();
+  t.timer_unit    = b >> 5;
+  t.timer_value   = b & 0x1F;
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, local_distinguished_name_t& l) {
+  l.ldn.assign(reinterpret_cast<const char*>(v.data()), v.size());
+}
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, ran_nas_cause_t& r) {
+  // same cause value sizes as gtpv2c_ran_nas_cause_ie
+  const uint8_t b = v.u8();
+  r.cause_type    = b & 0x0F;
+  r.protocol_type = b >> 4;
+  switch (r.protocol_type) {
+    case PROTOCOL_TYPE_E_S1AP:
+      r.cause_value.s1ap = v.be16();
+      break;
+    case PROTOCOL_TYPE_E_EMM:
+      r.cause_value.emm = v.u8();
+      break;
+    case PROTOCOL_TYPE_E_ESM:
+      r.cause_value.esm = v.u8();
+      break;
+    case PROTOCOL_TYPE_E_DIAMETER:
+      r.cause_value.diameter = v.be16();
+      break;
+    case PROTOCOL_TYPE_E_IKEV2:
+      r.cause_value.ikev2 = v.be16();
+      break;
+    default:
+      throw gtpc_ie_value_exception(v.type(), "protocol_type");
+  }
+}
+
+// grouped IE, below
+void decode_value(gtpv2c_view& v, bearer_context& b);
+
+//------------------------------------------------------------------------------
+template <class T, class C>
+inline void decode_ie(gtpv2c_view& ie, C& s) {
+  T v = {};
+  decode_value(ie, v);
+  s.set(v, ie.instance());
+}
+
+//------------------------------------------------------------------------------
+void decode_value(gtpv2c_view& v, bearer_context& b) {
+  gtpv2c_view ie;
+  while (v.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_EPS_BEARER_ID:
+        decode_ie<ebi_t>(ie, b);
+        break;
+      case GTP_IE_EPS_BEARER_LEVEL_TRAFFIC_FLOW_TEMPLATE:
+        decode_ie<traffic_flow_template_t>(ie, b);
+        break;
+      case GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER:
+        decode_ie<fteid_t>(ie, b);
+        break;
+      case GTP_IE_BEARER_QUALITY_OF_SERVICE:
+        decode_ie<bearer_qos_t>(ie, b);
+        break;
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, b);
+        break;
+      case GTP_IE_CHARGING_ID:
+        decode_ie<charging_id_t>(ie, b);
+        break;
+      case GTP_IE_BEARER_FLAGS:
+        decode_ie<bearer_flags_t>(ie, b);
+        break;
+      case GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<protocol_configuration_options_t>(ie, b);
+        break;
+      case GTP_IE_EXTENDED_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<extended_protocol_configuration_options_t>(ie, b);
+        break;
+      case GTP_IE_RAN_NAS_CAUSE:
+        decode_ie<ran_nas_cause_t>(ie, b);
+        break;
+      default:;
+    }
+  }
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+bool gtpv2c_view::next_ie(gtpv2c_view& ie) {
+  if (empty()) return false;
+  const uint8_t t = u8();
+  const uint16_t l = be16();
+  const uint8_t i  = u8() & 0x0F;
+  if (size() < l) {
+    throw gtpc_tlv_bad_length_exception(t, l);
+  }
+  ie = gtpv2c_view(p, l, t, i);
+  p += l;
+  return true;
+}
+//------------------------------------------------------------------------------
+gtpv2c_view gtpv2c_decoder::decode_header(
+    const uint8_t* buf, const size_t len, gtpv2c_msg_header& h) {
+  if (len < GTPV2C_MSG_HEADER_MIN_SIZE) {
+    throw gtpc_msg_bad_length_exception(0, len);
+  }
+  gtpv2c_view v(buf, len);
+  const uint8_t flags = v.u8();
+  h.set_message_type(v.u8());
+  // message length excludes the first 4 octets, T flag adds the TEID
+  const uint16_t length   = v.be16();
+  const uint16_t hdr_tail = (flags & 0x08) ? 8 : 4;
+  if ((length < hdr_tail) || (length > len - 4)) {
+    throw gtpc_msg_bad_length_exception(h.get_message_type(), length);
+  }
+  if (flags & 0x08) h.set_teid(v.be32());
+  h.set_sequence_number(v.be24());
+  v.skip(1);  // message priority, spare
+  h.set_message_length(length);
+  return gtpv2c_view(v.data(), length - hdr_tail);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(gtpv2c_view ies, gtpv2c_echo_request& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_RECOVERY_RESTART_COUNTER: {
+        recovery_t r = {};
+        decode_value(ie, r);
+        s.set(r);
+      } break;
+      case GTP_IE_NODE_FEATURES: {
+        node_features_t n = {};
+        decode_value(ie, n);
+        s.set(n);
+      } break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(gtpv2c_view ies, gtpv2c_echo_response& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_RECOVERY_RESTART_COUNTER: {
+        recovery_t r = {};
+        decode_value(ie, r);
+        s.set(r);
+      } break;
+      case GTP_IE_NODE_FEATURES: {
+        node_features_t n = {};
+        decode_value(ie, n);
+        s.set(n);
+      } break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_create_session_request& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_IMSI:
+        decode_ie<imsi_t>(ie, s);
+        break;
+      case GTP_IE_MSISDN:
+        decode_ie<msisdn_t>(ie, s);
+        break;
+      case GTP_IE_MOBILE_EQUIPMENT_IDENTITY:
+        decode_ie<mei_t>(ie, s);
+        break;
+      case GTP_IE_USER_LOCATION_INFORMATION:
+        decode_ie<uli_t>(ie, s);
+        break;
+      case GTP_IE_SERVING_NETWORK:
+        decode_ie<serving_network_t>(ie, s);
+        break;
+      case GTP_IE_RAT_TYPE:
+        decode_ie<rat_type_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      case GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER:
+        decode_ie<fteid_t>(ie, s);
+        break;
+      case GTP_IE_ACCESS_POINT_NAME:
+        decode_ie<apn_t>(ie, s);
+        break;
+      case GTP_IE_SELECTION_MODE:
+        decode_ie<selection_mode_t>(ie, s);
+        break;
+      case GTP_IE_PDN_TYPE:
+        decode_ie<pdn_type_t>(ie, s);
+        break;
+      case GTP_IE_PDN_ADDRESS_ALLOCATION:
+        decode_ie<paa_t>(ie, s);
+        break;
+      case GTP_IE_APN_RESTRICTION:
+        decode_ie<apn_restriction_t>(ie, s);
+        break;
+      case GTP_IE_AGGREGATE_MAXIMUM_BIT_RATE:
+        decode_ie<ambr_t>(ie, s);
+        break;
+      case GTP_IE_EPS_BEARER_ID:
+        decode_ie<ebi_t>(ie, s);
+        break;
+      case GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<protocol_configuration_options_t>(ie, s);
+        break;
+      case GTP_IE_BEARER_CONTEXT:
+        decode_ie<bearer_context>(ie, s);
+        break;
+      case GTP_IE_RECOVERY_RESTART_COUNTER:
+        decode_ie<recovery_t>(ie, s);
+        break;
+      case GTP_IE_FQ_CSID:
+        decode_ie<fq_csid_t>(ie, s);
+        break;
+      case GTP_IE_UE_TIME_ZONE:
+        decode_ie<ue_time_zone_t>(ie, s);
+        break;
+      case GTP_IE_USER_CSG_INFORMATION:
+        decode_ie<uci_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_create_session_response& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER:
+        decode_ie<fteid_t>(ie, s);
+        break;
+      case GTP_IE_PDN_ADDRESS_ALLOCATION:
+        decode_ie<paa_t>(ie, s);
+        break;
+      case GTP_IE_APN_RESTRICTION:
+        decode_ie<apn_restriction_t>(ie, s);
+        break;
+      case GTP_IE_AGGREGATE_MAXIMUM_BIT_RATE:
+        decode_ie<ambr_t>(ie, s);
+        break;
+      case GTP_IE_EPS_BEARER_ID:
+        decode_ie<ebi_t>(ie, s);
+        break;
+      case GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<protocol_configuration_options_t>(ie, s);
+        break;
+      case GTP_IE_BEARER_CONTEXT:
+        decode_ie<bearer_context>(ie, s);
+        break;
+      case GTP_IE_FQ_CSID:
+        decode_ie<fq_csid_t>(ie, s);
+        break;
+      case GTP_IE_EPC_TIMER:
+        decode_ie<epc_timer_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      case GTP_IE_LOCAL_DISTINGUISHED_NAME:
+        decode_ie<local_distinguished_name_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(gtpv2c_view ies, gtpv2c_modify_bearer_request& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_MOBILE_EQUIPMENT_IDENTITY:
+        decode_ie<mei_t>(ie, s);
+        break;
+      case GTP_IE_USER_LOCATION_INFORMATION:
+        decode_ie<uli_t>(ie, s);
+        break;
+      case GTP_IE_SERVING_NETWORK:
+        decode_ie<serving_network_t>(ie, s);
+        break;
+      case GTP_IE_RAT_TYPE:
+        decode_ie<rat_type_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      case GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER:
+        decode_ie<fteid_t>(ie, s);
+        break;
+      case GTP_IE_AGGREGATE_MAXIMUM_BIT_RATE:
+        decode_ie<ambr_t>(ie, s);
+        break;
+      case GTP_IE_DELAY_VALUE:
+        decode_ie<delay_value_t>(ie, s);
+        break;
+      case GTP_IE_BEARER_CONTEXT:
+        decode_ie<bearer_context>(ie, s);
+        break;
+      case GTP_IE_UE_TIME_ZONE:
+        decode_ie<ue_time_zone_t>(ie, s);
+        break;
+      case GTP_IE_USER_CSG_INFORMATION:
+        decode_ie<uci_t>(ie, s);
+        break;
+      case GTP_IE_IMSI:
+        decode_ie<imsi_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_modify_bearer_response& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_MSISDN:
+        decode_ie<msisdn_t>(ie, s);
+        break;
+      case GTP_IE_EPS_BEARER_ID:
+        decode_ie<ebi_t>(ie, s);
+        break;
+      case GTP_IE_APN_RESTRICTION:
+        decode_ie<apn_restriction_t>(ie, s);
+        break;
+      case GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<protocol_configuration_options_t>(ie, s);
+        break;
+      case GTP_IE_BEARER_CONTEXT:
+        decode_ie<bearer_context>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      case GTP_IE_CHARGING_ID:
+        decode_ie<charging_id_t>(ie, s);
+        break;
+      case GTP_IE_FQ_CSID:
+        decode_ie<fq_csid_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_delete_session_request& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_EPS_BEARER_ID:
+        decode_ie<ebi_t>(ie, s);
+        break;
+      case GTP_IE_USER_LOCATION_INFORMATION:
+        decode_ie<uli_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      case GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<protocol_configuration_options_t>(ie, s);
+        break;
+      case GTP_IE_NODE_TYPE:
+        decode_ie<node_type_t>(ie, s);
+        break;
+      case GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER:
+        decode_ie<fteid_t>(ie, s);
+        break;
+      case GTP_IE_UE_TIME_ZONE:
+        decode_ie<ue_time_zone_t>(ie, s);
+        break;
+      case GTP_IE_RAN_NAS_CAUSE:
+        decode_ie<ran_nas_cause_t>(ie, s);
+        break;
+      case GTP_IE_EXTENDED_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<extended_protocol_configuration_options_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_delete_session_response& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<protocol_configuration_options_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      case GTP_IE_EXTENDED_PROTOCOL_CONFIGURATION_OPTIONS:
+        decode_ie<extended_protocol_configuration_options_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_release_access_bearers_request& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_NODE_TYPE:
+        decode_ie<node_type_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_release_access_bearers_response& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_downlink_data_notification& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_EPS_BEARER_ID:
+        decode_ie<ebi_t>(ie, s);
+        break;
+      case GTP_IE_ALLOCATION_RETENTION_PRIORITY:
+        decode_ie<arp_t>(ie, s);
+        break;
+      case GTP_IE_IMSI:
+        decode_ie<imsi_t>(ie, s);
+        break;
+      case GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER:
+        decode_ie<fteid_t>(ie, s);
+        break;
+      case GTP_IE_INDICATION:
+        decode_ie<indication_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_decoder::decode(
+    gtpv2c_view ies, gtpv2c_downlink_data_notification_acknowledge& s) {
+  gtpv2c_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case GTP_IE_CAUSE:
+        decode_ie<cause_t>(ie, s);
+        break;
+      case GTP_IE_IMSI:
+        decode_ie<imsi_t>(ie, s);
+        break;
+      default:;
+    }
+  }
+}
+
+}  // namespace gtpv2c
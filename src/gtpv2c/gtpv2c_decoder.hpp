@@ -0,0 +1,148 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file gtpv2c_decoder.hpp
+  \brief Single pass GTPv2-C decoder, reads the received datagram in place and
+  fills the core containers of msg_gtpv2c.hpp
+*/
+#ifndef FILE_GTPV2C_DECODER_HPP_SEEN
+#define FILE_GTPV2C_DECODER_HPP_SEEN
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "3gpp_29.274.h"
+#include "3gpp_29.274.hpp"
+#include "msg_gtpv2c.hpp"
+
+namespace gtpv2c {
+
+//------------------------------------------------------------------------------
+// Bounds checked read cursor over a GTPv2-C message or over the value part of
+// an IE, nothing is copied. Reading past the end throws
+// gtpc_tlv_bad_length_exception for the IE the view was opened on.
+class gtpv2c_view {
+ public:
+  gtpv2c_view(
+      const uint8_t* buf, const size_t len, const uint8_t type = 0,
+      const uint8_t instance = 0)
+      : p(buf), end(buf + len), ie_type(type), ie_instance(instance) {}
+  gtpv2c_view() : p(nullptr), end(nullptr), ie_type(0), ie_instance(0) {}
+
+  size_t size() const { return end - p; }
+  bool empty() const { return p == end; }
+  uint8_t type() const { return ie_type; }
+  uint8_t instance() const { return ie_instance; }
+  const uint8_t* data() const { return p; }
+
+  void need(const size_t n) const {
+    if (size() < n) {
+      throw gtpc_tlv_bad_length_exception(ie_type, size());
+    }
+  }
+  void skip(const size_t n) {
+    need(n);
+    p += n;
+  }
+  uint8_t u8() {
+    need(1);
+    return *p++;
+  }
+  uint16_t be16() {
+    need(2);
+    uint16_t v = ((uint16_t) p[0] << 8) | p[1];
+    p += 2;
+    return v;
+  }
+  uint32_t be24() {
+    need(3);
+    uint32_t v = ((uint32_t) p[0] << 16) | ((uint32_t) p[1] << 8) | p[2];
+    p += 3;
+    return v;
+  }
+  uint32_t be32() {
+    need(4);
+    uint32_t v = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) |
+                 ((uint32_t) p[2] << 8) | p[3];
+    p += 4;
+    return v;
+  }
+  // 5 octets bit rates of the (Bearer) QoS IEs
+  uint64_t be40() {
+    uint64_t v = u8();
+    return (v << 32) | be32();
+  }
+  // copy raw bytes (addresses stay in network byte order)
+  void copy(void* dst, const size_t n) {
+    need(n);
+    memcpy(dst, p, n);
+    p += n;
+  }
+
+  /** \brief Cut the next IE off the view
+   *  @param[out] ie value part of the IE, typed with the IE type and instance
+   *  @returns false when the view is exhausted
+   **/
+  bool next_ie(gtpv2c_view& ie);
+
+ private:
+  const uint8_t* p;
+  const uint8_t* end;
+  uint8_t ie_type;
+  uint8_t ie_instance;
+};
+
+//------------------------------------------------------------------------------
+// Decodes the messages the SGW-C receives on S11/S5-S8 and the PGW-C on S5-S8.
+// IEs are handed to the set() overloads of the containers with their
+// instance. IEs unknown or not expected in a message are skipped, as
+// TS 29.274 asks of a receiver.
+class gtpv2c_decoder {
+ public:
+  /** \brief Decode the message header of the datagram, check the message
+   *  length against the datagram size
+   *  @returns the view over the IEs of the message
+   **/
+  static gtpv2c_view decode_header(
+      const uint8_t* buf, const size_t len, gtpv2c_msg_header& h);
+
+  static void decode(gtpv2c_view ies, gtpv2c_echo_request& s);
+  static void decode(gtpv2c_view ies, gtpv2c_echo_response& s);
+  static void decode(gtpv2c_view ies, gtpv2c_create_session_request& s);
+  static void decode(gtpv2c_view ies, gtpv2c_create_session_response& s);
+  static void decode(gtpv2c_view ies, gtpv2c_modify_bearer_request& s);
+  static void decode(gtpv2c_view ies, gtpv2c_modify_bearer_response& s);
+  static void decode(gtpv2c_view ies, gtpv2c_delete_session_request& s);
+  static void decode(gtpv2c_view ies, gtpv2c_delete_session_response& s);
+  static void decode(
+      gtpv2c_view ies, gtpv2c_release_access_bearers_request& s);
+  static void decode(
+      gtpv2c_view ies, gtpv2c_release_access_bearers_response& s);
+  static void decode(gtpv2c_view ies, gtpv2c_downlink_data_notification& s);
+  static void decode(
+      gtpv2c_view ies, gtpv2c_downlink_data_notification_acknowledge& s);
+};
+
+}  // namespace gtpv2c
+
+#endif /* FILE_GTPV2C_DECODER_HPP_SEEN */
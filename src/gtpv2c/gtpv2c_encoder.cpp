@@ -0,0 +1,851 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+
+/*! \file gtpv2c_encoder.cpp
+  \brief Direct to buffer GTPv2-C encoder
+*/
+#include "gtpv2c_encoder.hpp"
+
+namespace gtpv2c {
+namespace {
+
+//------------------------------------------------------------------------------
+// MCC/MNC digits of the PLMN identity (serving network, ULI fields)
+template <class T>
+inline void encode_plmn(gtpv2c_writer& w, const T& t) {
+  w.u8((t.mcc_digit_2 << 4) | (t.mcc_digit_1 & 0x0F));
+  w.u8((t.mnc_digit_3 << 4) | (t.mcc_digit_3 & 0x0F));
+  w.u8((t.mnc_digit_2 << 4) | (t.mnc_digit_1 & 0x0F));
+}
+//------------------------------------------------------------------------------
+// TBCD digits of IMSI, MSISDN and MEI, an odd number of digits is completed by
+// the 0xF filler
+template <class T>
+inline void encode_tbcd(
+    gtpv2c_writer& w, const T& t, const unsigned max_digits) {
+  const unsigned digits =
+      (t.num_digits < max_digits) ? t.num_digits : max_digits;
+  w.copy(t.u1.b, digits / 2);
+  if (digits & 1) w.u8(t.u1.b[digits / 2] | 0xF0);
+}
+
+//------------------------------------------------------------------------------
+// IE values, one overload per core type
+void encode_value(gtpv2c_writer& w, const imsi_t& i) {
+  encode_tbcd(w, i, 15);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const msisdn_t& m) {
+  encode_tbcd(w, m, MSISDN_MAX_LENGTH);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const mei_t& m) {
+  encode_tbcd(w, m, MEI_MAX_LENGTH);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const cause_t& c) {
+  w.u8(c.cause_value);
+  w.u8(c.cs | (c.bce << 1) | (c.pce << 2));
+  if (c.cause_value == MANDATORY_IE_INCORRECT) {
+    w.u8(c.offending_ie_type);
+    w.be16(c.offending_ie_length);
+    w.u8(c.offending_ie_instance & 0x0F);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const recovery_t& r) {
+  w.u8(r.restart_counter);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const apn_t& a) {
+  // labels of the dotted name, each one prefixed by its length
+  const std::string& s = a.access_point_name;
+  size_t label         = 0;
+  while (true) {
+    const size_t dot = s.find('.', label);
+    const size_t len =
+        (dot == std::string::npos) ? s.size() - label : dot - label;
+    w.u8(len);
+    w.copy(s.data() + label, len);
+    if (dot == std::string::npos) break;
+    label = dot + 1;
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const ambr_t& a) {
+  w.be32(a.br_ul);
+  w.be32(a.br_dl);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const ebi_t& e) {
+  w.u8(e.ebi & 0x0F);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const indication_t& i) {
+  w.u8(
+      i.sgwci | (i.israi << 1) | (i.isrsi << 2) | (i.oi << 3) | (i.dfi << 4) |
+      (i.hi << 5) | (i.dtf << 6) | (i.daf << 7));
+  w.u8(
+      i.msv | (i.si << 1) | (i.pt << 2) | (i.p << 3) | (i.crsi << 4) |
+      (i.cfsi << 5) | (i.uimsi << 6) | (i.sqci << 7));
+  w.u8(
+      i.ccrsi | (i.israu << 1) | (i.mbmdt << 2) | (i.s4af << 3) |
+      (i.s6af << 4) | (i.srni << 5) | (i.pbic << 6) | (i.retloc << 7));
+  w.u8(
+      i.cpsr | (i.clii << 1) | (i.csfbi << 2) | (i.ppsi << 3) | (i.ppon << 4) |
+      (i.ppof << 5) | (i.arrl << 6) | (i.cprai << 7));
+  w.u8(
+      i.aopi | (i.aosi << 1) | (i.pcri << 2) | (i.psci << 3) | (i.bdwi << 4) |
+      (i.dtci << 5) | (i.uasi << 6) | (i.nsi << 7));
+  w.u8(
+      i.wpmsi | (i.unaccsi << 1) | (i.pnsi << 2) | (i.s11tf << 3) |
+      (i.pmtsmi << 4) | (i.cpopci << 5) | (i.epcosi << 6) | (i.roaai << 7));
+  w.u8(
+      i.tspcmi | (i.enbcpi << 1) | (i.ltempi << 2) | (i.ltemui << 3) |
+      (i.eevrsi << 4));
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const protocol_configuration_options_t& p) {
+  w.u8((p.ext << 7) | (p.configuration_protocol & 0x07));
+  for (int i = 0; i < p.num_protocol_or_container_id; i++) {
+    const pco_protocol_or_container_id_t& c = p.protocol_or_container_ids[i];
+    w.be16(c.protocol_id);
+    w.u8(c.protocol_id_contents.size());
+    w.copy(c.protocol_id_contents.data(), c.protocol_id_contents.size());
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w, const extended_protocol_configuration_options_t& e) {
+  w.copy(
+      e.extended_protocol_configuration_options.data(),
+      e.extended_protocol_configuration_options.size());
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const pdn_type_t& p) {
+  w.u8(p.pdn_type & 0x07);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const paa_t& p) {
+  w.u8(p.pdn_type.pdn_type & 0x07);
+  switch (p.pdn_type.pdn_type) {
+    case PDN_TYPE_E_IPV4:
+      w.copy(&p.ipv4_address, sizeof(p.ipv4_address));
+      break;
+    case PDN_TYPE_E_IPV6:
+      w.u8(p.ipv6_prefix_length);
+      w.copy(&p.ipv6_address, sizeof(p.ipv6_address));
+      break;
+    case PDN_TYPE_E_IPV4V6:
+      w.u8(p.ipv6_prefix_length);
+      w.copy(&p.ipv6_address, sizeof(p.ipv6_address));
+      w.copy(&p.ipv4_address, sizeof(p.ipv4_address));
+      break;
+    case PDN_TYPE_E_NON_IP:
+      break;
+    default:
+      throw gtpc_ie_value_exception(GTP_IE_PDN_ADDRESS_ALLOCATION, "pdn_type");
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const bearer_qos_t& q) {
+  w.u8(q.pvi | ((q.pl & 0x0F) << 2) | (q.pci << 6));
+  w.u8(q.label_qci);
+  w.be40(q.maximum_bit_rate_for_uplink);
+  w.be40(q.maximum_bit_rate_for_downlink);
+  w.be40(q.guaranted_bit_rate_for_uplink);
+  w.be40(q.guaranted_bit_rate_for_downlink);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const rat_type_t& r) {
+  w.u8(r.rat_type);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const serving_network_t& s) {
+  encode_plmn(w, s);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const uli_t& u) {
+  const auto& h = u.user_location_information_ie_hdr;
+  w.u8(
+      h.cgi | (h.sai << 1) | (h.rai << 2) | (h.tai << 3) | (h.ecgi << 4) |
+      (h.lai << 5) | (h.macro_enodeb_id << 6) |
+      (h.extended_macro_enodeb_id << 7));
+  if (h.cgi) {
+    encode_plmn(w, u.cgi1);
+    w.be16(u.cgi1.location_area_code);
+    w.be16(u.cgi1.cell_identity);
+  }
+  if (h.sai) {
+    encode_plmn(w, u.sai1);
+    w.be16(u.sai1.location_area_code);
+    w.be16(u.sai1.service_area_code);
+  }
+  if (h.rai) {
+    encode_plmn(w, u.rai1);
+    w.be16(u.rai1.location_area_code);
+    w.be16(u.rai1.routing_area_code);
+  }
+  if (h.tai) {
+    encode_plmn(w, u.tai1);
+    w.be16(u.tai1.tracking_area_code);
+  }
+  if (h.ecgi) {
+    encode_plmn(w, u.ecgi1);
+    w.u8(u.ecgi1.eci & 0x0F);
+    w.copy(u.ecgi1.e_utran_cell_identifier, 3);
+  }
+  if (h.lai) {
+    encode_plmn(w, u.lai1);
+    w.be16(u.lai1.location_area_code);
+  }
+  if (h.macro_enodeb_id) {
+    encode_plmn(w, u.macro_enodeb_id1);
+    w.be24(u.macro_enodeb_id1.macro_enodeb_id & 0x0FFFFF);
+  }
+  if (h.extended_macro_enodeb_id) {
+    const auto& e = u.extended_macro_enodeb_id1;
+    encode_plmn(w, e);
+    w.be24((e.smenb << 23) | (e.extended_macro_enodeb_id & 0x0FFFFF));
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const fteid_t& f) {
+  w.u8((f.interface_type & 0x3F) | (f.v6 << 6) | (f.v4 << 7));
+  w.be32(f.teid_gre_key);
+  if (f.v4) w.copy(&f.ipv4_address, sizeof(f.ipv4_address));
+  if (f.v6) w.copy(&f.ipv6_address, sizeof(f.ipv6_address));
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const delay_value_t& d) {
+  w.u8(d.delay_value);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const charging_id_t& c) {
+  w.be32(c.charging_id_value);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const bearer_flags_t& f) {
+  w.u8(f.ppc | (f.vb << 1) | (f.vind << 2) | (f.asi << 3));
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const ue_time_zone_t& t) {
+  w.u8(t.time_zone);
+  w.u8(t.daylight_saving_time & 0x03);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const apn_restriction_t& a) {
+  w.u8(a.restriction_type_value);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const selection_mode_t& s) {
+  w.u8(s.selec_mode & 0x03);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const fq_csid_t& f) {
+  const auto& h = f.fq_csid_ie_hdr;
+  w.u8((h.node_id_type << 4) | (h.number_of_csids & 0x0F));
+  switch (h.node_id_type) {
+    case GLOBAL_UNICAST_IPv4:
+      w.copy(&h.node_id.unicast_ipv4, sizeof(h.node_id.unicast_ipv4));
+      break;
+    case GLOBAL_UNICAST_IPv6:
+      w.copy(&h.node_id.unicast_ipv6, sizeof(h.node_id.unicast_ipv6));
+      break;
+    case TYPE_EXOTIC:
+      w.be32(
+          ((1000 * h.node_id.exotic.mcc + h.node_id.exotic.mnc) << 12) |
+          h.node_id.exotic.operator_specific_id);
+      break;
+    default:
+      throw gtpc_ie_value_exception(GTP_IE_FQ_CSID, "node_id_type");
+  }
+  for (int i = 0; i < h.number_of_csids; i++) {
+    w.be16(f.pdn_connection_set_identifier[i]);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const node_type_t& n) {
+  w.u8(n.node_type);
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const node_features_t& n) {
+  w.u8(
+      n.prn | (n.mabr << 1) | (n.ntsr << 2) | (n.ciot << 3) | (n.s1un << 4));
+}
+//------------------------------------------------------------------------------
+void encode_value(gtpv2c_writer& w, const ran_nas_cause_t& r) {
+  w.u8((r.protocol_type << 4) | (r.cause_type & 0x0F));
+  switch (r.protocol_type) {
+    case PROTOCOL_TYPE_E_S1AP:
+      w.be16(r.cause_value.s1ap);
+      break;
+    case PROTOCOL_TYPE_E_EMM:
+      w.u8(r.cause_value.emm);
+      break;
+    case PROTOCOL_TYPE_E_ESM:
+      w.u8(r.cause_value.esm);
+      break;
+    case PROTOCOL_TYPE_E_DIAMETER:
+      w.be16(r.cause_value.diameter);
+      break;
+    case PROTOCOL_TYPE_E_IKEV2:
+      w.be16(r.cause_value.ikev2);
+      break;
+    default:
+      throw gtpc_ie_value_exception(GTP_IE_RAN_NAS_CAUSE, "protocol_type");
+  }
+}
+
+// grouped IEs, below
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_created_within_create_session_request& b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_removed_within_create_session_request& b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_created_within_create_session_response& b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_marked_for_removal_within_create_session_response&
+        b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_modified_within_modify_bearer_request& b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_removed_within_modify_bearer_request& b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_modified_within_modify_bearer_response& b);
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_marked_for_removal_within_modify_bearer_response& b);
+
+//------------------------------------------------------------------------------
+template <class T>
+inline void encode_ie(
+    gtpv2c_writer& w, const uint8_t type, const uint8_t instance, const T& v) {
+  const size_t value_offset = w.begin_ie(type, instance);
+  encode_value(w, v);
+  w.end_ie(value_offset);
+}
+//------------------------------------------------------------------------------
+template <class T>
+inline void encode_ie(
+    gtpv2c_writer& w, const uint8_t type, const uint8_t instance,
+    const std::vector<T>& l) {
+  for (const auto& v : l) encode_ie(w, type, instance, v);
+}
+//------------------------------------------------------------------------------
+template <class T>
+inline void encode_ie(
+    gtpv2c_writer& w, const uint8_t type, const uint8_t instance,
+    const std::pair<bool, T>& p) {
+  if (p.first) encode_ie(w, type, instance, p.second);
+}
+//------------------------------------------------------------------------------
+// F-TEIDs of the same message or grouped IE are told apart by their instance
+template <class T>
+inline void encode_fteid(gtpv2c_writer& w, const uint8_t instance, const T& f) {
+  encode_ie(w, GTP_IE_FULLY_QUALIFIED_TUNNEL_ENDPOINT_IDENTIFIER, instance, f);
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_created_within_create_session_request& b) {
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  }
+  // TFT is not encoded, as by gtpv2c_msg
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S1_U_ENB_FTEID) {
+    encode_fteid(w, 0, b.s1_u_enb_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S4_U_SGSN_FTEID) {
+    encode_fteid(w, 1, b.s4_u_sgsn_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S5_S8_U_SGW_FTEID) {
+    encode_fteid(w, 2, b.s5_s8_u_sgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S5_S8_U_PGW_FTEID) {
+    encode_fteid(w, 3, b.s5_s8_u_pgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S12_RNC_FTEID) {
+    encode_fteid(w, 4, b.s12_rnc_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S2B_U_EPDG_FTEID) {
+    encode_fteid(w, 5, b.s2b_u_epdg_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S2A_U_TWAN_FTEID) {
+    encode_fteid(w, 6, b.s2a_u_twan_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_BEARER_LEVEL_QOS) {
+    encode_ie(w, GTP_IE_BEARER_QUALITY_OF_SERVICE, 0, b.bearer_level_qos);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_CREATED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S11_U_MME_FTEID) {
+    encode_fteid(w, 7, b.s11_u_mme_fteid);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_removed_within_create_session_request& b) {
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_REMOVED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_REMOVED_WITHIN_CREATE_SESSION_REQUEST_PR_IE_S4_U_SGSN_FTEID) {
+    encode_fteid(w, 0, b.s4_u_sgsn_fteid);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_created_within_create_session_response& b) {
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_CAUSE) {
+    encode_ie(w, GTP_IE_CAUSE, 0, b.cause);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_S1_U_SGW_FTEID) {
+    encode_fteid(w, 0, b.s1_u_sgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_S4_U_SGW_FTEID) {
+    encode_fteid(w, 1, b.s4_u_sgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_S5_S8_U_PGW_FTEID) {
+    encode_fteid(w, 2, b.s5_s8_u_pgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_S12_SGW_FTEID) {
+    encode_fteid(w, 3, b.s12_sgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_S5_S8_BEARER_LEVEL_QOS) {
+    encode_ie(w, GTP_IE_BEARER_QUALITY_OF_SERVICE, 0, b.bearer_level_qos);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_CHARGING_ID) {
+    encode_ie(w, GTP_IE_CHARGING_ID, 0, b.charging_id);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_BEARER_FLAGS) {
+    encode_ie(w, GTP_IE_BEARER_FLAGS, 0, b.bearer_flags);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_CREATED_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_S11_U_SGW_FTEID) {
+    encode_fteid(w, 6, b.s11_u_sgw_fteid);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_marked_for_removal_within_create_session_response&
+        b) {
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_MARKED_FOR_REMOVAL_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_MARKED_FOR_REMOVAL_WITHIN_CREATE_SESSION_RESPONSE_PR_IE_CAUSE) {
+    encode_ie(w, GTP_IE_CAUSE, 0, b.cause);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_modified_within_modify_bearer_request& b) {
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_MODIFIED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_MODIFIED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_S1_U_ENB_FTEID) {
+    encode_fteid(w, 0, b.s1_u_enb_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_MODIFIED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_S5_S8_U_SGW_FTEID) {
+    encode_fteid(w, 1, b.s5_s8_u_sgw_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_MODIFIED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_S12_RNC_FTEID) {
+    encode_fteid(w, 2, b.s12_rnc_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_MODIFIED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_S4_U_SGSN_FTEID) {
+    encode_fteid(w, 3, b.s4_u_sgsn_fteid);
+  }
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_MODIFIED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_S11_U_MME_FTEID) {
+    encode_fteid(w, 4, b.s11_u_mme_fteid);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_to_be_removed_within_modify_bearer_request& b) {
+  if (b.ie_presence_mask &
+      GTPV2C_BEARER_CONTEXT_TO_BE_REMOVED_WITHIN_MODIFY_BEARER_REQUEST_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_modified_within_modify_bearer_response& b) {
+  encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  encode_ie(w, GTP_IE_CAUSE, 0, b.cause);
+  encode_fteid(w, 0, b.s1_u_sgw_fteid);
+  encode_fteid(w, 1, b.s12_sgw_fteid);
+  encode_fteid(w, 2, b.s4_u_sgw_fteid);
+  encode_fteid(w, 3, b.s11_u_sgw_fteid);
+  encode_ie(w, GTP_IE_CHARGING_ID, 0, b.charging_id);
+  encode_ie(w, GTP_IE_BEARER_FLAGS, 0, b.bearer_flags);
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    gtpv2c_writer& w,
+    const bearer_context_marked_for_removal_within_modify_bearer_response& b) {
+  encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, b.eps_bearer_id);
+  encode_ie(w, GTP_IE_CAUSE, 0, b.cause);
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_header(
+    gtpv2c_writer& w, const uint8_t msg_type, const gtpv2c_msg_header& h) {
+  // version 2, T flag when the message carries a TEID
+  w.u8(0x40 | (h.has_teid() ? 0x08 : 0x00));
+  w.u8(msg_type);
+  w.be16(0);  // message length, see end_header()
+  if (h.has_teid()) w.be32(h.get_teid());
+  w.be24(h.get_sequence_number());
+  w.u8(0);  // spare
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::end_header(const gtpv2c_writer& w, uint8_t* buf) {
+  if (w.sizing()) return;
+  // message length excludes the first 4 octets
+  const size_t length = w.size() - 4;
+  buf[2]              = length >> 8;
+  buf[3]              = length;
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_echo_request& s) {
+  encode_ie(
+      w, GTP_IE_RECOVERY_RESTART_COUNTER, 0, s.recovery_restart_counter);
+  encode_ie(w, GTP_IE_NODE_FEATURES, 0, s.sending_node_features);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_echo_response& s) {
+  encode_ie(
+      w, GTP_IE_RECOVERY_RESTART_COUNTER, 0, s.recovery_restart_counter);
+  encode_ie(w, GTP_IE_NODE_FEATURES, 0, s.sending_node_features);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_create_session_request& s) {
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_IMSI) {
+    encode_ie(w, GTP_IE_IMSI, 0, s.imsi);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_MSISDN) {
+    encode_ie(w, GTP_IE_MSISDN, 0, s.msisdn);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_MEI) {
+    encode_ie(w, GTP_IE_MOBILE_EQUIPMENT_IDENTITY, 0, s.mei);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_ULI) {
+    encode_ie(w, GTP_IE_USER_LOCATION_INFORMATION, 0, s.uli);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_SERVING_NETWORK) {
+    encode_ie(w, GTP_IE_SERVING_NETWORK, 0, s.serving_network);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_RAT_TYPE) {
+    encode_ie(w, GTP_IE_RAT_TYPE, 0, s.rat_type);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_INDICATION_FLAGS) {
+    encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_SENDER_FTEID_FOR_CONTROL_PLANE) {
+    encode_fteid(w, 0, s.sender_fteid_for_cp);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_PGW_S5S8_ADDRESS_FOR_CONTROL_PLANE) {
+    encode_fteid(w, 1, s.pgw_s5s8_address_for_cp);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_APN) {
+    encode_ie(w, GTP_IE_ACCESS_POINT_NAME, 0, s.apn);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_SELECTION_MODE) {
+    encode_ie(w, GTP_IE_SELECTION_MODE, 0, s.selection_mode);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_PDN_TYPE) {
+    encode_ie(w, GTP_IE_PDN_TYPE, 0, s.pdn_type);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_PAA) {
+    encode_ie(w, GTP_IE_PDN_ADDRESS_ALLOCATION, 0, s.paa);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_APN_RESTRICTION) {
+    encode_ie(w, GTP_IE_APN_RESTRICTION, 0, s.apn_restriction);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_APN_AMBR) {
+    encode_ie(w, GTP_IE_AGGREGATE_MAXIMUM_BIT_RATE, 0, s.ambr);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_LINKED_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, s.linked_eps_bearer_id);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_PCO) {
+    encode_ie(w, GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.pco);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_BEARER_CONTEXTS_TO_BE_CREATED) {
+    encode_ie(w, GTP_IE_BEARER_CONTEXT, 0, s.bearer_contexts_to_be_created);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_CREATE_SESSION_REQUEST_PR_IE_BEARER_CONTEXTS_TO_BE_REMOVED) {
+    encode_ie(w, GTP_IE_BEARER_CONTEXT, 1, s.bearer_contexts_to_be_removed);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_MME_FQ_CSID) {
+    encode_ie(w, GTP_IE_FQ_CSID, 0, s.mme_fq_csid);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_SGW_FQ_CSID) {
+    encode_ie(w, GTP_IE_FQ_CSID, 1, s.sgw_fq_csid);
+  }
+  if (s.ie_presence_mask & GTPV2C_CREATE_SESSION_REQUEST_PR_IE_UE_TIME_ZONE) {
+    encode_ie(w, GTP_IE_UE_TIME_ZONE, 0, s.ue_time_zone);
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_create_session_response& s) {
+  if (not s.cause.first) {
+    throw gtpc_missing_ie_exception(
+        "GTP_CREATE_SESSION_RESPONSE", "GTP_IE_CAUSE");
+  }
+  encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  encode_fteid(w, 0, s.sender_fteid_for_cp);
+  encode_fteid(w, 1, s.s5_s8_pgw_fteid);
+  encode_ie(w, GTP_IE_PDN_ADDRESS_ALLOCATION, 0, s.paa);
+  encode_ie(w, GTP_IE_APN_RESTRICTION, 0, s.apn_restriction);
+  encode_ie(w, GTP_IE_AGGREGATE_MAXIMUM_BIT_RATE, 0, s.apn_ambr);
+  encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, s.linked_eps_bearer_id);
+  encode_ie(w, GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.pco);
+  encode_ie(w, GTP_IE_BEARER_CONTEXT, 0, s.bearer_contexts_created);
+  encode_ie(w, GTP_IE_BEARER_CONTEXT, 1, s.bearer_contexts_marked_for_removal);
+  encode_ie(w, GTP_IE_FQ_CSID, 0, s.pgw_fq_csid);
+  encode_ie(w, GTP_IE_FQ_CSID, 1, s.sgw_fq_csid);
+  encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_delete_session_request& s) {
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_REQUEST_PR_IE_CAUSE) {
+    encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_DELETE_SESSION_REQUEST_PR_IE_LINKED_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, s.linked_eps_bearer_id);
+  }
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_REQUEST_PR_IE_ULI) {
+    encode_ie(w, GTP_IE_USER_LOCATION_INFORMATION, 0, s.uli);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_DELETE_SESSION_REQUEST_PR_IE_INDICATION_FLAGS) {
+    encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+  }
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_REQUEST_PR_IE_PCO) {
+    encode_ie(w, GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.pco);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_DELETE_SESSION_REQUEST_PR_IE_ORIGINATING_NODE) {
+    encode_ie(w, GTP_IE_NODE_TYPE, 0, s.originating_node);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_DELETE_SESSION_REQUEST_PR_IE_SENDER_FTEID_FOR_CONTROL_PLANE) {
+    encode_fteid(w, 0, s.sender_fteid_for_cp);
+  }
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_REQUEST_PR_IE_UE_TIME_ZONE) {
+    encode_ie(w, GTP_IE_UE_TIME_ZONE, 0, s.ue_time_zone);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_DELETE_SESSION_REQUEST_PR_IE_RAN_NAS_RELEASE_CAUSE) {
+    encode_ie(w, GTP_IE_RAN_NAS_CAUSE, 0, s.ran_nas_release_cause);
+  }
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_REQUEST_PR_IE_EPCO) {
+    encode_ie(w, GTP_IE_EXTENDED_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.epco);
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_delete_session_response& s) {
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_RESPONSE_PR_IE_CAUSE) {
+    encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  }
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_RESPONSE_PR_IE_PCO) {
+    encode_ie(w, GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.pco);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_DELETE_SESSION_RESPONSE_PR_IE_INDICATION_FLAGS) {
+    encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+  }
+  if (s.ie_presence_mask & GTPV2C_DELETE_SESSION_RESPONSE_PR_IE_EPCO) {
+    encode_ie(w, GTP_IE_EXTENDED_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.epco);
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_modify_bearer_request& s) {
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_MEI) {
+    encode_ie(w, GTP_IE_MOBILE_EQUIPMENT_IDENTITY, 0, s.mei);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_ULI) {
+    encode_ie(w, GTP_IE_USER_LOCATION_INFORMATION, 0, s.uli);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_SERVING_NETWORK) {
+    encode_ie(w, GTP_IE_SERVING_NETWORK, 0, s.serving_network);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_RAT_TYPE) {
+    encode_ie(w, GTP_IE_RAT_TYPE, 0, s.rat_type);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_INDICATION_FLAGS) {
+    encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_SENDER_FTEID_FOR_CONTROL_PLANE) {
+    encode_fteid(w, 0, s.sender_fteid_for_cp);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_APN_AMBR) {
+    encode_ie(w, GTP_IE_AGGREGATE_MAXIMUM_BIT_RATE, 0, s.apn_ambr);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_DELAY_DOWNLINK_PACKET_NOTIFICATION_REQUEST) {
+    encode_ie(w, GTP_IE_DELAY_VALUE, 0, s.delay_dl_packet_notif_req);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_BEARER_CONTEXTS_TO_BE_MODIFIED) {
+    encode_ie(w, GTP_IE_BEARER_CONTEXT, 0, s.bearer_contexts_to_be_modified);
+  }
+  if (s.ie_presence_mask &
+      GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_BEARER_CONTEXTS_TO_BE_REMOVED) {
+    encode_ie(w, GTP_IE_BEARER_CONTEXT, 1, s.bearer_contexts_to_be_removed);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_UE_TIME_ZONE) {
+    encode_ie(w, GTP_IE_UE_TIME_ZONE, 0, s.ue_time_zone);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_MME_FQ_CSID) {
+    encode_ie(w, GTP_IE_FQ_CSID, 0, s.mme_fq_csid);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_SGW_FQ_CSID) {
+    encode_ie(w, GTP_IE_FQ_CSID, 1, s.sgw_fq_csid);
+  }
+  if (s.ie_presence_mask & GTPV2C_MODIFY_BEARER_REQUEST_PR_IE_IMSI) {
+    encode_ie(w, GTP_IE_IMSI, 0, s.imsi);
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_modify_bearer_response& s) {
+  encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  encode_ie(w, GTP_IE_MSISDN, 0, s.msisdn);
+  encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, s.linked_eps_bearer_id);
+  encode_ie(w, GTP_IE_APN_RESTRICTION, 0, s.apn_restriction);
+  encode_ie(w, GTP_IE_PROTOCOL_CONFIGURATION_OPTIONS, 0, s.pco);
+  encode_ie(w, GTP_IE_FQ_CSID, 0, s.pgw_fq_csid);
+  encode_ie(w, GTP_IE_FQ_CSID, 1, s.sgw_fq_csid);
+  encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+  encode_ie(w, GTP_IE_CHARGING_ID, 0, s.pdn_connection_charging_id);
+  encode_ie(w, GTP_IE_BEARER_CONTEXT, 0, s.bearer_contexts_modified);
+  encode_ie(w, GTP_IE_BEARER_CONTEXT, 1, s.bearer_contexts_marked_for_removal);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_release_access_bearers_request& s) {
+  encode_ie(w, GTP_IE_NODE_TYPE, 0, s.originating_node);
+  encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_release_access_bearers_response& s) {
+  encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_downlink_data_notification& s) {
+  if (s.ie_presence_mask & DOWNLINK_DATA_NOTIFICATION_PR_IE_CAUSE) {
+    encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  }
+  if (s.ie_presence_mask & DOWNLINK_DATA_NOTIFICATION_PR_IE_EPS_BEARER_ID) {
+    encode_ie(w, GTP_IE_EPS_BEARER_ID, 0, s.eps_bearer_id);
+  }
+  if (s.ie_presence_mask & DOWNLINK_DATA_NOTIFICATION_PR_IE_IMSI) {
+    encode_ie(w, GTP_IE_IMSI, 0, s.imsi);
+  }
+  if (s.ie_presence_mask &
+      DOWNLINK_DATA_NOTIFICATION_PR_IE_SENDER_FTEID_FOR_CP) {
+    encode_fteid(w, 0, s.sender_fteid_for_cp);
+  }
+  if (s.ie_presence_mask & DOWNLINK_DATA_NOTIFICATION_PR_IE_INDICATION_FLAGS) {
+    encode_ie(w, GTP_IE_INDICATION, 0, s.indication_flags);
+  }
+}
+//------------------------------------------------------------------------------
+void gtpv2c_encoder::encode_ies(
+    gtpv2c_writer& w, const gtpv2c_downlink_data_notification_acknowledge& s) {
+  if (s.ie_presence_mask & DOWNLINK_DATA_NOTIFICATION_ACK_PR_IE_CAUSE) {
+    encode_ie(w, GTP_IE_CAUSE, 0, s.cause);
+  }
+  if (s.ie_presence_mask & DOWNLINK_DATA_NOTIFICATION_ACK_PR_IE_IMSI) {
+    encode_ie(w, GTP_IE_IMSI, 0, s.imsi);
+  }
+}
+
+}  // namespace gtpv2c
@@ -0,0 +1,194 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+
+/*! \file gtpv2c_encoder.hpp
+  \brief Direct to buffer GTPv2-C encoder, writes the core containers of
+  msg_gtpv2c.hpp into one contiguous buffer
+*/
+#ifndef FILE_GTPV2C_ENCODER_HPP_SEEN
+#define FILE_GTPV2C_ENCODER_HPP_SEEN
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "3gpp_29.274.h"
+#include "3gpp_29.274.hpp"
+#include "msg_gtpv2c.hpp"
+
+namespace gtpv2c {
+
+//------------------------------------------------------------------------------
+// Write cursor over a contiguous buffer. Constructed without a buffer it only
+// counts the bytes, this is the sizing pass. TLV lengths are patched in by
+// end_ie() once the value of the IE has been written.
+class gtpv2c_writer {
+ public:
+  gtpv2c_writer(uint8_t* buf, const size_t len, const uint8_t type = 0)
+      : start(buf), cap(len), pos(0), msg_type(type) {}
+  explicit gtpv2c_writer(const uint8_t type = 0)
+      : start(nullptr), cap(0), pos(0), msg_type(type) {}
+
+  size_t size() const { return pos; }
+  bool sizing() const { return start == nullptr; }
+
+  void u8(const uint8_t v) {
+    if (uint8_t* p = room(1)) p[0] = v;
+  }
+  void be16(const uint16_t v) {
+    if (uint8_t* p = room(2)) {
+      p[0] = v >> 8;
+      p[1] = v;
+    }
+  }
+  void be24(const uint32_t v) {
+    if (uint8_t* p = room(3)) {
+      p[0] = v >> 16;
+      p[1] = v >> 8;
+      p[2] = v;
+    }
+  }
+  void be32(const uint32_t v) {
+    if (uint8_t* p = room(4)) {
+      p[0] = v >> 24;
+      p[1] = v >> 16;
+      p[2] = v >> 8;
+      p[3] = v;
+    }
+  }
+  // 5 octets bit rates of the (Bearer) QoS IEs
+  void be40(const uint64_t v) {
+    u8(v >> 32);
+    be32(v);
+  }
+  // copy raw bytes (addresses are already in network byte order)
+  void copy(const void* src, const size_t n) {
+    if (uint8_t* p = room(n)) memcpy(p, src, n);
+  }
+
+  /** \brief Open an IE, the length field is left for end_ie()
+   *  @returns the offset of the value part of the IE
+   **/
+  size_t begin_ie(const uint8_t type, const uint8_t instance) {
+    u8(type);
+    be16(0);
+    u8(instance & 0x0F);
+    return pos;
+  }
+  void end_ie(const size_t value_offset) {
+    if (start) {
+      const size_t len        = pos - value_offset;
+      start[value_offset - 3] = len >> 8;
+      start[value_offset - 2] = len;
+    }
+  }
+
+ private:
+  uint8_t* room(const size_t n) {
+    const size_t at = pos;
+    pos += n;
+    if (!start) return nullptr;
+    if (pos > cap) {
+      throw gtpc_msg_bad_length_exception(msg_type, pos);
+    }
+    return start + at;
+  }
+
+  uint8_t* start;
+  size_t cap;
+  size_t pos;
+  uint8_t msg_type;
+};
+
+//------------------------------------------------------------------------------
+// Encodes the messages the SGW-C and the PGW-C send on S11 and S5-S8, the
+// header fields (TEID, sequence number) are taken from a gtpv2c_msg_header.
+// encoded_size() runs the encoder without a buffer so that the caller can
+// reserve the exact length.
+class gtpv2c_encoder {
+ public:
+  template <class M>
+  static size_t encoded_size(const M& s, const gtpv2c_msg_header& h) {
+    gtpv2c_writer w(M::msg_id);
+    encode_header(w, M::msg_id, h);
+    encode_ies(w, s);
+    return w.size();
+  }
+
+  /** \brief Encode a message into a caller supplied buffer
+   *  @returns the number of bytes written, throws
+   *  gtpc_msg_bad_length_exception if the buffer is too small
+   **/
+  template <class M>
+  static size_t encode(
+      const M& s, const gtpv2c_msg_header& h, uint8_t* buf, const size_t len) {
+    gtpv2c_writer w(buf, len, M::msg_id);
+    encode_header(w, M::msg_id, h);
+    encode_ies(w, s);
+    end_header(w, buf);
+    return w.size();
+  }
+
+  /** \brief Encode a message into bytes, resized to the message length
+   **/
+  template <class M>
+  static void encode(
+      const M& s, const gtpv2c_msg_header& h, std::vector<uint8_t>& bytes) {
+    bytes.resize(encoded_size(s, h));
+    encode(s, h, bytes.data(), bytes.size());
+  }
+
+ private:
+  static void encode_header(
+      gtpv2c_writer& w, const uint8_t msg_type, const gtpv2c_msg_header& h);
+  static void end_header(const gtpv2c_writer& w, uint8_t* buf);
+
+  static void encode_ies(gtpv2c_writer& w, const gtpv2c_echo_request& s);
+  static void encode_ies(gtpv2c_writer& w, const gtpv2c_echo_response& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_create_session_request& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_create_session_response& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_delete_session_request& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_delete_session_response& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_modify_bearer_request& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_modify_bearer_response& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_release_access_bearers_request& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_release_access_bearers_response& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_downlink_data_notification& s);
+  static void encode_ies(
+      gtpv2c_writer& w, const gtpv2c_downlink_data_notification_acknowledge& s);
+};
+
+}  // namespace gtpv2c
+
+#endif /* FILE_GTPV2C_ENCODER_HPP_SEEN */
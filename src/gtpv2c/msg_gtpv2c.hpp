@@ -5585,6 +5585,7 @@ class gtpv2c_release_access_bearers_response : public gtpv2c_ies_container {
   static const char* get_msg_name() {
     return "RELEASE_ACCESS_BEARERS_RESPONSE";
   };
+  static const uint8_t msg_id = GTP_RELEASE_ACCESS_BEARERS_RESPONSE;
 
   std::pair<bool, cause_t> cause;
   // SGW's node level Load Control Information
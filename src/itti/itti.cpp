@@ -28,86 +28,503 @@
 #include <signal.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <time.h>
+#include <unistd.h>
 #include <algorithm>
+#include <cerrno>
 #include <csignal>
+#include <cstring>
+#include <system_error>
 #include "common_defs.h"
 #include "logger.hpp"
 
 extern itti_mw* itti_inst;
 
-static itti_timer null_timer(
-    ITTI_INVALID_TIMER_ID, TASK_NONE, 0xFFFFFFFF, 0xFFFFFFFF, 0, 0);
+constexpr uint32_t
+    itti_timer_stats::kLateBucketLimitsUs[itti_timer_stats::kLateBuckets - 1];
+
+//------------------------------------------------------------------------------
+void itti_timer_stats::record_late(const uint64_t late_us) {
+  uint32_t b = 0;
+  while ((b < kLateBuckets - 1) && (late_us >= kLateBucketLimitsUs[b])) {
+    b++;
+  }
+  late_histogram[b]++;
+  late_max_us = std::max(late_max_us, late_us);
+}
+
+//------------------------------------------------------------------------------
+itti_timer_wheel::itti_timer_wheel()
+    : entries(), free_entries(kInvalidEntry), index(), now_tick(0) {
+  std::fill(heads, heads + kLevels * kSlots, kInvalidEntry);
+  memset(occupied, 0, sizeof(occupied));
+}
+
+//------------------------------------------------------------------------------
+uint32_t itti_timer_wheel::alloc_entry(const itti_timer& t) {
+  if (free_entries != kInvalidEntry) {
+    uint32_t e       = free_entries;
+    free_entries     = entries[e].next;
+    entries[e].timer = t;
+    return e;
+  }
+  entries.push_back(entry(t));
+  return entries.size() - 1;
+}
+
+//------------------------------------------------------------------------------
+void itti_timer_wheel::free_entry(const uint32_t e) {
+  entries[e].next = free_entries;
+  free_entries    = e;
+}
+
+//------------------------------------------------------------------------------
+void itti_timer_wheel::link(const uint32_t e) {
+  entry& en      = entries[e];
+  uint64_t delta = en.expires - now_tick;
+  uint32_t level = 0;
+  while ((level < kLevels - 1) && (delta >> (kSlotBits * (level + 1)))) {
+    level++;
+  }
+  uint32_t s = (en.expires >> (kSlotBits * level)) & kSlotMask;
+  en.slot    = level * kSlots + s;
+  en.prev    = kInvalidEntry;
+  en.next    = heads[en.slot];
+  if (en.next != kInvalidEntry) {
+    entries[en.next].prev = e;
+  }
+  heads[en.slot] = e;
+  occupied[level][s >> 6] |= (1ULL << (s & 63));
+}
+
+//------------------------------------------------------------------------------
+void itti_timer_wheel::unlink(const uint32_t e) {
+  entry& en = entries[e];
+  if (en.prev != kInvalidEntry) {
+    entries[en.prev].next = en.next;
+  } else {
+    heads[en.slot] = en.next;
+  }
+  if (en.next != kInvalidEntry) {
+    entries[en.next].prev = en.prev;
+  }
+  if (heads[en.slot] == kInvalidEntry) {
+    uint32_t level = en.slot / kSlots;
+    uint32_t s     = en.slot & kSlotMask;
+    occupied[level][s >> 6] &= ~(1ULL << (s & 63));
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_timer_wheel::cascade(const uint32_t level) {
+  uint32_t s    = (now_tick >> (kSlotBits * level)) & kSlotMask;
+  uint32_t slot = level * kSlots + s;
+  uint32_t e    = heads[slot];
+  heads[slot]   = kInvalidEntry;
+  occupied[level][s >> 6] &= ~(1ULL << (s & 63));
+  while (e != kInvalidEntry) {
+    uint32_t next = entries[e].next;
+    link(e);
+    e = next;
+  }
+}
+
+//------------------------------------------------------------------------------
+int itti_timer_wheel::next_occupied_slot(
+    const uint32_t level, const uint32_t from) const {
+  const uint32_t words = kSlots / 64;
+  uint32_t w           = from >> 6;
+  uint64_t bits        = occupied[level][w] & (~0ULL << (from & 63));
+  // one more iteration than words to look at the bits before from
+  for (uint32_t i = 0; i <= words; i++) {
+    if (bits) {
+      uint32_t s = (w << 6) + __builtin_ctzll(bits);
+      return (s - from) & kSlotMask;
+    }
+    w    = (w + 1) % words;
+    bits = occupied[level][w];
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+void itti_timer_wheel::insert(
+    const itti_timer& t, const uint64_t expires_tick) {
+  uint32_t e         = alloc_entry(t);
+  entries[e].expires = std::max(expires_tick, now_tick + 1);
+  link(e);
+  index[t.id] = e;
+}
+
+//------------------------------------------------------------------------------
+bool itti_timer_wheel::remove(const timer_id_t id, task_id_t* task_id) {
+  auto it = index.find(id);
+  if (it == index.end()) {
+    return false;
+  }
+  if (task_id) {
+    *task_id = entries[it->second].timer.task_id;
+  }
+  unlink(it->second);
+  free_entry(it->second);
+  index.erase(it);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+uint64_t itti_timer_wheel::next_event_tick() const {
+  if (index.empty()) {
+    return kNoEvent;
+  }
+  uint64_t next = kNoEvent;
+  int d         = next_occupied_slot(0, (now_tick + 1) & kSlotMask);
+  if (d >= 0) {
+    next = now_tick + 1 + d;
+  }
+  // Higher levels: a non empty slot is an event at its cascade time
+  for (uint32_t level = 1; level < kLevels; level++) {
+    uint32_t shift = kSlotBits * level;
+    uint64_t page  = now_tick >> shift;
+    d              = next_occupied_slot(level, (page + 1) & kSlotMask);
+    if (d >= 0) {
+      next = std::min(next, (page + 1 + d) << shift);
+    }
+  }
+  return next;
+}
+
+//------------------------------------------------------------------------------
+void itti_timer_wheel::advance(
+    const uint64_t tick, std::vector<itti_timer>& expired) {
+  while (now_tick < tick) {
+    uint64_t next = next_event_tick();
+    if (next > tick) {
+      now_tick = tick;
+      return;
+    }
+    now_tick = next;
+    // Cascade top-down, so that entries moved down can cascade again
+    for (uint32_t level = kLevels - 1; level > 0; level--) {
+      if ((now_tick & ((1ULL << (kSlotBits * level)) - 1)) == 0) {
+        cascade(level);
+      }
+    }
+    uint32_t slot = now_tick & kSlotMask;
+    uint32_t e    = heads[slot];
+    heads[slot]   = kInvalidEntry;
+    occupied[0][slot >> 6] &= ~(1ULL << (slot & 63));
+    while (e != kInvalidEntry) {
+      uint32_t next_e = entries[e].next;
+      if (entries[e].expires <= now_tick) {
+        expired.push_back(entries[e].timer);
+        index.erase(entries[e].timer.id);
+        free_entry(e);
+      } else {
+        link(e);
+      }
+      e = next_e;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+itti_ring::itti_ring(const uint32_t capacity)
+    : cells(),
+      mask(0),
+      drops(0),
+      enqueue_pos(0),
+      dequeue_pos(0),
+      depth_max(0) {
+  uint64_t size = 2;
+  while (size < capacity) size <<= 1;
+  mask  = size - 1;
+  cells = std::unique_ptr<cell[]>(new cell[size]);
+  for (uint64_t i = 0; i < size; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+//------------------------------------------------------------------------------
+bool itti_ring::push(std::shared_ptr<itti_msg>& message) {
+  if (try_push(message)) return true;
+  drops.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+bool itti_ring::try_push(std::shared_ptr<itti_msg>& message) {
+  cell* c      = nullptr;
+  uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+  while (true) {
+    c            = &cells[pos & mask];
+    uint64_t seq = c->sequence.load(std::memory_order_acquire);
+    int64_t dif  = (int64_t) seq - (int64_t) pos;
+    if (dif == 0) {
+      if (enqueue_pos.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      // full: the consumer did not release this cell yet
+      return false;
+    } else {
+      pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  c->message = std::move(message);
+  c->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<itti_msg> itti_ring::pop() {
+  cell* c      = &cells[dequeue_pos & mask];
+  uint64_t seq = c->sequence.load(std::memory_order_acquire);
+  if (seq != dequeue_pos + 1) {
+    return nullptr;
+  }
+  uint64_t depth = enqueue_pos.load(std::memory_order_relaxed) - dequeue_pos;
+  if (depth > depth_max) depth_max = depth;
+  std::shared_ptr<itti_msg> message = std::move(c->message);
+  c->sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+  dequeue_pos++;
+  return message;
+}
+
+//------------------------------------------------------------------------------
+itti_mailbox::itti_mailbox(const uint32_t capacity)
+    : lanes(),
+      m_overflow(),
+      overflow(),
+      overflow_size(0),
+      spills(0),
+      event_fd(-1),
+      parked(false) {
+  lanes[LANE_RESERVED] = std::unique_ptr<itti_ring>(
+      new itti_ring(std::min(capacity, kReservedCapacity)));
+  lanes[LANE_HIGH] = std::unique_ptr<itti_ring>(new itti_ring(capacity));
+  lanes[LANE_LOW]  = std::unique_ptr<itti_ring>(new itti_ring(capacity));
+  event_fd         = eventfd(0, EFD_CLOEXEC);
+  if (event_fd < 0) {
+    Logger::itti().error("eventfd failed: %s", strerror(errno));
+    throw std::system_error(
+        errno, std::generic_category(), "ITTI mailbox eventfd failed!");
+  }
+}
+
+//------------------------------------------------------------------------------
+itti_mailbox::~itti_mailbox() {
+  if (event_fd >= 0) {
+    close(event_fd);
+  }
+}
+
+//------------------------------------------------------------------------------
+itti_mailbox::lane_e itti_mailbox::priority_to_lane(
+    const message_priorities_t priority) {
+  if (priority >= MESSAGE_PRIORITY_MAX_LEAST) return LANE_RESERVED;
+  if (priority >= MESSAGE_PRIORITY_MED_LEAST) return LANE_HIGH;
+  return LANE_LOW;
+}
+
+//------------------------------------------------------------------------------
+bool itti_mailbox::push(std::shared_ptr<itti_msg> message) {
+  lane_e l = priority_to_lane(message->priority);
+  if (l != LANE_RESERVED) {
+    return lanes[l]->push(message);
+  }
+  if ((overflow_size.load(std::memory_order_acquire) == 0) &&
+      lanes[LANE_RESERVED]->try_push(message)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(m_overflow);
+  overflow.push_back(std::move(message));
+  overflow_size.store(overflow.size(), std::memory_order_release);
+  spills.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<itti_msg> itti_mailbox::pop_overflow() {
+  if (overflow_size.load(std::memory_order_acquire) == 0) return nullptr;
+  std::lock_guard<std::mutex> lock(m_overflow);
+  if (overflow.empty()) return nullptr;
+  std::shared_ptr<itti_msg> message = std::move(overflow.front());
+  overflow.pop_front();
+  overflow_size.store(overflow.size(), std::memory_order_release);
+  return message;
+}
+
+//------------------------------------------------------------------------------
+void itti_mailbox::notify() {
+  // Pairs with the fence in wait_pop(): either the consumer sees the message
+  // or we see it parked.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parked.load(std::memory_order_relaxed) &&
+      parked.exchange(false, std::memory_order_acq_rel)) {
+    uint64_t one = 1;
+    if (write(event_fd, &one, sizeof(one)) < 0) {
+      Logger::itti().error("Mailbox eventfd write failed: %s", strerror(errno));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<itti_msg> itti_mailbox::pop() {
+  std::shared_ptr<itti_msg> message = lanes[LANE_RESERVED]->pop();
+  if (message) return message;
+  // Reserved lane messages spilled after the ones left in the ring
+  message = pop_overflow();
+  if (message) return message;
+  for (int l = LANE_HIGH; l < LANE_MAX; l++) {
+    message = lanes[l]->pop();
+    if (message) return message;
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<itti_msg> itti_mailbox::wait_pop() {
+  while (true) {
+    std::shared_ptr<itti_msg> message = pop();
+    if (message) return message;
+    parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    message = pop();
+    if (message) {
+      parked.store(false, std::memory_order_relaxed);
+      return message;
+    }
+    uint64_t count = 0;
+    if ((read(event_fd, &count, sizeof(count)) < 0) && (errno != EINTR)) {
+      Logger::itti().error("Mailbox eventfd read failed: %s", strerror(errno));
+    }
+  }
+}
 
 //------------------------------------------------------------------------------
 void itti_mw::timer_manager_task(
     const util::thread_sched_params& sched_params) {
   Logger::itti().info("Starting timer_manager_task");
   sched_params.apply(TASK_ITTI_TIMER, Logger::itti());
+  std::vector<itti_timer> expired = {};
+  uint64_t expirations            = 0;
   while (true) {
-    if (itti_inst->terminate) return;
+    // Sleep till timer_fd expires, it is re-armed by timer_setup() when a
+    // timer expires before the current wake up
+    if (read(itti_inst->timer_fd, &expirations, sizeof(expirations)) < 0) {
+      if ((errno != EINTR) && (errno != EAGAIN)) {
+        Logger::itti().error(
+            "timer_manager_task read timerfd failed: %s", strerror(errno));
+        return;
+      }
+    }
     {
       std::unique_lock<std::mutex> lx(itti_inst->m_timers);
-      while (itti_inst->timers.empty()) {
-        itti_inst->c_timers.wait(lx);
-      }
-      if (not itti_inst->timers.empty()) {
-        std::set<itti_timer>::iterator it = itti_inst->timers.begin();
-        itti_inst->current_timer          = std::ref(*it);
-        itti_inst->timers.erase(it);
-      }
-      lx.unlock();
-
-      // check time-out
-      if (itti_inst->current_timer.time_out >
-          std::chrono::system_clock::now()) {
-        std::unique_lock<std::mutex> lto(itti_inst->m_timeout);
-        auto diff = itti_inst->current_timer.time_out -
-                    std::chrono::system_clock::now();
-        auto rc = itti_inst->c_timeout.wait_for(lto, diff);
-        lto.unlock();
-        if (std::cv_status::timeout == rc) {
-          // signal time-out
-          itti_msg_timeout mto(
-              TASK_ITTI_TIMER, itti_inst->current_timer.task_id,
-              itti_inst->current_timer.id, itti_inst->current_timer.arg1_user,
-              itti_inst->current_timer.arg2_user);
-          std::shared_ptr<itti_msg_timeout> msgsh =
-              std::make_shared<itti_msg_timeout>(mto);
-          int ret = itti_inst->send_msg(msgsh);
-        } else {
-          // other timer required ?
-          itti_inst->m_timers.lock();
-          if (itti_inst->current_timer.id != ITTI_INVALID_TIMER_ID) {
-            itti_inst->timers.insert(itti_inst->current_timer);
-          }
-          itti_inst->current_timer = null_timer;
-          itti_inst->m_timers.unlock();
-          // cout << "cv.wait released by other triggered timer end" << endl;
-        }
-      } else {
-        // signal time-out
-        itti_msg_timeout mto(
-            TASK_ITTI_TIMER, itti_inst->current_timer.task_id,
-            itti_inst->current_timer.id, itti_inst->current_timer.arg1_user,
-            itti_inst->current_timer.arg2_user);
-        std::shared_ptr<itti_msg_timeout> msgsh =
-            std::make_shared<itti_msg_timeout>(mto);
-        itti_inst->send_msg(msgsh);
-      }
+      if (itti_inst->terminate) return;
+      itti_inst->timer_wheel.advance(
+          itti_inst->time_point_to_tick(std::chrono::steady_clock::now()),
+          expired);
+      itti_inst->record_timeouts(expired);
+      itti_inst->timer_fd_tick = itti_timer_wheel::kNoEvent;
+      itti_inst->arm_timer_fd(
+          itti_inst->slack_tick(itti_inst->timer_wheel.next_event_tick()));
+    }
+    if (not expired.empty()) {
+      itti_inst->send_timeouts(expired);
+      expired.clear();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+uint64_t itti_mw::time_point_to_tick(
+    const std::chrono::steady_clock::time_point& time_point) const {
+  if (time_point <= timer_epoch) return 0;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             time_point - timer_epoch)
+      .count();
+}
+
+//------------------------------------------------------------------------------
+uint64_t itti_mw::slack_tick(const uint64_t tick) const {
+  if ((tick == itti_timer_wheel::kNoEvent) || (timer_slack_ticks <= 1)) {
+    return tick;
+  }
+  return ((tick + timer_slack_ticks - 1) / timer_slack_ticks) *
+         timer_slack_ticks;
+}
+
+//------------------------------------------------------------------------------
+void itti_mw::arm_timer_fd(const uint64_t tick) {
+  struct itimerspec its = {};
+  if (tick != itti_timer_wheel::kNoEvent) {
+    auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     timer_epoch + std::chrono::milliseconds(tick) -
+                     std::chrono::steady_clock::now())
+                     .count();
+    // a zeroed it_value would disarm the timer
+    if (delay <= 0) delay = 1;
+    its.it_value.tv_sec  = delay / 1000000000;
+    its.it_value.tv_nsec = delay % 1000000000;
+  }
+  if (timerfd_settime(timer_fd, 0, &its, nullptr) < 0) {
+    Logger::itti().error("timerfd_settime failed: %s", strerror(errno));
+    return;
+  }
+  timer_fd_tick = tick;
+}
+
+//------------------------------------------------------------------------------
+void itti_mw::record_timeouts(const std::vector<itti_timer>& expired) {
+  if (expired.empty()) return;
+  auto now = std::chrono::steady_clock::now();
+  for (auto& t : expired) {
+    int64_t late_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          now - t.time_out)
+                          .count();
+    timer_stats[t.task_id].fired++;
+    timer_stats[t.task_id].record_late((late_us > 0) ? late_us : 0);
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_mw::send_timeouts(std::vector<itti_timer>& expired) {
+  // Deliver all time-outs of a task in one batch
+  std::stable_sort(
+      expired.begin(), expired.end(),
+      [](const itti_timer& a, const itti_timer& b) {
+        return a.task_id < b.task_id;
+      });
+  std::vector<std::shared_ptr<itti_msg>> batch = {};
+  auto it                                      = expired.begin();
+  while (it != expired.end()) {
+    task_id_t task_id = it->task_id;
+    batch.clear();
+    for (; (it != expired.end()) && (it->task_id == task_id); ++it) {
+      batch.push_back(itti_make_msg<itti_msg_timeout>(
+          TASK_ITTI_TIMER, task_id, it->id, it->arg1_user, it->arg2_user));
     }
+    send_msgs(task_id, batch);
   }
 }
+
 //------------------------------------------------------------------------------
 itti_mw::itti_mw()
-    : timer_id(0),
-      msg_number(0),
+    : msg_number(0),
+      timer_id(0),
+      m_timer_id(),
       created_tasks(0),
       ready_tasks(0),
+      timer_wheel(),
+      timer_epoch(std::chrono::steady_clock::now()),
       m_timers(),
-      current_timer(null_timer),
-      m_timeout(),
-      m_timer_id(),
+      timer_fd(-1),
+      timer_fd_tick(itti_timer_wheel::kNoEvent),
+      timer_slack_ticks(1),
+      timer_stats(),
+      mailbox_capacity(itti_mailbox::kDefaultCapacity),
       terminate(false) {
   std::fill(itti_task_ctxts, itti_task_ctxts + TASK_MAX, nullptr);
 }
@@ -115,21 +532,17 @@ itti_mw::itti_mw()
 //------------------------------------------------------------------------------
 itti_mw::~itti_mw() {
   std::cout << "~itti()" << std::endl;
-  terminate = true;
-  timer_setup(0, 1, TASK_ITTI_TIMER, 0, 0);
-  timer_thread.detach();
-  // wake up thread timer if necessary
-
-  std::unique_lock<std::mutex> l(m_timers, std::defer_lock);
-  if (l.try_lock()) {
-    c_timers.notify_one();
-    std::cout << "~itti() c_timers notified!" << std::endl;
+  {
+    // wake up thread timer if necessary
+    std::unique_lock<std::mutex> l(m_timers);
+    terminate = true;
+    if (timer_fd >= 0) arm_timer_fd(0);
   }
-  // wake up thread timer if necessary
-  std::unique_lock<std::mutex> l2(m_timeout, std::defer_lock);
-  if (l2.try_lock()) {
-    c_timeout.notify_one();
-    std::cout << "~itti() c_timeout notified!" << std::endl;
+  if (timer_thread.joinable()) {
+    timer_thread.join();
+  }
+  if (timer_fd >= 0) {
+    close(timer_fd);
   }
 
   for (int t = TASK_FIRST; t < TASK_MAX; t++) {
@@ -141,8 +554,18 @@ itti_mw::~itti_mw() {
 }
 
 //------------------------------------------------------------------------------
-void itti_mw::start(const util::thread_sched_params& sched_params) {
+void itti_mw::start(
+    const util::thread_sched_params& sched_params,
+    const uint32_t timer_slack_ms, const uint32_t mailbox_capacity) {
   Logger::itti().startup("Starting...");
+  this->mailbox_capacity = mailbox_capacity;
+  timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+  if (timer_fd < 0) {
+    Logger::itti().error("timerfd_create failed: %s", strerror(errno));
+    throw std::system_error(
+        errno, std::generic_category(), "ITTI timerfd creation failed!");
+  }
+  timer_slack_ticks = (timer_slack_ms > 1) ? timer_slack_ms : 1;
   timer_thread = std::thread(timer_manager_task, sched_params);
   Logger::itti().startup("Started");
 }
@@ -165,7 +588,8 @@ int itti_mw::create_task(
   }
   if ((TASK_FIRST <= task_id) && (TASK_MAX > task_id)) {
     if (itti_task_ctxts[task_id] == nullptr) {
-      itti_task_ctxts[task_id] = new itti_task_ctxt(task_id);
+      itti_task_ctxts[task_id] =
+          new itti_task_ctxt(task_id, mailbox_capacity);
       {
         std::unique_lock<std::mutex> lk(itti_task_ctxts[task_id]->m_state);
         if (itti_task_ctxts[task_id]->task_state == TASK_STATE_NOT_CONFIGURED) {
@@ -214,12 +638,17 @@ int itti_mw::send_msg(std::shared_ptr<itti_msg> message) {
     if (itti_task_ctxts[message->destination]) {
       if (itti_task_ctxts[message->destination]->task_state ==
           TASK_STATE_READY) {
-        std::unique_lock<std::mutex> l(
-            itti_task_ctxts[message->destination]->m_queue);
-        // res =
-        itti_task_ctxts[message->destination]->msg_queue.push(message);
-        itti_task_ctxts[message->destination]->c_queue.notify_one();
-        return RETURNok;
+        itti_mailbox& mailbox = itti_task_ctxts[message->destination]->mailbox;
+        if (mailbox.push(message)) {
+          mailbox.notify();
+          return RETURNok;
+        }
+        Logger::itti().error(
+            "Unicast message number %lu can not be sent from %d to %d, "
+            "destination mailbox lane %d full!",
+            message->msg_num, message->origin, message->destination,
+            itti_mailbox::priority_to_lane(message->priority));
+        return RETURNerror;
       } else if (
           itti_task_ctxts[message->destination]->task_state ==
           TASK_STATE_ENDED) {
@@ -241,15 +670,54 @@ int itti_mw::send_msg(std::shared_ptr<itti_msg> message) {
   return RETURNerror;
 }
 
+//------------------------------------------------------------------------------
+int itti_mw::send_msgs(
+    const task_id_t task_id,
+    const std::vector<std::shared_ptr<itti_msg>>& messages) {
+  if ((TASK_FIRST <= task_id) && (TASK_MAX > task_id)) {
+    if (itti_task_ctxts[task_id]) {
+      if (itti_task_ctxts[task_id]->task_state == TASK_STATE_READY) {
+        itti_mailbox& mailbox = itti_task_ctxts[task_id]->mailbox;
+        size_t sent           = 0;
+        for (auto& message : messages) {
+          // a full lane does not hold back messages for other lanes
+          if (mailbox.push(message)) sent++;
+        }
+        mailbox.notify();
+        if (sent == messages.size()) {
+          return RETURNok;
+        }
+        Logger::itti().error(
+            "%lu messages out of %lu can not be sent to %d, destination "
+            "mailbox full!",
+            messages.size() - sent, messages.size(), task_id);
+        return RETURNerror;
+      }
+    }
+  }
+  Logger::itti().warn(
+      "Batch of %lu messages can not be sent to %d, destination task not "
+      "ready!",
+      messages.size(), task_id);
+  return RETURNerror;
+}
+
 //------------------------------------------------------------------------------
 int itti_mw::send_broadcast_msg(std::shared_ptr<itti_msg> message) {
   if (TASK_ALL == message->destination) {
     for (int t = TASK_FIRST; t < TASK_MAX; t++) {
       if (itti_task_ctxts[t]) {
         if (itti_task_ctxts[t]->task_state == TASK_STATE_READY) {
-          std::unique_lock<std::mutex> l(itti_task_ctxts[t]->m_queue);
-          itti_task_ctxts[t]->msg_queue.push(message);
-          itti_task_ctxts[t]->c_queue.notify_one();
+          itti_mailbox& mailbox = itti_task_ctxts[t]->mailbox;
+          if (mailbox.push(message)) {
+            mailbox.notify();
+          } else {
+            Logger::itti().error(
+                "Broadcast message number %lu can not be sent from %d to %d, "
+                "destination mailbox lane %d full!",
+                message->msg_num, message->origin, t,
+                itti_mailbox::priority_to_lane(message->priority));
+          }
         } else if (itti_task_ctxts[t]->task_state == TASK_STATE_ENDED) {
           Logger::itti().warn(
               "Broadcast message number %lu can not be sent from %d to %d, "
@@ -274,7 +742,7 @@ int itti_mw::send_terminate_msg(task_id_t src_task_id) {
   itti_msg_terminate msg(src_task_id, TASK_ALL);
   terminate = true;
   std::shared_ptr<itti_msg_terminate> smsg =
-      std::make_shared<itti_msg_terminate>(msg);
+      itti_make_msg<itti_msg_terminate>(msg);
   int ret = itti_inst->send_broadcast_msg(smsg);
 
   return ret;
@@ -283,14 +751,7 @@ int itti_mw::send_terminate_msg(task_id_t src_task_id) {
 std::shared_ptr<itti_msg> itti_mw::receive_msg(task_id_t task_id) {
   if ((TASK_FIRST <= task_id) && (TASK_MAX > task_id)) {
     if (itti_task_ctxts[task_id]) {
-      std::unique_lock<std::mutex> lk(itti_task_ctxts[task_id]->m_queue);
-      while (itti_task_ctxts[task_id]->msg_queue.empty()) {
-        itti_task_ctxts[task_id]->c_queue.wait(lk);
-      }
-      std::shared_ptr<itti_msg> msg =
-          itti_task_ctxts[task_id]->msg_queue.front();
-      itti_task_ctxts[task_id]->msg_queue.pop();
-      return msg;
+      return itti_task_ctxts[task_id]->mailbox.wait_pop();
     }
   }
   Logger::itti().warn("received message failed, bad task id");
@@ -298,16 +759,31 @@ std::shared_ptr<itti_msg> itti_mw::receive_msg(task_id_t task_id) {
 }
 
 //------------------------------------------------------------------------------
-std::shared_ptr<itti_msg> itti_mw::poll_msg(task_id_t task_id) {
+size_t itti_mw::receive_msgs(
+    const task_id_t task_id, std::vector<std::shared_ptr<itti_msg>>& messages,
+    const size_t max) {
+  messages.clear();
   if ((TASK_FIRST <= task_id) && (TASK_MAX > task_id)) {
     if (itti_task_ctxts[task_id]) {
-      std::lock_guard<std::mutex> lk(itti_task_ctxts[task_id]->m_queue);
-      if (!itti_task_ctxts[task_id]->msg_queue.empty()) {
-        std::shared_ptr<itti_msg> msg =
-            itti_task_ctxts[task_id]->msg_queue.front();
-        itti_task_ctxts[task_id]->msg_queue.pop();
-        return msg;
+      itti_mailbox& mailbox = itti_task_ctxts[task_id]->mailbox;
+      messages.push_back(mailbox.wait_pop());
+      while (messages.size() < max) {
+        std::shared_ptr<itti_msg> msg = mailbox.pop();
+        if (not msg) break;
+        messages.push_back(std::move(msg));
       }
+      return messages.size();
+    }
+  }
+  Logger::itti().warn("received messages failed, bad task id");
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+std::shared_ptr<itti_msg> itti_mw::poll_msg(task_id_t task_id) {
+  if ((TASK_FIRST <= task_id) && (TASK_MAX > task_id)) {
+    if (itti_task_ctxts[task_id]) {
+      return itti_task_ctxts[task_id]->mailbox.pop();
     }
   }
   return nullptr;
@@ -335,17 +811,22 @@ timer_id_t itti_mw::timer_setup(
     uint64_t arg1_user, uint64_t arg2_user) {
   // Not sending to task timer
   if ((TASK_FIRST < task_id) && (TASK_MAX > task_id)) {
-    itti_timer t(
-        increment_timer_id(), task_id, interval_sec, interval_us, arg1_user,
-        arg2_user);
-    timer_id_t id = t.id;
     std::unique_lock<std::mutex> l(m_timers);
-    timers.insert(t);
-    c_timers.notify_one();
-
+    timer_id_t id = increment_timer_id();
+    while ((id == ITTI_INVALID_TIMER_ID) || (timer_wheel.contains(id))) {
+      id = increment_timer_id();
+    }
+    itti_timer t(id, task_id, interval_sec, interval_us, arg1_user, arg2_user);
+    // Round up, a timer never fires before its time-out
+    uint64_t expires = time_point_to_tick(
+        t.time_out + std::chrono::microseconds(999));
+    timer_wheel.insert(t, expires);
+    timer_stats[task_id].armed++;
     // wake up thread timer if necessary
-    std::unique_lock<std::mutex> l2(m_timeout);
-    c_timeout.notify_one();
+    uint64_t wake_up_tick = slack_tick(expires);
+    if (wake_up_tick < timer_fd_tick) {
+      arm_timer_fd(wake_up_tick);
+    }
     return id;
   }
   return ITTI_INVALID_TIMER_ID;
@@ -354,24 +835,112 @@ timer_id_t itti_mw::timer_setup(
 //------------------------------------------------------------------------------
 int itti_mw::timer_remove(const timer_id_t& timer_id) {
   std::lock_guard<std::mutex> lk(m_timers);
-  if (current_timer.id == timer_id) {
-    // cout << "timer_remove() current_timer.id == timer_id" << endl;
-    current_timer = null_timer;
-    c_timers.notify_one();
-    // wake up thread timer if necessary
-    std::unique_lock<std::mutex> l2(m_timeout);
-    c_timeout.notify_one();
+  task_id_t task_id = TASK_NONE;
+  if (timer_wheel.remove(timer_id, &task_id)) {
+    timer_stats[task_id].cancelled++;
     return RETURNok;
-  } else {
-    std::set<itti_timer>::iterator it = itti_inst->timers.begin();
-    while (it != itti_inst->timers.end()) {
-      if (it->id == timer_id) {
-        itti_inst->timers.erase(it);
-        return RETURNok;
-      }
-      ++it;
-    }
   }
   Logger::itti().trace("Removing timer 0x%lx: Not found", timer_id);
   return RETURNerror;
 }
+
+//------------------------------------------------------------------------------
+itti_timer_stats itti_mw::get_timer_stats(const task_id_t task_id) {
+  if ((TASK_FIRST <= task_id) && (TASK_MAX > task_id)) {
+    std::lock_guard<std::mutex> lk(m_timers);
+    return timer_stats[task_id];
+  }
+  return itti_timer_stats();
+}
+
+//------------------------------------------------------------------------------
+void itti_mw::display_timer_stats() {
+  for (int t = TASK_FIRST; t < TASK_MAX; t++) {
+    itti_timer_stats stats = get_timer_stats((task_id_t) t);
+    if (stats.armed == 0) continue;
+    const uint64_t* h = stats.late_histogram;
+    Logger::itti().info(
+        "Task %d timers: armed %lu cancelled %lu fired %lu pending %lu, late "
+        "max %lu us",
+        t, stats.armed, stats.cancelled, stats.fired, stats.pending(),
+        stats.late_max_us);
+    Logger::itti().info(
+        "Task %d timers late: <1ms %lu <2ms %lu <5ms %lu <10ms %lu <20ms %lu "
+        "<50ms %lu <100ms %lu >=100ms %lu",
+        t, h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7]);
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_mw::display_mailbox_stats() {
+  static const char* lane_names[itti_mailbox::LANE_MAX] = {
+      "reserved", "high", "low"};
+  for (int t = TASK_FIRST; t < TASK_MAX; t++) {
+    if (itti_task_ctxts[t] == nullptr) continue;
+    for (int l = itti_mailbox::LANE_RESERVED; l < itti_mailbox::LANE_MAX; l++) {
+      const itti_ring& lane =
+          itti_task_ctxts[t]->mailbox.lane((itti_mailbox::lane_e) l);
+      Logger::itti().info(
+          "Task %d mailbox lane %s: depth %lu max depth %lu/%u enqueued %lu "
+          "dropped %lu",
+          t, lane_names[l], lane.depth(), lane.max_depth(), lane.capacity(),
+          lane.enqueued(), lane.dropped());
+    }
+    Logger::itti().info(
+        "Task %d mailbox reserved lane spilled %lu", t,
+        itti_task_ctxts[t]->mailbox.spilled());
+  }
+}
+
+//------------------------------------------------------------------------------
+void itti_mw::display_msg_pool_stats() {
+  itti_msg_pool::stats_t stats = itti_msg_pool::get_stats();
+  Logger::itti().info(
+      "Message pool: allocations %lu heap allocations %lu in use %lu",
+      stats.allocations, stats.heap_allocations, stats.in_use);
+}
+
+//------------------------------------------------------------------------------
+itti_dispatcher::itti_dispatcher(const task_id_t task_id, _Logger& logger)
+    : task_id(task_id), logger(logger), handlers(), unhandled() {}
+
+//------------------------------------------------------------------------------
+bool itti_dispatcher::dispatch(std::shared_ptr<itti_msg>& msg) {
+  if ((msg->msg_type >= ITTI_MSG_TYPE_FIRST) &&
+      (msg->msg_type < ITTI_MSG_TYPE_MAX) && (handlers[msg->msg_type])) {
+    handlers[msg->msg_type](msg);
+    return true;
+  }
+  if ((msg->msg_type >= ITTI_MSG_TYPE_FIRST) &&
+      (msg->msg_type < ITTI_MSG_TYPE_MAX)) {
+    unhandled[msg->msg_type]++;
+  }
+  logger.warn(
+      "Task %d: no handler for msg type %d from task %d", task_id,
+      msg->msg_type, msg->origin);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void itti_dispatcher::run() {
+  std::vector<std::shared_ptr<itti_msg>> batch = {};
+  do {
+    itti_inst->receive_msgs(task_id, batch);
+    for (auto& msg : batch) {
+      if (msg->msg_type == TERMINATE) {
+        logger.info("Received terminate message");
+        return;
+      }
+      dispatch(msg);
+    }
+  } while (true);
+}
+
+//------------------------------------------------------------------------------
+uint64_t itti_dispatcher::unhandled_count(
+    const itti_msg_type_t msg_type) const {
+  if ((msg_type >= ITTI_MSG_TYPE_FIRST) && (msg_type < ITTI_MSG_TYPE_MAX)) {
+    return unhandled[msg_type];
+  }
+  return 0;
+}
@@ -27,16 +27,20 @@
 #ifndef SRC_OAI_ITTI_ITTI_HPP_INCLUDED_
 #define SRC_OAI_ITTI_ITTI_HPP_INCLUDED_
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
 //#include <iomanip>
 #include <stdint.h>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <queue>
-#include <set>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include "itti_msg.hpp"
 #include "thread_sched.hpp"
 
@@ -57,13 +61,13 @@ class itti_timer {
       const timer_id_t id, const task_id_t task_id, const uint32_t interval_sec,
       const uint32_t interval_us, uint64_t arg1_user, uint64_t arg2_user)
       : id(id), task_id(task_id), arg1_user(arg1_user), arg2_user(arg2_user) {
-    time_out = std::chrono::system_clock::now() +
+    time_out = std::chrono::steady_clock::now() +
                std::chrono::seconds(interval_sec) +
                std::chrono::microseconds(interval_us);
   }
   itti_timer(
       const timer_id_t id, const task_id_t task_id,
-      const std::chrono::system_clock::time_point time_out, uint64_t arg1_user,
+      const std::chrono::steady_clock::time_point time_out, uint64_t arg1_user,
       uint64_t arg2_user)
       : id(id),
         task_id(task_id),
@@ -83,27 +87,224 @@ class itti_timer {
   ~itti_timer() {}
   timer_id_t id;
   task_id_t task_id;
-  std::chrono::system_clock::time_point time_out;
+  std::chrono::steady_clock::time_point time_out;
   uint64_t arg1_user;
   uint64_t arg2_user;
 };
 
 //------------------------------------------------------------------------------
-struct timer_comparator {
-  bool operator()(const itti_timer& left, const itti_timer& right) const {
-    return (left.time_out < right.time_out);
+// Hashed hierarchical timing wheel (4 levels of 256 slots, 1 tick = 1 ms).
+// Timers are kept in a slab of entries linked in per slot doubly linked lists,
+// an index gives the entry of a timer id, so arming and cancelling are O(1).
+class itti_timer_wheel {
+ public:
+  static const uint32_t kLevels       = 4;
+  static const uint32_t kSlotBits     = 8;
+  static const uint32_t kSlots        = 1 << kSlotBits;
+  static const uint32_t kSlotMask     = kSlots - 1;
+  static const uint32_t kInvalidEntry = UINT32_MAX;
+  static const uint64_t kNoEvent      = UINT64_MAX;
+
+  itti_timer_wheel();
+  itti_timer_wheel(itti_timer_wheel const&) = delete;
+  void operator=(itti_timer_wheel const&) = delete;
+
+  bool empty() const { return index.empty(); }
+  size_t size() const { return index.size(); }
+  bool contains(const timer_id_t id) const { return index.count(id) > 0; }
+  uint64_t current_tick() const { return now_tick; }
+
+  /** \brief Arm a timer, expiring at the absolute tick expires_tick
+   *  (clamped to the next tick if already in the past).
+   **/
+  void insert(const itti_timer& t, const uint64_t expires_tick);
+
+  /** \brief Cancel a timer
+   *  \param task_id if not null, set to the task that armed the timer
+   *  @returns true if the timer was armed, false otherwise
+   **/
+  bool remove(const timer_id_t id, task_id_t* task_id = nullptr);
+
+  /** \brief Next tick at which advance() has some work to do (expiry or
+   *  cascade of a higher level slot), kNoEvent if the wheel is empty.
+   **/
+  uint64_t next_event_tick() const;
+
+  /** \brief Move the wheel forward up to tick, appending expired timers
+   *  in expiry order to expired.
+   **/
+  void advance(const uint64_t tick, std::vector<itti_timer>& expired);
+
+ private:
+  struct entry {
+    explicit entry(const itti_timer& t)
+        : timer(t), expires(0), prev(0), next(0), slot(0) {}
+    itti_timer timer;
+    uint64_t expires;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t slot;  // level * kSlots + slot in level
+  };
+
+  uint32_t alloc_entry(const itti_timer& t);
+  void free_entry(const uint32_t e);
+  void link(const uint32_t e);
+  void unlink(const uint32_t e);
+  void cascade(const uint32_t level);
+  int next_occupied_slot(const uint32_t level, const uint32_t from) const;
+
+  std::vector<entry> entries;
+  uint32_t free_entries;
+  uint32_t heads[kLevels * kSlots];
+  uint64_t occupied[kLevels][kSlots / 64];
+  std::unordered_map<timer_id_t, uint32_t> index;
+  uint64_t now_tick;
+};
+
+//------------------------------------------------------------------------------
+// Timer activity of a task, late firing is the delay between the requested
+// time-out and the delivery of the time-out message to the task queue.
+class itti_timer_stats {
+ public:
+  static const uint32_t kLateBuckets = 8;
+  // Upper bounds (exclusive) in microseconds of the late firing buckets, the
+  // last bucket collects everything above 100 ms.
+  static constexpr uint32_t kLateBucketLimitsUs[kLateBuckets - 1] = {
+      1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+  itti_timer_stats()
+      : armed(0), cancelled(0), fired(0), late_max_us(0), late_histogram() {}
+
+  void record_late(const uint64_t late_us);
+  uint64_t pending() const { return armed - cancelled - fired; }
+
+  uint64_t armed;
+  uint64_t cancelled;
+  uint64_t fired;
+  uint64_t late_max_us;
+  uint64_t late_histogram[kLateBuckets];
+};
+
+//------------------------------------------------------------------------------
+// Bounded lock-free multi-producer single-consumer message ring (D. Vyukov
+// bounded queue, each cell carries a sequence number telling producers and
+// the consumer whose turn it is).
+class itti_ring {
+ public:
+  explicit itti_ring(const uint32_t capacity);
+  itti_ring(itti_ring const&) = delete;
+  void operator=(itti_ring const&) = delete;
+
+  uint32_t capacity() const { return mask + 1; }
+
+  /** \brief Enqueue a message (producer side), counted as dropped if the
+   *  ring is full
+   *  @returns false if the ring is full
+   **/
+  bool push(std::shared_ptr<itti_msg>& message);
+
+  /** \brief Enqueue a message (producer side), message is left untouched and
+   *  nothing is counted if the ring is full
+   *  @returns false if the ring is full
+   **/
+  bool try_push(std::shared_ptr<itti_msg>& message);
+
+  /** \brief Dequeue a message (consumer side), nullptr if empty
+   **/
+  std::shared_ptr<itti_msg> pop();
+
+  // Counters, approximate when read while producers are running
+  uint64_t enqueued() const {
+    return enqueue_pos.load(std::memory_order_relaxed);
   }
+  uint64_t dropped() const { return drops.load(std::memory_order_relaxed); }
+  uint64_t depth() const { return enqueued() - dequeue_pos; }
+  uint64_t max_depth() const { return depth_max; }
+
+ private:
+  struct cell {
+    std::atomic<uint64_t> sequence;
+    std::shared_ptr<itti_msg> message;
+  };
+
+  std::unique_ptr<cell[]> cells;
+  uint64_t mask;
+  std::atomic<uint64_t> drops;
+  alignas(64) std::atomic<uint64_t> enqueue_pos;
+  alignas(64) uint64_t dequeue_pos;
+  uint64_t depth_max;
+};
+
+//------------------------------------------------------------------------------
+// Per task mailbox: one ring per priority lane, served in strict priority
+// order. The reserved lane carries timer, heartbeat and control messages, so
+// they do not queue behind a signalling storm. These must never be lost: when
+// the reserved ring is full they spill into an unbounded overflow list, served
+// right after the reserved ring. The consumer parks on an eventfd, producers
+// only write to the eventfd when the consumer is parked.
+class itti_mailbox {
+ public:
+  enum lane_e {
+    LANE_RESERVED = 0,  // priority >= MESSAGE_PRIORITY_MAX_LEAST
+    LANE_HIGH,          // priority >= MESSAGE_PRIORITY_MED_LEAST
+    LANE_LOW,           // only messages a sender explicitly lowers
+    LANE_MAX
+  };
+  static const uint32_t kDefaultCapacity  = 8192;
+  static const uint32_t kReservedCapacity = 1024;
+
+  explicit itti_mailbox(const uint32_t capacity);
+  itti_mailbox(itti_mailbox const&) = delete;
+  void operator=(itti_mailbox const&) = delete;
+  ~itti_mailbox();
+
+  static lane_e priority_to_lane(const message_priorities_t priority);
+
+  const itti_ring& lane(const lane_e l) const { return *lanes[l]; }
+  // Number of reserved lane messages that went through the overflow list
+  uint64_t spilled() const { return spills.load(std::memory_order_relaxed); }
+
+  /** \brief Enqueue a message in the lane of its priority, without waking up
+   *  the consumer. Reserved lane messages are always accepted.
+   *  @returns false if the lane is full
+   **/
+  bool push(std::shared_ptr<itti_msg> message);
+
+  /** \brief Wake up the consumer if it is parked
+   **/
+  void notify();
+
+  /** \brief Dequeue the message of highest priority (consumer side), nullptr
+   *  if empty
+   **/
+  std::shared_ptr<itti_msg> pop();
+
+  /** \brief Dequeue a message (consumer side), parking till one arrives
+   **/
+  std::shared_ptr<itti_msg> wait_pop();
+
+ private:
+  std::shared_ptr<itti_msg> pop_overflow();
+
+  std::unique_ptr<itti_ring> lanes[LANE_MAX];
+  // Reserved lane messages that did not fit in the reserved ring. While it
+  // is not empty, reserved lane messages are appended to it, so they keep
+  // their order.
+  std::mutex m_overflow;
+  std::deque<std::shared_ptr<itti_msg>> overflow;
+  std::atomic<uint64_t> overflow_size;
+  std::atomic<uint64_t> spills;
+  int event_fd;
+  std::atomic<bool> parked;
 };
 
 class itti_task_ctxt {
  public:
-  explicit itti_task_ctxt(const task_id_t task_id)
+  itti_task_ctxt(const task_id_t task_id, const uint32_t mailbox_capacity)
       : task_id(task_id),
         m_state(),
         task_state(TASK_STATE_STARTING),
-        msg_queue(),
-        m_queue(),
-        c_queue() {}
+        mailbox(mailbox_capacity) {}
   ~itti_task_ctxt() {}
 
   const task_id_t task_id;
@@ -118,12 +319,14 @@ class itti_task_ctxt {
   std::mutex m_state;
   volatile task_state_t task_state;
 
-  std::queue<std::shared_ptr<itti_msg>> msg_queue;
-  std::mutex m_queue;
-  std::condition_variable c_queue;
+  itti_mailbox mailbox;
 };
 
 class itti_mw {
+ public:
+  // Default maximum number of messages returned by one receive_msgs() call
+  static const size_t kReceiveBatchMax = 64;
+
  private:
   itti_task_ctxt* itti_task_ctxts[TASK_MAX];
 
@@ -138,17 +341,29 @@ class itti_mw {
   std::atomic<int> created_tasks;
   std::atomic<int> ready_tasks;
 
-  std::set<itti_timer, timer_comparator> timers;
-  itti_timer current_timer;
+  itti_timer_wheel timer_wheel;
+  std::chrono::steady_clock::time_point timer_epoch;
   std::mutex m_timers;
-  std::condition_variable c_timers;
+  // CLOCK_MONOTONIC timerfd, the only wake up source of the timer thread
+  int timer_fd;
+  // tick for which timer_fd is armed, itti_timer_wheel::kNoEvent if disarmed
+  uint64_t timer_fd_tick;
+  // wake ups are aligned on multiples of timer_slack_ticks, so that expiries
+  // falling in the same slack window are handled by a single wake up
+  uint64_t timer_slack_ticks;
+  itti_timer_stats timer_stats[TASK_MAX];
 
-  std::mutex m_timeout;
-  std::condition_variable c_timeout;
+  uint32_t mailbox_capacity;
 
   bool terminate;
 
   static void timer_manager_task(const util::thread_sched_params& sched_params);
+  uint64_t time_point_to_tick(
+      const std::chrono::steady_clock::time_point& time_point) const;
+  uint64_t slack_tick(const uint64_t tick) const;
+  void arm_timer_fd(const uint64_t tick);
+  void record_timeouts(const std::vector<itti_timer>& expired);
+  void send_timeouts(std::vector<itti_timer>& expired);
 
  public:
   itti_mw();
@@ -156,7 +371,17 @@ class itti_mw {
   void operator=(itti_mw const&) = delete;
   ~itti_mw();
 
-  void start(const util::thread_sched_params& sched_params);
+  /** \brief Start the timer thread
+   *  \param sched_params scheduling parameters of the timer thread
+   *  \param timer_slack_ms width of the window in which timer expiries are
+   *  coalesced into a single wake up (0 or 1: 1 ms resolution)
+   *  \param mailbox_capacity size of the message ring of tasks created
+   *  afterwards (rounded up to a power of 2)
+   **/
+  void start(
+      const util::thread_sched_params& sched_params,
+      const uint32_t timer_slack_ms   = 0,
+      const uint32_t mailbox_capacity = itti_mailbox::kDefaultCapacity);
 
   timer_id_t increment_timer_id();
   unsigned int increment_message_number();
@@ -169,10 +394,22 @@ class itti_mw {
 
   /** \brief Send a message to a task (could be itself)
    \param message message to send
-   @returns -1 on failure, 0 otherwise
+   @returns -1 on failure (including destination mailbox full), 0 otherwise
    **/
   int send_msg(std::shared_ptr<itti_msg> message);
 
+  /** \brief Send a batch of messages to a task, each one pushed without lock
+   in the mailbox lane of its priority, the receiver woken up once
+   \param task_id Task ID of the receiving task
+   \param messages messages to send, all destinated to task_id
+   @returns -1 if the task is not ready or if a lane was full: the messages
+   of the other lanes are still delivered, the batch may be partly sent.
+   0 otherwise
+   **/
+  int send_msgs(
+      const task_id_t task_id,
+      const std::vector<std::shared_ptr<itti_msg>>& messages);
+
   /** \brief Retrieves a message in the queue associated to task_id.
    * If the queue is empty, the thread is blocked till a new message arrives.
    \param task_id Task ID of the receiving task
@@ -180,6 +417,18 @@ class itti_mw {
    **/
   std::shared_ptr<itti_msg> receive_msg(task_id_t task_id);
 
+  /** \brief Retrieves all the messages pending in the queue associated to
+   * task_id, up to max. If the queue is empty, the thread is blocked till a new
+   * message arrives.
+   \param task_id Task ID of the receiving task
+   \param messages cleared, then filled with the received messages
+   \param max maximum number of messages to retrieve
+   @returns number of messages retrieved, 0 on failure
+   **/
+  size_t receive_msgs(
+      const task_id_t task_id, std::vector<std::shared_ptr<itti_msg>>& messages,
+      const size_t max = kReceiveBatchMax);
+
   /** \brief Try to retrieves a message in the queue associated to task_id.
    \param task_id Task ID of the receiving task
    \param received_msg Pointer to the allocated message
@@ -242,7 +491,86 @@ class itti_mw {
    **/
   int timer_remove(const timer_id_t& timer_id);
 
+  /** \brief Snapshot of the timer activity of a task
+   *  \param task_id task id of the task that requested the timers
+   **/
+  itti_timer_stats get_timer_stats(const task_id_t task_id);
+
+  /** \brief Log the timer activity of every task having armed a timer
+   **/
+  void display_timer_stats();
+
+  /** \brief Log the depth and traffic of every mailbox lane of every task
+   **/
+  void display_mailbox_stats();
+
+  /** \brief Log how many message blocks were served by itti_msg_pool and
+   *  how many of them had to be taken from the heap
+   **/
+  void display_msg_pool_stats();
+
   static void signal_handler(int signum);
 };
 
+//------------------------------------------------------------------------------
+// Dispatch table of a task, indexed by message type. A handler registered for
+// a message type receives the message already cast to the class bound to that
+// type by ITTI_MSG_CLASS(), no RTTI is involved.
+class itti_dispatcher {
+ public:
+  typedef std::function<void(std::shared_ptr<itti_msg>&)> handler_t;
+
+  itti_dispatcher(const task_id_t task_id, _Logger& logger);
+  itti_dispatcher(itti_dispatcher const&) = delete;
+  void operator=(itti_dispatcher const&) = delete;
+
+  /** \brief Register the handler of the messages of type T
+   *  \param handler callable taking a std::shared_ptr to the class bound to
+   *  T by ITTI_MSG_CLASS()
+   **/
+  template <itti_msg_type_t T, typename F>
+  itti_dispatcher& on(F handler) {
+    typedef typename itti_msg_class<T>::type msg_class_t;
+    handlers[T] = [handler](std::shared_ptr<itti_msg>& msg) {
+      handler(std::static_pointer_cast<msg_class_t>(msg));
+    };
+    return *this;
+  }
+
+  /** \brief Register the same (generic) handler for each of the types Ts
+   **/
+  template <itti_msg_type_t... Ts, typename F>
+  itti_dispatcher& on_each(F handler) {
+    (on<Ts>(handler), ...);
+    return *this;
+  }
+
+  /** \brief Silently drop the messages of type T
+   **/
+  template <itti_msg_type_t T>
+  itti_dispatcher& ignore() {
+    handlers[T] = [](std::shared_ptr<itti_msg>&) {};
+    return *this;
+  }
+
+  /** \brief Call the handler registered for the type of msg
+   *  @returns false if there is none, the message is then reported and counted
+   *  as unhandled
+   **/
+  bool dispatch(std::shared_ptr<itti_msg>& msg);
+
+  /** \brief Receive and dispatch the messages of the task till it receives a
+   *  TERMINATE message
+   **/
+  void run();
+
+  uint64_t unhandled_count(const itti_msg_type_t msg_type) const;
+
+ private:
+  const task_id_t task_id;
+  _Logger& logger;
+  handler_t handlers[ITTI_MSG_TYPE_MAX];
+  uint64_t unhandled[ITTI_MSG_TYPE_MAX];
+};
+
 #endif /* SRC_OAI_ITTI_ITTI_HPP_INCLUDED_ */
@@ -28,16 +28,173 @@
 #include "itti_msg.hpp"
 #include "itti.hpp"
 
+#include <atomic>
+#include <mutex>
+#include <new>
+
 extern itti_mw* itti_inst;
 
+namespace {
+
+struct pool_block {
+  pool_block* next;
+};
+
+// Free list of a size class shared by all threads.
+struct pool_class {
+  std::mutex lock;
+  pool_block* head;
+};
+
+pool_class pool_classes[itti_msg_pool::kClasses] = {};
+
+std::atomic<uint64_t> pool_allocations(0);
+std::atomic<uint64_t> pool_heap_allocations(0);
+std::atomic<uint64_t> pool_releases(0);
+
+// Blocks a thread keeps for itself before giving a slab worth of them back.
+constexpr uint32_t kCacheMax = 2 * itti_msg_pool::kSlabBlocks;
+
+// Set when the cache of the thread is destroyed. Constant initialised and
+// trivially destructible, so it can still be read by the thread_local and
+// static destructors that run after the cache is gone: their messages then go
+// straight to the free list of their class.
+thread_local bool cache_gone = false;
+
+struct pool_cache {
+  pool_block* head[itti_msg_pool::kClasses];
+  uint32_t count[itti_msg_pool::kClasses];
+
+  pool_cache() : head(), count() {}
+  ~pool_cache() {
+    cache_gone = true;
+    for (size_t c = 0; c < itti_msg_pool::kClasses; c++) {
+      if (head[c]) give_back(c, count[c]);
+    }
+  }
+
+  // Move n blocks of the cache to the free list of the class
+  void give_back(const size_t c, uint32_t n) {
+    pool_block* first = head[c];
+    pool_block* last  = first;
+    count[c] -= n;
+    while (--n) last = last->next;
+    head[c] = last->next;
+    std::lock_guard<std::mutex> lock(pool_classes[c].lock);
+    last->next          = pool_classes[c].head;
+    pool_classes[c].head = first;
+  }
+
+  // Take up to a slab worth of blocks from the free list of the class, or
+  // carve a new slab when it is empty
+  void refill(const size_t c) {
+    {
+      std::lock_guard<std::mutex> lock(pool_classes[c].lock);
+      pool_block* b = pool_classes[c].head;
+      while (b && (count[c] < itti_msg_pool::kSlabBlocks)) {
+        pool_classes[c].head = b->next;
+        b->next              = head[c];
+        head[c]              = b;
+        count[c]++;
+        b = pool_classes[c].head;
+      }
+    }
+    if (head[c]) return;
+    const size_t block_size = (c + 1) * itti_msg_pool::kClassBytes;
+    char* slab              = static_cast<char*>(
+        ::operator new(block_size * itti_msg_pool::kSlabBlocks));
+    pool_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < itti_msg_pool::kSlabBlocks; i++) {
+      pool_block* b = reinterpret_cast<pool_block*>(slab + i * block_size);
+      b->next       = head[c];
+      head[c]       = b;
+    }
+    count[c] += itti_msg_pool::kSlabBlocks;
+  }
+};
+
+thread_local pool_cache cache;
+
+// Allocation once the cache of the thread is gone
+void* allocate_uncached(const size_t c) {
+  {
+    std::lock_guard<std::mutex> lock(pool_classes[c].lock);
+    pool_block* b = pool_classes[c].head;
+    if (b) {
+      pool_classes[c].head = b->next;
+      return b;
+    }
+  }
+  pool_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  return ::operator new((c + 1) * itti_msg_pool::kClassBytes);
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+void* itti_msg_pool::allocate(const size_t size) {
+  pool_allocations.fetch_add(1, std::memory_order_relaxed);
+  if ((size == 0) || (size > kMaxBytes)) {
+    pool_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+  const size_t c = (size - 1) / kClassBytes;
+  if (cache_gone) return allocate_uncached(c);
+  if (!cache.head[c]) cache.refill(c);
+  pool_block* b = cache.head[c];
+  cache.head[c] = b->next;
+  cache.count[c]--;
+  return b;
+}
+
+//------------------------------------------------------------------------------
+void itti_msg_pool::release(void* p, const size_t size) noexcept {
+  if (!p) return;
+  pool_releases.fetch_add(1, std::memory_order_relaxed);
+  if ((size == 0) || (size > kMaxBytes)) {
+    ::operator delete(p);
+    return;
+  }
+  const size_t c = (size - 1) / kClassBytes;
+  pool_block* b  = static_cast<pool_block*>(p);
+  if (cache_gone) {
+    std::lock_guard<std::mutex> lock(pool_classes[c].lock);
+    b->next              = pool_classes[c].head;
+    pool_classes[c].head = b;
+    return;
+  }
+  b->next        = cache.head[c];
+  cache.head[c]  = b;
+  if (++cache.count[c] > kCacheMax) {
+    cache.give_back(c, kSlabBlocks);
+  }
+}
+
+//------------------------------------------------------------------------------
+itti_msg_pool::stats_t itti_msg_pool::get_stats() {
+  stats_t stats          = {};
+  stats.allocations      = pool_allocations.load(std::memory_order_relaxed);
+  stats.heap_allocations =
+      pool_heap_allocations.load(std::memory_order_relaxed);
+  stats.in_use =
+      stats.allocations - pool_releases.load(std::memory_order_relaxed);
+  return stats;
+}
+
 itti_msg::itti_msg()
-    : msg_type(ITTI_MSG_TYPE_NONE), origin(TASK_NONE), destination(TASK_NONE) {
+    : msg_type(ITTI_MSG_TYPE_NONE),
+      origin(TASK_NONE),
+      destination(TASK_NONE),
+      priority(MESSAGE_PRIORITY_MED) {
   msg_num = itti_inst->increment_message_number();
 };
 
 itti_msg::itti_msg(
     const itti_msg_type_t msg_type, task_id_t origin, task_id_t destination)
-    : msg_type(msg_type), origin(origin), destination(destination) {
+    : msg_type(msg_type),
+      origin(origin),
+      destination(destination),
+      priority(default_priority(msg_type)) {
   msg_num = itti_inst->increment_message_number();
 };
 
@@ -45,8 +202,38 @@ itti_msg::itti_msg(const itti_msg& i)
     : msg_type(i.msg_type),
       msg_num(i.msg_num),
       origin(i.origin),
-      destination(i.destination){};
+      destination(i.destination),
+      priority(i.priority){};
 
 const char* itti_msg::get_msg_name() {
   return "UNINITIALIZED";
 }
+
+message_priorities_t itti_msg::default_priority(
+    const itti_msg_type_t msg_type) {
+  switch (msg_type) {
+    case TIME_OUT:
+    case HEALTH_PING:
+    case TERMINATE:
+    case SXAB_HEARTBEAT_REQUEST:
+    case SXAB_HEARTBEAT_RESPONSE:
+      return MESSAGE_PRIORITY_MAX;
+    case SXAB_ASSOCIATION_SETUP_REQUEST:
+    case SXAB_ASSOCIATION_SETUP_RESPONSE:
+    case SXAB_ASSOCIATION_UPDATE_REQUEST:
+    case SXAB_ASSOCIATION_UPDATE_RESPONSE:
+    case SXAB_ASSOCIATION_RELEASE_REQUEST:
+    case SXAB_ASSOCIATION_RELEASE_RESPONSE:
+    case SXAB_NODE_REPORT_REQUEST:
+    case SXAB_NODE_REPORT_RESPONSE:
+    case S11_REMOTE_PEER_NOT_RESPONDING:
+    case S5S8_REMOTE_PEER_NOT_RESPONDING:
+    case SXAB_REMOTE_PEER_NOT_RESPONDING:
+      return MESSAGE_PRIORITY_MAX_LEAST;
+    // All S11/S5S8 and Sx session messages share the same lane, a Create
+    // Session Request can neither be overtaken by the Modify Bearer or Delete
+    // Session Request of the same session nor starved by them.
+    default:
+      return MESSAGE_PRIORITY_MED;
+  }
+}
@@ -27,9 +27,17 @@
 #ifndef SRC_ITTI_ITTI_MSG_HPP_INCLUDED_
 #define SRC_ITTI_ITTI_MSG_HPP_INCLUDED_
 
+#include <stddef.h>
 #include <stdint.h>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
+// Number of task ids reserved for the workers of the PGW-C application
+#define TASK_PGWC_APP_MAX_WORKERS 8
+// Number of task ids reserved for the workers of the SGW-C application
+#define TASK_SGWC_APP_MAX_WORKERS 8
+
 typedef enum {
   TASK_FIRST      = 0,
   TASK_ITTI_TIMER = TASK_FIRST,
@@ -38,14 +46,16 @@ typedef enum {
   TASK_GTPV1_U,
   TASK_GTPV2_C,
   TASK_MME_S11,
-  TASK_PGWC_APP,
+  TASK_PGWC_APP,  // first worker of the PGW-C application
+  TASK_PGWC_APP_LAST = TASK_PGWC_APP + TASK_PGWC_APP_MAX_WORKERS - 1,
   TASK_PGWU_APP,
   TASK_SPGWU_APP,
   TASK_PGWC_S5S8,
   TASK_PGWC_SX,
   TASK_PGWU_SX,
   TASK_PGW_UDP,
-  TASK_SGWC_APP,
+  TASK_SGWC_APP,  // first worker of the SGW-C application
+  TASK_SGWC_APP_LAST = TASK_SGWC_APP + TASK_SGWC_APP_MAX_WORKERS - 1,
   TASK_SGWC_S11,
   TASK_SGWC_S5S8,
   TASK_SGWC_SXA,
@@ -111,6 +121,7 @@ typedef enum {
   S5S8_DOWNLINK_DATA_NOTIFICATION,
   S5S8_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE,
   S5S8_DOWNLINK_DATA_NOTIFICATION_FAILURE_INDICATION,
+  SXAB_REMOTE_PEER_NOT_RESPONDING,
   SXAB_HEARTBEAT_REQUEST,
   SXAB_HEARTBEAT_RESPONSE,
   SXAB_PFCP_PFD_MANAGEMENT_REQUEST,
@@ -145,6 +156,57 @@ typedef enum {
 
 typedef unsigned long message_number_t;
 
+//------------------------------------------------------------------------------
+// Slab pool serving ITTI messages and the reference counts of the shared
+// pointers carrying them. Blocks are grouped in size classes of kClassBytes,
+// a released block goes back to a small per thread cache, then to the free
+// list of its class, and is handed out again before any new slab is taken
+// from the heap. Sizes above the largest class are passed to the heap.
+class itti_msg_pool {
+ public:
+  static constexpr size_t kClassBytes = 64;
+  static constexpr size_t kClasses    = 64;
+  static constexpr size_t kMaxBytes   = kClassBytes * kClasses;
+  static constexpr size_t kSlabBlocks = 32;
+
+  typedef struct stats_s {
+    uint64_t allocations;       // blocks handed out
+    uint64_t heap_allocations;  // slabs and oversized blocks from the heap
+    uint64_t in_use;            // blocks not released yet
+  } stats_t;
+
+  static void* allocate(const size_t size);
+  static void release(void* p, const size_t size) noexcept;
+  static stats_t get_stats();
+};
+
+// Standard allocator over itti_msg_pool, used for shared_ptr control blocks.
+template <class T>
+class itti_msg_allocator {
+ public:
+  typedef T value_type;
+
+  itti_msg_allocator() noexcept {}
+  template <class U>
+  itti_msg_allocator(const itti_msg_allocator<U>&) noexcept {}
+
+  T* allocate(const size_t n) {
+    return static_cast<T*>(itti_msg_pool::allocate(n * sizeof(T)));
+  }
+  void deallocate(T* p, const size_t n) noexcept {
+    itti_msg_pool::release(p, n * sizeof(T));
+  }
+};
+
+template <class T, class U>
+bool operator==(const itti_msg_allocator<T>&, const itti_msg_allocator<U>&) {
+  return true;
+}
+template <class T, class U>
+bool operator!=(const itti_msg_allocator<T>&, const itti_msg_allocator<U>&) {
+  return false;
+}
+
 class itti_msg {
  public:
   itti_msg();
@@ -158,18 +220,67 @@ class itti_msg {
     std::swap(origin, other.origin);
     std::swap(destination, other.destination);
     std::swap(msg_type, other.msg_type);
+    std::swap(priority, other.priority);
     return *this;
   }
 
   virtual ~itti_msg() = default;
   static const char* get_msg_name();
 
+  // The destructor being virtual, the sized delete gets the size of the
+  // dynamic type and the block returns to the right size class.
+  static void* operator new(const size_t size) {
+    return itti_msg_pool::allocate(size);
+  }
+  static void operator delete(void* p, const size_t size) noexcept {
+    itti_msg_pool::release(p, size);
+  }
+
+  /** \brief Priority given to a message type unless the sender overrides it.
+   *  Timer, heartbeat and control messages get the highest priority, all
+   *  session messages the same medium one, so they are served in order.
+   **/
+  static message_priorities_t default_priority(const itti_msg_type_t msg_type);
+
   message_number_t msg_num;
   task_id_t origin;
   task_id_t destination;
   itti_msg_type_t msg_type;
+  message_priorities_t priority;
 };
 
+/** \brief Hand a message created with new over to a shared pointer whose
+ *  reference count is also allocated from itti_msg_pool.
+ **/
+template <class T>
+std::shared_ptr<T> itti_msg_shared(T* msg) {
+  return std::shared_ptr<T>(
+      msg, std::default_delete<T>(), itti_msg_allocator<T>());
+}
+
+/** \brief make_shared for ITTI messages: the message and its reference count
+ *  share a single block of itti_msg_pool.
+ **/
+template <class T, class... Args>
+std::shared_ptr<T> itti_make_msg(Args&&... args) {
+  return std::allocate_shared<T>(
+      itti_msg_allocator<T>(), std::forward<Args>(args)...);
+}
+
+// Class of the messages of type T, declared with ITTI_MSG_CLASS() next to
+// the message class. The dispatcher relies on it to static_cast a message
+// from its msg_type, so every message class must be bound to its type.
+template <itti_msg_type_t T>
+struct itti_msg_class;
+
+#define ITTI_MSG_CLASS(MSG_TYPE, MSG_CLASS)                                   \
+  template <>                                                                 \
+  struct itti_msg_class<MSG_TYPE> {                                           \
+    static_assert(                                                            \
+        std::is_base_of<itti_msg, MSG_CLASS>::value, "not an itti message");  \
+    typedef MSG_CLASS type;                                                   \
+  }
+
 class itti_msg_timeout : public itti_msg {
  public:
   itti_msg_timeout(
@@ -208,4 +319,8 @@ class itti_msg_terminate : public itti_msg {
   static const char* get_msg_name() { return "TERMINATE"; };
 };
 
+ITTI_MSG_CLASS(TIME_OUT, itti_msg_timeout);
+ITTI_MSG_CLASS(HEALTH_PING, itti_msg_ping);
+ITTI_MSG_CLASS(TERMINATE, itti_msg_terminate);
+
 #endif /* SRC_ITTI_ITTI_MSG_HPP_INCLUDED_ */
@@ -50,7 +50,7 @@ void send_heartbeat_to_tasks(const uint32_t sequence);
 void send_heartbeat_to_tasks(const uint32_t sequence) {
   itti_msg_ping* itti_msg =
       new itti_msg_ping(TASK_SGWC_APP, TASK_ALL, sequence);
-  std::shared_ptr<itti_msg_ping> i = std::shared_ptr<itti_msg_ping>(itti_msg);
+  std::shared_ptr<itti_msg_ping> i = itti_msg_shared(itti_msg);
   int ret                          = itti_inst->send_broadcast_msg(i);
   if (RETURNok != ret) {
     Logger::sgwc_app().error(
@@ -65,6 +65,9 @@ void term_signal_handler(int signum) {
   if (itti_inst) {
     itti_inst->send_terminate_msg(TASK_SGWC_APP);
     itti_inst->wait_tasks_end();
+    itti_inst->display_timer_stats();
+    itti_inst->display_mailbox_stats();
+    itti_inst->display_msg_pool_stats();
   }
   std::cout << "Freeing Allocated memory..." << std::endl;
   if (async_shell_cmd_inst) {
@@ -119,7 +122,10 @@ int main(int argc, char** argv) {
 
     // Inter task Interface
     itti_inst = new itti_mw();
-    itti_inst->start(pgwc::pgw_config::timer_.sched_params);
+    itti_inst->start(
+        pgwc::pgw_config::timer_.sched_params,
+        pgwc::pgw_config::timer_.slack_ms,
+        pgwc::pgw_config::timer_.mailbox_size);
 
     // system command
     async_shell_cmd_inst =
@@ -58,70 +58,126 @@ void pgw_app_task(void*);
 int pgw_app::apply_config() {
   Logger::pgwc_app().info("Apply config...");
   int pool_id = 0;
+  paa_dynamic::get_instance().set_num_shards(get_num_workers());
   for (auto p : pgw_config::spgw_app_.pdns) {
     int range = be32toh(p.ue_pool_range_high.s_addr) -
                 be32toh(p.ue_pool_range_low.s_addr);
-    paa_dynamic::get_instance().add_pool(
-        p.apn_label, pool_id++, p.ue_pool_range_low, range);
-    paa_dynamic::get_instance().add_pool(
-        p.apn_label, pool_id++, p.paa_pool6_prefix, p.paa_pool6_prefix_len);
+    if ((p.pdn_type.pdn_type == PDN_TYPE_E_IPV4) ||
+        (p.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6)) {
+      paa_dynamic::get_instance().add_pool(
+          p.apn_label, pool_id, p.ue_pool_range_low, range);
+    }
+    pool_id++;
+    if ((p.pdn_type.pdn_type == PDN_TYPE_E_IPV6) ||
+        (p.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6)) {
+      paa_dynamic::get_instance().add_pool(
+          p.apn_label, pool_id, p.paa_pool6_prefix, p.paa_pool6_prefix_len);
+    }
+    pool_id++;
   }
   Logger::pgwc_app().info("Applied config");
   return RETURNok;
 }
 
 //------------------------------------------------------------------------------
-teid_t pgw_app::generate_s5s8_cp_teid() {
-  std::unique_lock<std::mutex> ls(m_s5s8_cp_teid_generator);
-  teid_t teid = ++teid_s5s8_cp_generator;
-  while ((is_s5s8c_teid_exist(teid)) || (teid == UNASSIGNED_TEID)) {
-    teid = ++teid_s5s8_cp_generator;
+uint32_t pgw_app::get_num_workers() {
+  return pgw_config::spgw_app_.worker_threads;
+}
+//------------------------------------------------------------------------------
+uint32_t pgw_app::imsi64_2_shard(const imsi64_t& imsi64) {
+  return imsi64 % get_num_workers();
+}
+//------------------------------------------------------------------------------
+uint32_t pgw_app::teid_2_shard(const teid_t& teid) {
+  return teid % get_num_workers();
+}
+//------------------------------------------------------------------------------
+uint32_t pgw_app::seid_2_shard(const seid_t& seid) {
+  // see pgw_pdn_connection::generate_seid()
+  return teid_2_shard((teid_t)(seid & 0xFFFFFFFF));
+}
+//------------------------------------------------------------------------------
+task_id_t pgw_app::create_session_request_2_task(
+    const teid_t& teid, const gtpv2c::gtpv2c_create_session_request& gtp_ies) {
+  // the handler looks the context up by IMSI first, it must run on the worker
+  // of the IMSI shard, the shard of the TEIDs of the context
+  imsi_t imsi = {};
+  if (gtp_ies.get(imsi)) {
+    return shard_2_task(imsi64_2_shard(imsi.to_imsi64()));
   }
-  s5s8cplteid.insert(teid);
+  if (teid) {
+    return teid_2_task(teid);
+  }
+  return TASK_PGWC_APP;
+}
+
+//------------------------------------------------------------------------------
+teid_t pgw_app::generate_s5s8_cp_teid(const uint32_t shard) {
+  pgw_app_shard& s           = shards[shard];
+  const uint32_t num_workers = get_num_workers();
+  const teid_t max_generator = (UINT32_MAX - shard) / num_workers;
+  std::unique_lock<std::mutex> ls(s.m_s5s8_cp_teid_generator);
+  teid_t teid = UNASSIGNED_TEID;
+  do {
+    if (++s.teid_s5s8_cp_generator > max_generator) {
+      s.teid_s5s8_cp_generator = 1;
+    }
+    teid = s.teid_s5s8_cp_generator * num_workers + shard;
+  } while ((s.s5s8cplteid.count(teid)) || (teid == UNASSIGNED_TEID));
+  s.s5s8cplteid.insert(teid);
   ls.unlock();
   return teid;
 }
 
 //------------------------------------------------------------------------------
 bool pgw_app::is_s5s8c_teid_exist(const teid_t& teid_s5s8_cp) const {
-  return bool{s5s8cplteid.count(teid_s5s8_cp) > 0};
+  const pgw_app_shard& s = shards[teid_2_shard(teid_s5s8_cp)];
+  std::unique_lock<std::mutex> ls(s.m_s5s8_cp_teid_generator);
+  return bool{s.s5s8cplteid.count(teid_s5s8_cp) > 0};
 }
 
 //------------------------------------------------------------------------------
 void pgw_app::free_s5s8c_teid(const teid_t& teid_s5s8_cp) {
-  s5s8cplteid.erase(teid_s5s8_cp);  // can return value of erase
+  pgw_app_shard& s = shards[teid_2_shard(teid_s5s8_cp)];
+  std::unique_lock<std::mutex> ls(s.m_s5s8_cp_teid_generator);
+  s.s5s8cplteid.erase(teid_s5s8_cp);  // can return value of erase
 }
 
 //------------------------------------------------------------------------------
 bool pgw_app::is_imsi64_2_pgw_context(const imsi64_t& imsi64) const {
-  std::shared_lock lock(m_imsi2pgw_context);
-  return bool{imsi2pgw_context.count(imsi64) > 0};
+  const pgw_app_shard& s = shards[imsi64_2_shard(imsi64)];
+  std::shared_lock lock(s.m_imsi2pgw_context);
+  return bool{s.imsi2pgw_context.count(imsi64) > 0};
 }
 //------------------------------------------------------------------------------
 std::shared_ptr<pgw_context> pgw_app::imsi64_2_pgw_context(
     const imsi64_t& imsi64) const {
-  std::shared_lock lock(m_imsi2pgw_context);
-  return imsi2pgw_context.at(imsi64);
+  const pgw_app_shard& s = shards[imsi64_2_shard(imsi64)];
+  std::shared_lock lock(s.m_imsi2pgw_context);
+  return s.imsi2pgw_context.at(imsi64);
 }
 //------------------------------------------------------------------------------
 void pgw_app::set_imsi64_2_pgw_context(
     const imsi64_t& imsi64, std::shared_ptr<pgw_context> pc) {
-  std::unique_lock lock(m_imsi2pgw_context);
-  imsi2pgw_context[imsi64] = pc;
+  pgw_app_shard& s = shards[imsi64_2_shard(imsi64)];
+  std::unique_lock lock(s.m_imsi2pgw_context);
+  s.imsi2pgw_context[imsi64] = pc;
 }
 //------------------------------------------------------------------------------
 void pgw_app::set_seid_2_pgw_context(
     const seid_t& seid, std::shared_ptr<pgw_context>& pc) {
-  std::unique_lock lock(m_seid2pgw_context);
-  seid2pgw_context[seid] = pc;
+  pgw_app_shard& s = shards[seid_2_shard(seid)];
+  std::unique_lock lock(s.m_seid2pgw_context);
+  s.seid2pgw_context[seid] = pc;
 }
 //------------------------------------------------------------------------------
 bool pgw_app::seid_2_pgw_context(
     const seid_t& seid, std::shared_ptr<pgw_context>& pc) const {
-  std::shared_lock lock(m_seid2pgw_context);
+  const pgw_app_shard& s = shards[seid_2_shard(seid)];
+  std::shared_lock lock(s.m_seid2pgw_context);
   std::map<seid_t, std::shared_ptr<pgw_context>>::const_iterator it =
-      seid2pgw_context.find(seid);
-  if (it != seid2pgw_context.end()) {
+      s.seid2pgw_context.find(seid);
+  if (it != s.seid2pgw_context.end()) {
     pc = it->second;
     return true;
   }
@@ -141,27 +197,34 @@ fteid_t pgw_app::build_s5s8_cp_fteid(
   return fteid;
 }
 //------------------------------------------------------------------------------
-fteid_t pgw_app::generate_s5s8_cp_fteid(const struct in_addr ipv4_address) {
-  teid_t teid = generate_s5s8_cp_teid();
+fteid_t pgw_app::generate_s5s8_cp_fteid(
+    const uint32_t shard, const struct in_addr ipv4_address) {
+  teid_t teid = generate_s5s8_cp_teid(shard);
   return build_s5s8_cp_fteid(ipv4_address, teid);
 }
 //------------------------------------------------------------------------------
 void pgw_app::free_s5s8_cp_fteid(const fteid_t& fteid) {
-  std::unique_lock lock(m_s5s8lteid2pgw_context);
-  s5s8lteid2pgw_context.erase(fteid.teid_gre_key);
+  pgw_app_shard& s = shards[teid_2_shard(fteid.teid_gre_key)];
+  std::unique_lock lock(s.m_s5s8lteid2pgw_context);
+  s.s5s8lteid2pgw_context.erase(fteid.teid_gre_key);
   free_s5s8c_teid(fteid.teid_gre_key);
 }
 //------------------------------------------------------------------------------
 bool pgw_app::is_s5s8cpgw_fteid_2_pgw_context(
     const fteid_t& ls5s8_fteid) const {
-  std::shared_lock lock(m_s5s8lteid2pgw_context);
-  return bool{s5s8lteid2pgw_context.count(ls5s8_fteid.teid_gre_key) > 0};
+  const pgw_app_shard& s = shards[teid_2_shard(ls5s8_fteid.teid_gre_key)];
+  std::shared_lock lock(s.m_s5s8lteid2pgw_context);
+  return bool{s.s5s8lteid2pgw_context.count(ls5s8_fteid.teid_gre_key) > 0};
 }
 //------------------------------------------------------------------------------
 std::shared_ptr<pgw_context> pgw_app::s5s8cpgw_fteid_2_pgw_context(
     fteid_t& ls5s8_fteid) {
-  if (is_s5s8cpgw_fteid_2_pgw_context(ls5s8_fteid)) {
-    return s5s8lteid2pgw_context.at(ls5s8_fteid.teid_gre_key);
+  pgw_app_shard& s = shards[teid_2_shard(ls5s8_fteid.teid_gre_key)];
+  std::shared_lock lock(s.m_s5s8lteid2pgw_context);
+  std::map<teid_t, std::shared_ptr<pgw_context>>::const_iterator it =
+      s.s5s8lteid2pgw_context.find(ls5s8_fteid.teid_gre_key);
+  if (it != s.s5s8lteid2pgw_context.end()) {
+    return it->second;
   } else {
     return std::shared_ptr<pgw_context>(nullptr);
   }
@@ -169,136 +232,86 @@ std::shared_ptr<pgw_context> pgw_app::s5s8cpgw_fteid_2_pgw_context(
 //------------------------------------------------------------------------------
 void pgw_app::set_s5s8cpgw_fteid_2_pgw_context(
     fteid_t& ls5s8_fteid, std::shared_ptr<pgw_context> spc) {
-  std::unique_lock lock(m_s5s8lteid2pgw_context);
-  s5s8lteid2pgw_context[ls5s8_fteid.teid_gre_key] = spc;
+  pgw_app_shard& s = shards[teid_2_shard(ls5s8_fteid.teid_gre_key)];
+  std::unique_lock lock(s.m_s5s8lteid2pgw_context);
+  s.s5s8lteid2pgw_context[ls5s8_fteid.teid_gre_key] = spc;
 }
 
 //------------------------------------------------------------------------------
 void pgw_app::delete_pgw_context(std::shared_ptr<pgw_context> spc) {
-  imsi64_t imsi64 = spc.get()->imsi.to_imsi64();
-  std::unique_lock lock(m_imsi2pgw_context);
-  imsi2pgw_context.erase(imsi64);
+  imsi64_t imsi64  = spc.get()->imsi.to_imsi64();
+  pgw_app_shard& s = shards[imsi64_2_shard(imsi64)];
+  std::unique_lock lock(s.m_imsi2pgw_context);
+  s.imsi2pgw_context.erase(imsi64);
 }
+//------------------------------------------------------------------------------
+void pgw_app::handle_itti_msg(itti_sx_restore& m) {
+  Logger::pgwc_app().info(
+      "Received RESTORE_SX_SESSIONS for %lu sessions", m.sessions.size());
+  for (auto& fseid : m.sessions) {
+    restore_sx_sessions(fseid.seid);
+  }
+}
+
 //------------------------------------------------------------------------------
 void pgw_app::restore_sx_sessions(const seid_t& seid) const {
-  std::shared_lock lock(m_seid2pgw_context);
+  std::shared_lock lock(shards[seid_2_shard(seid)].m_seid2pgw_context);
   // TODO
 }
 
 //------------------------------------------------------------------------------
-void pgw_app_task(void*) {
-  const task_id_t task_id = TASK_PGWC_APP;
+void pgw_app_task(void* args_p) {
+  const uint32_t shard    = (uint32_t)(uintptr_t) args_p;
+  const task_id_t task_id = pgw_app::shard_2_task(shard);
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case SXAB_SESSION_ESTABLISHMENT_RESPONSE:
-        if (itti_sxab_session_establishment_response* m =
-                dynamic_cast<itti_sxab_session_establishment_response*>(msg)) {
-          pgw_app_inst->handle_itti_msg(std::ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_MODIFICATION_RESPONSE:
-        if (itti_sxab_session_modification_response* m =
-                dynamic_cast<itti_sxab_session_modification_response*>(msg)) {
-          pgw_app_inst->handle_itti_msg(std::ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_DELETION_RESPONSE:
-        if (itti_sxab_session_deletion_response* m =
-                dynamic_cast<itti_sxab_session_deletion_response*>(msg)) {
-          pgw_app_inst->handle_itti_msg(std::ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_REPORT_REQUEST:
-        pgw_app_inst->handle_itti_msg(
-            std::static_pointer_cast<itti_sxab_session_report_request>(
-                shared_msg));
-        break;
-
-      case S5S8_CREATE_SESSION_REQUEST:
-        pgw_app_inst->handle_itti_msg(
-            std::static_pointer_cast<itti_s5s8_create_session_request>(
-                shared_msg));
-        break;
-
-      case S5S8_DELETE_SESSION_REQUEST:
-        pgw_app_inst->handle_itti_msg(
-            std::static_pointer_cast<itti_s5s8_delete_session_request>(
-                shared_msg));
-        break;
-
-      case S5S8_MODIFY_BEARER_REQUEST:
-        pgw_app_inst->handle_itti_msg(
-            std::static_pointer_cast<itti_s5s8_modify_bearer_request>(
-                shared_msg));
-        break;
-
-      case S5S8_RELEASE_ACCESS_BEARERS_REQUEST:
-        pgw_app_inst->handle_itti_msg(
-            std::static_pointer_cast<itti_s5s8_release_access_bearers_request>(
-                shared_msg));
-        break;
-
-      case S5S8_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE:
-        if (itti_s5s8_downlink_data_notification_acknowledge* m =
-                dynamic_cast<itti_s5s8_downlink_data_notification_acknowledge*>(
-                    msg)) {
-          pgw_app_inst->handle_itti_msg(std::ref(*m));
-        }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::pgwc_app().trace("TIME-OUT event timer id %d", to->timer_id);
-          switch (to->arg1_user) {
-            case kTriggerAssociationUpNodes:
-              PfcpUpNodes::Instance().TriggerAssociations();
-              break;
-            default:
-              Logger::pgwc_app().error(
-                  "TIME-OUT event timer id %d not handled", to->timer_id);
-          }
+  itti_dispatcher dispatcher(task_id, Logger::pgwc_app());
+  dispatcher
+      .on_each<
+          SXAB_SESSION_ESTABLISHMENT_RESPONSE,
+          SXAB_SESSION_MODIFICATION_RESPONSE,
+          SXAB_SESSION_DELETION_RESPONSE,
+          SXAB_REMOTE_PEER_NOT_RESPONDING,
+          S5S8_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE,
+          RESTORE_SX_SESSIONS>(
+          [](auto m) { pgw_app_inst->handle_itti_msg(std::ref(*m)); })
+      .on_each<
+          SXAB_SESSION_REPORT_REQUEST,
+          S5S8_CREATE_SESSION_REQUEST,
+          S5S8_DELETE_SESSION_REQUEST,
+          S5S8_MODIFY_BEARER_REQUEST,
+          S5S8_RELEASE_ACCESS_BEARERS_REQUEST>(
+          [](auto m) { pgw_app_inst->handle_itti_msg(m); })
+      .on<TIME_OUT>([](auto to) {
+        Logger::pgwc_app().trace("TIME-OUT event timer id %d", to->timer_id);
+        switch (to->arg1_user) {
+          case kTriggerAssociationUpNodes:
+            PfcpUpNodes::Instance().TriggerAssociations();
+            break;
+          default:
+            Logger::pgwc_app().error(
+                "TIME-OUT event timer id %d not handled", to->timer_id);
         }
-        break;
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::pgwc_app().info("Received terminate message");
-          return;
-        }
-      case HEALTH_PING:
-        break;
-      default:
-        Logger::pgwc_app().info("no handler for msg type %d", msg->msg_type);
-    }
-  } while (true);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
 }
 
 //------------------------------------------------------------------------------
-pgw_app::pgw_app(const std::string& config_file)
-    : m_s5s8_cp_teid_generator(),
-      m_imsi2pgw_context(),
-      m_s5s8lteid2pgw_context(),
-      m_seid2pgw_context() {
+pgw_app::pgw_app(const std::string& config_file) : shards() {
   Logger::pgwc_app().startup("Starting...");
 
-  teid_s5s8_cp_generator = 0;
-  imsi2pgw_context       = {};
-  s5s8lteid2pgw_context  = {};
-  s5s8cplteid            = {};
-
   apply_config();
 
-  if (itti_inst->create_task(TASK_PGWC_APP, pgw_app_task, nullptr)) {
-    Logger::pgwc_app().error("Cannot create task TASK_PGWC_APP");
-    throw std::runtime_error("Cannot create task TASK_PGWC_APP");
+  // Worker 0 is TASK_PGWC_APP, it also handles the PFCP association timers
+  for (uint32_t shard = 0; shard < get_num_workers(); shard++) {
+    if (itti_inst->create_task(
+            shard_2_task(shard), pgw_app_task, (void*) (uintptr_t) shard)) {
+      Logger::pgwc_app().error("Cannot create task TASK_PGWC_APP %u", shard);
+      throw std::runtime_error("Cannot create task TASK_PGWC_APP");
+    }
   }
+  Logger::pgwc_app().info("Started %u worker(s)", get_num_workers());
 
   try {
     pgw_s5s8_inst  = new pgw_s5s8();
@@ -337,8 +350,8 @@ void pgw_app::start_up_association(const pfcp::node_id_t& node_id) {
 
   pfcp_associations::get_instance().add_peer_candidate_node(node_id);
   std::shared_ptr<itti_sxab_association_setup_request> sxa_asc =
-      std::shared_ptr<itti_sxab_association_setup_request>(
-          new itti_sxab_association_setup_request(TASK_PGWC_APP, TASK_PGWC_SX));
+      itti_msg_shared(new itti_sxab_association_setup_request(
+          TASK_PGWC_APP, TASK_PGWC_SX));
   pfcp::cp_function_features_s cp_function_features;
   cp_function_features      = {};
   cp_function_features.load = 1;
@@ -417,7 +430,7 @@ void pgw_app::send_create_session_response_cause(
   s5s8->r_endpoint = r_endpoint;
   s5s8->gtp_ies.set(cause);
   std::shared_ptr<itti_s5s8_create_session_response> msg =
-      std::shared_ptr<itti_s5s8_create_session_response>(s5s8);
+      itti_msg_shared(s5s8);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::pgwc_app().error(
@@ -442,7 +455,7 @@ void pgw_app::send_delete_session_response_cause_request_accepted(
   s5s8->r_endpoint = r_endpoint;
   s5s8->gtp_ies.set(cause);
   std::shared_ptr<itti_s5s8_delete_session_response> msg =
-      std::shared_ptr<itti_s5s8_delete_session_response>(s5s8);
+      itti_msg_shared(s5s8);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::pgwc_app().error(
@@ -465,8 +478,7 @@ void pgw_app::send_modify_bearer_response_cause_context_not_found(
   s5s8->teid       = teid;
   s5s8->r_endpoint = r_endpoint;
   s5s8->gtp_ies.set(cause);
-  std::shared_ptr<itti_s5s8_modify_bearer_response> msg =
-      std::shared_ptr<itti_s5s8_modify_bearer_response>(s5s8);
+  std::shared_ptr<itti_s5s8_modify_bearer_response> msg = itti_msg_shared(s5s8);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::pgwc_app().error(
@@ -490,7 +502,7 @@ void pgw_app::send_delete_session_response_cause_context_not_found(
   s5s8->r_endpoint = r_endpoint;
   s5s8->gtp_ies.set(cause);
   std::shared_ptr<itti_s5s8_delete_session_response> msg =
-      std::shared_ptr<itti_s5s8_delete_session_response>(s5s8);
+      itti_msg_shared(s5s8);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::pgwc_app().error(
@@ -515,7 +527,7 @@ void pgw_app::send_release_access_bearers_response_cause_context_not_found(
   s5s8->r_endpoint = r_endpoint;
   s5s8->gtp_ies.set(cause);
   std::shared_ptr<itti_s5s8_release_access_bearers_response> msg =
-      std::shared_ptr<itti_s5s8_release_access_bearers_response>(s5s8);
+      itti_msg_shared(s5s8);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::pgwc_app().error(
@@ -540,7 +552,7 @@ void pgw_app::send_release_access_bearers_response_cause_request_accepted(
   s5s8->r_endpoint = r_endpoint;
   s5s8->gtp_ies.set(cause);
   std::shared_ptr<itti_s5s8_release_access_bearers_response> msg =
-      std::shared_ptr<itti_s5s8_release_access_bearers_response>(s5s8);
+      itti_msg_shared(s5s8);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::pgwc_app().error(
@@ -624,7 +636,8 @@ void pgw_app::handle_itti_msg(
       if (is_imsi64_2_pgw_context(imsi64)) {
         pc = imsi64_2_pgw_context(imsi64);
       } else {
-        pc = std::shared_ptr<pgw_context>(new pgw_context());
+        pc        = std::shared_ptr<pgw_context>(new pgw_context());
+        pc->shard = imsi64_2_shard(imsi64);
         set_imsi64_2_pgw_context(imsi64, pc);
       }
     }
@@ -843,6 +856,23 @@ void pgw_app::handle_itti_msg(itti_sxab_session_deletion_response& smresp) {
   }
 }
 
+//------------------------------------------------------------------------------
+void pgw_app::handle_itti_msg(itti_sxab_remote_peer_not_responding& rpnr) {
+  std::shared_ptr<pgw_context> pc = {};
+  if (seid_2_pgw_context(rpnr.seid, pc)) {
+    pc.get()->handle_itti_msg(rpnr);
+
+    if (pc->apns.size() == 0) {
+      delete_pgw_context(pc);
+    }
+  } else {
+    Logger::pgwc_app().debug(
+        "SXAB REMOTE PEER NOT RESPONDING seid " SEID_FMT "  pfcp_tx_id %" PRIX64
+        ", pgw_context not found, discarded!",
+        rpnr.seid, rpnr.trxn_id);
+  }
+}
+
 //------------------------------------------------------------------------------
 void pgw_app::handle_itti_msg(
     std::shared_ptr<itti_sxab_session_report_request> snr) {
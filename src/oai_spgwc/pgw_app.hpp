@@ -30,6 +30,7 @@
 
 #include "3gpp_29.274.h"
 #include "itti_msg_s5s8.hpp"
+#include "itti_msg_sx_restore.hpp"
 #include "itti_msg_sxab.hpp"
 #include "pgw_context.hpp"
 #include "pgw_pco.hpp"
@@ -55,11 +56,13 @@ enum LivenessEventType {
 // zzz;
 class pgw_config;  // same namespace
 
-class pgw_app {
- private:
-  std::thread::id thread_id;
-  std::thread thread;
-  // teid generators (linear)
+// Contexts of the subscribers handled by one worker of pgw_app. The local
+// S5S8 control plane TEIDs (and the SEIDs derived from them) of a shard are
+// congruent to its index modulo the number of workers, so that any message
+// can be routed to its worker from its TEID or SEID alone.
+class pgw_app_shard {
+ public:
+  // teid generator (linear, by steps of the number of workers)
   teid_t teid_s5s8_cp_generator;
 
   std::map<imsi64_t, std::shared_ptr<pgw_context>> imsi2pgw_context;
@@ -68,15 +71,37 @@ class pgw_app {
 
   std::set<teid_t> s5s8cplteid;
 
-  std::mutex m_s5s8_cp_teid_generator;
+  // guards teid_s5s8_cp_generator and s5s8cplteid
+  mutable std::mutex m_s5s8_cp_teid_generator;
 
   mutable std::shared_mutex m_imsi2pgw_context;
   mutable std::shared_mutex m_s5s8lteid2pgw_context;
   mutable std::shared_mutex m_seid2pgw_context;
 
+  pgw_app_shard()
+      : teid_s5s8_cp_generator(0),
+        imsi2pgw_context(),
+        s5s8lteid2pgw_context(),
+        seid2pgw_context(),
+        s5s8cplteid(),
+        m_s5s8_cp_teid_generator(),
+        m_imsi2pgw_context(),
+        m_s5s8lteid2pgw_context(),
+        m_seid2pgw_context() {}
+  pgw_app_shard(pgw_app_shard const&) = delete;
+  void operator=(pgw_app_shard const&) = delete;
+};
+
+class pgw_app {
+ private:
+  std::thread::id thread_id;
+  std::thread thread;
+
+  pgw_app_shard shards[TASK_PGWC_APP_MAX_WORKERS];
+
   int apply_config();
 
-  teid_t generate_s5s8_cp_teid();
+  teid_t generate_s5s8_cp_teid(const uint32_t shard);
   void free_s5s8c_teid(const teid_t& teid_s5s8_cp);
   bool is_s5s8c_teid_exist(const teid_t& teid_s5s8_cp) const;
   // teid_t generate_s5s8_up_teid();
@@ -110,6 +135,29 @@ class pgw_app {
   pgw_app(pgw_app const&) = delete;
   void operator=(pgw_app const&) = delete;
 
+  /** \brief Number of workers (ITTI tasks TASK_PGWC_APP and following)
+   *  sharing the subscribers, from the spgw_app/worker_threads setting
+   **/
+  static uint32_t get_num_workers();
+  static uint32_t imsi64_2_shard(const imsi64_t& imsi64);
+  static uint32_t teid_2_shard(const teid_t& teid);
+  static uint32_t seid_2_shard(const seid_t& seid);
+  static task_id_t shard_2_task(const uint32_t shard) {
+    return (task_id_t)(TASK_PGWC_APP + shard);
+  }
+  static task_id_t teid_2_task(const teid_t& teid) {
+    return shard_2_task(teid_2_shard(teid));
+  }
+  static task_id_t seid_2_task(const seid_t& seid) {
+    return shard_2_task(seid_2_shard(seid));
+  }
+  /** \brief Worker handling a CREATE_SESSION_REQUEST: the one owning the
+   *  IMSI if any, else the one owning the destination TEID
+   **/
+  static task_id_t create_session_request_2_task(
+      const teid_t& teid,
+      const gtpv2c::gtpv2c_create_session_request& gtp_ies);
+
   void send_create_session_response_cause(
       const uint64_t gtpc_tx_id, const teid_t teid, const endpoint& r_endpoint,
       const cause_t& cause) const;
@@ -131,7 +179,8 @@ class pgw_app {
 
   fteid_t build_s5s8_cp_fteid(
       const struct in_addr ipv4_address, const teid_t teid);
-  fteid_t generate_s5s8_cp_fteid(const struct in_addr ipv4_address);
+  fteid_t generate_s5s8_cp_fteid(
+      const uint32_t shard, const struct in_addr ipv4_address);
   void free_s5s8_cp_fteid(const fteid_t& fteid);
   void set_s5s8cpgw_fteid_2_pgw_context(
       fteid_t& rs5s8_fteid, std::shared_ptr<pgw_context> spc);
@@ -169,8 +218,10 @@ class pgw_app {
   void handle_itti_msg(itti_sxab_session_establishment_response& m);
   void handle_itti_msg(itti_sxab_session_modification_response& m);
   void handle_itti_msg(itti_sxab_session_deletion_response& m);
+  void handle_itti_msg(itti_sxab_remote_peer_not_responding& m);
   void handle_itti_msg(std::shared_ptr<itti_sxab_session_report_request> snr);
   void handle_itti_msg(itti_sxab_association_setup_request& m);
+  void handle_itti_msg(itti_sx_restore& m);
 
   void restore_sx_sessions(const seid_t& seid) const;
   void start_up_association(const pfcp::node_id_t& node_id);
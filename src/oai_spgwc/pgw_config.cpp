@@ -148,6 +148,20 @@ const bool pgw_config::ParseTimer(
     const RAPIDJSON_NAMESPACE::Value& conf, timer_cfg_t& cfg) {
   if (conf.HasMember("itti")) {
     const RAPIDJSON_NAMESPACE::Value& itti_section = conf["itti"];
+    if (itti_section.HasMember("slack_ms")) {
+      if (!itti_section["slack_ms"].IsUint()) {
+        Logger::pgwc_app().error("Error parsing json value: itti/slack_ms");
+        return false;
+      }
+      cfg.slack_ms = itti_section["slack_ms"].GetUint();
+    }
+    if (itti_section.HasMember("mailbox_size")) {
+      if (!itti_section["mailbox_size"].IsUint()) {
+        Logger::pgwc_app().error("Error parsing json value: itti/mailbox_size");
+        return false;
+      }
+      cfg.mailbox_size = itti_section["mailbox_size"].GetUint();
+    }
     if (itti_section.HasMember("sched_params")) {
       const RAPIDJSON_NAMESPACE::Value& sched_section =
           itti_section["sched_params"];
@@ -237,11 +251,9 @@ bool pgw_config::ParseJson() {
 
   if (doc.HasMember("timer")) {
     const RAPIDJSON_NAMESPACE::Value& timer_section = doc["timer"];
-    if (timer_section.HasMember("timer")) {
-      if (!ParseTimer(doc["timer"], timer_)) {
-        Logger::pgwc_app().error("Failed to parse json timer");
-        return false;
-      }
+    if (!ParseTimer(timer_section, timer_)) {
+      Logger::pgwc_app().error("Failed to parse json timer");
+      return false;
     }
   }
   if (doc.HasMember("gtpv2c")) {
@@ -274,15 +286,48 @@ bool pgw_config::ParseJson() {
         return false;
       }
       gtpv2c_.worker_threads = gtpv2c_section["worker_threads"].GetUint();
+      if (gtpv2c_.worker_threads < 1) {
+        Logger::pgwc_app().error("gtpv2c/worker_threads must be at least 1");
+        return false;
+      }
+    }
+    if (gtpv2c_section.HasMember("udp_batch_size")) {
+      if (!gtpv2c_section["udp_batch_size"].IsInt()) {
+        Logger::pgwc_app().error(
+            "Error parsing json value: gtpv2c/udp_batch_size");
+        return false;
+      }
+      gtpv2c_.udp_batch_size = gtpv2c_section["udp_batch_size"].GetUint();
+      if ((gtpv2c_.udp_batch_size < 1) ||
+          (gtpv2c_.udp_batch_size > UDP_MAX_BATCH_SIZE)) {
+        Logger::pgwc_app().error(
+            "gtpv2c/udp_batch_size must be in [1..%d]", UDP_MAX_BATCH_SIZE);
+        return false;
+      }
+    }
+    if (gtpv2c_section.HasMember("use_io_uring")) {
+      if (!gtpv2c_section["use_io_uring"].IsBool()) {
+        Logger::pgwc_app().error(
+            "Error parsing json value: gtpv2c/use_io_uring");
+        return false;
+      }
+      gtpv2c_.use_io_uring = gtpv2c_section["use_io_uring"].GetBool();
     }
     if (gtpv2c_section.HasMember("max_concurrent_procedures")) {
-      if (!gtpv2c_section["max_concurrent_procedures"].IsInt()) {
+      if (!gtpv2c_section["max_concurrent_procedures"].IsUint()) {
         Logger::pgwc_app().error(
             "Error parsing json value: gtpv2c/max_concurrent_procedures");
         return false;
       }
       gtpv2c_.max_concurrent_procedures =
           gtpv2c_section["max_concurrent_procedures"].GetUint();
+      if ((gtpv2c_.max_concurrent_procedures < 1) ||
+          (gtpv2c_.max_concurrent_procedures > PGW_MAX_CONCURRENT_PROCEDURES)) {
+        Logger::pgwc_app().error(
+            "gtpv2c/max_concurrent_procedures must be in [1..%u]",
+            PGW_MAX_CONCURRENT_PROCEDURES);
+        return false;
+      }
     }
 
     if (gtpv2c_section.HasMember("sched_params")) {
@@ -325,15 +370,48 @@ bool pgw_config::ParseJson() {
         return false;
       }
       pfcp_.worker_threads = pfcp_section["worker_threads"].GetUint();
+      if (pfcp_.worker_threads < 1) {
+        Logger::pgwc_app().error("pfcp/worker_threads must be at least 1");
+        return false;
+      }
+    }
+    if (pfcp_section.HasMember("udp_batch_size")) {
+      if (!pfcp_section["udp_batch_size"].IsInt()) {
+        Logger::pgwc_app().error(
+            "Error parsing json value: pfcp/udp_batch_size");
+        return false;
+      }
+      pfcp_.udp_batch_size = pfcp_section["udp_batch_size"].GetUint();
+      if ((pfcp_.udp_batch_size < 1) ||
+          (pfcp_.udp_batch_size > UDP_MAX_BATCH_SIZE)) {
+        Logger::pgwc_app().error(
+            "pfcp/udp_batch_size must be in [1..%d]", UDP_MAX_BATCH_SIZE);
+        return false;
+      }
+    }
+    if (pfcp_section.HasMember("use_io_uring")) {
+      if (!pfcp_section["use_io_uring"].IsBool()) {
+        Logger::pgwc_app().error(
+            "Error parsing json value: pfcp/use_io_uring");
+        return false;
+      }
+      pfcp_.use_io_uring = pfcp_section["use_io_uring"].GetBool();
     }
     if (pfcp_section.HasMember("max_concurrent_procedures")) {
-      if (!pfcp_section["max_concurrent_procedures"].IsInt()) {
+      if (!pfcp_section["max_concurrent_procedures"].IsUint()) {
         Logger::pgwc_app().error(
             "Error parsing json value: pfcp/max_concurrent_procedures");
         return false;
       }
       pfcp_.max_concurrent_procedures =
           pfcp_section["max_concurrent_procedures"].GetUint();
+      if ((pfcp_.max_concurrent_procedures < 1) ||
+          (pfcp_.max_concurrent_procedures > PGW_MAX_CONCURRENT_PROCEDURES)) {
+        Logger::pgwc_app().error(
+            "pfcp/max_concurrent_procedures must be in [1..%u]",
+            PGW_MAX_CONCURRENT_PROCEDURES);
+        return false;
+      }
     }
     if (pfcp_section.HasMember("sched_params")) {
       const RAPIDJSON_NAMESPACE::Value& sched_section =
@@ -381,6 +459,14 @@ bool pgw_config::ParseJson() {
             "Error parsing json value: spgw_app/worker_threads");
         return false;
       }
+      spgw_app_.worker_threads = spgw_app_section["worker_threads"].GetUint();
+      if ((spgw_app_.worker_threads < 1) ||
+          (spgw_app_.worker_threads > TASK_PGWC_APP_MAX_WORKERS)) {
+        Logger::pgwc_app().error(
+            "spgw_app/worker_threads must be in [1..%d]",
+            TASK_PGWC_APP_MAX_WORKERS);
+        return false;
+      }
     }
     if (spgw_app_section.HasMember("sched_params")) {
       const RAPIDJSON_NAMESPACE::Value& sched_section =
@@ -593,6 +679,15 @@ bool pgw_config::ParseJson() {
             util::trim(prefix);
             // pdn_cfg.paa_pool6_prefix_len.push_back(std::stoi(prefix));
             pdn_cfg.paa_pool6_prefix_len = std::stoi(prefix);
+            // a /64 prefix is given to each UE
+            if ((pdn_cfg.paa_pool6_prefix_len < 1) ||
+                (pdn_cfg.paa_pool6_prefix_len > 64)) {
+              Logger::pgwc_app().error(
+                  "Bad prefix length in pdns/[ipv6_prefix] %d nth item, "
+                  "expected 1..64",
+                  i);
+              return false;
+            }
             if (pdn_cfg.pdn_type == PDN_TYPE_E_IPV4) {
               pdn_cfg.pdn_type = PDN_TYPE_E_IPV4V6;
             } else if (pdn_cfg.pdn_type.pdn_type != PDN_TYPE_E_IPV4V6) {
@@ -772,6 +867,9 @@ void pgw_config::Display() {
   Logger::pgwc_app().info("    N3 ...............: %u", gtpv2c_.n3);
   Logger::pgwc_app().info("    T3 ...............: %u ms", gtpv2c_.t3_ms);
   Logger::pgwc_app().info("    workers ..........: %u", gtpv2c_.worker_threads);
+  Logger::pgwc_app().info("    UDP batch ........: %u", gtpv2c_.udp_batch_size);
+  Logger::pgwc_app().info(
+      "    io_uring .........: %s", gtpv2c_.use_io_uring ? "true" : "false");
   Logger::pgwc_app().info(
       "    max procedures ...: %u", gtpv2c_.max_concurrent_procedures);
   Logger::pgwc_app().info("    Threading:");
@@ -786,6 +884,9 @@ void pgw_config::Display() {
   Logger::pgwc_app().info("    N1 ...............: %u", pfcp_.n1);
   Logger::pgwc_app().info("    T1 ...............: %u ms", pfcp_.t1_ms);
   Logger::pgwc_app().info("    workers ..........: %u", pfcp_.worker_threads);
+  Logger::pgwc_app().info("    UDP batch ........: %u", pfcp_.udp_batch_size);
+  Logger::pgwc_app().info(
+      "    io_uring .........: %s", pfcp_.use_io_uring ? "true" : "false");
   Logger::pgwc_app().info(
       "    max procedures ...: %u", pfcp_.max_concurrent_procedures);
   Logger::pgwc_app().info("    Threading:");
@@ -797,6 +898,8 @@ void pgw_config::Display() {
       "        Sched prio ...: %d", pfcp_.sched_params.sched_priority);
   Logger::pgwc_app().info("- Timers :");
   Logger::pgwc_app().info("    ITTI implementation:");
+  Logger::pgwc_app().info("        Slack ........: %u ms", timer_.slack_ms);
+  Logger::pgwc_app().info("        Mailbox size .: %u", timer_.mailbox_size);
   Logger::pgwc_app().info(
       "        CPU id .......: %d", timer_.sched_params.cpu_id);
   Logger::pgwc_app().info(
@@ -805,6 +908,8 @@ void pgw_config::Display() {
       "        Sched prio ...: %d", timer_.sched_params.sched_priority);
   Logger::pgwc_app().info("- SPGW-C APP :");
   Logger::pgwc_app().info("    Threading:");
+  Logger::pgwc_app().info(
+      "        Workers ......: %u", spgw_app_.worker_threads);
   Logger::pgwc_app().info(
       "        CPU id .......: %d", spgw_app_.sched_params.cpu_id);
   Logger::pgwc_app().info(
@@ -47,11 +47,19 @@
 #include "thread_sched.hpp"
 
 #define PGW_MAX_ALLOCATED_PDN_ADDRESSES 1024
+// Procedures are found by the low bits of their 24 bits GTPv2-C or PFCP
+// sequence number, at least 4 bits are left to tell apart reuses of a slot.
+#define PGW_MAX_CONCURRENT_PROCEDURES (1 << 20)
+#define PGW_DEFAULT_CONCURRENT_PROCEDURES 16384
 
 namespace pgwc {
 
 typedef struct timer_cfg_s {
   util::thread_sched_params sched_params;
+  // ITTI timer expiries within this window are coalesced in one wake up
+  uint32_t slack_ms;
+  // capacity of the message ring of each ITTI task
+  uint32_t mailbox_size;
 } timer_cfg_t;
 
 typedef struct gtpv2c_cfg_s {
@@ -59,8 +67,12 @@ typedef struct gtpv2c_cfg_s {
   uint16_t n3;
   uint16_t t3_ms;
   uint16_t worker_threads;
+  // datagrams per recvmmsg()/sendmmsg() call, 1 for recvfrom()/sendto()
+  uint16_t udp_batch_size;
+  // io_uring socket I/O if the kernel supports it
+  bool use_io_uring;
   util::thread_sched_params sched_params;
-  uint16_t max_concurrent_procedures;
+  uint32_t max_concurrent_procedures;
 } gtpv2c_cfg_t;
 
 typedef struct pfcp_cfg_s {
@@ -68,8 +80,12 @@ typedef struct pfcp_cfg_s {
   uint16_t n1;
   uint16_t t1_ms;
   uint16_t worker_threads;
+  // datagrams per recvmmsg()/sendmmsg() call, 1 for recvfrom()/sendto()
+  uint16_t udp_batch_size;
+  // io_uring socket I/O if the kernel supports it
+  bool use_io_uring;
   util::thread_sched_params sched_params;
-  uint16_t max_concurrent_procedures;
+  uint32_t max_concurrent_procedures;
 } pfcp_cfg_t;
 
 typedef struct interface_cfg_s {
@@ -127,6 +143,7 @@ typedef struct itti_cfg_s {
 } itti_cfg_t;
 
 typedef struct pgw_app_cfg_s {
+  uint16_t worker_threads;
   util::thread_sched_params sched_params;
   struct in_addr default_dnsv4;
   struct in_addr default_dns_secv4;
@@ -208,24 +225,30 @@ class pgw_config {
     timer_.sched_params.cpu_id         = -1;
     timer_.sched_params.sched_policy   = SCHED_FIFO;
     timer_.sched_params.sched_priority = 46;
+    timer_.slack_ms                    = 1;
+    timer_.mailbox_size                = 8192;
 
     gtpv2c_.port                        = gtpv2c::default_port;
     gtpv2c_.n3                          = 3;
     gtpv2c_.t3_ms                       = 1000;
     gtpv2c_.worker_threads              = 1;
+    gtpv2c_.udp_batch_size              = 1;
+    gtpv2c_.use_io_uring                = false;
     gtpv2c_.sched_params.cpu_id         = -1;
     gtpv2c_.sched_params.sched_policy   = SCHED_FIFO;
     gtpv2c_.sched_params.sched_priority = 40;
-    gtpv2c_.max_concurrent_procedures   = 256;
+    gtpv2c_.max_concurrent_procedures   = PGW_DEFAULT_CONCURRENT_PROCEDURES;
 
     pfcp_.port                        = pfcp::default_port;
     pfcp_.n1                          = 3;
     pfcp_.t1_ms                       = 1000;
     pfcp_.worker_threads              = 1;
+    pfcp_.udp_batch_size              = 1;
+    pfcp_.use_io_uring                = false;
     pfcp_.sched_params.cpu_id         = -1;
     pfcp_.sched_params.sched_policy   = SCHED_FIFO;
     pfcp_.sched_params.sched_priority = 42;
-    pfcp_.max_concurrent_procedures   = 256;
+    pfcp_.max_concurrent_procedures   = PGW_DEFAULT_CONCURRENT_PROCEDURES;
 
     s11_.iface.if_name         = "lo";
     s11_.iface.addr4.s_addr    = INADDR_ANY;
@@ -247,6 +270,7 @@ class pgw_config {
     sx_.iface.network4.s_addr = INADDR_ANY;
     sx_.iface.addr6           = in6addr_any;
 
+    spgw_app_.worker_threads                           = 1;
     spgw_app_.sched_params.cpu_id                      = -1;
     spgw_app_.sched_params.sched_policy                = SCHED_FIFO;
     spgw_app_.sched_params.sched_priority              = 44;
@@ -176,14 +176,17 @@ void pgw_pdn_connection::remove_eps_bearer(pgw_eps_bearer& bearer) {
 }
 
 //------------------------------------------------------------------------------
-void pgw_pdn_connection::deallocate_ressources(const std::string& apn) {
+void pgw_pdn_connection::deallocate_ressources(const int32_t paa_pools) {
   for (std::map<uint8_t, pgw_eps_bearer>::iterator it = eps_bearers.begin();
        it != eps_bearers.end(); ++it) {
     it->second.deallocate_ressources();
   }
   eps_bearers.clear();
   if (ipv4) {
-    paa_dynamic::get_instance().release_paa(apn, ipv4_address);
+    paa_dynamic::get_instance().release_paa(paa_pools, ipv4_address);
+  }
+  if (ipv6) {
+    paa_dynamic::get_instance().release_paa(paa_pools, ipv6_address);
   }
   pgw_app_inst->free_s5s8_cp_fteid(pgw_fteid_s5_s8_cp);
   clear();
@@ -298,14 +301,14 @@ bool apn_context::find_pdn_connection(
 void apn_context::delete_pdn_connection(
     std::shared_ptr<pgw_pdn_connection>& pdn_connection) {
   if (pdn_connection.get()) {
-    pdn_connection->deallocate_ressources(apn_in_use);
+    pdn_connection->deallocate_ressources(paa_pools);
     // remove it from collection
     std::unique_lock<std::recursive_mutex> lock(m_context);
     for (std::vector<std::shared_ptr<pgw_pdn_connection>>::iterator it =
              pdn_connections.begin();
          it != pdn_connections.end(); ++it) {
       if (pdn_connection.get() == (*it).get()) {
-        pdn_connection->deallocate_ressources(apn_in_use);
+        pdn_connection->deallocate_ressources(paa_pools);
         pdn_connections.erase(it);
         return;
       }
@@ -318,7 +321,7 @@ void apn_context::deallocate_ressources() {
   for (std::vector<std::shared_ptr<pgw_pdn_connection>>::iterator it =
            pdn_connections.begin();
        it != pdn_connections.end(); ++it) {
-    (*it)->deallocate_ressources(apn_in_use);
+    (*it)->deallocate_ressources(paa_pools);
   }
   pdn_connections.clear();
   in_use   = false;
@@ -485,7 +488,7 @@ void pgw_context::handle_itti_msg(
   itti_s5s8_create_session_response* s5s8 =
       new itti_s5s8_create_session_response(TASK_PGWC_APP, TASK_PGWC_S5S8);
   std::shared_ptr<itti_s5s8_create_session_response> s5_triggered_pending =
-      std::shared_ptr<itti_s5s8_create_session_response>(s5s8);
+      itti_msg_shared(s5s8);
 
   csreq->gtp_ies.get(imsi);
   indication_t indication = {};
@@ -499,6 +502,7 @@ void pgw_context::handle_itti_msg(
     apn_context* a = new (apn_context);
     a->in_use      = true;
     a->apn_in_use  = csreq->gtp_ies.apn.access_point_name;
+    a->paa_pools   = paa_dynamic::get_instance().get_apn_handle(a->apn_in_use);
     if (csreq->gtp_ies.ie_presence_mask &
         GTPV2C_CREATE_SESSION_REQUEST_PR_IE_APN_AMBR) {
       a->apn_ambr = csreq->gtp_ies.ambr;
@@ -521,7 +525,7 @@ void pgw_context::handle_itti_msg(
         csreq->gtp_ies.bearer_contexts_to_be_created.at(0).eps_bearer_id;
     p->sgw_fteid_s5_s8_cp = csreq->gtp_ies.sender_fteid_for_cp;
     p->pgw_fteid_s5_s8_cp = pgw_app_inst->generate_s5s8_cp_fteid(
-        pgwc::pgw_config::pgw_s5s8_.iface.addr4);
+        shard, pgwc::pgw_config::pgw_s5s8_.iface.addr4);
     pgw_app_inst->set_s5s8cpgw_fteid_2_pgw_context(
         p->pgw_fteid_s5_s8_cp, shared_from_this());
     sp = std::shared_ptr<pgw_pdn_connection>(p);
@@ -625,8 +629,8 @@ void pgw_context::handle_itti_msg(
       if (!pco_ids.ci_ipv4_address_allocation_via_dhcpv4) {
         bool paa_res = csreq->gtp_ies.get(paa);
         if ((not paa_res) || (not paa.is_ip_assigned())) {
-          bool success =
-              paa_dynamic::get_instance().get_free_paa(sa->apn_in_use, paa);
+          bool success = paa_dynamic::get_instance().get_free_paa(
+              shard, sa->paa_pools, paa);
           if (success) {
             set_paa = true;
           } else {
@@ -646,8 +650,8 @@ void pgw_context::handle_itti_msg(
     case PDN_TYPE_E_IPV6: {
       bool paa_res = csreq->gtp_ies.get(paa);
       if ((not paa_res) || (not paa.is_ip_assigned())) {
-        bool success =
-            paa_dynamic::get_instance().get_free_paa(sa->apn_in_use, paa);
+        bool success = paa_dynamic::get_instance().get_free_paa(
+            shard, sa->paa_pools, paa);
         if (success) {
           set_paa = true;
         } else {
@@ -663,8 +667,8 @@ void pgw_context::handle_itti_msg(
     case PDN_TYPE_E_IPV4V6: {
       bool paa_res = csreq->gtp_ies.get(paa);
       if ((not paa_res) || (not paa.is_ip_assigned())) {
-        bool success =
-            paa_dynamic::get_instance().get_free_paa(sa->apn_in_use, paa);
+        bool success = paa_dynamic::get_instance().get_free_paa(
+            shard, sa->paa_pools, paa);
         if (success) {
           set_paa = true;
         } else {
@@ -737,12 +741,22 @@ void pgw_context::handle_itti_msg(
     if (s5s8->gtp_ies.get(free_paa)) {
       switch (sp->pdn_type.pdn_type) {
         case PDN_TYPE_E_IPV4:
+          paa_dynamic::get_instance().release_paa(
+              sa->paa_pools, free_paa.ipv4_address);
+          break;
+
         case PDN_TYPE_E_IPV4V6:
           paa_dynamic::get_instance().release_paa(
-              sa->apn_in_use, free_paa.ipv4_address);
+              sa->paa_pools, free_paa.ipv4_address);
+          paa_dynamic::get_instance().release_paa(
+              sa->paa_pools, free_paa.ipv6_address);
           break;
 
         case PDN_TYPE_E_IPV6:
+          paa_dynamic::get_instance().release_paa(
+              sa->paa_pools, free_paa.ipv6_address);
+          break;
+
         case PDN_TYPE_E_NON_IP:
         default:;
       }
@@ -801,7 +815,7 @@ void pgw_context::handle_itti_msg(
       itti_s5s8_delete_session_response* s5s8 =
           new itti_s5s8_delete_session_response(TASK_PGWC_APP, TASK_PGWC_S5S8);
       std::shared_ptr<itti_s5s8_delete_session_response> s5_triggered_pending =
-          std::shared_ptr<itti_s5s8_delete_session_response>(s5s8);
+          itti_msg_shared(s5s8);
       //------
       // GTPV2C-Stack
       //------
@@ -877,7 +891,7 @@ void pgw_context::handle_itti_msg(
       itti_s5s8_modify_bearer_response* s5s8 =
           new itti_s5s8_modify_bearer_response(TASK_PGWC_APP, TASK_PGWC_S5S8);
       std::shared_ptr<itti_s5s8_modify_bearer_response> s5_triggered_pending =
-          std::shared_ptr<itti_s5s8_modify_bearer_response>(s5s8);
+          itti_msg_shared(s5s8);
       //------
       // GTPV2C-Stack
       //------
@@ -924,9 +938,7 @@ void pgw_context::handle_itti_msg(
             new itti_s5s8_release_access_bearers_response(
                 TASK_PGWC_APP, TASK_PGWC_S5S8);
         std::shared_ptr<itti_s5s8_release_access_bearers_response>
-            s5_triggered_pending =
-                std::shared_ptr<itti_s5s8_release_access_bearers_response>(
-                    s5s8);
+            s5_triggered_pending = itti_msg_shared(s5s8);
         //------
         // GTPV2C-Stack
         //------
@@ -1015,6 +1027,23 @@ void pgw_context::handle_itti_msg(itti_sxab_session_deletion_response& sdresp) {
   std::cout << toString() << std::endl;
 }
 //------------------------------------------------------------------------------
+void pgw_context::handle_itti_msg(itti_sxab_remote_peer_not_responding& rpnr) {
+  std::shared_ptr<pgw_procedure> proc = {};
+  if (find_procedure(rpnr.trxn_id, proc)) {
+    Logger::pgwc_app().warn(
+        "SXAB REMOTE PEER NOT RESPONDING to msg type %d seid " SEID_FMT
+        "  pfcp_tx_id %" PRIX64 ", pgw_procedure aborted",
+        rpnr.message_type, rpnr.seid, rpnr.trxn_id);
+    proc->handle_itti_msg(rpnr);
+    remove_procedure(proc.get());
+  } else {
+    Logger::pgwc_app().debug(
+        "SXAB REMOTE PEER NOT RESPONDING seid " SEID_FMT "  pfcp_tx_id %" PRIX64
+        ", pgw_procedure not found, discarded!",
+        rpnr.seid, rpnr.trxn_id);
+  }
+}
+//------------------------------------------------------------------------------
 void pgw_context::handle_itti_msg(
     std::shared_ptr<itti_sxab_session_report_request>& req) {
   pfcp::report_type_t report_type;
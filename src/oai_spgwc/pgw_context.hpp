@@ -177,7 +177,7 @@ class pgw_pdn_connection
   // deletion of object instances cannot be always guaranteed when removing them
   // from a collection, so that is why actually the deallocation of resources is
   // not done in the destructor of objects.
-  void deallocate_ressources(const std::string& apn);
+  void deallocate_ressources(const int32_t paa_pools);
 
   std::string toString() const;
 
@@ -267,7 +267,8 @@ class pgw_pdn_connection
 
 class apn_context {
  public:
-  apn_context() : m_context(), in_use(false), pdn_connections() {
+  apn_context()
+      : m_context(), in_use(false), paa_pools(-1), pdn_connections() {
     apn_ambr = {0};
   }
 
@@ -294,6 +295,7 @@ class apn_context {
 
   bool in_use;
   std::string apn_in_use;  // The APN currently used, as received from the SGW.
+  int32_t paa_pools;       // handle of the dynamic PAA pools of apn_in_use
   ambr_t apn_ambr;  // APN AMBR: The maximum aggregated uplink and downlink MBR
                     // values to be shared across all Non-GBR bearers, which are
                     // established for this APN.
@@ -323,7 +325,8 @@ class pgw_context : public std::enable_shared_from_this<pgw_context> {
         imsi_unauthenticated_indicator(false),
         apns(),
         pending_procedures(),
-        msisdn() {}
+        msisdn(),
+        shard(0) {}
 
   pgw_context(pgw_context& b) = delete;
 
@@ -367,6 +370,7 @@ class pgw_context : public std::enable_shared_from_this<pgw_context> {
   void handle_itti_msg(itti_sxab_session_establishment_response&);
   void handle_itti_msg(itti_sxab_session_modification_response&);
   void handle_itti_msg(itti_sxab_session_deletion_response&);
+  void handle_itti_msg(itti_sxab_remote_peer_not_responding&);
   void handle_itti_msg(std::shared_ptr<itti_sxab_session_report_request>&);
 
   std::string toString() const;
@@ -394,6 +398,8 @@ class pgw_context : public std::enable_shared_from_this<pgw_context> {
   //--------------------------------------------
   // internals
   std::vector<std::shared_ptr<pgw_procedure>> pending_procedures;
+  // pgw_app worker owning the context, local TEIDs are allocated in its shard
+  uint32_t shard;
 
   // Big recursive lock
   mutable std::recursive_mutex m_context;
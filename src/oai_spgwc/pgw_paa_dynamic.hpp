@@ -29,93 +29,117 @@
 #ifndef FILE_PGW_PAA_DYNAMIC_HPP_SEEN
 #define FILE_PGW_PAA_DYNAMIC_HPP_SEEN
 
+#include "bitmap_allocator.hpp"
 #include "logger.hpp"
 
-#include <bitset>
+#include <endian.h>
 #include <map>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+// /64 prefixes of an ipv6_pool are tracked with 1 bit each, a pool shorter
+// than /40 is not used beyond its first 2^24 prefixes
+#define PAA_IPV6_POOL_MAX_PREFIXES (1 << 24)
 
 class ipv6_pool {
  public:
   struct in6_addr prefix;
   int prefix_len;
 
-  ipv6_pool() : prefix(), prefix_len(0) {}
-
-  ipv6_pool(const struct in6_addr prfix, const int prfix_len) {
-    prefix     = prfix;
-    prefix_len = prfix_len;
+ protected:
+  // upper 64 bits of the first /64 prefix, host order
+  uint64_t first;
+  uint32_t num;
+  // bit n allocated if the /64 prefix first + n is in use
+  util::sharded_bitmap_allocator alloc;
+
+  static uint64_t upper64(const struct in6_addr& a) {
+    uint64_t u;
+    memcpy(&u, a.s6_addr, sizeof(u));
+    return be64toh(u);
   }
 
-  ipv6_pool(const ipv6_pool& p) : prefix(p.prefix), prefix_len(p.prefix_len) {}
+  static uint32_t num_prefixes(const int prfix_len) {
+    if (prfix_len >= 64) return 1;
+    const int free_bits = 64 - prfix_len;
+    return (free_bits >= 24) ? PAA_IPV6_POOL_MAX_PREFIXES : (1 << free_bits);
+  }
 
-  bool alloc_address(struct in6_addr& allocated) {
-    allocated = prefix;
-    return true;
+ public:
+  ipv6_pool(
+      const struct in6_addr prfix, const int prfix_len,
+      const uint32_t num_shards)
+      : prefix(prfix),
+        prefix_len(prfix_len),
+        num(num_prefixes(prfix_len)),
+        alloc(num, num_shards) {
+    first = upper64(prefix);
+    if (prefix_len < 64) {
+      first &= ~((uint64_t(1) << (64 - prefix_len)) - 1);
+    }
   }
 
-  void free_address(const struct in_addr& allocated) {}
-};
+  ipv6_pool(const ipv6_pool& p) = delete;
 
-class ipv4_pool {
- protected:
-  struct in_addr start;
-  int num;
-  std::map<int, uint32_t> alloc;
-
-  bool alloc_free_bit(int& bit_pos) {
-    bit_pos = 0;
-    for (int i = 0; i < alloc.size(); ++i) {
-      if (alloc[i] != std::numeric_limits<uint32_t>::max()) {
-        std::bitset<32> bs(alloc[i]);
-        int word_bit_pos = 0;
-        while (bs[word_bit_pos]) {
-          bit_pos++;
-          word_bit_pos++;
-        }
-        bs.set(word_bit_pos);
-        alloc[i] = bs.to_ulong();
-        return true;
-      }
-      bit_pos += 32;
+  uint32_t size() const { return num; }
+
+  /** \brief Allocate a /64 prefix, the interface identifier (lower 64 bits)
+   *  is the one of the configured prefix
+   **/
+  bool alloc_address(const uint32_t shard, struct in6_addr& allocated) {
+    uint32_t pos = 0;
+    if (alloc.alloc(shard, pos)) {
+      allocated          = prefix;
+      const uint64_t u64 = htobe64(first + pos);
+      memcpy(allocated.s6_addr, &u64, sizeof(u64));
+      return true;
     }
+    allocated = in6addr_any;
     return false;
   }
 
-  bool free_bit(const int bit_pos) {
-    if (bit_pos < num) {
-      int bit_pos32    = bit_pos >> 5;
-      int word_bit_pos = bit_pos & 0x0000001F;
-      std::bitset<32> bs(alloc[bit_pos32]);
-      bs.reset(word_bit_pos);
-      alloc[bit_pos32] = bs.to_ulong();
-      return true;
+  bool free_address(const struct in6_addr& allocated) {
+    if (in_pool(allocated)) {
+      return alloc.free(upper64(allocated) - first);
     }
     return false;
   }
 
- public:
-  ipv4_pool() : num(0), alloc() { start.s_addr = 0; };
+  /** \brief Mark a prefix allocated before a restart as in use
+   **/
+  bool reserve_address(const struct in6_addr& allocated) {
+    if (in_pool(allocated)) {
+      return alloc.alloc_at(upper64(allocated) - first);
+    }
+    return false;
+  }
+
+  bool in_pool(const struct in6_addr& a) const {
+    return ((upper64(a) - first) < num);
+  }
+};
+
+class ipv4_pool {
+ protected:
+  struct in_addr start;
+  uint32_t num;
+  // bit n allocated if start + n is in use
+  util::sharded_bitmap_allocator alloc;
 
-  ipv4_pool(const struct in_addr first, const uint32_t range) : alloc() {
+ public:
+  ipv4_pool(
+      const struct in_addr first, const uint32_t range,
+      const uint32_t num_shards)
+      : num(range), alloc(range, num_shards) {
     start.s_addr = first.s_addr;
-    num          = range;
-    int range32  = range >> 5;
-    int i        = 0;
-    for (i = 0; i < range32; ++i) {
-      alloc[i] = 0;
-    }
-    if (range & 0x0000001F) {
-      alloc[i] = std::numeric_limits<uint32_t>::max() << (range & 0x0000001F);
-    }
   };
 
-  ipv4_pool(const ipv4_pool& p) : num(p.num), alloc(p.alloc) {
-    start.s_addr = p.start.s_addr;
-  };
+  ipv4_pool(const ipv4_pool& p) = delete;
 
-  bool alloc_address(struct in_addr& allocated) {
-    int bit_pos = 0;
-    if (alloc_free_bit(bit_pos)) {
+  bool alloc_address(const uint32_t shard, struct in_addr& allocated) {
+    uint32_t bit_pos = 0;
+    if (alloc.alloc(shard, bit_pos)) {
       allocated.s_addr = be32toh(start.s_addr) + bit_pos;  // overflow
       allocated.s_addr = htobe32(allocated.s_addr);
       return true;
@@ -126,38 +150,150 @@ class ipv4_pool {
 
   bool free_address(const struct in_addr& allocated) {
     if (in_pool(allocated)) {
-      int bit_pos = be32toh(allocated.s_addr) - be32toh(start.s_addr);
-      return free_bit(bit_pos);
+      uint32_t bit_pos = be32toh(allocated.s_addr) - be32toh(start.s_addr);
+      return alloc.free(bit_pos);
+    }
+    return false;
+  }
+
+  /** \brief Mark an address allocated before a restart as in use
+   **/
+  bool reserve_address(const struct in_addr& allocated) {
+    if (in_pool(allocated)) {
+      uint32_t bit_pos = be32toh(allocated.s_addr) - be32toh(start.s_addr);
+      return alloc.alloc_at(bit_pos);
     }
     return false;
   }
 
   bool in_pool(const struct in_addr& a) const {
-    int addr_start = be32toh(start.s_addr);
-    int addr       = be32toh(a.s_addr);
+    uint32_t addr_start = be32toh(start.s_addr);
+    uint32_t addr       = be32toh(a.s_addr);
     return ((addr - addr_start) < num);
   }
 };
 
 class apn_dynamic_pools {
  public:
-  std::vector<uint32_t> ipv4_pool_ids;
-  std::vector<uint32_t> ipv6_pool_ids;
+  std::string apn_label;
+  std::vector<ipv4_pool*> ipv4_pools;
+  std::vector<ipv6_pool*> ipv6_pools;
 
-  apn_dynamic_pools() : ipv4_pool_ids(), ipv6_pool_ids() {}
+  explicit apn_dynamic_pools(const std::string& label)
+      : apn_label(label), ipv4_pools(), ipv6_pools() {}
+};
 
-  void add_ipv4_pool_id(const uint32_t id) { ipv4_pool_ids.push_back(id); }
-  void add_ipv6_pool_id(const uint32_t id) { ipv6_pool_ids.push_back(id); }
+/** \brief Told of every dynamic address or prefix allocated and released, so
+ *  that they can be stored and given back to paa_dynamic::restore_paa() after
+ *  a restart. Called by the pgw_app workers concurrently, it must not call
+ *  paa_dynamic.
+ **/
+class paa_persistence {
+ public:
+  virtual ~paa_persistence() {}
+  virtual void ipv4_allocated(
+      const std::string& apn_label, const struct in_addr& ipv4_address) = 0;
+  virtual void ipv4_released(
+      const std::string& apn_label, const struct in_addr& ipv4_address) = 0;
+  virtual void ipv6_allocated(
+      const std::string& apn_label, const struct in6_addr& ipv6_prefix) = 0;
+  virtual void ipv6_released(
+      const std::string& apn_label, const struct in6_addr& ipv6_prefix) = 0;
 };
 
+/** \brief Dynamic PAA of the APNs. Pools are added and APNs resolved to
+ *  handles while applying the configuration, then never modified: the
+ *  allocations only lock the shard of the pool they touch.
+ **/
 class paa_dynamic {
  private:
-  std::map<int32_t, ipv4_pool> ipv4_pools;
-  std::map<int32_t, ipv6_pool> ipv6_pools;
+  std::map<int32_t, std::unique_ptr<ipv4_pool>> ipv4_pools;
+  std::map<int32_t, std::unique_ptr<ipv6_pool>> ipv6_pools;
+
+  // index is the handle of the APN
+  std::vector<apn_dynamic_pools> apns;
+  std::map<std::string, int32_t> apn_handles;
+  uint32_t num_shards;
+  paa_persistence* persistence;
+
+  paa_dynamic()
+      : ipv4_pools(),
+        ipv6_pools(),
+        apns(),
+        apn_handles(),
+        num_shards(1),
+        persistence(nullptr){};
+
+  apn_dynamic_pools& get_or_add_apn(const std::string& apn_label) {
+    std::map<std::string, int32_t>::iterator it = apn_handles.find(apn_label);
+    if (it != apn_handles.end()) {
+      return apns[it->second];
+    }
+    apn_handles[apn_label] = apns.size();
+    apns.push_back(apn_dynamic_pools(apn_label));
+    return apns.back();
+  }
 
-  std::map<std::string, apn_dynamic_pools> apns;
+  const apn_dynamic_pools* get_apn(const int32_t apn_handle) const {
+    if ((apn_handle >= 0) && (apn_handle < (int32_t) apns.size())) {
+      return &apns[apn_handle];
+    }
+    return nullptr;
+  }
 
-  paa_dynamic() : ipv4_pools(), ipv6_pools(), apns(){};
+  bool alloc_ipv4(
+      const uint32_t shard, const apn_dynamic_pools& apn_pool,
+      struct in_addr& ipv4_address) {
+    for (auto pool : apn_pool.ipv4_pools) {
+      if (pool->alloc_address(shard, ipv4_address)) {
+        if (persistence) {
+          persistence->ipv4_allocated(apn_pool.apn_label, ipv4_address);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool alloc_ipv6(
+      const uint32_t shard, const apn_dynamic_pools& apn_pool,
+      struct in6_addr& ipv6_prefix) {
+    for (auto pool : apn_pool.ipv6_pools) {
+      if (pool->alloc_address(shard, ipv6_prefix)) {
+        if (persistence) {
+          persistence->ipv6_allocated(apn_pool.apn_label, ipv6_prefix);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool free_ipv4(
+      const apn_dynamic_pools& apn_pool, const struct in_addr& ipv4_address) {
+    for (auto pool : apn_pool.ipv4_pools) {
+      if (pool->free_address(ipv4_address)) {
+        if (persistence) {
+          persistence->ipv4_released(apn_pool.apn_label, ipv4_address);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool free_ipv6(
+      const apn_dynamic_pools& apn_pool, const struct in6_addr& ipv6_prefix) {
+    for (auto pool : apn_pool.ipv6_pools) {
+      if (pool->free_address(ipv6_prefix)) {
+        if (persistence) {
+          persistence->ipv6_released(apn_pool.apn_label, ipv6_prefix);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
 
  public:
   static paa_dynamic& get_instance() {
@@ -168,20 +304,20 @@ class paa_dynamic {
   paa_dynamic(paa_dynamic const&) = delete;
   void operator=(paa_dynamic const&) = delete;
 
+  /** \brief Number of shards of the pools added after, usually the number of
+   *  pgw_app workers
+   **/
+  void set_num_shards(const uint32_t num) { num_shards = (num) ? num : 1; }
+
   void add_pool(
       const std::string& apn_label, const int pool_id,
       const struct in_addr& first, const int range) {
     if (pool_id >= 0) {
-      uint32_t uint32pool_id = uint32_t(pool_id);
-      if (!ipv4_pools.count(uint32pool_id)) {
-        ipv4_pool pool(first, range);
-        ipv4_pools[uint32pool_id] = pool;
-      }
-      if (!apns.count(apn_label)) {
-        apn_dynamic_pools adp = {};
-        adp.add_ipv4_pool_id(uint32pool_id);
-        apns[apn_label] = adp;
+      std::unique_ptr<ipv4_pool>& pool = ipv4_pools[pool_id];
+      if (not pool) {
+        pool.reset(new ipv4_pool(first, range, num_shards));
       }
+      get_or_add_apn(apn_label).ipv4_pools.push_back(pool.get());
     }
   }
 
@@ -189,118 +325,142 @@ class paa_dynamic {
       const std::string& apn_label, const int pool_id,
       const struct in6_addr& prefix, const int prefix_len) {
     if (pool_id >= 0) {
-      uint32_t uint32pool_id = uint32_t(pool_id);
-      if (!ipv6_pools.count(uint32pool_id)) {
-        ipv6_pool pool(prefix, prefix_len);
-        ipv6_pools[uint32pool_id] = pool;
-      }
-      if (!apns.count(apn_label)) {
-        apn_dynamic_pools adp = {};
-        adp.add_ipv6_pool_id(uint32pool_id);
-        apns[apn_label] = adp;
+      std::unique_ptr<ipv6_pool>& pool = ipv6_pools[pool_id];
+      if (not pool) {
+        pool.reset(new ipv6_pool(prefix, prefix_len, num_shards));
+        if (prefix_len < 64 - 24) {
+          Logger::pgwc_app().warn(
+              "APN %s: only %u /64 prefixes of the /%d IPv6 pool are used",
+              apn_label.c_str(), pool->size(), prefix_len);
+        }
       }
+      get_or_add_apn(apn_label).ipv6_pools.push_back(pool.get());
     }
   }
 
-  bool get_free_paa(const std::string& apn_label, paa_t& paa) {
-    if (apns.count(apn_label)) {
-      apn_dynamic_pools& apn_pool = apns[apn_label];
+  /** \brief Set the receiver of the allocations, nullptr for none, before
+   *  any allocation
+   **/
+  void set_persistence(paa_persistence* p) { persistence = p; }
+
+  /** \brief @returns the handle of the pools of an APN, -1 if the APN has no
+   *  dynamic pool
+   **/
+  int32_t get_apn_handle(const std::string& apn_label) const {
+    std::map<std::string, int32_t>::const_iterator it =
+        apn_handles.find(apn_label);
+    if (it != apn_handles.end()) {
+      return it->second;
+    }
+    return -1;
+  }
+
+  /** \brief Allocate the PAA of a PDN connection in the pools of an APN
+   *  @param shard of the pools tried first, the pgw_app worker of the caller
+   **/
+  bool get_free_paa(
+      const uint32_t shard, const int32_t apn_handle, paa_t& paa) {
+    const apn_dynamic_pools* apn_pool = get_apn(apn_handle);
+    if (apn_pool) {
       if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4) {
-        for (std::vector<uint32_t>::const_iterator it4 =
-                 apn_pool.ipv4_pool_ids.begin();
-             it4 != apn_pool.ipv4_pool_ids.end(); ++it4) {
-          if (ipv4_pools[*it4].alloc_address(paa.ipv4_address)) {
-            return true;
-          }
+        if (alloc_ipv4(shard, *apn_pool, paa.ipv4_address)) {
+          return true;
         }
         Logger::pgwc_app().warn(
-            "Could not get PAA PDN_TYPE_E_IPV4 for APN %s", apn_label.c_str());
+            "Could not get PAA PDN_TYPE_E_IPV4 for APN %s",
+            apn_pool->apn_label.c_str());
         return false;
       } else if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6) {
-        bool success                              = false;
-        std::vector<uint32_t>::const_iterator it4 = {};
-        for (it4 = apn_pool.ipv4_pool_ids.begin();
-             it4 != apn_pool.ipv4_pool_ids.end(); ++it4) {
-          if (ipv4_pools[*it4].alloc_address(paa.ipv4_address)) {
-            success = true;
-          }
-        }
-        if (success) {
-          for (std::vector<uint32_t>::const_iterator it6 =
-                   apn_pool.ipv6_pool_ids.begin();
-               it6 != apn_pool.ipv6_pool_ids.end(); ++it6) {
-            if (ipv6_pools[*it6].alloc_address(paa.ipv6_address)) {
-              return true;
-            }
+        if (alloc_ipv4(shard, *apn_pool, paa.ipv4_address)) {
+          if (alloc_ipv6(shard, *apn_pool, paa.ipv6_address)) {
+            paa.ipv6_prefix_length = 64;
+            return true;
           }
-          ipv4_pools[*it4].free_address(paa.ipv4_address);
+          free_ipv4(*apn_pool, paa.ipv4_address);
         }
         Logger::pgwc_app().warn(
             "Could not get PAA PDN_TYPE_E_IPV4V6 for APN %s",
-            apn_label.c_str());
+            apn_pool->apn_label.c_str());
         return false;
       } else if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV6) {
-        for (std::vector<uint32_t>::const_iterator it6 =
-                 apn_pool.ipv6_pool_ids.begin();
-             it6 != apn_pool.ipv6_pool_ids.end(); ++it6) {
-          if (ipv6_pools[*it6].alloc_address(paa.ipv6_address)) {
-            return true;
-          }
+        if (alloc_ipv6(shard, *apn_pool, paa.ipv6_address)) {
+          paa.ipv6_prefix_length = 64;
+          return true;
         }
         Logger::pgwc_app().warn(
-            "Could not get PAA PDN_TYPE_E_IPV6 for APN %s", apn_label.c_str());
+            "Could not get PAA PDN_TYPE_E_IPV6 for APN %s",
+            apn_pool->apn_label.c_str());
         return false;
       }
     }
-    Logger::pgwc_app().warn("Could not get PAA for APN %s", apn_label.c_str());
+    Logger::pgwc_app().warn("Could not get PAA for APN handle %d", apn_handle);
     return false;
   }
 
-  bool release_paa(const std::string& apn_label, const paa_t& paa) {
-    if (apns.count(apn_label)) {
-      apn_dynamic_pools& apn_pool = apns[apn_label];
-      if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4) {
-        for (std::vector<uint32_t>::const_iterator it4 =
-                 apn_pool.ipv4_pool_ids.begin();
-             it4 != apn_pool.ipv4_pool_ids.end(); ++it4) {
-          if (ipv4_pools[*it4].free_address(paa.ipv4_address)) {
-            return true;
-          }
+  /** \brief Mark the dynamic address(es) of a PAA allocated before a restart
+   *  as in use
+   **/
+  bool restore_paa(const int32_t apn_handle, const paa_t& paa) {
+    const apn_dynamic_pools* apn_pool = get_apn(apn_handle);
+    if (not apn_pool) return false;
+    bool restored = false;
+    if ((paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4) ||
+        (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6)) {
+      for (auto pool : apn_pool->ipv4_pools) {
+        if (pool->reserve_address(paa.ipv4_address)) {
+          restored = true;
+          break;
         }
-        return false;
-      } else if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6) {
-        bool success                              = false;
-        std::vector<uint32_t>::const_iterator it4 = {};
-        for (it4 = apn_pool.ipv4_pool_ids.begin();
-             it4 != apn_pool.ipv4_pool_ids.end(); ++it4) {
-          if (ipv4_pools[*it4].free_address(paa.ipv4_address)) {
-            return true;
-          }
+      }
+    }
+    if ((paa.pdn_type.pdn_type == PDN_TYPE_E_IPV6) ||
+        (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6)) {
+      for (auto pool : apn_pool->ipv6_pools) {
+        if (pool->reserve_address(paa.ipv6_address)) {
+          restored = true;
+          break;
         }
-        return false;
+      }
+    }
+    return restored;
+  }
+
+  bool release_paa(const int32_t apn_handle, const paa_t& paa) {
+    const apn_dynamic_pools* apn_pool = get_apn(apn_handle);
+    if (apn_pool) {
+      if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4) {
+        return free_ipv4(*apn_pool, paa.ipv4_address);
+      } else if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV4V6) {
+        bool success = free_ipv4(*apn_pool, paa.ipv4_address);
+        return free_ipv6(*apn_pool, paa.ipv6_address) && success;
       } else if (paa.pdn_type.pdn_type == PDN_TYPE_E_IPV6) {
-        return true;
+        return free_ipv6(*apn_pool, paa.ipv6_address);
       }
     }
     Logger::pgwc_app().warn(
-        "Could not release PAA for APN %s", apn_label.c_str());
+        "Could not release PAA for APN handle %d", apn_handle);
     return false;
   }
 
   bool release_paa(
-      const std::string& apn_label, const struct in_addr& ipv4_address) {
-    if (apns.count(apn_label)) {
-      apn_dynamic_pools& apn_pool = apns[apn_label];
-      for (std::vector<uint32_t>::const_iterator it4 =
-               apn_pool.ipv4_pool_ids.begin();
-           it4 != apn_pool.ipv4_pool_ids.end(); ++it4) {
-        if (ipv4_pools[*it4].free_address(ipv4_address)) {
-          return true;
-        }
-      }
+      const int32_t apn_handle, const struct in_addr& ipv4_address) {
+    const apn_dynamic_pools* apn_pool = get_apn(apn_handle);
+    if ((apn_pool) && (free_ipv4(*apn_pool, ipv4_address))) {
+      return true;
+    }
+    Logger::pgwc_app().warn(
+        "Could not release PAA for APN handle %d", apn_handle);
+    return false;
+  }
+
+  bool release_paa(
+      const int32_t apn_handle, const struct in6_addr& ipv6_prefix) {
+    const apn_dynamic_pools* apn_pool = get_apn(apn_handle);
+    if ((apn_pool) && (free_ipv6(*apn_pool, ipv6_prefix))) {
+      return true;
     }
     Logger::pgwc_app().warn(
-        "Could not release PAA for APN %s", apn_label.c_str());
+        "Could not release PAA for APN handle %d", apn_handle);
     return false;
   }
 };
@@ -30,6 +30,7 @@
 #include "common_defs.h"
 #include "itti.hpp"
 #include "logger.hpp"
+#include "pgw_app.hpp"
 #include "pgw_config.hpp"
 
 #include <stdexcept>
@@ -49,68 +50,22 @@ void pgw_s5s8_task(void* args_p) {
   const task_id_t task_id = TASK_PGWC_S5S8;
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case S5S8_CREATE_SESSION_RESPONSE:
-        if (itti_s5s8_create_session_response* m =
-                dynamic_cast<itti_s5s8_create_session_response*>(msg)) {
-          pgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_DELETE_SESSION_RESPONSE:
-        if (itti_s5s8_delete_session_response* m =
-                dynamic_cast<itti_s5s8_delete_session_response*>(msg)) {
-          pgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_MODIFY_BEARER_RESPONSE:
-        if (itti_s5s8_modify_bearer_response* m =
-                dynamic_cast<itti_s5s8_modify_bearer_response*>(msg)) {
-          pgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_RELEASE_ACCESS_BEARERS_RESPONSE:
-        if (itti_s5s8_release_access_bearers_response* m =
-                dynamic_cast<itti_s5s8_release_access_bearers_response*>(msg)) {
-          pgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_DOWNLINK_DATA_NOTIFICATION:
-        if (itti_s5s8_downlink_data_notification* m =
-                dynamic_cast<itti_s5s8_downlink_data_notification*>(msg)) {
-          pgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::pgwc_s5s8().debug("TIME-OUT event timer id %d", to->timer_id);
-          pgw_s5s8_inst->time_out_itti_event(to->timer_id);
-        }
-        break;
-
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::pgwc_s5s8().info("Received terminate message");
-          return;
-        }
-        break;
-
-      case HEALTH_PING:
-        break;
-
-      default:
-        Logger::pgwc_s5s8().info("no handler for msg type %d", msg->msg_type);
-    }
-
-  } while (true);
+  itti_dispatcher dispatcher(task_id, Logger::pgwc_s5s8());
+  dispatcher
+      .on_each<
+          S5S8_CREATE_SESSION_RESPONSE,
+          S5S8_DELETE_SESSION_RESPONSE,
+          S5S8_MODIFY_BEARER_RESPONSE,
+          S5S8_RELEASE_ACCESS_BEARERS_RESPONSE,
+          S5S8_DOWNLINK_DATA_NOTIFICATION>(
+          [](auto m) { pgw_s5s8_inst->send_msg(std::ref(*m)); })
+      .on<TIME_OUT>([](auto to) {
+        Logger::pgwc_s5s8().debug("TIME-OUT event timer id %d", to->timer_id);
+        pgw_s5s8_inst->time_out_itti_event(to->timer_id);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
+  pgw_s5s8_inst->stop();
 }
 
 //------------------------------------------------------------------------------
@@ -118,7 +73,10 @@ pgw_s5s8::pgw_s5s8()
     : gtpv2c_stack(
           pgwc::pgw_config::gtpv2c_.t3_ms, pgwc::pgw_config::gtpv2c_.n3,
           string(inet_ntoa(pgw_cfg.pgw_s5s8_.iface.addr4)),
-          pgw_cfg.gtpv2c_.port, pgw_cfg.gtpv2c_.sched_params) {
+          pgw_cfg.gtpv2c_.port, pgw_cfg.gtpv2c_.sched_params,
+          pgw_cfg.gtpv2c_.worker_threads, pgw_cfg.gtpv2c_.udp_batch_size,
+          pgw_cfg.gtpv2c_.use_io_uring,
+          pgw_cfg.gtpv2c_.max_concurrent_procedures) {
   Logger::pgwc_s5s8().startup("Starting...");
   if (itti_inst->create_task(TASK_PGWC_S5S8, pgw_s5s8_task, nullptr)) {
     Logger::pgwc_s5s8().error("Cannot create task TASK_PGWC_S5S8");
@@ -154,23 +112,26 @@ void pgw_s5s8::send_msg(itti_s5s8_downlink_data_notification& i) {
 }
 //------------------------------------------------------------------------------
 void pgw_s5s8::handle_receive_create_session_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                      = true;
   uint64_t gtpc_tx_id                             = 0;
   gtpv2c_create_session_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_PGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_create_session_request* itti_msg =
-        new itti_s5s8_create_session_request(TASK_PGWC_S5S8, TASK_PGWC_APP);
+        new itti_s5s8_create_session_request(
+            TASK_PGWC_S5S8, pgw_app::create_session_request_2_task(
+                                msg.get_teid(), msg_ies_container));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_create_session_request> i =
-        std::shared_ptr<itti_s5s8_create_session_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_s5s8().error(
@@ -186,23 +147,25 @@ void pgw_s5s8::handle_receive_create_session_request(
 }
 //------------------------------------------------------------------------------
 void pgw_s5s8::handle_receive_delete_session_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                      = true;
   uint64_t gtpc_tx_id                             = 0;
   gtpv2c_delete_session_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_PGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_delete_session_request* itti_msg =
-        new itti_s5s8_delete_session_request(TASK_PGWC_S5S8, TASK_PGWC_APP);
+        new itti_s5s8_delete_session_request(
+            TASK_PGWC_S5S8, pgw_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_delete_session_request> i =
-        std::shared_ptr<itti_s5s8_delete_session_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_s5s8().error(
@@ -214,23 +177,25 @@ void pgw_s5s8::handle_receive_delete_session_request(
 }
 //------------------------------------------------------------------------------
 void pgw_s5s8::handle_receive_modify_bearer_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                     = true;
   uint64_t gtpc_tx_id                            = 0;
   gtpv2c_modify_bearer_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_PGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_modify_bearer_request* itti_msg =
-        new itti_s5s8_modify_bearer_request(TASK_PGWC_S5S8, TASK_PGWC_APP);
+        new itti_s5s8_modify_bearer_request(
+            TASK_PGWC_S5S8, pgw_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_modify_bearer_request> i =
-        std::shared_ptr<itti_s5s8_modify_bearer_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_s5s8().error(
@@ -242,24 +207,25 @@ void pgw_s5s8::handle_receive_modify_bearer_request(
 }
 //------------------------------------------------------------------------------
 void pgw_s5s8::handle_receive_release_access_bearers_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                              = true;
   uint64_t gtpc_tx_id                                     = 0;
   gtpv2c_release_access_bearers_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_PGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_release_access_bearers_request* itti_msg =
         new itti_s5s8_release_access_bearers_request(
-            TASK_PGWC_S5S8, TASK_PGWC_APP);
+            TASK_PGWC_S5S8, pgw_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_release_access_bearers_request> i =
-        std::shared_ptr<itti_s5s8_release_access_bearers_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_s5s8().error(
@@ -271,25 +237,25 @@ void pgw_s5s8::handle_receive_release_access_bearers_request(
 }
 //------------------------------------------------------------------------------
 void pgw_s5s8::handle_receive_downlink_data_notification_acknowledge(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                                      = true;
   uint64_t gtpc_tx_id                                             = 0;
   gtpv2c_downlink_data_notification_acknowledge msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_downlink_data_notification_acknowledge* itti_msg =
         new itti_s5s8_downlink_data_notification_acknowledge(
-            TASK_PGWC_S5S8, TASK_PGWC_APP);
+            TASK_PGWC_S5S8, pgw_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_downlink_data_notification_acknowledge> i =
-        std::shared_ptr<itti_s5s8_downlink_data_notification_acknowledge>(
-            itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_s5s8().error(
@@ -302,12 +268,13 @@ void pgw_s5s8::handle_receive_downlink_data_notification_acknowledge(
 
 //------------------------------------------------------------------------------
 void pgw_s5s8::handle_receive_gtpv2c_msg(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   // Logger::pgwc_s5s8().trace( "handle_receive_gtpv2c_msg msg type %d length
   // %d", msg.get_message_type(), msg.get_message_length());
   switch (msg.get_message_type()) {
     case GTP_CREATE_SESSION_REQUEST: {
-      handle_receive_create_session_request(msg, remote_endpoint);
+      handle_receive_create_session_request(msg, ies, remote_endpoint);
     } break;
     case GTP_ECHO_REQUEST:
     case GTP_ECHO_RESPONSE:
@@ -315,16 +282,16 @@ void pgw_s5s8::handle_receive_gtpv2c_msg(
     case GTP_CREATE_SESSION_RESPONSE:
       break;
     case GTP_MODIFY_BEARER_REQUEST: {
-      handle_receive_modify_bearer_request(msg, remote_endpoint);
+      handle_receive_modify_bearer_request(msg, ies, remote_endpoint);
     } break;
     case GTP_MODIFY_BEARER_RESPONSE:
       break;
     case GTP_DELETE_SESSION_REQUEST: {
-      handle_receive_delete_session_request(msg, remote_endpoint);
+      handle_receive_delete_session_request(msg, ies, remote_endpoint);
     } break;
     case GTP_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE: {
       handle_receive_downlink_data_notification_acknowledge(
-          msg, remote_endpoint);
+          msg, ies, remote_endpoint);
     } break;
     case GTP_DELETE_SESSION_RESPONSE:
     case GTP_CHANGE_NOTIFICATION_REQUEST:
@@ -388,7 +355,7 @@ void pgw_s5s8::handle_receive_gtpv2c_msg(
     case GTP_DELETE_INDIRECT_DATA_FORWARDING_TUNNEL_RESPONSE:
       break;
     case GTP_RELEASE_ACCESS_BEARERS_REQUEST: {
-      handle_receive_release_access_bearers_request(msg, remote_endpoint);
+      handle_receive_release_access_bearers_request(msg, ies, remote_endpoint);
     } break;
 
     case GTP_RELEASE_ACCESS_BEARERS_RESPONSE:
@@ -416,13 +383,12 @@ void pgw_s5s8::handle_receive(
     const endpoint& remote_endpoint) {
   // Logger::pgwc_s5s8().info( "handle_receive(%d bytes)", bytes_transferred);
   // std::cout << string_to_hex(recv_buffer, bytes_transferred) << std::endl;
-  std::istringstream iss(std::istringstream::binary);
-  iss.rdbuf()->pubsetbuf(recv_buffer, bytes_transferred);
   gtpv2c_msg msg  = {};
   msg.remote_port = remote_endpoint.port();
   try {
-    msg.load_from(iss);
-    handle_receive_gtpv2c_msg(msg, remote_endpoint);
+    gtpv2c_view ies = gtpv2c_decoder::decode_header(
+        reinterpret_cast<const uint8_t*>(recv_buffer), bytes_transferred, msg);
+    handle_receive_gtpv2c_msg(msg, ies, remote_endpoint);
   } catch (gtpc_exception& e) {
     Logger::pgwc_s5s8().info("handle_receive exception %s", e.what());
   }
@@ -435,12 +401,12 @@ void pgw_s5s8::notify_ul_error(
     case cause_value_e::REMOTE_PEER_NOT_RESPONDING: {
       itti_s5s8_remote_peer_not_responding* itti_msg =
           new itti_s5s8_remote_peer_not_responding(
-              TASK_PGWC_S5S8, TASK_PGWC_APP);
+              TASK_PGWC_S5S8, pgw_app::teid_2_task(l_teid));
       itti_msg->r_endpoint = r_endpoint;
       itti_msg->gtpc_tx_id = gtpc_tx_id;
       itti_msg->teid       = l_teid;
       std::shared_ptr<itti_s5s8_remote_peer_not_responding> i =
-          std::shared_ptr<itti_s5s8_remote_peer_not_responding>(itti_msg);
+          itti_msg_shared(itti_msg);
       int ret = itti_inst->send_msg(i);
       if (RETURNok != ret) {
         Logger::pgwc_s5s8().error(
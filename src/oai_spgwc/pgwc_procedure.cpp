@@ -23,6 +23,7 @@
 #include "3gpp_29.244.h"
 #include "3gpp_29.274.h"
 #include "3gpp_conversions.hpp"
+#include "alloc_stats.hpp"
 #include "common_defs.h"
 #include "conversions.hpp"
 #include "itti.hpp"
@@ -35,6 +36,7 @@
 #include "pgw_pfcp_association.hpp"
 
 #include <algorithm>  // std::search
+#include <map>
 
 using namespace pfcp;
 using namespace pgwc;
@@ -47,16 +49,18 @@ extern pgwc::pgw_config pgw_cfg;
 //------------------------------------------------------------------------------
 int sx_session_restore_procedure::run() {
   if (pending_sessions.size()) {
-    itti_sx_restore* itti_msg = nullptr;
+    // sessions are restored by the pgw_app worker owning their SEID
+    std::map<task_id_t, itti_sx_restore*> itti_msgs = {};
     for (std::set<pfcp::fseid_t>::iterator it = pending_sessions.begin();
          it != pending_sessions.end(); ++it) {
+      const task_id_t task_id    = pgw_app::seid_2_task(it->seid);
+      itti_sx_restore*& itti_msg = itti_msgs[task_id];
       if (!itti_msg) {
-        itti_msg = new itti_sx_restore(TASK_PGWC_SX, TASK_PGWC_APP);
+        itti_msg = new itti_sx_restore(TASK_PGWC_SX, task_id);
       }
       itti_msg->sessions.insert(*it);
       if (itti_msg->sessions.size() >= 64) {
-        std::shared_ptr<itti_sx_restore> i =
-            std::shared_ptr<itti_sx_restore>(itti_msg);
+        std::shared_ptr<itti_sx_restore> i = itti_msg_shared(itti_msg);
         int ret = itti_inst->send_msg(i);
         if (RETURNok != ret) {
           Logger::pgwc_sx().error(
@@ -66,17 +70,20 @@ int sx_session_restore_procedure::run() {
         itti_msg = nullptr;
       }
     }
-    if (itti_msg) {
-      std::shared_ptr<itti_sx_restore> i =
-          std::shared_ptr<itti_sx_restore>(itti_msg);
-      int ret = itti_inst->send_msg(i);
-      if (RETURNok != ret) {
-        Logger::pgwc_sx().error(
-            "Could not send ITTI message %s to task TASK_PGWC_APP",
-            i->get_msg_name());
-        return RETURNerror;
+    int rc = RETURNok;
+    for (auto& m : itti_msgs) {
+      if (m.second) {
+        std::shared_ptr<itti_sx_restore> i = itti_msg_shared(m.second);
+        int ret = itti_inst->send_msg(i);
+        if (RETURNok != ret) {
+          Logger::pgwc_sx().error(
+              "Could not send ITTI message %s to task TASK_PGWC_APP",
+              i->get_msg_name());
+          rc = RETURNerror;
+        }
       }
     }
+    return rc;
   }
   return RETURNok;
 }
@@ -85,6 +92,7 @@ int session_establishment_procedure::run(
     std::shared_ptr<itti_s5s8_create_session_request>& req,
     std::shared_ptr<itti_s5s8_create_session_response>& resp,
     std::shared_ptr<pgwc::pgw_context> pc) {
+  util::alloc_scope allocs;
   // TODO check if compatible with ongoing procedures if any
   pfcp::node_id_t up_node_id = {};
   if (not pfcp_associations::get_instance().select_up_node(
@@ -109,17 +117,18 @@ int session_establishment_procedure::run(
   //-------------------
   s5_trigger           = req;
   s5_triggered_pending = resp;
+  this->pc             = pc;
   ppc->generate_seid();
   itti_sxab_session_establishment_request* sx_ser =
       new itti_sxab_session_establishment_request(TASK_PGWC_APP, TASK_PGWC_SX);
   sx_ser->seid    = 0;
+  sx_ser->l_seid  = ppc->seid;
   sx_ser->trxn_id = this->trxn_id;
 
   sx_ser->r_endpoint = sa->remote_endpoint;
   // sx_ser->r_endpoint =
   //                   endpoint(up_node_id.u1.ipv4_address, pfcp::default_port);
-  sx_triggered =
-      std::shared_ptr<itti_sxab_session_establishment_request>(sx_ser);
+  sx_triggered = itti_msg_shared(sx_ser);
 
   //-------------------
   // IE node_id_t
@@ -136,7 +145,12 @@ int session_establishment_procedure::run(
   cp_fseid.seid = ppc->seid;
   sx_ser->pfcp_ies.set(cp_fseid);
 
-  for (auto it : s5_trigger->gtp_ies.bearer_contexts_to_be_created) {
+  // one PDR and one FAR per bearer
+  sx_ser->pfcp_ies.create_pdrs.reserve(
+      s5_trigger->gtp_ies.bearer_contexts_to_be_created.size());
+  sx_ser->pfcp_ies.create_fars.reserve(
+      s5_trigger->gtp_ies.bearer_contexts_to_be_created.size());
+  for (const auto& it : s5_trigger->gtp_ies.bearer_contexts_to_be_created) {
     //*******************
     // UPLINK
     //*******************
@@ -239,6 +253,12 @@ int session_establishment_procedure::run(
 
   // for finding procedure when receiving response
   pgw_app_inst->set_seid_2_pgw_context(cp_fseid.seid, pc);
+#if ALLOC_STATS
+  Logger::pgwc_app().debug(
+      "Session Establishment Request built, %" PRIu64 " allocations (%" PRIu64
+      " bytes)",
+      allocs.elapsed().allocations, allocs.elapsed().bytes);
+#endif
 
   Logger::pgwc_app().info(
       "Sending ITTI message %s to task TASK_PGWC_SX", sx_ser->get_msg_name());
@@ -260,7 +280,7 @@ void session_establishment_procedure::handle_itti_msg(
     resp.pfcp_ies.get(ppc->up_fseid);
   }
 
-  for (auto it : resp.pfcp_ies.created_pdrs) {
+  for (const auto& it : resp.pfcp_ies.created_pdrs) {
     pfcp::pdr_id_t pdr_id = {};
     pfcp::far_id_t far_id = {};
     if (it.get(pdr_id)) {
@@ -287,7 +307,7 @@ void session_establishment_procedure::handle_itti_msg(
     }
   }
 
-  for (auto it : s5_trigger->gtp_ies.bearer_contexts_to_be_created) {
+  for (const auto& it : s5_trigger->gtp_ies.bearer_contexts_to_be_created) {
     pgw_eps_bearer b                                                  = {};
     gtpv2c::bearer_context_created_within_create_session_response bcc = {};
     ::cause_t bcc_cause                                               = {
@@ -317,6 +337,48 @@ void session_establishment_procedure::handle_itti_msg(
         s5_triggered_pending->gtp_ies.get_msg_name());
   }
 }
+//------------------------------------------------------------------------------
+void session_establishment_procedure::handle_itti_msg(
+    itti_sxab_remote_peer_not_responding& m) {
+  // no PFCP session on the UP, the Create Session fails
+  ::cause_t cause   = {};
+  cause.pce         = 1;
+  cause.cause_value = NO_RESOURCES_AVAILABLE;
+  s5_triggered_pending->gtp_ies.set(cause);
+  s5_triggered_pending->gtp_ies.clear_pco();
+  s5_triggered_pending->gtp_ies.clear_apn_ambr();
+  s5_triggered_pending->gtp_ies.clear_paa();
+  s5_triggered_pending->gtp_ies.clear_s5_s8_pgw_fteid();
+  for (const auto& it : s5_trigger->gtp_ies.bearer_contexts_to_be_created) {
+    gtpv2c::bearer_context_created_within_create_session_response bcc = {};
+    ::cause_t bcc_cause                                               = {
+        .cause_value = NO_RESOURCES_AVAILABLE, .pce = 0, .bce = 0, .cs = 0};
+    bcc.set(it.eps_bearer_id);
+    bcc.set(bcc_cause);
+    s5_triggered_pending->gtp_ies.add_bearer_context_created(bcc);
+  }
+
+  Logger::pgwc_app().info(
+      "Sending ITTI message %s to task TASK_PGWC_S5S8",
+      s5_triggered_pending->gtp_ies.get_msg_name());
+  int ret = itti_inst->send_msg(s5_triggered_pending);
+  if (RETURNok != ret) {
+    Logger::pgwc_app().error(
+        "Could not send ITTI message %s to task TASK_PGWC_S5S8",
+        s5_triggered_pending->gtp_ies.get_msg_name());
+  }
+
+  // release the PAA and the F-TEID of the PDN connection
+  pdn_duo_t pdn_duo = {};
+  if (pc->find_pdn_connection(
+          ppc->pgw_fteid_s5_s8_cp.teid_gre_key, IS_FIND_PDN_WITH_LOCAL_TEID,
+          pdn_duo)) {
+    pc->delete_pdn_connection(pdn_duo.first, pdn_duo.second);
+  } else {
+    Logger::pgwc_app().error(
+        "Could not delete PDN connection (APN context not found)");
+  }
+}
 
 //------------------------------------------------------------------------------
 int modify_bearer_procedure::run(
@@ -332,10 +394,10 @@ int modify_bearer_procedure::run(
   itti_sxab_session_modification_request* sx_smr =
       new itti_sxab_session_modification_request(TASK_PGWC_APP, TASK_PGWC_SX);
   sx_smr->seid       = ppc->up_fseid.seid;
+  sx_smr->l_seid     = ppc->seid;
   sx_smr->trxn_id    = this->trxn_id;
   sx_smr->r_endpoint = endpoint(ppc->up_fseid.ipv4_address, pgw_cfg.pfcp_.port);
-  sx_triggered =
-      std::shared_ptr<itti_sxab_session_modification_request>(sx_smr);
+  sx_triggered = itti_msg_shared(sx_smr);
 
   //-------------------
   // IE fseid_t
@@ -839,6 +901,22 @@ void modify_bearer_procedure::handle_itti_msg(
   }
 }
 
+//------------------------------------------------------------------------------
+void modify_bearer_procedure::handle_itti_msg(
+    itti_sxab_remote_peer_not_responding& m) {
+  ::cause_t gtp_cause = {
+      .cause_value = NO_RESOURCES_AVAILABLE, .pce = 0, .bce = 0, .cs = 0};
+  s5_triggered_pending->gtp_ies.set(gtp_cause);
+  Logger::pgwc_app().info(
+      "Sending ITTI message %s to task TASK_PGWC_S5S8",
+      s5_triggered_pending->gtp_ies.get_msg_name());
+  int ret = itti_inst->send_msg(s5_triggered_pending);
+  if (RETURNok != ret) {
+    Logger::pgwc_app().error(
+        "Could not send ITTI message %s to task TASK_PGWC_S5S8",
+        s5_triggered_pending->gtp_ies.get_msg_name());
+  }
+}
 //------------------------------------------------------------------------------
 int release_access_bearers_procedure::run(
     std::shared_ptr<itti_s5s8_release_access_bearers_request>& req,
@@ -851,10 +929,10 @@ int release_access_bearers_procedure::run(
   itti_sxab_session_modification_request* sx_smr =
       new itti_sxab_session_modification_request(TASK_PGWC_APP, TASK_PGWC_SX);
   sx_smr->seid       = ppc->up_fseid.seid;
+  sx_smr->l_seid     = ppc->seid;
   sx_smr->trxn_id    = this->trxn_id;
   sx_smr->r_endpoint = endpoint(ppc->up_fseid.ipv4_address, pgw_cfg.pfcp_.port);
-  sx_triggered =
-      std::shared_ptr<itti_sxab_session_modification_request>(sx_smr);
+  sx_triggered = itti_msg_shared(sx_smr);
 
   //-------------------
   // IE fseid_t
@@ -960,6 +1038,22 @@ void release_access_bearers_procedure::handle_itti_msg(
   }
 }
 //------------------------------------------------------------------------------
+void release_access_bearers_procedure::handle_itti_msg(
+    itti_sxab_remote_peer_not_responding& m) {
+  ::cause_t gtp_cause = {
+      .cause_value = NO_RESOURCES_AVAILABLE, .pce = 0, .bce = 0, .cs = 0};
+  s5_triggered_pending->gtp_ies.set(gtp_cause);
+  Logger::pgwc_app().info(
+      "Sending ITTI message %s to task TASK_PGWC_S5S8",
+      s5_triggered_pending->gtp_ies.get_msg_name());
+  int ret = itti_inst->send_msg(s5_triggered_pending);
+  if (RETURNok != ret) {
+    Logger::pgwc_app().error(
+        "Could not send ITTI message %s to task TASK_PGWC_S5S8",
+        s5_triggered_pending->gtp_ies.get_msg_name());
+  }
+}
+//------------------------------------------------------------------------------
 int delete_session_procedure::run(
     std::shared_ptr<itti_s5s8_delete_session_request>& req,
     std::shared_ptr<itti_s5s8_delete_session_response>& resp,
@@ -973,9 +1067,10 @@ int delete_session_procedure::run(
   itti_sxab_session_deletion_request* sx =
       new itti_sxab_session_deletion_request(TASK_PGWC_APP, TASK_PGWC_SX);
   sx->seid       = ppc->up_fseid.seid;
+  sx->l_seid     = ppc->seid;
   sx->trxn_id    = this->trxn_id;
   sx->r_endpoint = endpoint(ppc->up_fseid.ipv4_address, pgw_cfg.pfcp_.port);
-  sx_triggered   = std::shared_ptr<itti_sxab_session_deletion_request>(sx);
+  sx_triggered   = itti_msg_shared(sx);
 
   Logger::pgwc_app().info(
       "Sending ITTI message %s to task TASK_PGWC_SX",
@@ -1018,6 +1113,18 @@ void delete_session_procedure::handle_itti_msg(
     }
   }
 
+  complete(gtp_cause);
+}
+//------------------------------------------------------------------------------
+void delete_session_procedure::handle_itti_msg(
+    itti_sxab_remote_peer_not_responding& m) {
+  // the session is released on the CP whatever the state of the UP
+  ::cause_t gtp_cause = {
+      .cause_value = REQUEST_ACCEPTED, .pce = 0, .bce = 0, .cs = 0};
+  complete(gtp_cause);
+}
+//------------------------------------------------------------------------------
+void delete_session_procedure::complete(const ::cause_t& gtp_cause) {
   s5_triggered_pending->gtp_ies.set(gtp_cause);
 
   Logger::pgwc_app().info(
@@ -1056,7 +1163,7 @@ int downlink_data_report_procedure::run(
   s5->r_endpoint =
       endpoint(ppc->sgw_fteid_s5_s8_cp.ipv4_address, pgw_cfg.gtpv2c_.port);
   s5->gtp_ies.set(e);
-  s5_triggered = std::shared_ptr<itti_s5s8_downlink_data_notification>(s5);
+  s5_triggered = itti_msg_shared(s5);
 
   Logger::pgwc_app().info(
       "Sending ITTI message %s to task TASK_PGWC_S5S8",
@@ -1098,7 +1205,7 @@ void downlink_data_report_procedure::handle_itti_msg(
   sx->trxn_id    = this->trxn_id;
   sx->r_endpoint = endpoint(ppc->up_fseid.ipv4_address, pgw_cfg.pfcp_.port);
   std::shared_ptr<itti_sxab_session_report_response> sx_triggered =
-      std::shared_ptr<itti_sxab_session_report_response>(sx);
+      itti_msg_shared(sx);
   sx->pfcp_ies.set(pfcp_cause);
   int ret = itti_inst->send_msg(sx_triggered);
   if (RETURNok != ret) {
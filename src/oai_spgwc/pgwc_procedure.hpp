@@ -66,6 +66,7 @@ class pgw_procedure {
   }
   virtual void handle_itti_msg(itti_sxab_session_modification_response& resp) {}
   virtual void handle_itti_msg(itti_sxab_session_deletion_response& resp) {}
+  virtual void handle_itti_msg(itti_sxab_remote_peer_not_responding& m) {}
   virtual void handle_itti_msg(
       itti_s5s8_downlink_data_notification_acknowledge& resp) {}
 };
@@ -109,6 +110,7 @@ class session_establishment_procedure : public pgw_procedure {
       std::shared_ptr<itti_s5s8_create_session_response>& resp,
       std::shared_ptr<pgwc::pgw_context> pc);
   void handle_itti_msg(itti_sxab_session_establishment_response& resp);
+  void handle_itti_msg(itti_sxab_remote_peer_not_responding& m);
 
   //~session_establishment_procedure() {}
 
@@ -133,6 +135,7 @@ class modify_bearer_procedure : public pgw_procedure {
       std::shared_ptr<itti_s5s8_modify_bearer_response>& resp,
       std::shared_ptr<pgwc::pgw_context> pc);
   void handle_itti_msg(itti_sxab_session_modification_response& resp);
+  void handle_itti_msg(itti_sxab_remote_peer_not_responding& m);
 
   //~modify_bearer_procedure() {}
 
@@ -157,6 +160,7 @@ class release_access_bearers_procedure : public pgw_procedure {
       std::shared_ptr<itti_s5s8_release_access_bearers_response>& resp,
       std::shared_ptr<pgwc::pgw_context> pc);
   void handle_itti_msg(itti_sxab_session_modification_response& resp);
+  void handle_itti_msg(itti_sxab_remote_peer_not_responding& m);
 
   //~release_access_bearers_procedure() {}
 
@@ -185,6 +189,10 @@ class delete_session_procedure : public pgw_procedure {
       std::shared_ptr<itti_s5s8_delete_session_response>& resp,
       std::shared_ptr<pgwc::pgw_context> pc);
   void handle_itti_msg(itti_sxab_session_deletion_response& resp);
+  void handle_itti_msg(itti_sxab_remote_peer_not_responding& m);
+  /** \brief Send the Delete Session Response, delete the PDN connection
+   **/
+  void complete(const ::cause_t& gtp_cause);
 
   //~delete_session_procedure() {}
 
@@ -27,9 +27,11 @@
 */
 
 #include "pgwc_sxab.hpp"
+#include "alloc_stats.hpp"
 #include "common_defs.h"
 #include "itti.hpp"
 #include "logger.hpp"
+#include "pgw_app.hpp"
 #include "pgw_config.hpp"
 #include "PfcpUpNodes.hpp"
 
@@ -53,147 +55,42 @@ void pgwc_sxab_task(void* args_p) {
   const task_id_t task_id = TASK_PGWC_SX;
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case SXAB_HEARTBEAT_REQUEST:
-        if (itti_sxab_heartbeat_request* m =
-                dynamic_cast<itti_sxab_heartbeat_request*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
+  itti_dispatcher dispatcher(task_id, Logger::pgwc_sx());
+  dispatcher
+      .on_each<
+          SXAB_HEARTBEAT_REQUEST,
+          SXAB_HEARTBEAT_RESPONSE,
+          SXAB_ASSOCIATION_SETUP_RESPONSE,
+          SXAB_ASSOCIATION_UPDATE_REQUEST,
+          SXAB_ASSOCIATION_UPDATE_RESPONSE,
+          SXAB_ASSOCIATION_RELEASE_REQUEST,
+          SXAB_ASSOCIATION_RELEASE_RESPONSE,
+          SXAB_VERSION_NOT_SUPPORTED_RESPONSE,
+          SXAB_NODE_REPORT_RESPONSE,
+          SXAB_SESSION_SET_DELETION_REQUEST>(
+          [](auto m) { pgwc_sxab_inst->handle_itti_msg(std::ref(*m)); })
+      .on_each<
+          SXAB_ASSOCIATION_SETUP_REQUEST,
+          SXAB_SESSION_ESTABLISHMENT_REQUEST,
+          SXAB_SESSION_MODIFICATION_REQUEST,
+          SXAB_SESSION_DELETION_REQUEST,
+          SXAB_SESSION_REPORT_RESPONSE>(
+          [](auto m) { pgwc_sxab_inst->send_sx_msg(std::ref(*m)); })
+      .on<TIME_OUT>([](auto to) {
+        Logger::pgwc_sx().trace(
+            "TIME-OUT event timer id %d arg1 %d", to->timer_id, to->arg1_user);
+        switch (to->arg1_user) {
+          case TASK_PGWC_SX_TRIGGER_HEARTBEAT_REQUEST:
+            pfcp_associations::get_instance().initiate_heartbeat_request(
+                to->timer_id, to->arg2_user);
+            break;
+          default:
+            pgwc_sxab_inst->time_out_itti_event(to->timer_id);
         }
-        break;
-
-      case SXAB_HEARTBEAT_RESPONSE:
-        if (itti_sxab_heartbeat_response* m =
-                dynamic_cast<itti_sxab_heartbeat_response*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_ASSOCIATION_SETUP_REQUEST:
-        if (itti_sxab_association_setup_request* m =
-                dynamic_cast<itti_sxab_association_setup_request*>(msg)) {
-          // pgwc_sxab_inst->handle_itti_msg(ref(*m));
-          pgwc_sxab_inst->send_sx_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_ASSOCIATION_SETUP_RESPONSE:
-        if (itti_sxab_association_setup_response* m =
-                dynamic_cast<itti_sxab_association_setup_response*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_ASSOCIATION_UPDATE_REQUEST:
-        if (itti_sxab_association_update_request* m =
-                dynamic_cast<itti_sxab_association_update_request*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_ASSOCIATION_UPDATE_RESPONSE:
-        if (itti_sxab_association_update_response* m =
-                dynamic_cast<itti_sxab_association_update_response*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_ASSOCIATION_RELEASE_REQUEST:
-        if (itti_sxab_association_release_request* m =
-                dynamic_cast<itti_sxab_association_release_request*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_ASSOCIATION_RELEASE_RESPONSE:
-        if (itti_sxab_association_release_response* m =
-                dynamic_cast<itti_sxab_association_release_response*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_VERSION_NOT_SUPPORTED_RESPONSE:
-        if (itti_sxab_version_not_supported_response* m =
-                dynamic_cast<itti_sxab_version_not_supported_response*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_NODE_REPORT_RESPONSE:
-        if (itti_sxab_node_report_response* m =
-                dynamic_cast<itti_sxab_node_report_response*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_SET_DELETION_REQUEST:
-        if (itti_sxab_session_set_deletion_request* m =
-                dynamic_cast<itti_sxab_session_set_deletion_request*>(msg)) {
-          pgwc_sxab_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_ESTABLISHMENT_REQUEST:
-        if (itti_sxab_session_establishment_request* m =
-                dynamic_cast<itti_sxab_session_establishment_request*>(msg)) {
-          pgwc_sxab_inst->send_sx_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_MODIFICATION_REQUEST:
-        if (itti_sxab_session_modification_request* m =
-                dynamic_cast<itti_sxab_session_modification_request*>(msg)) {
-          pgwc_sxab_inst->send_sx_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_DELETION_REQUEST:
-        if (itti_sxab_session_deletion_request* m =
-                dynamic_cast<itti_sxab_session_deletion_request*>(msg)) {
-          pgwc_sxab_inst->send_sx_msg(ref(*m));
-        }
-        break;
-
-      case SXAB_SESSION_REPORT_RESPONSE:
-        if (itti_sxab_session_report_response* m =
-                dynamic_cast<itti_sxab_session_report_response*>(msg)) {
-          pgwc_sxab_inst->send_sx_msg(ref(*m));
-        }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::pgwc_sx().trace(
-              "TIME-OUT event timer id %d arg1 %d", to->timer_id,
-              to->arg1_user);
-          switch (to->arg1_user) {
-            case TASK_PGWC_SX_TRIGGER_HEARTBEAT_REQUEST:
-              pfcp_associations::get_instance().initiate_heartbeat_request(
-                  to->timer_id, to->arg2_user);
-              break;
-            default:
-              pgwc_sxab_inst->time_out_itti_event(to->timer_id);
-          }
-        }
-        break;
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::pgwc_sx().info("Received terminate message");
-          return;
-        }
-        break;
-
-      case HEALTH_PING:
-        break;
-
-      default:
-        Logger::pgwc_sx().info("no handler for msg type %d", msg->msg_type);
-    }
-
-  } while (true);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
+  pgwc_sxab_inst->stop();
 }
 
 //------------------------------------------------------------------------------
@@ -201,7 +98,9 @@ pgwc_sxab::pgwc_sxab()
     : pfcp_l4_stack(
           pgw_cfg.pfcp_.t1_ms, pgw_cfg.pfcp_.n1,
           string(inet_ntoa(pgw_cfg.sx_.iface.addr4)), pgw_cfg.pfcp_.port,
-          pgw_cfg.pfcp_.sched_params) {
+          pgw_cfg.pfcp_.sched_params, pgw_cfg.pfcp_.worker_threads,
+          pgw_cfg.pfcp_.udp_batch_size, pgw_cfg.pfcp_.use_io_uring,
+          pgw_cfg.pfcp_.max_concurrent_procedures) {
   Logger::pgwc_sx().startup("Starting...");
   // TODO  refine this, look at RFC5905
   std::tm tm_epoch       = {0};          // Feb 8th, 2036
@@ -229,36 +128,36 @@ pgwc_sxab::pgwc_sxab()
 
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_pfcp_msg(
-    pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp_msg& msg, const pfcp_view& ies, const endpoint& remote_endpoint) {
   Logger::pgwc_sx().trace(
       "handle_receive_pfcp_msg msg type %d length %d", msg.get_message_type(),
       msg.get_message_length());
   switch (msg.get_message_type()) {
     case PFCP_ASSOCIATION_SETUP_REQUEST:
-      handle_receive_association_setup_request(msg, remote_endpoint);
+      handle_receive_association_setup_request(msg, ies, remote_endpoint);
       break;
     case PFCP_HEARTBEAT_REQUEST:
-      handle_receive_heartbeat_request(msg, remote_endpoint);
+      handle_receive_heartbeat_request(msg, ies, remote_endpoint);
       break;
     case PFCP_HEARTBEAT_RESPONSE:
-      handle_receive_heartbeat_response(msg, remote_endpoint);
+      handle_receive_heartbeat_response(msg, ies, remote_endpoint);
       break;
     case PFCP_SESSION_ESTABLISHMENT_RESPONSE:
-      handle_receive_session_establishment_response(msg, remote_endpoint);
+      handle_receive_session_establishment_response(msg, ies, remote_endpoint);
       break;
     case PFCP_SESSION_MODIFICATION_RESPONSE:
-      handle_receive_session_modification_response(msg, remote_endpoint);
+      handle_receive_session_modification_response(msg, ies, remote_endpoint);
       break;
     case PFCP_SESSION_DELETION_RESPONSE:
-      handle_receive_session_deletion_response(msg, remote_endpoint);
+      handle_receive_session_deletion_response(msg, ies, remote_endpoint);
       break;
     case PFCP_SESSION_REPORT_REQUEST:
-      handle_receive_session_report_request(msg, remote_endpoint);
+      handle_receive_session_report_request(msg, ies, remote_endpoint);
       break;
     case PFCP_PFCP_PFD_MANAGEMENT_REQUEST:
     case PFCP_PFCP_PFD_MANAGEMENT_RESPONSE:
     case PFCP_ASSOCIATION_SETUP_RESPONSE:
-      handle_receive_association_setup_response(msg, remote_endpoint);
+      handle_receive_association_setup_response(msg, ies, remote_endpoint);
       break;
     case PFCP_ASSOCIATION_UPDATE_REQUEST:
     case PFCP_ASSOCIATION_UPDATE_RESPONSE:
@@ -285,11 +184,12 @@ void pgwc_sxab::handle_receive_pfcp_msg(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_heartbeat_request(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                               = true;
   uint64_t trxn_id                         = 0;
   pfcp_heartbeat_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
@@ -307,11 +207,12 @@ void pgwc_sxab::handle_receive_heartbeat_request(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_heartbeat_response(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                = true;
   uint64_t trxn_id                          = 0;
   pfcp_heartbeat_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
@@ -328,11 +229,12 @@ void pgwc_sxab::handle_receive_heartbeat_response(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_association_setup_request(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                       = true;
   uint64_t trxn_id                                 = 0;
   pfcp_association_setup_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
@@ -359,14 +261,15 @@ void pgwc_sxab::handle_receive_association_setup_request(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_association_setup_response(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   // TODO: To be completed
   Logger::pgwc_sx().info(
       "Received SX ASSOCIATION SETUP RESPONSE from an UP NODE");
   bool error                                        = true;
   uint64_t trxn_id                                  = 0;
   pfcp_association_setup_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SPGWU_SX, error, trxn_id);
@@ -395,23 +298,31 @@ void pgwc_sxab::handle_receive_association_setup_response(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_session_establishment_response(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
+  util::alloc_scope allocs;
   bool error                                            = true;
   uint64_t trxn_id                                      = 0;
   pfcp_session_establishment_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
     itti_sxab_session_establishment_response* itti_msg =
         new itti_sxab_session_establishment_response(
-            TASK_PGWC_SX, TASK_PGWC_APP);
-    itti_msg->pfcp_ies   = msg_ies_container;
+            TASK_PGWC_SX, pgw_app::seid_2_task(msg.get_seid()));
+    itti_msg->pfcp_ies   = std::move(msg_ies_container);
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->trxn_id    = trxn_id;
     itti_msg->seid       = msg.get_seid();
     std::shared_ptr<itti_sxab_session_establishment_response> i =
-        std::shared_ptr<itti_sxab_session_establishment_response>(itti_msg);
+        itti_msg_shared(itti_msg);
+#if ALLOC_STATS
+    Logger::pgwc_sx().debug(
+        "Session Establishment Response received, %" PRIu64
+        " allocations (%" PRIu64 " bytes)",
+        allocs.elapsed().allocations, allocs.elapsed().bytes);
+#endif
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_sx().error(
@@ -423,23 +334,24 @@ void pgwc_sxab::handle_receive_session_establishment_response(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_session_modification_response(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                           = true;
   uint64_t trxn_id                                     = 0;
   pfcp_session_modification_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
     itti_sxab_session_modification_response* itti_msg =
         new itti_sxab_session_modification_response(
-            TASK_PGWC_SX, TASK_PGWC_APP);
+            TASK_PGWC_SX, pgw_app::seid_2_task(msg.get_seid()));
     itti_msg->pfcp_ies   = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->trxn_id    = trxn_id;
     itti_msg->seid       = msg.get_seid();
     std::shared_ptr<itti_sxab_session_modification_response> i =
-        std::shared_ptr<itti_sxab_session_modification_response>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_sx().error(
@@ -451,22 +363,24 @@ void pgwc_sxab::handle_receive_session_modification_response(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_session_deletion_response(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                       = true;
   uint64_t trxn_id                                 = 0;
   pfcp_session_deletion_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
     itti_sxab_session_deletion_response* itti_msg =
-        new itti_sxab_session_deletion_response(TASK_PGWC_SX, TASK_PGWC_APP);
+        new itti_sxab_session_deletion_response(
+            TASK_PGWC_SX, pgw_app::seid_2_task(msg.get_seid()));
     itti_msg->pfcp_ies   = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->trxn_id    = trxn_id;
     itti_msg->seid       = msg.get_seid();
     std::shared_ptr<itti_sxab_session_deletion_response> i =
-        std::shared_ptr<itti_sxab_session_deletion_response>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_sx().error(
@@ -478,22 +392,24 @@ void pgwc_sxab::handle_receive_session_deletion_response(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive_session_report_request(
-    pfcp::pfcp_msg& msg, const endpoint& remote_endpoint) {
+    pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                    = true;
   uint64_t trxn_id                              = 0;
   pfcp_session_report_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  pfcp_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(msg, remote_endpoint, TASK_PGWC_SX, error, trxn_id);
   if (!error) {
     itti_sxab_session_report_request* itti_msg =
-        new itti_sxab_session_report_request(TASK_PGWC_SX, TASK_PGWC_APP);
+        new itti_sxab_session_report_request(
+            TASK_PGWC_SX, pgw_app::seid_2_task(msg.get_seid()));
     itti_msg->pfcp_ies   = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->trxn_id    = trxn_id;
     itti_msg->seid       = msg.get_seid();
     std::shared_ptr<itti_sxab_session_report_request> i =
-        std::shared_ptr<itti_sxab_session_report_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::pgwc_sx().error(
@@ -547,15 +463,25 @@ void pgwc_sxab::send_heartbeat_response(
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::send_sx_msg(itti_sxab_session_establishment_request& i) {
-  send_request(i.r_endpoint, i.seid, i.pfcp_ies, TASK_PGWC_SX, i.trxn_id);
+  util::alloc_scope allocs;
+  send_request(
+      i.r_endpoint, i.seid, i.l_seid, i.pfcp_ies, TASK_PGWC_SX, i.trxn_id);
+#if ALLOC_STATS
+  Logger::pgwc_sx().debug(
+      "Session Establishment Request sent, %" PRIu64 " allocations (%" PRIu64
+      " bytes)",
+      allocs.elapsed().allocations, allocs.elapsed().bytes);
+#endif
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::send_sx_msg(itti_sxab_session_modification_request& i) {
-  send_request(i.r_endpoint, i.seid, i.pfcp_ies, TASK_PGWC_SX, i.trxn_id);
+  send_request(
+      i.r_endpoint, i.seid, i.l_seid, i.pfcp_ies, TASK_PGWC_SX, i.trxn_id);
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::send_sx_msg(itti_sxab_session_deletion_request& i) {
-  send_request(i.r_endpoint, i.seid, i.pfcp_ies, TASK_PGWC_SX, i.trxn_id);
+  send_request(
+      i.r_endpoint, i.seid, i.l_seid, i.pfcp_ies, TASK_PGWC_SX, i.trxn_id);
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::handle_receive(
@@ -563,13 +489,12 @@ void pgwc_sxab::handle_receive(
     const endpoint& remote_endpoint) {
   Logger::pgwc_sx().info("handle_receive(%d bytes)", bytes_transferred);
   // std::cout << string_to_hex(recv_buffer, bytes_transferred) << std::endl;
-  std::istringstream iss(std::istringstream::binary);
-  iss.rdbuf()->pubsetbuf(recv_buffer, bytes_transferred);
   pfcp_msg msg    = {};
   msg.remote_port = remote_endpoint.port();
   try {
-    msg.load_from(iss);
-    handle_receive_pfcp_msg(msg, remote_endpoint);
+    pfcp_view ies = pfcp_decoder::decode_header(
+        reinterpret_cast<const uint8_t*>(recv_buffer), bytes_transferred, msg);
+    handle_receive_pfcp_msg(msg, ies, remote_endpoint);
   } catch (pfcp_exception& e) {
     Logger::pgwc_sx().info("handle_receive exception %s", e.what());
   }
@@ -584,9 +509,9 @@ void pgwc_sxab::time_out_itti_event(const uint32_t timer_id) {
 }
 //------------------------------------------------------------------------------
 void pgwc_sxab::notify_ul_error(
-    const endpoint& remote_endpoint, const uint8_t message_type,
-    const uint32_t message_sequence_number, const uint64_t trxn_id,
-    const ::cause_value_e cause) {
+    const endpoint& remote_endpoint, const uint64_t l_seid,
+    const uint8_t message_type, const uint32_t message_sequence_number,
+    const uint64_t trxn_id, const ::cause_value_e cause) {
   Logger::pgwc_sx().trace(
       "notify_ul_error proc %" PRId64 " cause %d", trxn_id, cause);
   // TODO if needed: collection registering subscribers for events.
@@ -597,6 +522,26 @@ void pgwc_sxab::notify_ul_error(
         pfcp_associations::get_instance().timeout_heartbeat_request(
             trxn_id, remote_endpoint);
         break;
+      case PFCP_SESSION_ESTABLISHMENT_REQUEST:
+      case PFCP_SESSION_MODIFICATION_REQUEST:
+      case PFCP_SESSION_DELETION_REQUEST: {
+        // the procedure of the session fails on the worker owning it
+        itti_sxab_remote_peer_not_responding* itti_msg =
+            new itti_sxab_remote_peer_not_responding(
+                TASK_PGWC_SX, pgw_app::seid_2_task(l_seid));
+        itti_msg->r_endpoint   = remote_endpoint;
+        itti_msg->trxn_id      = trxn_id;
+        itti_msg->seid         = l_seid;
+        itti_msg->message_type = message_type;
+        std::shared_ptr<itti_sxab_remote_peer_not_responding> i =
+            itti_msg_shared(itti_msg);
+        int ret = itti_inst->send_msg(i);
+        if (RETURNok != ret) {
+          Logger::pgwc_sx().error(
+              "Could not send ITTI message %s to task TASK_PGWC_APP",
+              i->get_msg_name());
+        }
+      } break;
       default:
           // TODO later, for stats, etc
           ;
@@ -34,6 +34,7 @@
 //--Other includes -------------------------------------------------------------
 #include "itti_msg_sxab.hpp"
 #include "pfcp.hpp"
+#include "pfcp_decoder.hpp"
 #include "pgw_pfcp_association.hpp"
 
 namespace pgwc {
@@ -92,28 +93,38 @@ class pgwc_sxab : public pfcp::pfcp_l4_stack {
   void send_heartbeat_response(
       const endpoint& r_endpoint, const uint64_t trxn_id);
 
-  void handle_receive_pfcp_msg(pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+  void handle_receive_pfcp_msg(
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive(
       char* recv_buffer, const std::size_t bytes_transferred,
       const endpoint& r_endpoint);
 
   void handle_receive_heartbeat_request(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive_heartbeat_response(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive_association_setup_request(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive_association_setup_response(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
 
   void handle_receive_session_establishment_response(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive_session_modification_response(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive_session_deletion_response(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
   void handle_receive_session_report_request(
-      pfcp::pfcp_msg& msg, const endpoint& r_endpoint);
+      pfcp::pfcp_msg& msg, const pfcp::pfcp_view& ies,
+      const endpoint& r_endpoint);
 
   void time_out_itti_event(const uint32_t timer_id);
 
@@ -125,9 +136,9 @@ class pgwc_sxab : public pfcp::pfcp_l4_stack {
 
  protected:
   void notify_ul_error(
-      const endpoint& remote_endpoint, const uint8_t message_type,
-      const uint32_t message_sequence_number, const uint64_t trxn_id,
-      const ::cause_value_e cause);
+      const endpoint& remote_endpoint, const uint64_t l_seid,
+      const uint8_t message_type, const uint32_t message_sequence_number,
+      const uint64_t trxn_id, const ::cause_value_e cause);
 };
 }  // namespace pgwc
 #endif /* FILE_PGWC_SXAB_HPP_SEEN */
@@ -37,6 +37,7 @@
 #include "sgwc_s11.hpp"
 #include "sgwc_s5s8.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace gtpv2c;
@@ -59,82 +60,141 @@ extern pgwc::pgw_config pgw_cfg;
 void sgwc_app_task(void*);
 
 //------------------------------------------------------------------------------
-teid_t sgwc_app::generate_s11_cp_teid() {
-  teid_t loop_detect_teid = teid_s11_cp;
-  teid_t teid             = ++teid_s11_cp;
-  while ((is_s11c_teid_exist(teid)) || (teid == UNASSIGNED_TEID)) {
-    teid = ++teid_s11_cp;
-    if (loop_detect_teid == teid) return UNASSIGNED_TEID;
-  }
-  return teid;
+uint32_t sgwc_app::get_num_workers() {
+  return pgwc::pgw_config::spgw_app_.worker_threads;
+}
+//------------------------------------------------------------------------------
+void sgwc_app::get_teid_range(
+    const uint32_t shard, teid_t& first_teid, teid_t& last_teid) {
+  const uint64_t range = (((uint64_t) UINT32_MAX) + 1) / get_num_workers();
+  first_teid           = (teid_t)(shard * range);
+  // the last range gets the remainder of the division
+  last_teid = (shard == (get_num_workers() - 1)) ?
+                  UINT32_MAX :
+                  (teid_t)(first_teid + range - 1);
+}
+//------------------------------------------------------------------------------
+uint32_t sgwc_app::teid_2_shard(const teid_t& teid) {
+  const uint64_t range = (((uint64_t) UINT32_MAX) + 1) / get_num_workers();
+  return std::min((uint32_t)(teid / range), get_num_workers() - 1);
+}
+//------------------------------------------------------------------------------
+uint32_t sgwc_app::imsi64_2_shard(const imsi64_t& imsi64) {
+  return imsi64 % get_num_workers();
 }
 //------------------------------------------------------------------------------
-teid_t sgwc_app::generate_s5s8_cp_teid() {
-  teid_t loop_detect_teid = teid_s5s8_cp;
-  teid_t teid             = ++teid_s5s8_cp;
-  while ((is_s5s8c_teid_exist(teid)) || (teid == UNASSIGNED_TEID)) {
-    teid = ++teid_s5s8_cp;
-    if (loop_detect_teid == teid) return UNASSIGNED_TEID;
+task_id_t sgwc_app::create_session_request_2_task(
+    const teid_t& teid, const gtpv2c::gtpv2c_create_session_request& gtp_ies) {
+  if (teid) {
+    return teid_2_task(teid);
   }
-  return teid;
+  imsi_t imsi = {};
+  if (gtp_ies.get(imsi)) {
+    return shard_2_task(imsi64_2_shard(imsi.to_imsi64()));
+  }
+  return TASK_SGWC_APP;
+}
+//------------------------------------------------------------------------------
+teid_t sgwc_app::generate_s11_cp_teid(const uint32_t shard) {
+  teid_t first_teid = 0;
+  teid_t last_teid  = 0;
+  get_teid_range(shard, first_teid, last_teid);
+  teid_t& teid            = teid_s11_cp[shard];
+  teid_t loop_detect_teid = teid;
+  do {
+    teid = (teid == last_teid) ? first_teid : teid + 1;
+    if ((teid != UNASSIGNED_TEID) && (not is_s11c_teid_exist(teid))) {
+      return teid;
+    }
+  } while (teid != loop_detect_teid);
+  return UNASSIGNED_TEID;
+}
+//------------------------------------------------------------------------------
+teid_t sgwc_app::generate_s5s8_cp_teid(const uint32_t shard) {
+  teid_t first_teid = 0;
+  teid_t last_teid  = 0;
+  get_teid_range(shard, first_teid, last_teid);
+  teid_t& teid            = teid_s5s8_cp[shard];
+  teid_t loop_detect_teid = teid;
+  do {
+    teid = (teid == last_teid) ? first_teid : teid + 1;
+    if ((teid != UNASSIGNED_TEID) && (not is_s5s8c_teid_exist(teid))) {
+      return teid;
+    }
+  } while (teid != loop_detect_teid);
+  return UNASSIGNED_TEID;
 }
 
 //------------------------------------------------------------------------------
 bool sgwc_app::is_s11c_teid_exist(const teid_t& teid_s11_cp) const {
-  return bool{s11lteid2sgw_eps_bearer_context.count(teid_s11_cp) > 0};
+  return s11lteid2sgw_eps_bearer_context.find(teid_s11_cp) !=
+         s11lteid2sgw_eps_bearer_context.cend();
 }
 //------------------------------------------------------------------------------
 bool sgwc_app::is_s5s8c_teid_exist(const teid_t& teid_s5s8_cp) const {
-  return bool{s5s8lteid2sgw_contexts.count(teid_s5s8_cp) > 0};
+  return s5s8lteid2sgw_contexts.find(teid_s5s8_cp) !=
+         s5s8lteid2sgw_contexts.cend();
 }
 //------------------------------------------------------------------------------
-fteid_t sgwc_app::generate_s11_cp_fteid(const struct in_addr ipv4_address) {
+fteid_t sgwc_app::generate_s11_cp_fteid(
+    const uint32_t shard, const struct in_addr ipv4_address) {
   fteid_t fteid        = {};
   fteid.interface_type = S11_S4_SGW_GTP_C;
   fteid.v4             = 1;
   fteid.ipv4_address   = ipv4_address;
   fteid.v6             = 0;
   fteid.ipv6_address   = in6addr_any;
-  fteid.teid_gre_key   = generate_s11_cp_teid();
+  fteid.teid_gre_key   = generate_s11_cp_teid(shard);
   return fteid;
 }
 //------------------------------------------------------------------------------
-fteid_t sgwc_app::generate_s5s8_cp_fteid(const struct in_addr ipv4_address) {
+fteid_t sgwc_app::generate_s5s8_cp_fteid(
+    const uint32_t shard, const struct in_addr ipv4_address) {
   fteid_t fteid        = {};
   fteid.interface_type = S5_S8_SGW_GTP_C;
   fteid.v4             = 1;
   fteid.ipv4_address   = ipv4_address;
   fteid.v6             = 0;
   fteid.ipv6_address   = in6addr_any;
-  fteid.teid_gre_key   = generate_s5s8_cp_teid();
+  fteid.teid_gre_key   = generate_s5s8_cp_teid(shard);
   return fteid;
 }
 //------------------------------------------------------------------------------
 bool sgwc_app::is_s5s8sgw_teid_2_sgw_contexts(const teid_t& sgw_teid) const {
-  return bool{s5s8lteid2sgw_contexts.count(sgw_teid) > 0};
+  return s5s8lteid2sgw_contexts.find(sgw_teid) !=
+         s5s8lteid2sgw_contexts.cend();
 }
 //------------------------------------------------------------------------------
 bool sgwc_app::is_s11sgw_teid_2_sgw_eps_bearer_context(
     const teid_t& sgw_teid) const {
-  return bool{s11lteid2sgw_eps_bearer_context.count(sgw_teid) > 0};
+  return s11lteid2sgw_eps_bearer_context.find(sgw_teid) !=
+         s11lteid2sgw_eps_bearer_context.cend();
 }
 //------------------------------------------------------------------------------
 std::pair<
     std::shared_ptr<sgw_eps_bearer_context>,
     std::shared_ptr<sgw_pdn_connection>>
 sgwc_app::s5s8sgw_teid_2_sgw_contexts(const teid_t& sgw_teid) const {
-  return s5s8lteid2sgw_contexts.at(sgw_teid);
+  auto it = s5s8lteid2sgw_contexts.find(sgw_teid);
+  if (it == s5s8lteid2sgw_contexts.cend()) {
+    throw std::out_of_range("s5s8sgw_teid_2_sgw_contexts");
+  }
+  return it->second;
 }
 //------------------------------------------------------------------------------
 shared_ptr<sgw_eps_bearer_context>
 sgwc_app::s11sgw_teid_2_sgw_eps_bearer_context(const teid_t& sgw_teid) const {
-  return s11lteid2sgw_eps_bearer_context.at(sgw_teid);
+  auto it = s11lteid2sgw_eps_bearer_context.find(sgw_teid);
+  if (it == s11lteid2sgw_eps_bearer_context.cend()) {
+    throw std::out_of_range("s11sgw_teid_2_sgw_eps_bearer_context");
+  }
+  return it->second;
 }
 //------------------------------------------------------------------------------
 void sgwc_app::set_s5s8sgw_teid_2_sgw_contexts(
     const teid_t& sgw_teid, shared_ptr<sgw_eps_bearer_context> sebc,
     std::shared_ptr<sgw_pdn_connection> spc) {
-  s5s8lteid2sgw_contexts[sgw_teid] = std::make_pair(sebc, spc);
+  s5s8lteid2sgw_contexts.insert_or_assign(sgw_teid, std::make_pair(sebc, spc));
 }
 //------------------------------------------------------------------------------
 void sgwc_app::delete_s5s8sgw_teid_2_sgw_contexts(const teid_t& sgw_teid) {
@@ -144,22 +204,27 @@ void sgwc_app::delete_s5s8sgw_teid_2_sgw_contexts(const teid_t& sgw_teid) {
 //------------------------------------------------------------------------------
 void sgwc_app::set_s11sgw_teid_2_sgw_eps_bearer_context(
     const teid_t& sgw_teid, shared_ptr<sgw_eps_bearer_context> sebc) {
-  s11lteid2sgw_eps_bearer_context[sgw_teid] = sebc;
+  s11lteid2sgw_eps_bearer_context.insert_or_assign(sgw_teid, sebc);
 }
 //------------------------------------------------------------------------------
 bool sgwc_app::is_imsi64_2_sgw_eps_bearer_context(
     const imsi64_t& imsi64) const {
-  return bool{imsi2sgw_eps_bearer_context.count(imsi64) > 0};
+  return imsi2sgw_eps_bearer_context.find(imsi64) !=
+         imsi2sgw_eps_bearer_context.cend();
 }
 //------------------------------------------------------------------------------
 shared_ptr<sgw_eps_bearer_context> sgwc_app::imsi64_2_sgw_eps_bearer_context(
     const imsi64_t& imsi64) const {
-  return imsi2sgw_eps_bearer_context.at(imsi64);
+  auto it = imsi2sgw_eps_bearer_context.find(imsi64);
+  if (it == imsi2sgw_eps_bearer_context.cend()) {
+    throw std::out_of_range("imsi64_2_sgw_eps_bearer_context");
+  }
+  return it->second;
 }
 //------------------------------------------------------------------------------
 void sgwc_app::set_imsi64_2_sgw_eps_bearer_context(
     const imsi64_t& imsi64, shared_ptr<sgw_eps_bearer_context> sebc) {
-  imsi2sgw_eps_bearer_context[imsi64] = sebc;
+  imsi2sgw_eps_bearer_context.insert_or_assign(imsi64, sebc);
 }
 //------------------------------------------------------------------------------
 void sgwc_app::delete_sgw_eps_bearer_context(
@@ -176,135 +241,48 @@ void sgwc_app::delete_sgw_eps_bearer_context(
 }
 //------------------------------------------------------------------------------
 void sgwc_app_task(void* args_p) {
-  const task_id_t task_id = TASK_SGWC_APP;
+  const uint32_t shard    = (uint32_t)(uintptr_t) args_p;
+  const task_id_t task_id = sgwc_app::shard_2_task(shard);
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case S5S8_CREATE_SESSION_RESPONSE:
-        if (itti_s5s8_create_session_response* m =
-                dynamic_cast<itti_s5s8_create_session_response*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_DELETE_SESSION_RESPONSE:
-        if (itti_s5s8_delete_session_response* m =
-                dynamic_cast<itti_s5s8_delete_session_response*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_DOWNLINK_DATA_NOTIFICATION:
-        if (itti_s5s8_downlink_data_notification* m =
-                dynamic_cast<itti_s5s8_downlink_data_notification*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_MODIFY_BEARER_RESPONSE:
-        if (itti_s5s8_modify_bearer_response* m =
-                dynamic_cast<itti_s5s8_modify_bearer_response*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_RELEASE_ACCESS_BEARERS_RESPONSE:
-        if (itti_s5s8_release_access_bearers_response* m =
-                dynamic_cast<itti_s5s8_release_access_bearers_response*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_REMOTE_PEER_NOT_RESPONDING:
-        if (itti_s5s8_remote_peer_not_responding* m =
-                dynamic_cast<itti_s5s8_remote_peer_not_responding*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S11_CREATE_SESSION_REQUEST:
-        /*
-         * We received a create session request from MME (with GTP abstraction
-         * here) procedures might be: E-UTRAN Initial Attach UE requests PDN
-         * connectivity
-         */
-        if (itti_s11_create_session_request* m =
-                dynamic_cast<itti_s11_create_session_request*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S11_DELETE_SESSION_REQUEST:
-        if (itti_s11_delete_session_request* m =
-                dynamic_cast<itti_s11_delete_session_request*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S11_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE:
-        if (itti_s11_downlink_data_notification_acknowledge* m =
-                dynamic_cast<itti_s11_downlink_data_notification_acknowledge*>(
-                    msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S11_MODIFY_BEARER_REQUEST:
-        if (itti_s11_modify_bearer_request* m =
-                dynamic_cast<itti_s11_modify_bearer_request*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S11_RELEASE_ACCESS_BEARERS_REQUEST:
-        if (itti_s11_release_access_bearers_request* m =
-                dynamic_cast<itti_s11_release_access_bearers_request*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case S11_REMOTE_PEER_NOT_RESPONDING:
-        if (itti_s11_remote_peer_not_responding* m =
-                dynamic_cast<itti_s11_remote_peer_not_responding*>(msg)) {
-          sgwc_app_inst->handle_itti_msg(ref(*m));
-        }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::sgwc_app().info("TIME-OUT event timer id %d", to->timer_id);
-        }
-        break;
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::sgwc_app().info("Received terminate message");
-          return;
-        }
-        break;
-
-      case HEALTH_PING:
-        break;
-
-      default:
-        Logger::sgwc_app().info(
-            "no handler for ITTI msg type %d", msg->msg_type);
-    }
-  } while (true);
+  // S11_CREATE_SESSION_REQUEST: we received a create session request from MME
+  // (with GTP abstraction here) procedures might be: E-UTRAN Initial Attach UE
+  // requests PDN connectivity
+  itti_dispatcher dispatcher(task_id, Logger::sgwc_app());
+  dispatcher
+      .on_each<
+          S5S8_CREATE_SESSION_RESPONSE,
+          S5S8_DELETE_SESSION_RESPONSE,
+          S5S8_DOWNLINK_DATA_NOTIFICATION,
+          S5S8_MODIFY_BEARER_RESPONSE,
+          S5S8_RELEASE_ACCESS_BEARERS_RESPONSE,
+          S5S8_REMOTE_PEER_NOT_RESPONDING,
+          S11_CREATE_SESSION_REQUEST,
+          S11_DELETE_SESSION_REQUEST,
+          S11_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE,
+          S11_MODIFY_BEARER_REQUEST,
+          S11_RELEASE_ACCESS_BEARERS_REQUEST,
+          S11_REMOTE_PEER_NOT_RESPONDING>(
+          [](auto m) { sgwc_app_inst->handle_itti_msg(std::ref(*m)); })
+      .on<TIME_OUT>([](auto to) {
+        Logger::sgwc_app().info("TIME-OUT event timer id %d", to->timer_id);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
 }
 
 //------------------------------------------------------------------------------
 sgwc_app::sgwc_app(const std::string& config_file)
-    : s11lteid2sgw_eps_bearer_context() {
+    : imsi2sgw_eps_bearer_context(),
+      s11lteid2sgw_eps_bearer_context(),
+      s5s8lteid2sgw_contexts() {
   Logger::sgwc_app().startup("Starting...");
-  teid_s11_cp                     = 0;
-  teid_s5s8_cp                    = 0;
-  imsi2sgw_eps_bearer_context     = {};
-  s11lteid2sgw_eps_bearer_context = {};
-  s5s8lteid2sgw_contexts          = {};
+  for (uint32_t shard = 0; shard < get_num_workers(); shard++) {
+    teid_t first_teid = 0;
+    // first TEIDs generated will be the first ones of the range
+    get_teid_range(shard, first_teid, teid_s11_cp[shard]);
+    teid_s5s8_cp[shard] = teid_s11_cp[shard];
+  }
 
   try {
     sgw_s5s8_inst = new sgw_s5s8();
@@ -314,10 +292,15 @@ sgwc_app::sgwc_app(const std::string& config_file)
     throw;
   }
 
-  if (itti_inst->create_task(TASK_SGWC_APP, sgwc_app_task, nullptr)) {
-    Logger::sgwc_app().error("Cannot create task TASK_SGWC_APP");
-    throw std::runtime_error("Cannot create task TASK_SGWC_APP");
+  // Worker 0 is TASK_SGWC_APP
+  for (uint32_t shard = 0; shard < get_num_workers(); shard++) {
+    if (itti_inst->create_task(
+            shard_2_task(shard), sgwc_app_task, (void*) (uintptr_t) shard)) {
+      Logger::sgwc_app().error("Cannot create task TASK_SGWC_APP %u", shard);
+      throw std::runtime_error("Cannot create task TASK_SGWC_APP");
+    }
   }
+  Logger::sgwc_app().info("Started %u worker(s)", get_num_workers());
 }
 
 //------------------------------------------------------------------------------
@@ -450,6 +433,7 @@ void sgwc_app::handle_itti_msg(itti_s11_create_session_request& csreq) {
             imsi.toString().c_str());
         ebc = std::shared_ptr<sgw_eps_bearer_context>(
             new sgw_eps_bearer_context());
+        ebc->shard = imsi64_2_shard(imsi64);
         set_imsi64_2_sgw_eps_bearer_context(imsi64, ebc);
       }
     }
@@ -821,8 +805,7 @@ void sgwc_app::send_create_session_response_cause(
   s11->teid       = teid;
   s11->r_endpoint = r_endpoint;
   s11->gtp_ies.set(cause);
-  std::shared_ptr<itti_s11_create_session_response> msg =
-      std::shared_ptr<itti_s11_create_session_response>(s11);
+  std::shared_ptr<itti_s11_create_session_response> msg = itti_msg_shared(s11);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::sgwc_app().error(
@@ -34,7 +34,7 @@
 #include "itti_msg_s5s8.hpp"
 #include "sgwc_eps_bearer_context.hpp"
 
-#include <boost/atomic.hpp>
+#include <folly/concurrency/ConcurrentHashMap.h>
 
 #include <map>
 #include <memory>
@@ -49,25 +49,28 @@ class sgwc_app {
   std::thread::id thread_id;
   std::thread thread;
 
-  // teid generators (linear)
-  boost::atomic<teid_t> teid_s11_cp;
-  boost::atomic<teid_t> teid_s5s8_cp;
+  // teid generators (linear), one per worker, each one inside the TEID range
+  // of its worker
+  teid_t teid_s11_cp[TASK_SGWC_APP_MAX_WORKERS];
+  teid_t teid_s5s8_cp[TASK_SGWC_APP_MAX_WORKERS];
   /* There shall be only one pair of TEID-C per UE over the S11 and the S4
      interfaces. The same tunnel shall be shared for the control messages
      related to the same UE operation. A TEID-C on the S11/S4 interface shall be
      released after all its associated EPS bearers are deleted.*/
-  std::map<imsi64_t, std::shared_ptr<sgw_eps_bearer_context>>
+  // The maps are shared by all workers, a worker only reads and writes the
+  // entries of the contexts it owns.
+  folly::ConcurrentHashMap<imsi64_t, std::shared_ptr<sgw_eps_bearer_context>>
       imsi2sgw_eps_bearer_context;
-  std::map<teid_t, std::shared_ptr<sgw_eps_bearer_context>>
+  folly::ConcurrentHashMap<teid_t, std::shared_ptr<sgw_eps_bearer_context>>
       s11lteid2sgw_eps_bearer_context;
 
-  std::map<
+  folly::ConcurrentHashMap<
       teid_t, std::pair<
                   std::shared_ptr<sgw_eps_bearer_context>,
                   std::shared_ptr<sgw_pdn_connection>>>
       s5s8lteid2sgw_contexts;
 
-  teid_t generate_s11_cp_teid();
+  teid_t generate_s11_cp_teid(const uint32_t shard);
   bool is_s11c_teid_exist(const teid_t& teid_s11_cp) const;
 
   bool is_s5s8sgw_teid_2_sgw_contexts(const teid_t& sgw_teid) const;
@@ -79,7 +82,7 @@ class sgwc_app {
   void set_imsi64_2_sgw_eps_bearer_context(
       const imsi64_t& imsi64, std::shared_ptr<sgw_eps_bearer_context> sebc);
 
-  teid_t generate_s5s8_cp_teid();
+  teid_t generate_s5s8_cp_teid(const uint32_t shard);
   bool is_s5s8c_teid_exist(const teid_t& teid_s5s8_cp) const;
 
   bool is_s5s8u_teid_exist(const teid_t& teid_s5s8_up) const;
@@ -110,12 +113,36 @@ class sgwc_app {
   sgwc_app(sgwc_app const&) = delete;
   void operator=(sgwc_app const&) = delete;
 
+  /** \brief Number of workers (ITTI tasks TASK_SGWC_APP and following), from
+   *  the spgw_app/worker_threads setting. The local TEID space is split in as
+   *  many ranges, a worker allocating its S11 and S5S8 TEIDs in its own range
+   **/
+  static uint32_t get_num_workers();
+  static void get_teid_range(
+      const uint32_t shard, teid_t& first_teid, teid_t& last_teid);
+  static uint32_t teid_2_shard(const teid_t& teid);
+  static uint32_t imsi64_2_shard(const imsi64_t& imsi64);
+  static task_id_t shard_2_task(const uint32_t shard) {
+    return (task_id_t)(TASK_SGWC_APP + shard);
+  }
+  static task_id_t teid_2_task(const teid_t& teid) {
+    return shard_2_task(teid_2_shard(teid));
+  }
+  /** \brief Worker handling a S11 CREATE_SESSION_REQUEST: the one owning the
+   *  destination TEID if any, else the one owning the IMSI
+   **/
+  static task_id_t create_session_request_2_task(
+      const teid_t& teid,
+      const gtpv2c::gtpv2c_create_session_request& gtp_ies);
+
   void send_create_session_response_cause(
       const uint64_t gtpc_tx_id, const teid_t teid, const endpoint& r_endpoint,
       const cause_t& cause) const;
 
-  fteid_t generate_s5s8_cp_fteid(const struct in_addr ipv4_address);
-  fteid_t generate_s11_cp_fteid(const struct in_addr ipv4_address);
+  fteid_t generate_s5s8_cp_fteid(
+      const uint32_t shard, const struct in_addr ipv4_address);
+  fteid_t generate_s11_cp_fteid(
+      const uint32_t shard, const struct in_addr ipv4_address);
   std::pair<
       std::shared_ptr<sgw_eps_bearer_context>,
       std::shared_ptr<sgw_pdn_connection>>
@@ -324,8 +324,8 @@ void sgw_eps_bearer_context::delete_pdn_connection(
 void sgw_eps_bearer_context::handle_itti_msg(
     itti_s11_create_session_request& csreq) {
   if (sgw_fteid_s11_s4_cp.teid_gre_key == UNASSIGNED_TEID) {
-    sgw_fteid_s11_s4_cp =
-        sgwc_app_inst->generate_s11_cp_fteid(pgw_cfg.s11_.iface.addr4);
+    sgw_fteid_s11_s4_cp = sgwc_app_inst->generate_s11_cp_fteid(
+        shard, pgw_cfg.s11_.iface.addr4);
     sgwc_app_inst->set_s11sgw_teid_2_sgw_eps_bearer_context(
         sgw_fteid_s11_s4_cp.teid_gre_key, shared_from_this());
     mme_fteid_s11 = csreq.gtp_ies.sender_fteid_for_cp;
@@ -268,7 +268,8 @@ class sgw_eps_bearer_context
         sgsn_fteid_s4_cp(),
         last_known_cell_Id(),
         pending_procedures(),
-        pdn_connections() {}
+        pdn_connections(),
+        shard(0) {}
 
   void release();
   void create_procedure(itti_s11_create_session_request&);
@@ -372,6 +373,7 @@ class sgw_eps_bearer_context
   //--------------------------------------------
   // internals
   std::vector<std::shared_ptr<sebc_procedure>> pending_procedures;
+  uint32_t shard;  // sgwc_app worker owning this context and its TEIDs
 };
 }  // namespace sgwc
 
@@ -111,7 +111,7 @@ int create_session_request_procedure::run(
   p->default_bearer =
       msg.gtp_ies.bearer_contexts_to_be_created.at(0).eps_bearer_id;
   p->sgw_fteid_s5_s8_cp = sgwc_app_inst->generate_s5s8_cp_fteid(
-      pgwc::pgw_config::sgw_s5s8_.iface.addr4);
+      ebc->shard, pgwc::pgw_config::sgw_s5s8_.iface.addr4);
   sgwc_app_inst->set_s5s8sgw_teid_2_sgw_contexts(
       p->sgw_fteid_s5_s8_cp.teid_gre_key, c, spc);
 
@@ -219,7 +219,7 @@ int create_session_request_procedure::run(
       pgwc::pgw_config::pgw_s5s8_.iface.addr4, pgwc::pgw_config::gtpv2c_.port);
 
   std::shared_ptr<itti_s5s8_create_session_request> msg =
-      std::shared_ptr<itti_s5s8_create_session_request>(s5s8_csr);
+      itti_msg_shared(s5s8_csr);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::sgwc_app().error(
@@ -337,7 +337,7 @@ void create_session_request_procedure::handle_itti_msg(
   }
 
   std::shared_ptr<itti_s11_create_session_response> msg_send =
-      std::shared_ptr<itti_s11_create_session_response>(s11_csresp);
+      itti_msg_shared(s11_csresp);
   int ret = itti_inst->send_msg(msg_send);
   if (RETURNok != ret) {
     Logger::sgwc_app().error(
@@ -377,7 +377,7 @@ void create_session_request_procedure::handle_itti_msg(
   s11_csresp->gtp_ies.set_sender_fteid_for_cp(ebc->sgw_fteid_s11_s4_cp);
 
   std::shared_ptr<itti_s11_create_session_response> msg_send =
-      std::shared_ptr<itti_s11_create_session_response>(s11_csresp);
+      itti_msg_shared(s11_csresp);
   int ret = itti_inst->send_msg(msg_send);
   if (RETURNok != ret) {
     Logger::sgwc_app().error(
@@ -478,7 +478,7 @@ int delete_session_request_procedure::run(
     if (msg.gtp_ies.get(epco)) s5s8_dsr->gtp_ies.set(epco);
 
     std::shared_ptr<itti_s5s8_delete_session_request> msg =
-        std::shared_ptr<itti_s5s8_delete_session_request>(s5s8_dsr);
+        itti_msg_shared(s5s8_dsr);
     int ret = itti_inst->send_msg(msg);
     if (RETURNok != ret) {
       Logger::sgwc_app().error(
@@ -520,7 +520,7 @@ void delete_session_request_procedure::handle_itti_msg(
   ebc->delete_pdn_connection(pdn);
 
   std::shared_ptr<itti_s11_delete_session_response> msg =
-      std::shared_ptr<itti_s11_delete_session_response>(s11_dsresp);
+      itti_msg_shared(s11_dsresp);
   int ret = itti_inst->send_msg(msg);
   if (RETURNok != ret) {
     Logger::sgwc_app().error(
@@ -651,7 +651,7 @@ int modify_bearer_request_procedure::run(shared_ptr<sgw_eps_bearer_context> c) {
       }
 
       std::shared_ptr<itti_s11_modify_bearer_response> msg_send =
-          std::shared_ptr<itti_s11_modify_bearer_response>(s11_mbresp);
+          itti_msg_shared(s11_mbresp);
       int ret = itti_inst->send_msg(msg_send);
       if (RETURNok != ret) {
         Logger::sgwc_app().error(
@@ -668,7 +668,7 @@ int modify_bearer_request_procedure::run(shared_ptr<sgw_eps_bearer_context> c) {
         itti_s5s8_modify_bearer_request* s5s8_mbr =
             new itti_s5s8_modify_bearer_request(TASK_SGWC_APP, TASK_SGWC_S5S8);
         std::shared_ptr<itti_s5s8_modify_bearer_request> msg_s5s8 =
-            std::shared_ptr<itti_s5s8_modify_bearer_request>(s5s8_mbr);
+            itti_msg_shared(s5s8_mbr);
         // New gtpc_tx_id
         px->gtpc_tx_id =
             util::uint_uid_generator<uint64_t>::get_instance().get_uid();
@@ -860,7 +860,7 @@ void modify_bearer_request_procedure::handle_itti_msg(
         s11_resp->gtp_ies.set(global_cause);
 
         std::shared_ptr<itti_s11_modify_bearer_response> msg =
-            std::shared_ptr<itti_s11_modify_bearer_response>(s11_resp);
+            itti_msg_shared(s11_resp);
         int ret = itti_inst->send_msg(msg);
         if (RETURNok != ret) {
           Logger::sgwc_app().error(
@@ -951,7 +951,7 @@ int release_access_bearers_request_procedure::run(
             pgwc::pgw_config::gtpv2c_.port);
 
         std::shared_ptr<itti_s5s8_release_access_bearers_request> msg =
-            std::shared_ptr<itti_s5s8_release_access_bearers_request>(s5s8);
+            itti_msg_shared(s5s8);
         // breal->msg = msg;
 
         int ret = itti_inst->send_msg(msg);
@@ -979,7 +979,7 @@ int release_access_bearers_request_procedure::run(
       s11->gtp_ies.set(cause);
 
       std::shared_ptr<itti_s11_release_access_bearers_response> msg_send =
-          std::shared_ptr<itti_s11_release_access_bearers_response>(s11);
+          itti_msg_shared(s11);
       int ret = itti_inst->send_msg(msg_send);
       if (RETURNok != ret) {
         Logger::sgwc_app().error(
@@ -1056,7 +1056,7 @@ void release_access_bearers_request_procedure::handle_itti_msg(
       if (bearers.empty()) {
         // Send  response
         std::shared_ptr<itti_s11_release_access_bearers_response> msg =
-            std::shared_ptr<itti_s11_release_access_bearers_response>(s11_resp);
+            itti_msg_shared(s11_resp);
         int ret = itti_inst->send_msg(msg);
         if (RETURNok != ret) {
           Logger::sgwc_app().error(
@@ -1103,7 +1103,7 @@ int downlink_data_notification_procedure::run(
     s11->gtpc_tx_id = get_trxn_id();
     s11->r_endpoint =
         endpoint(ebc->mme_fteid_s11.ipv4_address, gtpv2c::default_port);
-    s11_triggered = std::shared_ptr<itti_s11_downlink_data_notification>(s11);
+    s11_triggered = itti_msg_shared(s11);
 
     Logger::sgwc_app().info(
         "Sending ITTI message %s to task TASK_SGWC_S11",
@@ -1129,8 +1129,7 @@ void downlink_data_notification_procedure::handle_itti_msg(
   s5->r_endpoint = endpoint(
       pdn_connection->pgw_fteid_s5_s8_cp.ipv4_address, gtpv2c::default_port);
   std::shared_ptr<itti_s5s8_downlink_data_notification_acknowledge>
-      s5_response =
-          std::shared_ptr<itti_s5s8_downlink_data_notification_acknowledge>(s5);
+      s5_response = itti_msg_shared(s5);
 
   Logger::sgwc_app().info(
       "Sending ITTI message %s to task TASK_SGWC_S5S8",
@@ -31,6 +31,7 @@
 #include "itti.hpp"
 #include "logger.hpp"
 #include "pgw_config.hpp"
+#include "sgwc_app.hpp"
 
 #include <stdexcept>
 
@@ -64,67 +65,22 @@ void sgw_s11_task(void* args_p) {
   const task_id_t task_id = TASK_SGWC_S11;
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case S11_CREATE_SESSION_RESPONSE:
-        if (itti_s11_create_session_response* m =
-                dynamic_cast<itti_s11_create_session_response*>(msg)) {
-          sgw_s11_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S11_DELETE_SESSION_RESPONSE:
-        if (itti_s11_delete_session_response* m =
-                dynamic_cast<itti_s11_delete_session_response*>(msg)) {
-          sgw_s11_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S11_MODIFY_BEARER_RESPONSE:
-        if (itti_s11_modify_bearer_response* m =
-                dynamic_cast<itti_s11_modify_bearer_response*>(msg)) {
-          sgw_s11_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S11_RELEASE_ACCESS_BEARERS_RESPONSE:
-        if (itti_s11_release_access_bearers_response* m =
-                dynamic_cast<itti_s11_release_access_bearers_response*>(msg)) {
-          sgw_s11_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S11_DOWNLINK_DATA_NOTIFICATION:
-        if (itti_s11_downlink_data_notification* m =
-                dynamic_cast<itti_s11_downlink_data_notification*>(msg)) {
-          sgw_s11_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::sgwc_s11().debug("TIME-OUT event timer id %d", to->timer_id);
-          sgw_s11_inst->time_out_itti_event(to->timer_id);
-        }
-        break;
-
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::sgwc_s11().info("Received terminate message");
-          return;
-        }
-        break;
-
-      case HEALTH_PING:
-        break;
-
-      default:
-        Logger::sgwc_s11().info("no handler for msg type %d", msg->msg_type);
-    }
-  } while (true);
+  itti_dispatcher dispatcher(task_id, Logger::sgwc_s11());
+  dispatcher
+      .on_each<
+          S11_CREATE_SESSION_RESPONSE,
+          S11_DELETE_SESSION_RESPONSE,
+          S11_MODIFY_BEARER_RESPONSE,
+          S11_RELEASE_ACCESS_BEARERS_RESPONSE,
+          S11_DOWNLINK_DATA_NOTIFICATION>(
+          [](auto m) { sgw_s11_inst->send_msg(std::ref(*m)); })
+      .on<TIME_OUT>([](auto to) {
+        Logger::sgwc_s11().debug("TIME-OUT event timer id %d", to->timer_id);
+        sgw_s11_inst->time_out_itti_event(to->timer_id);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
+  sgw_s11_inst->stop();
 }
 
 //------------------------------------------------------------------------------
@@ -133,7 +89,11 @@ sgw_s11::sgw_s11()
           pgwc::pgw_config::gtpv2c_.t3_ms, pgwc::pgw_config::gtpv2c_.n3,
           string(inet_ntoa(pgwc::pgw_config::s11_.iface.addr4)),
           pgwc::pgw_config::gtpv2c_.port,
-          pgwc::pgw_config::gtpv2c_.sched_params) {
+          pgwc::pgw_config::gtpv2c_.sched_params,
+          pgwc::pgw_config::gtpv2c_.worker_threads,
+          pgwc::pgw_config::gtpv2c_.udp_batch_size,
+          pgwc::pgw_config::gtpv2c_.use_io_uring,
+          pgwc::pgw_config::gtpv2c_.max_concurrent_procedures) {
   Logger::sgwc_s11().startup("Starting...");
   if (itti_inst->create_task(TASK_SGWC_S11, sgw_s11_task, nullptr)) {
     Logger::sgwc_s11().error("Cannot create task TASK_SGWC_S11");
@@ -169,23 +129,26 @@ void sgw_s11::send_msg(itti_s11_downlink_data_notification& i) {
 }
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_create_session_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                      = true;
   uint64_t gtpc_tx_id                             = 0;
   gtpv2c_create_session_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
   if (!error) {
     itti_s11_create_session_request* itti_msg =
-        new itti_s11_create_session_request(TASK_SGWC_S11, TASK_SGWC_APP);
+        new itti_s11_create_session_request(
+            TASK_SGWC_S11, sgwc_app::create_session_request_2_task(
+                               msg.get_teid(), msg_ies_container));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s11_create_session_request> i =
-        std::shared_ptr<itti_s11_create_session_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s11().error(
@@ -197,23 +160,25 @@ void sgw_s11::handle_receive_create_session_request(
 }
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_delete_session_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                      = true;
   uint64_t gtpc_tx_id                             = 0;
   gtpv2c_delete_session_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
   if (!error) {
     itti_s11_delete_session_request* itti_msg =
-        new itti_s11_delete_session_request(TASK_SGWC_S11, TASK_SGWC_APP);
+        new itti_s11_delete_session_request(
+            TASK_SGWC_S11, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s11_delete_session_request> i =
-        std::shared_ptr<itti_s11_delete_session_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s11().error(
@@ -225,23 +190,25 @@ void sgw_s11::handle_receive_delete_session_request(
 }
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_modify_bearer_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                     = true;
   uint64_t gtpc_tx_id                            = 0;
   gtpv2c_modify_bearer_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
   if (!error) {
     itti_s11_modify_bearer_request* itti_msg =
-        new itti_s11_modify_bearer_request(TASK_SGWC_S11, TASK_SGWC_APP);
+        new itti_s11_modify_bearer_request(
+            TASK_SGWC_S11, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s11_modify_bearer_request> i =
-        std::shared_ptr<itti_s11_modify_bearer_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s11().error(
@@ -253,24 +220,25 @@ void sgw_s11::handle_receive_modify_bearer_request(
 }
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_release_access_bearers_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                              = true;
   uint64_t gtpc_tx_id                                     = 0;
   gtpv2c_release_access_bearers_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
   if (!error) {
     itti_s11_release_access_bearers_request* itti_msg =
         new itti_s11_release_access_bearers_request(
-            TASK_SGWC_S11, TASK_SGWC_APP);
+            TASK_SGWC_S11, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s11_release_access_bearers_request> i =
-        std::shared_ptr<itti_s11_release_access_bearers_request>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s11().error(
@@ -282,25 +250,25 @@ void sgw_s11::handle_receive_release_access_bearers_request(
 }
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_downlink_data_notification_acknowledge(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                                      = true;
   uint64_t gtpc_tx_id                                             = 0;
   gtpv2c_downlink_data_notification_acknowledge msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
   if (!error) {
     itti_s11_downlink_data_notification_acknowledge* itti_msg =
         new itti_s11_downlink_data_notification_acknowledge(
-            TASK_SGWC_S11, TASK_SGWC_APP);
+            TASK_SGWC_S11, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s11_downlink_data_notification_acknowledge> i =
-        std::shared_ptr<itti_s11_downlink_data_notification_acknowledge>(
-            itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s11().error(
@@ -313,11 +281,12 @@ void sgw_s11::handle_receive_downlink_data_notification_acknowledge(
 
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_echo_request(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                            = true;
   uint64_t gtpc_tx_id                   = 0;
   gtpv2c_echo_request msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
@@ -335,11 +304,12 @@ void sgw_s11::handle_receive_echo_request(
 }
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_echo_response(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                             = true;
   uint64_t gtpc_tx_id                    = 0;
   gtpv2c_echo_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S11, error, gtpc_tx_id);
@@ -366,31 +336,32 @@ void sgw_s11::send_echo_response(
 
 //------------------------------------------------------------------------------
 void sgw_s11::handle_receive_gtpv2c_msg(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   // Logger::sgwc_s11().trace( "handle_receive_gtpv2c_msg msg type %d length
   // %d", msg.get_message_type(), msg.get_message_length());
   switch (msg.get_message_type()) {
     case GTP_CREATE_SESSION_REQUEST: {
-      handle_receive_create_session_request(msg, remote_endpoint);
+      handle_receive_create_session_request(msg, ies, remote_endpoint);
     } break;
     case GTP_MODIFY_BEARER_REQUEST: {
-      handle_receive_modify_bearer_request(msg, remote_endpoint);
+      handle_receive_modify_bearer_request(msg, ies, remote_endpoint);
     } break;
     case GTP_DELETE_SESSION_REQUEST: {
-      handle_receive_delete_session_request(msg, remote_endpoint);
+      handle_receive_delete_session_request(msg, ies, remote_endpoint);
     } break;
     case GTP_RELEASE_ACCESS_BEARERS_REQUEST: {
-      handle_receive_release_access_bearers_request(msg, remote_endpoint);
+      handle_receive_release_access_bearers_request(msg, ies, remote_endpoint);
     } break;
     case GTP_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE: {
       handle_receive_downlink_data_notification_acknowledge(
-          msg, remote_endpoint);
+          msg, ies, remote_endpoint);
     } break;
     case GTP_ECHO_REQUEST: {
-      handle_receive_echo_request(msg, remote_endpoint);
+      handle_receive_echo_request(msg, ies, remote_endpoint);
     } break;
     case GTP_ECHO_RESPONSE: {
-      handle_receive_echo_response(msg, remote_endpoint);
+      handle_receive_echo_response(msg, ies, remote_endpoint);
     } break;
     case GTP_VERSION_NOT_SUPPORTED_INDICATION:
     case GTP_CREATE_SESSION_RESPONSE:
@@ -480,13 +451,12 @@ void sgw_s11::handle_receive(
     const endpoint& remote_endpoint) {
   // Logger::sgwc_s11().info( "handle_receive(%d bytes)", bytes_transferred);
   // std::cout << string_to_hex(recv_buffer, bytes_transferred) << std::endl;
-  std::istringstream iss(std::istringstream::binary);
-  iss.rdbuf()->pubsetbuf(recv_buffer, bytes_transferred);
   gtpv2c_msg msg  = {};
   msg.remote_port = remote_endpoint.port();
   try {
-    msg.load_from(iss);
-    handle_receive_gtpv2c_msg(msg, remote_endpoint);
+    gtpv2c_view ies = gtpv2c_decoder::decode_header(
+        reinterpret_cast<const uint8_t*>(recv_buffer), bytes_transferred, msg);
+    handle_receive_gtpv2c_msg(msg, ies, remote_endpoint);
   } catch (gtpc_exception& e) {
     Logger::sgwc_s11().info("handle_receive exception %s", e.what());
   }
@@ -498,12 +468,13 @@ void sgw_s11::notify_ul_error(
   switch (cause) {
     case cause_value_e::REMOTE_PEER_NOT_RESPONDING: {
       itti_s11_remote_peer_not_responding* itti_msg =
-          new itti_s11_remote_peer_not_responding(TASK_SGWC_S11, TASK_SGWC_APP);
+          new itti_s11_remote_peer_not_responding(
+              TASK_SGWC_S11, sgwc_app::teid_2_task(l_teid));
       itti_msg->r_endpoint = r_endpoint;
       itti_msg->gtpc_tx_id = gtpc_tx_id;
       itti_msg->teid       = l_teid;
       std::shared_ptr<itti_s11_remote_peer_not_responding> i =
-          std::shared_ptr<itti_s11_remote_peer_not_responding>(itti_msg);
+          itti_msg_shared(itti_msg);
       int ret = itti_inst->send_msg(i);
       if (RETURNok != ret) {
         Logger::sgwc_s11().error(
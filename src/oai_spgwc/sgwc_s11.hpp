@@ -29,6 +29,7 @@
 #define FILE_SGWC_S11_HPP_SEEN
 
 #include "gtpv2c.hpp"
+#include "gtpv2c_decoder.hpp"
 #include "itti_msg_s11.hpp"
 
 #include <thread>
@@ -41,21 +42,29 @@ class sgw_s11 : public gtpv2c::gtpv2c_stack {
   std::thread thread;
 
   void handle_receive_gtpv2c_msg(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_echo_request(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_echo_response(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_create_session_request(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_delete_session_request(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_modify_bearer_request(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_release_access_bearers_request(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_downlink_data_notification_acknowledge(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
 
  public:
   sgw_s11();
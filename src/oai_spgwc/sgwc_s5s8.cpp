@@ -31,6 +31,7 @@
 #include "itti.hpp"
 #include "logger.hpp"
 #include "pgw_config.hpp"
+#include "sgwc_app.hpp"
 
 #include <stdexcept>
 
@@ -49,68 +50,22 @@ void sgw_s5s8_task(void* args_p) {
   const task_id_t task_id = TASK_SGWC_S5S8;
   itti_inst->notify_task_ready(task_id);
 
-  do {
-    std::shared_ptr<itti_msg> shared_msg = itti_inst->receive_msg(task_id);
-    auto* msg                            = shared_msg.get();
-    switch (msg->msg_type) {
-      case S5S8_CREATE_SESSION_REQUEST:
-        if (itti_s5s8_create_session_request* m =
-                dynamic_cast<itti_s5s8_create_session_request*>(msg)) {
-          sgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_MODIFY_BEARER_REQUEST:
-        if (itti_s5s8_modify_bearer_request* m =
-                dynamic_cast<itti_s5s8_modify_bearer_request*>(msg)) {
-          sgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_RELEASE_ACCESS_BEARERS_REQUEST:
-        if (itti_s5s8_release_access_bearers_request* m =
-                dynamic_cast<itti_s5s8_release_access_bearers_request*>(msg)) {
-          sgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_DELETE_SESSION_REQUEST:
-        if (itti_s5s8_delete_session_request* m =
-                dynamic_cast<itti_s5s8_delete_session_request*>(msg)) {
-          sgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case S5S8_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE:
-        if (itti_s5s8_downlink_data_notification_acknowledge* m =
-                dynamic_cast<itti_s5s8_downlink_data_notification_acknowledge*>(
-                    msg)) {
-          sgw_s5s8_inst->send_msg(ref(*m));
-        }
-        break;
-
-      case TIME_OUT:
-        if (itti_msg_timeout* to = dynamic_cast<itti_msg_timeout*>(msg)) {
-          Logger::sgwc_s5s8().debug("TIME-OUT event timer id %d", to->timer_id);
-          sgw_s5s8_inst->time_out_itti_event(to->timer_id);
-        }
-        break;
-
-      case TERMINATE:
-        if (itti_msg_terminate* terminate =
-                dynamic_cast<itti_msg_terminate*>(msg)) {
-          Logger::sgwc_s5s8().info("Received terminate message");
-          return;
-        }
-        break;
-
-      case HEALTH_PING:
-        break;
-
-      default:
-        Logger::sgwc_s5s8().info("no handler for msg type %d", msg->msg_type);
-    }
-  } while (true);
+  itti_dispatcher dispatcher(task_id, Logger::sgwc_s5s8());
+  dispatcher
+      .on_each<
+          S5S8_CREATE_SESSION_REQUEST,
+          S5S8_MODIFY_BEARER_REQUEST,
+          S5S8_RELEASE_ACCESS_BEARERS_REQUEST,
+          S5S8_DELETE_SESSION_REQUEST,
+          S5S8_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE>(
+          [](auto m) { sgw_s5s8_inst->send_msg(std::ref(*m)); })
+      .on<TIME_OUT>([](auto to) {
+        Logger::sgwc_s5s8().debug("TIME-OUT event timer id %d", to->timer_id);
+        sgw_s5s8_inst->time_out_itti_event(to->timer_id);
+      })
+      .ignore<HEALTH_PING>();
+  dispatcher.run();
+  sgw_s5s8_inst->stop();
 }
 
 //------------------------------------------------------------------------------
@@ -119,7 +74,11 @@ sgw_s5s8::sgw_s5s8()
           pgwc::pgw_config::gtpv2c_.t3_ms, pgwc::pgw_config::gtpv2c_.n3,
           string(inet_ntoa(pgwc::pgw_config::sgw_s5s8_.iface.addr4)),
           pgwc::pgw_config::gtpv2c_.port,
-          pgwc::pgw_config::gtpv2c_.sched_params) {
+          pgwc::pgw_config::gtpv2c_.sched_params,
+          pgwc::pgw_config::gtpv2c_.worker_threads,
+          pgwc::pgw_config::gtpv2c_.udp_batch_size,
+          pgwc::pgw_config::gtpv2c_.use_io_uring,
+          pgwc::pgw_config::gtpv2c_.max_concurrent_procedures) {
   Logger::sgwc_s5s8().startup("Starting...");
   if (itti_inst->create_task(TASK_SGWC_S5S8, sgw_s5s8_task, nullptr)) {
     Logger::sgwc_s5s8().error("Cannot create task TASK_SGWC_S5S8");
@@ -154,23 +113,25 @@ void sgw_s5s8::send_msg(itti_s5s8_downlink_data_notification_acknowledge& i) {
 }
 //------------------------------------------------------------------------------
 void sgw_s5s8::handle_receive_create_session_response(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                       = true;
   uint64_t gtpc_tx_id                              = 0;
   gtpv2c_create_session_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_create_session_response* itti_msg =
-        new itti_s5s8_create_session_response(TASK_SGWC_S5S8, TASK_SGWC_APP);
+        new itti_s5s8_create_session_response(
+            TASK_SGWC_S5S8, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_create_session_response> i =
-        std::shared_ptr<itti_s5s8_create_session_response>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s5s8().error(
@@ -182,23 +143,25 @@ void sgw_s5s8::handle_receive_create_session_response(
 }
 //------------------------------------------------------------------------------
 void sgw_s5s8::handle_receive_modify_bearer_response(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                      = true;
   uint64_t gtpc_tx_id                             = 0;
   gtpv2c_modify_bearer_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_modify_bearer_response* itti_msg =
-        new itti_s5s8_modify_bearer_response(TASK_SGWC_S5S8, TASK_SGWC_APP);
+        new itti_s5s8_modify_bearer_response(
+            TASK_SGWC_S5S8, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_modify_bearer_response> i =
-        std::shared_ptr<itti_s5s8_modify_bearer_response>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s5s8().error(
@@ -210,24 +173,25 @@ void sgw_s5s8::handle_receive_modify_bearer_response(
 }
 //------------------------------------------------------------------------------
 void sgw_s5s8::handle_receive_release_access_bearers_response(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                               = true;
   uint64_t gtpc_tx_id                                      = 0;
   gtpv2c_release_access_bearers_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_release_access_bearers_response* itti_msg =
         new itti_s5s8_release_access_bearers_response(
-            TASK_SGWC_S5S8, TASK_SGWC_APP);
+            TASK_SGWC_S5S8, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_release_access_bearers_response> i =
-        std::shared_ptr<itti_s5s8_release_access_bearers_response>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s5s8().error(
@@ -239,23 +203,25 @@ void sgw_s5s8::handle_receive_release_access_bearers_response(
 }
 //------------------------------------------------------------------------------
 void sgw_s5s8::handle_receive_delete_session_response(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                       = true;
   uint64_t gtpc_tx_id                              = 0;
   gtpv2c_delete_session_response msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_delete_session_response* itti_msg =
-        new itti_s5s8_delete_session_response(TASK_SGWC_S5S8, TASK_SGWC_APP);
+        new itti_s5s8_delete_session_response(
+            TASK_SGWC_S5S8, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_delete_session_response> i =
-        std::shared_ptr<itti_s5s8_delete_session_response>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s5s8().error(
@@ -267,23 +233,25 @@ void sgw_s5s8::handle_receive_delete_session_response(
 }
 //------------------------------------------------------------------------------
 void sgw_s5s8::handle_receive_downlink_data_notification(
-    gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c::gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   bool error                                          = true;
   uint64_t gtpc_tx_id                                 = 0;
   gtpv2c_downlink_data_notification msg_ies_container = {};
-  msg.to_core_type(msg_ies_container);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
 
   handle_receive_message_cb(
       msg, remote_endpoint, TASK_SGWC_S5S8, error, gtpc_tx_id);
   if (!error) {
     itti_s5s8_downlink_data_notification* itti_msg =
-        new itti_s5s8_downlink_data_notification(TASK_SGWC_S5S8, TASK_SGWC_APP);
+        new itti_s5s8_downlink_data_notification(
+            TASK_SGWC_S5S8, sgwc_app::teid_2_task(msg.get_teid()));
     itti_msg->gtp_ies    = msg_ies_container;
     itti_msg->r_endpoint = remote_endpoint;
     itti_msg->gtpc_tx_id = gtpc_tx_id;
     itti_msg->teid       = msg.get_teid();
     std::shared_ptr<itti_s5s8_downlink_data_notification> i =
-        std::shared_ptr<itti_s5s8_downlink_data_notification>(itti_msg);
+        itti_msg_shared(itti_msg);
     int ret = itti_inst->send_msg(i);
     if (RETURNok != ret) {
       Logger::sgwc_s5s8().error(
@@ -296,7 +264,8 @@ void sgw_s5s8::handle_receive_downlink_data_notification(
 
 //------------------------------------------------------------------------------
 void sgw_s5s8::handle_receive_gtpv2c_msg(
-    gtpv2c_msg& msg, const endpoint& remote_endpoint) {
+    gtpv2c_msg& msg, const gtpv2c_view& ies,
+    const endpoint& remote_endpoint) {
   // Logger::sgwc_s5s8().trace( "handle_receive_gtpv2c_msg msg type %d length
   // %d", msg.get_message_type(), msg.get_message_length());
   switch (msg.get_message_type()) {
@@ -306,24 +275,24 @@ void sgw_s5s8::handle_receive_gtpv2c_msg(
     case GTP_ECHO_RESPONSE:
     case GTP_VERSION_NOT_SUPPORTED_INDICATION:
     case GTP_CREATE_SESSION_RESPONSE:
-      handle_receive_create_session_response(msg, remote_endpoint);
+      handle_receive_create_session_response(msg, ies, remote_endpoint);
       break;
     case GTP_MODIFY_BEARER_REQUEST: {
     } break;
     case GTP_MODIFY_BEARER_RESPONSE:
-      handle_receive_modify_bearer_response(msg, remote_endpoint);
+      handle_receive_modify_bearer_response(msg, ies, remote_endpoint);
       break;
     case GTP_DELETE_SESSION_REQUEST: {
       // handle_receive_delete_session_request(msg, remote_endpoint);
     } break;
     case GTP_DELETE_SESSION_RESPONSE: {
-      handle_receive_delete_session_response(msg, remote_endpoint);
+      handle_receive_delete_session_response(msg, ies, remote_endpoint);
     } break;
     case GTP_RELEASE_ACCESS_BEARERS_RESPONSE: {
-      handle_receive_release_access_bearers_response(msg, remote_endpoint);
+      handle_receive_release_access_bearers_response(msg, ies, remote_endpoint);
     } break;
     case GTP_DOWNLINK_DATA_NOTIFICATION: {
-      handle_receive_downlink_data_notification(msg, remote_endpoint);
+      handle_receive_downlink_data_notification(msg, ies, remote_endpoint);
     } break;
 
     case GTP_CHANGE_NOTIFICATION_REQUEST:
@@ -410,13 +379,12 @@ void sgw_s5s8::handle_receive(
     const endpoint& remote_endpoint) {
   // Logger::sgwc_s5s8().info( "handle_receive(%d bytes)", bytes_transferred);
   // std::cout << string_to_hex(recv_buffer, bytes_transferred) << std::endl;
-  std::istringstream iss(std::istringstream::binary);
-  iss.rdbuf()->pubsetbuf(recv_buffer, bytes_transferred);
   gtpv2c_msg msg  = {};
   msg.remote_port = remote_endpoint.port();
   try {
-    msg.load_from(iss);
-    handle_receive_gtpv2c_msg(msg, remote_endpoint);
+    gtpv2c_view ies = gtpv2c_decoder::decode_header(
+        reinterpret_cast<const uint8_t*>(recv_buffer), bytes_transferred, msg);
+    handle_receive_gtpv2c_msg(msg, ies, remote_endpoint);
   } catch (gtpc_exception& e) {
     Logger::sgwc_s5s8().info("handle_receive exception %s", e.what());
   }
@@ -429,12 +397,12 @@ void sgw_s5s8::notify_ul_error(
     case cause_value_e::REMOTE_PEER_NOT_RESPONDING: {
       itti_s5s8_remote_peer_not_responding* itti_msg =
           new itti_s5s8_remote_peer_not_responding(
-              TASK_SGWC_S5S8, TASK_SGWC_APP);
+              TASK_SGWC_S5S8, sgwc_app::teid_2_task(l_teid));
       itti_msg->r_endpoint = r_endpoint;
       itti_msg->gtpc_tx_id = gtpc_tx_id;
       itti_msg->l_teid     = l_teid;
       std::shared_ptr<itti_s5s8_remote_peer_not_responding> i =
-          std::shared_ptr<itti_s5s8_remote_peer_not_responding>(itti_msg);
+          itti_msg_shared(itti_msg);
       int ret = itti_inst->send_msg(i);
       if (RETURNok != ret) {
         Logger::sgwc_s5s8().error(
@@ -29,6 +29,7 @@
 #define FILE_SGWC_S5S8_HPP_SEEN
 
 #include "gtpv2c.hpp"
+#include "gtpv2c_decoder.hpp"
 #include "itti_msg_s5s8.hpp"
 
 #include <thread>
@@ -41,17 +42,23 @@ class sgw_s5s8 : public gtpv2c::gtpv2c_stack {
   std::thread thread;
 
   void handle_receive_gtpv2c_msg(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_create_session_response(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_delete_session_response(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_modify_bearer_response(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_release_access_bearers_response(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
   void handle_receive_downlink_data_notification(
-      gtpv2c::gtpv2c_msg& msg, const endpoint& remote_endpoint);
+      gtpv2c::gtpv2c_msg& msg, const gtpv2c::gtpv2c_view& ies,
+      const endpoint& remote_endpoint);
 
  public:
   sgw_s5s8();
@@ -28,904 +28,283 @@
 
 #include "3gpp_29.244.hpp"
 
+#include <array>
+#include <memory>
 #include <string>
 
 using namespace pfcp;
 
+namespace {
+// Builds the IE of a received TLV, the value is then read by its load_from()
+typedef pfcp_ie* (*pfcp_ie_factory_t)(const pfcp_tlv& tlv);
+
+struct pfcp_ie_decoder {
+  pfcp_ie_factory_t factory;
+  // size hint, fewest value octets the IE can be decoded from
+  uint16_t min_length;
+};
+
+// one slot per IE type of 3gpp_29.244.h, vendor specific types are not in
+#define PFCP_IE_TABLE_SIZE (PFCP_IE_FRAMED_IPV6_ROUTE + 1)
+typedef std::array<pfcp_ie_decoder, PFCP_IE_TABLE_SIZE> pfcp_ie_table_t;
+
+template <class IE>
+pfcp_ie* new_ie(const pfcp_tlv& tlv) {
+  return new IE(tlv);
+}
+
+template <class IE>
+constexpr void add(
+    pfcp_ie_table_t& t, const uint16_t type, const uint16_t min_length) {
+  t[type] = {new_ie<IE>, min_length};
+}
+
+// IE types without a class in 3gpp_29.244.hpp keep an empty slot
+constexpr pfcp_ie_table_t make_pfcp_ie_table() {
+  pfcp_ie_table_t t = {};
+  add<pfcp_create_pdr_ie>(t, PFCP_IE_CREATE_PDR, 4);
+  add<pfcp_pdi_ie>(t, PFCP_IE_PDI, 4);
+  add<pfcp_create_far_ie>(t, PFCP_IE_CREATE_FAR, 4);
+  add<pfcp_forwarding_parameters_ie>(t, PFCP_IE_FORWARDING_PARAMETERS, 4);
+  add<pfcp_duplicating_parameters_ie>(t, PFCP_IE_DUPLICATING_PARAMETERS, 4);
+  add<pfcp_create_urr_ie>(t, PFCP_IE_CREATE_URR, 4);
+  add<pfcp_create_qer_ie>(t, PFCP_IE_CREATE_QER, 4);
+  add<pfcp_created_pdr_ie>(t, PFCP_IE_CREATED_PDR, 4);
+  add<pfcp_update_pdr_ie>(t, PFCP_IE_UPDATE_PDR, 4);
+  add<pfcp_update_far_ie>(t, PFCP_IE_UPDATE_FAR, 4);
+  add<pfcp_update_forwarding_parameters_ie>(
+      t, PFCP_IE_UPDATE_FORWARDING_PARAMETERS, 4);
+  add<pfcp_update_bar_within_pfcp_session_report_response_ie>(
+      t, PFCP_IE_UPDATE_BAR_WITHIN_PFCP_SESSION_REPORT_RESPONSE, 4);
+  add<pfcp_update_urr_ie>(t, PFCP_IE_UPDATE_URR, 4);
+  add<pfcp_update_qer_ie>(t, PFCP_IE_UPDATE_QER, 4);
+  add<pfcp_remove_pdr_ie>(t, PFCP_IE_REMOVE_PDR, 4);
+  add<pfcp_remove_far_ie>(t, PFCP_IE_REMOVE_FAR, 4);
+  add<pfcp_remove_urr_ie>(t, PFCP_IE_REMOVE_URR, 4);
+  add<pfcp_remove_qer_ie>(t, PFCP_IE_REMOVE_QER, 4);
+  add<pfcp_cause_ie>(t, PFCP_IE_CAUSE, 1);
+  add<pfcp_source_interface_ie>(t, PFCP_IE_SOURCE_INTERFACE, 1);
+  add<pfcp_fteid_ie>(t, PFCP_IE_F_TEID, 0);
+  add<pfcp_network_instance_ie>(t, PFCP_IE_NETWORK_INSTANCE, 0);
+  add<pfcp_sdf_filter_ie>(t, PFCP_IE_SDF_FILTER, 0);
+  add<pfcp_application_id_ie>(t, PFCP_IE_APPLICATION_ID, 0);
+  add<pfcp_gate_status_ie>(t, PFCP_IE_GATE_STATUS, 1);
+  add<pfcp_mbr_ie>(t, PFCP_IE_MBR, 10);
+  add<pfcp_gbr_ie>(t, PFCP_IE_GBR, 10);
+  add<pfcp_qer_correlation_id_ie>(t, PFCP_IE_QER_CORRELATION_ID, 1);
+  add<pfcp_precedence_ie>(t, PFCP_IE_PRECEDENCE, 4);
+  add<pfcp_transport_level_marking_ie>(t, PFCP_IE_TRANSPORT_LEVEL_MARKING, 2);
+  add<pfcp_volume_threshold_ie>(t, PFCP_IE_VOLUME_THRESHOLD, 0);
+  add<pfcp_time_threshold_ie>(t, PFCP_IE_TIME_THRESHOLD, 4);
+  add<pfcp_monitoring_time_ie>(t, PFCP_IE_MONITORING_TIME, 4);
+  add<pfcp_subsequent_volume_threshold_ie>(
+      t, PFCP_IE_SUBSEQUENT_VOLUME_THRESHOLD, 0);
+  add<pfcp_subsequent_time_threshold_ie>(
+      t, PFCP_IE_SUBSEQUENT_TIME_THRESHOLD, 4);
+  add<pfcp_inactivity_detection_time_ie>(
+      t, PFCP_IE_INACTIVITY_DETECTION_TIME, 4);
+  add<pfcp_reporting_triggers_ie>(t, PFCP_IE_REPORTING_TRIGGERS, 2);
+  // add<pfcp_redirect_information_ie>(t, PFCP_IE_REDIRECT_INFORMATION, 0);
+  add<pfcp_report_type_ie>(t, PFCP_IE_REPORT_TYPE, 1);
+  add<pfcp_offending_ie_ie>(t, PFCP_IE_OFFENDING_IE, 2);
+  add<pfcp_forwarding_policy_ie>(t, PFCP_IE_FORWARDING_POLICY, 0);
+  add<pfcp_destination_interface_ie>(t, PFCP_IE_DESTINATION_INTERFACE, 1);
+  add<pfcp_up_function_features_ie>(t, PFCP_IE_UP_FUNCTION_FEATURES, 0);
+  add<pfcp_apply_action_ie>(t, PFCP_IE_APPLY_ACTION, 1);
+  // add<pfcp_downlink_data_service_information_ie>(
+  //     t, PFCP_IE_DOWNLINK_DATA_SERVICE_INFORMATION, 0);
+  // add<pfcp_downlink_data_notification_delay_ie>(
+  //     t, PFCP_IE_DOWNLINK_DATA_NOTIFICATION_DELAY, 0);
+  // add<pfcp_dl_buffering_duration_ie>(t, PFCP_IE_DL_BUFFERING_DURATION, 0);
+  // add<pfcp_dl_buffering_suggested_packet_count_ie>(
+  //     t, PFCP_IE_DL_BUFFERING_SUGGESTED_PACKET_COUNT, 0);
+  // add<pfcp_pfcpsmreq_flags_ie>(t, PFCP_IE_PFCPSMREQ_FLAGS, 0);
+  // add<pfcp_pfcpsrrsp_flags_ie>(t, PFCP_IE_PFCPSRRSP_FLAGS, 0);
+  // add<pfcp_load_control_information_ie>(
+  //     t, PFCP_IE_LOAD_CONTROL_INFORMATION, 0);
+  // add<pfcp_sequence_number_ie>(t, PFCP_IE_SEQUENCE_NUMBER, 0);
+  // add<pfcp_metric_ie>(t, PFCP_IE_METRIC, 0);
+  // add<pfcp_overload_control_information_ie>(
+  //     t, PFCP_IE_OVERLOAD_CONTROL_INFORMATION, 0);
+  // add<pfcp_timer_ie>(t, PFCP_IE_TIMER, 0);
+  add<pfcp_pdr_id_ie>(t, PFCP_IE_PACKET_DETECTION_RULE_ID, 2);
+  add<pfcp_f_seid_ie>(t, PFCP_IE_F_SEID, 9);
+  // add<pfcp_application_ids_pfds_ie>(t, PFCP_IE_APPLICATION_IDS_PFDS, 0);
+  // add<pfcp_pfd_ie>(t, PFCP_IE_PFD, 0);
+  add<pfcp_node_id_ie>(t, PFCP_IE_NODE_ID, 0);
+  // add<pfcp_pfd_contents_ie>(t, PFCP_IE_PFD_CONTENTS, 0);
+  // add<pfcp_measurement_method_ie>(t, PFCP_IE_MEASUREMENT_METHOD, 0);
+  // add<pfcp_usage_report_trigger_ie>(t, PFCP_IE_USAGE_REPORT_TRIGGER, 0);
+  // add<pfcp_measurement_period_ie>(t, PFCP_IE_MEASUREMENT_PERIOD, 0);
+  // add<pfcp_fq_csid_ie>(t, PFCP_IE_FQ_CSID, 0);
+  // add<pfcp_volume_measurement_ie>(t, PFCP_IE_VOLUME_MEASUREMENT, 0);
+  // add<pfcp_duration_measurement_ie>(t, PFCP_IE_DURATION_MEASUREMENT, 0);
+  // add<pfcp_application_detection_information_ie>(
+  //     t, PFCP_IE_APPLICATION_DETECTION_INFORMATION, 0);
+  // add<pfcp_time_of_first_packet_ie>(t, PFCP_IE_TIME_OF_FIRST_PACKET, 0);
+  // add<pfcp_time_of_last_packet_ie>(t, PFCP_IE_TIME_OF_LAST_PACKET, 0);
+  // add<pfcp_quota_holding_time_ie>(t, PFCP_IE_QUOTA_HOLDING_TIME, 0);
+  // add<pfcp_dropped_dl_traffic_threshold_ie>(
+  //     t, PFCP_IE_DROPPED_DL_TRAFFIC_THRESHOLD, 0);
+  // add<pfcp_volume_quota_ie>(t, PFCP_IE_VOLUME_QUOTA, 0);
+  // add<pfcp_time_quota_ie>(t, PFCP_IE_TIME_QUOTA, 0);
+  // add<pfcp_start_time_ie>(t, PFCP_IE_START_TIME, 0);
+  // add<pfcp_end_time_ie>(t, PFCP_IE_END_TIME, 0);
+  // add<pfcp_query_urr_ie>(t, PFCP_IE_QUERY_URR, 0);
+  // add<pfcp_usage_report_within_session_modification_response_ie>(
+  //     t, PFCP_IE_USAGE_REPORT_WITHIN_SESSION_MODIFICATION_RESPONSE, 0);
+  // add<pfcp_usage_report_within_session_deletion_response_ie>(
+  //     t, PFCP_IE_USAGE_REPORT_WITHIN_SESSION_DELETION_RESPONSE, 0);
+  // add<pfcp_usage_report_within_session_report_request_ie>(
+  //     t, PFCP_IE_USAGE_REPORT_WITHIN_SESSION_REPORT_REQUEST, 0);
+  add<pfcp_urr_id_ie>(t, PFCP_IE_URR_ID, 4);
+  // add<pfcp_linked_urr_id_ie>(t, PFCP_IE_LINKED_URR_ID, 0);
+  add<pfcp_downlink_data_report_ie>(t, PFCP_IE_DOWNLINK_DATA_REPORT, 4);
+  add<pfcp_outer_header_creation_ie>(t, PFCP_IE_OUTER_HEADER_CREATION, 4);
+  // add<pfcp_create_bar_ie>(t, PFCP_IE_CREATE_BAR, 0);
+  // add<pfcp_update_bar_within_session_modification_request_ie>(
+  //     t, PFCP_IE_UPDATE_BAR_WITHIN_PFCP_SESSION_MODIFICATION_REQUEST, 0);
+  // add<pfcp_remove_bar_ie>(t, PFCP_IE_REMOVE_BAR, 0);
+  add<pfcp_bar_id_ie>(t, PFCP_IE_BAR_ID, 1);
+  add<pfcp_cp_function_features_ie>(t, PFCP_IE_CP_FUNCTION_FEATURES, 1);
+  // add<pfcp_usage_information_ie>(t, PFCP_IE_USAGE_INFORMATION, 0);
+  // add<pfcp_application_instance_id_ie>(
+  //     t, PFCP_IE_APPLICATION_INSTANCE_ID, 0);
+  // add<pfcp_flow_information_ie>(t, PFCP_IE_FLOW_INFORMATION, 0);
+  add<pfcp_ue_ip_address_ie>(t, PFCP_IE_UE_IP_ADDRESS, 0);
+  // add<pfcp_packet_rate_ie>(t, PFCP_IE_PACKET_RATE, 0);
+  add<pfcp_outer_header_removal_ie>(t, PFCP_IE_OUTER_HEADER_REMOVAL, 1);
+  add<pfcp_recovery_time_stamp_ie>(t, PFCP_IE_RECOVERY_TIME_STAMP, 4);
+  // add<pfcp_dl_flow_level_marking_ie>(t, PFCP_IE_DL_FLOW_LEVEL_MARKING, 0);
+  // add<pfcp_header_enrichment_ie>(t, PFCP_IE_HEADER_ENRICHMENT, 0);
+  // add<pfcp_error_indication_report_ie>(
+  //     t, PFCP_IE_ERROR_INDICATION_REPORT, 0);
+  // add<pfcp_measurement_information_ie>(
+  //     t, PFCP_IE_MEASUREMENT_INFORMATION, 0);
+  // add<pfcp_node_report_type_ie>(t, PFCP_IE_NODE_REPORT_TYPE, 0);
+  // add<pfcp_user_plane_path_failure_report_ie>(
+  //     t, PFCP_IE_USER_PLANE_PATH_FAILURE_REPORT, 0);
+  // add<pfcp_remote_gtp_u_peer_ie>(t, PFCP_IE_REMOTE_GTP_U_PEER, 0);
+  // add<pfcp_ur_seqn_ie>(t, PFCP_IE_UR_SEQN, 0);
+  // add<pfcp_update_duplicating_parameters_ie>(
+  //     t, PFCP_IE_UPDATE_DUPLICATING_PARAMETERS, 0);
+  add<pfcp_activate_predefined_rules_ie>(
+      t, PFCP_IE_ACTIVATE_PREDEFINED_RULES, 0);
+  add<pfcp_deactivate_predefined_rules_ie>(
+      t, PFCP_IE_DEACTIVATE_PREDEFINED_RULES, 0);
+  add<pfcp_far_id_ie>(t, PFCP_IE_FAR_ID, 4);
+  add<pfcp_qer_id_ie>(t, PFCP_IE_QER_ID, 4);
+  // add<pfcp_oci_flags_ie>(t, PFCP_IE_OCI_FLAGS, 0);
+  // add<pfcp_pfcp_association_release_request_ie>(
+  //     t, PFCP_IE_PFCP_ASSOCIATION_RELEASE_REQUEST, 0);
+  // add<pfcp_graceful_release_period_ie>(
+  //     t, PFCP_IE_GRACEFUL_RELEASE_PERIOD, 0);
+  // add<pfcp_pdn_type_ie>(t, PFCP_IE_PDN_TYPE, 0);
+  add<pfcp_failed_rule_id_ie>(t, PFCP_IE_FAILED_RULE_ID, 1);
+  // add<pfcp_time_quota_mechanism_ie>(t, PFCP_IE_TIME_QUOTA_MECHANISM, 0);
+  add<pfcp_user_plane_ip_resource_information_ie>(
+      t, PFCP_IE_USER_PLANE_IP_RESOURCE_INFORMATION, 0);
+  add<pfcp_user_plane_inactivity_timer_ie>(
+      t, PFCP_IE_USER_PLANE_INACTIVITY_TIMER, 4);
+  // add<pfcp_aggregated_urrs_ie>(t, PFCP_IE_AGGREGATED_URRS, 0);
+  // add<pfcp_multiplier_ie>(t, PFCP_IE_MULTIPLIER, 0);
+  // add<pfcp_aggregated_urr_id_ie>(t, PFCP_IE_AGGREGATED_URR_ID, 0);
+  // add<pfcp_subsequent_volume_quota_ie>(
+  //     t, PFCP_IE_SUBSEQUENT_VOLUME_QUOTA, 0);
+  // add<pfcp_subsequent_time_quota_ie>(t, PFCP_IE_SUBSEQUENT_TIME_QUOTA, 0);
+  // add<pfcp_rqi_ie>(t, PFCP_IE_RQI, 0);
+  add<pfcp_qfi_ie>(t, PFCP_IE_QFI, 1);
+  // add<pfcp_query_urr_reference_ie>(t, PFCP_IE_QUERY_URR_REFERENCE, 0);
+  // add<pfcp_additional_usage_reports_information_ie>(
+  //     t, PFCP_IE_ADDITIONAL_USAGE_REPORTS_INFORMATION, 0);
+  // add<pfcp_create_traffic_endpoint_ie>(
+  //     t, PFCP_IE_CREATE_TRAFFIC_ENDPOINT, 4);
+  // add<pfcp_created_traffic_endpoint_ie>(
+  //     t, PFCP_IE_CREATED_TRAFFIC_ENDPOINT, 0);
+  // add<pfcp_update_traffic_endpoint_ie>(
+  //     t, PFCP_IE_UPDATE_TRAFFIC_ENDPOINT, 0);
+  // add<pfcp_remove_traffic_endpoint_ie>(
+  //     t, PFCP_IE_REMOVE_TRAFFIC_ENDPOINT, 0);
+  // add<pfcp_traffic_endpoint_id_ie>(t, PFCP_IE_TRAFFIC_ENDPOINT_ID, 0);
+  // add<pfcp_ethernet_packet_filter_ie>(t, PFCP_IE_ETHERNET_PACKET_FILTER, 0);
+  // add<pfcp_mac_address_ie>(t, PFCP_IE_MAC_ADDRESS, 0);
+  // add<pfcp_c_tag_ie>(t, PFCP_IE_C_TAG, 0);
+  // add<pfcp_s_tag_ie>(t, PFCP_IE_S_TAG, 0);
+  // add<pfcp_ethertype_ie>(t, PFCP_IE_ETHERTYPE, 0);
+  // add<pfcp_proxying_ie>(t, PFCP_IE_PROXYING, 0);
+  // add<pfcp_ethernet_filter_id_ie>(t, PFCP_IE_ETHERNET_FILTER_ID, 0);
+  // add<pfcp_ethernet_filter_properties_ie>(
+  //     t, PFCP_IE_ETHERNET_FILTER_PROPERTIES, 0);
+  // add<pfcp_suggested_buffering_packets_count_ie>(
+  //     t, PFCP_IE_SUGGESTED_BUFFERING_PACKETS_COUNT, 0);
+  add<pfcp_user_id_ie>(t, PFCP_IE_USER_ID, 1);
+  // add<pfcp_ethernet_pdu_session_information_ie>(
+  //     t, PFCP_IE_ETHERNET_PDU_SESSION_INFORMATION, 0);
+  // add<pfcp_ethernet_traffic_information_ie>(
+  //     t, PFCP_IE_ETHERNET_TRAFFIC_INFORMATION, 0);
+  // add<pfcp_mac_addresses_detected_ie>(t, PFCP_IE_MAC_ADDRESSES_DETECTED, 0);
+  // add<pfcp_mac_addresses_removed_ie>(t, PFCP_IE_MAC_ADDRESSES_REMOVED, 0);
+  // add<pfcp_ethernet_inactivity_timer_ie>(
+  //     t, PFCP_IE_ETHERNET_INACTIVITY_TIMER, 0);
+  // add<pfcp_additional_monitoring_time_ie>(
+  //     t, PFCP_IE_ADDITIONAL_MONITORING_TIME, 0);
+  // add<pfcp_event_information_ie>(t, PFCP_IE_EVENT_INFORMATION, 0);
+  // add<pfcp_event_reporting_ie>(t, PFCP_IE_EVENT_REPORTING, 0);
+  // add<pfcp_event_id_ie>(t, PFCP_IE_EVENT_ID, 0);
+  // add<pfcp_event_threshold_ie>(t, PFCP_IE_EVENT_THRESHOLD, 0);
+  // add<pfcp_trace_information_ie>(t, PFCP_IE_TRACE_INFORMATION, 0);
+  // add<pfcp_framed_route_ie>(t, PFCP_IE_FRAMED_ROUTE, 0);
+  // add<pfcp_framed_routing_ie>(t, PFCP_IE_FRAMED_ROUTING, 0);
+  // add<pfcp_framed_ipv6_route_ie>(t, PFCP_IE_FRAMED_IPV6_ROUTE, 0);
+  return t;
+}
+
+constexpr pfcp_ie_table_t pfcp_ie_table = make_pfcp_ie_table();
+
+// Stands for an IE with no class, or a vendor specific IE: its value is
+// consumed without being stored, it brings nothing to the core containers and
+// is not sent again
+class pfcp_skipped_ie : public pfcp_ie {
+ public:
+  explicit pfcp_skipped_ie(const pfcp_tlv& t) : pfcp_ie(t) {}
+
+  void to_core_type(pfcp_ies_container& s) {}
+
+  void dump_to(std::ostream& os) {}
+
+  void load_from(std::istream& is) {
+    // the Enterprise ID, already read, counts in the length
+    is.ignore((tlv.type & 0x8000) ? tlv.length - 2 : tlv.length);
+  }
+};
+}  // namespace
+
 //------------------------------------------------------------------------------
 pfcp_ie* pfcp_ie::new_pfcp_ie_from_stream(std::istream& is) {
   pfcp_tlv tlv;
   tlv.load_from(is);
   if (tlv.length) {
-    switch (tlv.type) {
-      case PFCP_IE_CREATE_PDR: {
-        pfcp_create_pdr_ie* ie = new pfcp_create_pdr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_PDI: {
-        pfcp_pdi_ie* ie = new pfcp_pdi_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_CREATE_FAR: {
-        pfcp_create_far_ie* ie = new pfcp_create_far_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_FORWARDING_PARAMETERS: {
-        pfcp_forwarding_parameters_ie* ie =
-            new pfcp_forwarding_parameters_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_DUPLICATING_PARAMETERS: {
-        pfcp_duplicating_parameters_ie* ie =
-            new pfcp_duplicating_parameters_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_CREATE_URR: {
-        pfcp_create_urr_ie* ie = new pfcp_create_urr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_CREATE_QER: {
-        pfcp_create_qer_ie* ie = new pfcp_create_qer_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_CREATED_PDR: {
-        pfcp_created_pdr_ie* ie = new pfcp_created_pdr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UPDATE_PDR: {
-        pfcp_update_pdr_ie* ie = new pfcp_update_pdr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UPDATE_FAR: {
-        pfcp_update_far_ie* ie = new pfcp_update_far_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UPDATE_FORWARDING_PARAMETERS: {
-        pfcp_update_forwarding_parameters_ie* ie =
-            new pfcp_update_forwarding_parameters_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UPDATE_BAR_WITHIN_PFCP_SESSION_REPORT_RESPONSE: {
-        pfcp_update_bar_within_pfcp_session_report_response_ie* ie =
-            new pfcp_update_bar_within_pfcp_session_report_response_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UPDATE_URR: {
-        pfcp_update_urr_ie* ie = new pfcp_update_urr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UPDATE_QER: {
-        pfcp_update_qer_ie* ie = new pfcp_update_qer_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_REMOVE_PDR: {
-        pfcp_remove_pdr_ie* ie = new pfcp_remove_pdr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_REMOVE_FAR: {
-        pfcp_remove_far_ie* ie = new pfcp_remove_far_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_REMOVE_URR: {
-        pfcp_remove_urr_ie* ie = new pfcp_remove_urr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_REMOVE_QER: {
-        pfcp_remove_qer_ie* ie = new pfcp_remove_qer_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_CAUSE: {
-        pfcp_cause_ie* ie = new pfcp_cause_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_SOURCE_INTERFACE: {
-        pfcp_source_interface_ie* ie = new pfcp_source_interface_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_F_TEID: {
-        pfcp_fteid_ie* ie = new pfcp_fteid_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_NETWORK_INSTANCE: {
-        pfcp_network_instance_ie* ie = new pfcp_network_instance_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_SDF_FILTER: {
-        pfcp_sdf_filter_ie* ie = new pfcp_sdf_filter_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_APPLICATION_ID: {
-        pfcp_application_id_ie* ie = new pfcp_application_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_GATE_STATUS: {
-        pfcp_gate_status_ie* ie = new pfcp_gate_status_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_MBR: {
-        pfcp_mbr_ie* ie = new pfcp_mbr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_GBR: {
-        pfcp_gbr_ie* ie = new pfcp_gbr_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_QER_CORRELATION_ID: {
-        pfcp_qer_correlation_id_ie* ie = new pfcp_qer_correlation_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_PRECEDENCE: {
-        pfcp_precedence_ie* ie = new pfcp_precedence_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_TRANSPORT_LEVEL_MARKING: {
-        pfcp_transport_level_marking_ie* ie =
-            new pfcp_transport_level_marking_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_VOLUME_THRESHOLD: {
-        pfcp_volume_threshold_ie* ie = new pfcp_volume_threshold_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_TIME_THRESHOLD: {
-        pfcp_time_threshold_ie* ie = new pfcp_time_threshold_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_MONITORING_TIME: {
-        pfcp_monitoring_time_ie* ie = new pfcp_monitoring_time_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_SUBSEQUENT_VOLUME_THRESHOLD: {
-        pfcp_subsequent_volume_threshold_ie* ie =
-            new pfcp_subsequent_volume_threshold_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_SUBSEQUENT_TIME_THRESHOLD: {
-        pfcp_subsequent_time_threshold_ie* ie =
-            new pfcp_subsequent_time_threshold_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_INACTIVITY_DETECTION_TIME: {
-        pfcp_inactivity_detection_time_ie* ie =
-            new pfcp_inactivity_detection_time_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_REPORTING_TRIGGERS: {
-        pfcp_reporting_triggers_ie* ie = new pfcp_reporting_triggers_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_REDIRECT_INFORMATION: {
-        //        pfcp_redirect_information_ie *ie = new
-        //        pfcp_redirect_information_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-      case PFCP_IE_REPORT_TYPE: {
-        pfcp_report_type_ie* ie = new pfcp_report_type_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_OFFENDING_IE: {
-        pfcp_offending_ie_ie* ie = new pfcp_offending_ie_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_FORWARDING_POLICY: {
-        pfcp_forwarding_policy_ie* ie = new pfcp_forwarding_policy_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_DESTINATION_INTERFACE: {
-        pfcp_destination_interface_ie* ie =
-            new pfcp_destination_interface_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_UP_FUNCTION_FEATURES: {
-        pfcp_up_function_features_ie* ie =
-            new pfcp_up_function_features_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_APPLY_ACTION: {
-        pfcp_apply_action_ie* ie = new pfcp_apply_action_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_DOWNLINK_DATA_SERVICE_INFORMATION: {
-        //        pfcp_downlink_data_service_information_ie *ie = new
-        //        pfcp_downlink_data_service_information_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_DOWNLINK_DATA_NOTIFICATION_DELAY: {
-        //        pfcp_downlink_data_notification_delay_ie *ie = new
-        //        pfcp_downlink_data_notification_delay_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_DL_BUFFERING_DURATION: {
-        //        pfcp_dl_buffering_duration_ie *ie = new
-        //        pfcp_dl_buffering_duration_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_DL_BUFFERING_SUGGESTED_PACKET_COUNT: {
-        //        pfcp_dl_buffering_suggested_packet_count_ie *ie = new
-        //        pfcp_dl_buffering_suggested_packet_count_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_PFCPSMREQ_FLAGS: {
-        //        pfcp_pfcpsmreq_flags_ie *ie = new
-        //        pfcp_pfcpsmreq_flags_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_PFCPSRRSP_FLAGS: {
-        //        pfcp_pfcpsrrsp_flags_ie *ie = new
-        //        pfcp_pfcpsrrsp_flags_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_LOAD_CONTROL_INFORMATION: {
-        //        pfcp_load_control_information_ie *ie = new
-        //        pfcp_load_control_information_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_SEQUENCE_NUMBER: {
-        //        pfcp_sequence_number_ie *ie = new
-        //        pfcp_sequence_number_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_METRIC: {
-        //        pfcp_metric_ie *ie = new pfcp_metric_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_OVERLOAD_CONTROL_INFORMATION: {
-        //        pfcp_overload_control_information_ie *ie = new
-        //        pfcp_overload_control_information_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_TIMER: {
-        //        pfcp_timer_ie *ie = new pfcp_timer_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_PACKET_DETECTION_RULE_ID: {
-        pfcp_pdr_id_ie* ie = new pfcp_pdr_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_F_SEID: {
-        pfcp_f_seid_ie* ie = new pfcp_f_seid_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_APPLICATION_IDS_PFDS: {
-        //        pfcp_application_ids_pfds_ie *ie = new
-        //        pfcp_application_ids_pfds_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_PFD: {
-        //        pfcp_pfd_ie *ie = new pfcp_pfd_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_NODE_ID: {
-        pfcp_node_id_ie* ie = new pfcp_node_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_PFD_CONTENTS: {
-        //        pfcp_pfd_contents_ie *ie = new pfcp_pfd_contents_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MEASUREMENT_METHOD: {
-        //        pfcp_measurement_method_ie *ie = new
-        //        pfcp_measurement_method_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_USAGE_REPORT_TRIGGER: {
-        //        pfcp_usage_report_trigger_ie *ie = new
-        //        pfcp_usage_report_trigger_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MEASUREMENT_PERIOD: {
-        //        pfcp_measurement_period_ie *ie = new
-        //        pfcp_measurement_period_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_FQ_CSID: {
-        //        pfcp_fq_csid_ie *ie = new pfcp_fq_csid_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_VOLUME_MEASUREMENT: {
-        //        pfcp_volume_measurement_ie *ie = new
-        //        pfcp_volume_measurement_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_DURATION_MEASUREMENT: {
-        //        pfcp_duration_measurement_ie *ie = new
-        //        pfcp_duration_measurement_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_APPLICATION_DETECTION_INFORMATION: {
-        //        pfcp_application_detection_information_ie *ie = new
-        //        pfcp_application_detection_information_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_TIME_OF_FIRST_PACKET: {
-        //        pfcp_time_of_first_packet_ie *ie = new
-        //        pfcp_time_of_first_packet_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_TIME_OF_LAST_PACKET: {
-        //        pfcp_time_of_last_packet_ie *ie = new
-        //        pfcp_time_of_last_packet_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_QUOTA_HOLDING_TIME: {
-        //        pfcp_quota_holding_time_ie *ie = new
-        //        pfcp_quota_holding_time_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_DROPPED_DL_TRAFFIC_THRESHOLD: {
-        //        pfcp_dropped_dl_traffic_threshold_ie *ie = new
-        //        pfcp_dropped_dl_traffic_threshold_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_VOLUME_QUOTA: {
-        //        pfcp_volume_quota_ie *ie = new pfcp_volume_quota_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_TIME_QUOTA: {
-        //        pfcp_time_quota_ie *ie = new pfcp_time_quota_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_START_TIME: {
-        //        pfcp_start_time_ie *ie = new pfcp_start_time_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_END_TIME: {
-        //        pfcp_end_time_ie *ie = new pfcp_end_time_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_QUERY_URR: {
-        //        pfcp_query_urr_ie *ie = new pfcp_query_urr_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_USAGE_REPORT_WITHIN_SESSION_MODIFICATION_RESPONSE: {
-        //        pfcp_usage_report_within_session_modification_response_ie *ie
-        //        = new
-        //        pfcp_usage_report_within_session_modification_response_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_USAGE_REPORT_WITHIN_SESSION_DELETION_RESPONSE: {
-        //        pfcp_usage_report_within_session_deletion_response_ie *ie =
-        //        new
-        //        pfcp_usage_report_within_session_deletion_response_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_USAGE_REPORT_WITHIN_SESSION_REPORT_REQUEST: {
-        //        pfcp_usage_report_within_session_report_request_ie *ie = new
-        //        pfcp_usage_report_within_session_report_request_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_URR_ID: {
-        pfcp_urr_id_ie* ie = new pfcp_urr_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_LINKED_URR_ID: {
-        //        pfcp_linked_urr_id_ie *ie = new pfcp_linked_urr_id_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_DOWNLINK_DATA_REPORT: {
-        pfcp_downlink_data_report_ie* ie =
-            new pfcp_downlink_data_report_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_OUTER_HEADER_CREATION: {
-        pfcp_outer_header_creation_ie* ie =
-            new pfcp_outer_header_creation_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_CREATE_BAR: {
-        //        pfcp_create_bar_ie *ie = new pfcp_create_bar_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_UPDATE_BAR_WITHIN_PFCP_SESSION_MODIFICATION_REQUEST:
-        //    {
-        //        pfcp_update_bar_within_session_modification_request_ie *ie =
-        //        new
-        //        pfcp_update_bar_within_session_modification_request_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_REMOVE_BAR: {
-        //        pfcp_remove_bar_ie *ie = new pfcp_remove_bar_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_BAR_ID: {
-        pfcp_bar_id_ie* ie = new pfcp_bar_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_CP_FUNCTION_FEATURES: {
-        pfcp_cp_function_features_ie* ie =
-            new pfcp_cp_function_features_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_USAGE_INFORMATION: {
-        //        pfcp_usage_information_ie *ie = new
-        //        pfcp_usage_information_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_APPLICATION_INSTANCE_ID: {
-        //        pfcp_application_instance_id_ie *ie = new
-        //        pfcp_application_instance_id_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_FLOW_INFORMATION: {
-        //        pfcp_flow_information_ie *ie = new
-        //        pfcp_flow_information_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-      case PFCP_IE_UE_IP_ADDRESS: {
-        pfcp_ue_ip_address_ie* ie = new pfcp_ue_ip_address_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_PACKET_RATE: {
-        //        pfcp_packet_rate_ie *ie = new pfcp_packet_rate_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_OUTER_HEADER_REMOVAL: {
-        pfcp_outer_header_removal_ie* ie =
-            new pfcp_outer_header_removal_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_RECOVERY_TIME_STAMP: {
-        pfcp_recovery_time_stamp_ie* ie = new pfcp_recovery_time_stamp_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_DL_FLOW_LEVEL_MARKING: {
-        //        pfcp_dl_flow_level_marking_ie *ie = new
-        //        pfcp_dl_flow_level_marking_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_HEADER_ENRICHMENT: {
-        //        pfcp_header_enrichment_ie *ie = new
-        //        pfcp_header_enrichment_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ERROR_INDICATION_REPORT: {
-        //        pfcp_error_indication_report_ie *ie = new
-        //        pfcp_error_indication_report_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MEASUREMENT_INFORMATION: {
-        //        pfcp_measurement_information_ie *ie = new
-        //        pfcp_measurement_information_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_NODE_REPORT_TYPE: {
-        //        pfcp_node_report_type_ie *ie = new
-        //        pfcp_node_report_type_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_USER_PLANE_PATH_FAILURE_REPORT: {
-        //        pfcp_user_plane_path_failure_report_ie *ie = new
-        //        pfcp_user_plane_path_failure_report_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_REMOTE_GTP_U_PEER: {
-        //        pfcp_remote_gtp_u_peer_ie *ie = new
-        //        pfcp_remote_gtp_u_peer_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_UR_SEQN: {
-        //        pfcp_ur_seqn_ie *ie = new pfcp_ur_seqn_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_UPDATE_DUPLICATING_PARAMETERS: {
-        //        pfcp_update_duplicating_parameters_ie *ie = new
-        //        pfcp_update_duplicating_parameters_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_ACTIVATE_PREDEFINED_RULES: {
-        pfcp_activate_predefined_rules_ie* ie =
-            new pfcp_activate_predefined_rules_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_DEACTIVATE_PREDEFINED_RULES: {
-        pfcp_deactivate_predefined_rules_ie* ie =
-            new pfcp_deactivate_predefined_rules_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_FAR_ID: {
-        pfcp_far_id_ie* ie = new pfcp_far_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_QER_ID: {
-        pfcp_qer_id_ie* ie = new pfcp_qer_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_OCI_FLAGS: {
-        //        pfcp_oci_flags_ie *ie = new pfcp_oci_flags_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_PFCP_ASSOCIATION_RELEASE_REQUEST: {
-        //        pfcp_pfcp_association_release_request_ie *ie = new
-        //        pfcp_pfcp_association_release_request_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_GRACEFUL_RELEASE_PERIOD: {
-        //        pfcp_graceful_release_period_ie *ie = new
-        //        pfcp_graceful_release_period_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_PDN_TYPE: {
-        //        pfcp_pdn_type_ie *ie = new pfcp_pdn_type_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_FAILED_RULE_ID: {
-        pfcp_failed_rule_id_ie* ie = new pfcp_failed_rule_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_TIME_QUOTA_MECHANISM: {
-        //        pfcp_time_quota_mechanism_ie *ie = new
-        //        pfcp_time_quota_mechanism_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-      case PFCP_IE_USER_PLANE_IP_RESOURCE_INFORMATION: {
-        pfcp_user_plane_ip_resource_information_ie* ie =
-            new pfcp_user_plane_ip_resource_information_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-      case PFCP_IE_USER_PLANE_INACTIVITY_TIMER: {
-        pfcp_user_plane_inactivity_timer_ie* ie =
-            new pfcp_user_plane_inactivity_timer_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_AGGREGATED_URRS: {
-        //        pfcp_aggregated_urrs_ie *ie = new
-        //        pfcp_aggregated_urrs_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MULTIPLIER: {
-        //        pfcp_multiplier_ie *ie = new pfcp_multiplier_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_AGGREGATED_URR_ID: {
-        //        pfcp_aggregated_urr_id_ie *ie = new
-        //        pfcp_aggregated_urr_id_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_SUBSEQUENT_VOLUME_QUOTA: {
-        //        pfcp_subsequent_volume_quota_ie *ie = new
-        //        pfcp_subsequent_volume_quota_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_SUBSEQUENT_TIME_QUOTA: {
-        //        pfcp_subsequent_time_quota_ie *ie = new
-        //        pfcp_subsequent_time_quota_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_RQI: {
-        //        pfcp_rqi_ie *ie = new pfcp_rqi_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_QFI: {
-        pfcp_qfi_ie* ie = new pfcp_qfi_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_QUERY_URR_REFERENCE: {
-        //        pfcp_query_urr_reference_ie *ie = new
-        //        pfcp_query_urr_reference_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ADDITIONAL_USAGE_REPORTS_INFORMATION: {
-        //        pfcp_additional_usage_reports_information_ie *ie = new
-        //        pfcp_additional_usage_reports_information_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_CREATE_TRAFFIC_ENDPOINT: {
-        //        pfcp_create_traffic_endpoint_ie *ie = new
-        //        pfcp_create_traffic_endpoint_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_CREATED_TRAFFIC_ENDPOINT: {
-        //        pfcp_created_traffic_endpoint_ie *ie = new
-        //        pfcp_created_traffic_endpoint_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_UPDATE_TRAFFIC_ENDPOINT: {
-        //        pfcp_update_traffic_endpoint_ie *ie = new
-        //        pfcp_update_traffic_endpoint_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_REMOVE_TRAFFIC_ENDPOINT: {
-        //        pfcp_remove_traffic_endpoint_ie *ie = new
-        //        pfcp_remove_traffic_endpoint_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_TRAFFIC_ENDPOINT_ID: {
-        //        pfcp_traffic_endpoint_id_ie *ie = new
-        //        pfcp_traffic_endpoint_id_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ETHERNET_PACKET_FILTER: {
-        //        pfcp_ethernet_packet_filter_ie *ie = new
-        //        pfcp_ethernet_packet_filter_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MAC_ADDRESS: {
-        //        pfcp_mac_address_ie *ie = new pfcp_mac_address_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_C_TAG: {
-        //        pfcp_c_tag_ie *ie = new pfcp_c_tag_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_S_TAG: {
-        //        pfcp_s_tag_ie *ie = new pfcp_s_tag_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ETHERTYPE: {
-        //        pfcp_ethertype_ie *ie = new pfcp_ethertype_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_PROXYING: {
-        //        pfcp_proxying_ie *ie = new pfcp_proxying_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ETHERNET_FILTER_ID: {
-        //        pfcp_ethernet_filter_id_ie *ie = new
-        //        pfcp_ethernet_filter_id_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ETHERNET_FILTER_PROPERTIES: {
-        //        pfcp_ethernet_filter_properties_ie *ie = new
-        //        pfcp_ethernet_filter_properties_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_SUGGESTED_BUFFERING_PACKETS_COUNT: {
-        //        pfcp_suggested_buffering_packets_count_ie *ie = new
-        //        pfcp_suggested_buffering_packets_count_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-      case PFCP_IE_USER_ID: {
-        pfcp_user_id_ie* ie = new pfcp_user_id_ie(tlv);
-        ie->load_from(is);
-        return ie;
-      } break;
-        //    case PFCP_IE_ETHERNET_PDU_SESSION_INFORMATION: {
-        //        pfcp_ethernet_pdu_session_information_ie *ie = new
-        //        pfcp_ethernet_pdu_session_information_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ETHERNET_TRAFFIC_INFORMATION: {
-        //        pfcp_ethernet_traffic_information_ie *ie = new
-        //        pfcp_ethernet_traffic_information_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MAC_ADDRESSES_DETECTED: {
-        //        pfcp_mac_addresses_detected_ie *ie = new
-        //        pfcp_mac_addresses_detected_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_MAC_ADDRESSES_REMOVED: {
-        //        pfcp_mac_addresses_removed_ie *ie = new
-        //        pfcp_mac_addresses_removed_ie(tlv); ie->load_from(is); return
-        //        ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ETHERNET_INACTIVITY_TIMER: {
-        //        pfcp_ethernet_inactivity_timer_ie *ie = new
-        //        pfcp_ethernet_inactivity_timer_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_ADDITIONAL_MONITORING_TIME: {
-        //        pfcp_additional_monitoring_time_ie *ie = new
-        //        pfcp_additional_monitoring_time_ie(tlv); ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_EVENT_INFORMATION: {
-        //        pfcp_event_information_ie *ie = new
-        //        pfcp_event_information_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_EVENT_REPORTING: {
-        //        pfcp_event_reporting_ie *ie = new
-        //        pfcp_event_reporting_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_EVENT_ID: {
-        //        pfcp_event_id_ie *ie = new pfcp_event_id_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_EVENT_THRESHOLD: {
-        //        pfcp_event_threshold_ie *ie = new
-        //        pfcp_event_threshold_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_TRACE_INFORMATION: {
-        //        pfcp_trace_information_ie *ie = new
-        //        pfcp_trace_information_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_FRAMED_ROUTE: {
-        //        pfcp_framed_route_ie *ie = new pfcp_framed_route_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_FRAMED_ROUTING: {
-        //        pfcp_framed_routing_ie *ie = new pfcp_framed_routing_ie(tlv);
-        //        ie->load_from(is);
-        //        return ie;
-        //      }
-        //      break;
-        //    case PFCP_IE_FRAMED_IPV6_ROUTE: {
-        //        pfcp_framed_ipv6_route_ie *ie = new
-        //        pfcp_framed_ipv6_route_ie(tlv); ie->load_from(is); return ie;
-        //      }
-        //      break;
-      default:
-        Logger::pfcp().error(
-            "Unknown PFCP IE type %d (length %d)", tlv.get_type(),
-            tlv.get_length());
-        return nullptr;
+    if (tlv.type < pfcp_ie_table.size()) {
+      const pfcp_ie_decoder& d = pfcp_ie_table[tlv.type];
+      if (d.factory) {
+        if (tlv.length < d.min_length) {
+          throw pfcp_tlv_bad_length_exception(
+              tlv.type, tlv.length, __FILE__, __LINE__);
+        }
+        std::unique_ptr<pfcp_ie> ie(d.factory(tlv));
+        ie->load_from(is);
+        return ie.release();
+      }
+    } else if ((tlv.type & 0x8000) && (tlv.length < 2)) {
+      throw pfcp_tlv_bad_length_exception(
+          tlv.type, tlv.length, __FILE__, __LINE__);
     }
+    Logger::pfcp().trace(
+        "Skipping PFCP IE type %d (length %d)", tlv.get_type(),
+        tlv.get_length());
+    pfcp_ie* ie = new pfcp_skipped_ie(tlv);
+    ie->load_from(is);
+    return ie;
   } else {
     Logger::pfcp().error(
         "PFCP IE type %d length %d", tlv.get_type(), tlv.get_length());
@@ -35,38 +35,45 @@ using namespace std;
 
 extern itti_mw* itti_inst;
 
+namespace {
+// responses not kept for duplicated requests are encoded in the buffer of the
+// sending thread
+std::vector<uint8_t>& response_bytes() {
+  thread_local std::vector<uint8_t> bytes;
+  return bytes;
+}
+}  // namespace
+
 //------------------------------------------------------------------------------
 pfcp_l4_stack::pfcp_l4_stack(
     const uint32_t t1_milli_seconds, const uint32_t n1_retransmit,
     const string& ip_address, const unsigned short port_num,
-    const util::thread_sched_params& sched_params)
+    const util::thread_sched_params& sched_params, const uint32_t num_workers,
+    const uint32_t udp_batch_size, const bool io_uring,
+    const uint32_t max_concurrent_procedures)
     : t1_ms(t1_milli_seconds),
       n1(n1_retransmit),
       udp_s_registered(ip_address.c_str(), port_num),
-      udp_s_allocated(ip_address.c_str(), 0) {
+      udp_s_allocated(ip_address.c_str(), 0),
+      m_transactions(),
+      transactions(max_concurrent_procedures, 24, (uint32_t) time(nullptr)),
+      response_cache_bytes(0) {
   Logger::pfcp().info(
-      "pfcp_l4_stack created listening to %s:%d", ip_address.c_str(), port_num);
-  trxn_id2seq_num      = {};
-  proc_cleanup_timers  = {};
-  msg_out_retry_timers = {};
-  pending_procedures   = {};
-
-  id = 0;
+      "pfcp_l4_stack created listening to %s:%d, %u worker(s), %u procedures "
+      "max",
+      ip_address.c_str(), port_num, num_workers, max_concurrent_procedures);
 
-  timespec ts;
-  clock_gettime(CLOCK_REALTIME, &ts);
-  seq_num         = (uint32_t) ts.tv_nsec & 0x7FFFFFFF;
+  id              = 0;
   restart_counter = 0;
-  udp_s_registered.start_receive(this, sched_params);
-  udp_s_allocated.start_receive(this, sched_params);
+  udp_s_registered.start_receive(
+      this, sched_params, num_workers, udp_batch_size, io_uring);
+  udp_s_allocated.start_receive(
+      this, sched_params, num_workers, udp_batch_size, io_uring);
 }
 //------------------------------------------------------------------------------
-uint32_t pfcp_l4_stack::get_next_seq_num() {
-  seq_num++;
-  if (seq_num & 0x80000000) {
-    seq_num = 0;
-  }
-  return seq_num;
+void pfcp_l4_stack::stop() {
+  udp_s_registered.stop();
+  udp_s_allocated.stop();
 }
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::handle_receive(
@@ -126,8 +133,7 @@ void pfcp_l4_stack::start_msg_retry_timer(
       time_out_milli_seconds / 1000, (time_out_milli_seconds % 1000) * 1000,
       task_id);
   if (p.retry_timer_id != ITTI_INVALID_TIMER_ID) {
-    msg_out_retry_timers.insert(
-        std::pair<timer_id_t, uint32_t>(p.retry_timer_id, seq_num));
+    transactions.bind_timer(seq_num, p.retry_timer_id);
     Logger::pfcp().trace(
         "Started Msg retry timer %d, proc %" PRId64 ", seq %d",
         p.retry_timer_id, p.trxn_id, seq_num);
@@ -141,17 +147,17 @@ void pfcp_l4_stack::start_msg_retry_timer(
 void pfcp_l4_stack::stop_msg_retry_timer(pfcp_procedure& p) {
   if (p.retry_timer_id != ITTI_INVALID_TIMER_ID) {
     itti_inst->timer_remove(p.retry_timer_id);
-    msg_out_retry_timers.erase(p.retry_timer_id);
+    transactions.unbind_timer(p.retry_timer_id);
     Logger::pfcp().trace(
-        "Stopped Msg retry timer %d, proc %" PRId64 ", seq %d",
-        p.retry_timer_id, p.trxn_id, p.retry_msg->get_sequence_number());
+        "Stopped Msg retry timer %d, proc %" PRId64, p.retry_timer_id,
+        p.trxn_id);
     p.retry_timer_id = ITTI_INVALID_TIMER_ID;
   }
 }
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::stop_msg_retry_timer(timer_id_t& t) {
   itti_inst->timer_remove(t);
-  msg_out_retry_timers.erase(t);
+  transactions.unbind_timer(t);
   Logger::pfcp().trace("Stopped Msg retry timer %d", t);
 }
 //------------------------------------------------------------------------------
@@ -161,8 +167,7 @@ void pfcp_l4_stack::start_proc_cleanup_timer(
   p.proc_cleanup_timer_id = itti_inst->timer_setup(
       time_out_milli_seconds / 1000, (time_out_milli_seconds % 1000) * 1000,
       task_id);
-  proc_cleanup_timers.insert(
-      std::pair<timer_id_t, uint32_t>(p.proc_cleanup_timer_id, seq_num));
+  transactions.bind_timer(seq_num, p.proc_cleanup_timer_id);
   Logger::pfcp().trace(
       "Started proc cleanup timer %d, proc %" PRId64 " t-out %" PRIu32 " ms",
       p.proc_cleanup_timer_id, p.trxn_id, time_out_milli_seconds);
@@ -173,191 +178,200 @@ void pfcp_l4_stack::stop_proc_cleanup_timer(pfcp_procedure& p) {
   Logger::pfcp().trace(
       "Stopped proc cleanup timer %d, proc %" PRId64 "",
       p.proc_cleanup_timer_id, p.trxn_id);
-  msg_out_retry_timers.erase(p.proc_cleanup_timer_id);
-  proc_cleanup_timers.erase(p.proc_cleanup_timer_id);
+  transactions.unbind_timer(p.proc_cleanup_timer_id);
   p.proc_cleanup_timer_id = 0;
 }
 //------------------------------------------------------------------------------
+pfcp_procedure* pfcp_l4_stack::open_procedure(uint32_t& seq_num) {
+  uint32_t oldest = 0;
+  if (transactions.full() && transactions.oldest_retired(oldest)) {
+    close_procedure(oldest);
+  }
+  return transactions.open(seq_num);
+}
+//------------------------------------------------------------------------------
+void pfcp_l4_stack::close_procedure(const uint32_t seq_num) {
+  pfcp_procedure* proc = transactions.find(seq_num);
+  if (not proc) return;
+  if (proc->retry_timer_id != ITTI_INVALID_TIMER_ID) {
+    stop_msg_retry_timer(*proc);
+  }
+  if (proc->proc_cleanup_timer_id != ITTI_INVALID_TIMER_ID) {
+    stop_proc_cleanup_timer(*proc);
+  }
+  if (proc->received_request) {
+    release_response_bytes(*proc);
+  }
+  if (proc->trxn_id) {
+    free_trxn_id(proc->trxn_id);
+  }
+  transactions.close(seq_num);
+}
+//------------------------------------------------------------------------------
 void pfcp_l4_stack::handle_receive_message_cb(
     const pfcp_msg& msg, const endpoint& remote_endpoint,
     const task_id_t& task_id, bool& error, uint64_t& trxn_id) {
-  trxn_id = 0;
-  error   = true;
-  std::map<uint32_t, pfcp_procedure>::iterator it;
-  it = pending_procedures.find(msg.get_sequence_number());
-  // If no procedure found concerning this message
-  if (it == pending_procedures.end()) {
-    // If procedure type is a request-like procedure
-    if (pfcp_l4_stack::check_request_type(msg.get_message_type())) {
-      pfcp_procedure proc   = {};
-      proc.trxn_id          = generate_trxn_id();
-      proc.initial_msg_type = msg.get_message_type();
-      // TODO later 13.3 Detection and handling of requests which have timed out
-      // at the originating entity if (msg_has_timestamp()) {
-      // start_proc_cleanup_timer(proc, (N3+1) x T3, task_id,
-      // msg.get_sequence_number()); } else
-      start_proc_cleanup_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-      pending_procedures.insert(
-          std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-      trxn_id2seq_num.insert(std::pair<uint64_t, uint32_t>(
-          proc.trxn_id, msg.get_sequence_number()));
-      error   = false;
-      trxn_id = proc.trxn_id;
-      Logger::pfcp().info(
-          "Received Initial PFCP msg type %d, seq %d, proc %" PRId64 "",
-          msg.get_message_type(), msg.get_sequence_number(), proc.trxn_id);
-    } else {
-      Logger::pfcp().info(
-          "Failed to check Initial message type, Silently discarding PFCP msg "
-          "type %d, seq %d",
-          msg.get_message_type(), msg.get_sequence_number());
-      error = true;
-    }
-    return;
-  } else {
-    // Found procedure concerning this message
-
-    //    Logger::pfcp().info( "pfcp_procedure retry_timer_id        %d",
-    //    it->second.retry_timer_id); Logger::pfcp().info( "pfcp_procedure
-    //    proc_cleanup_timer_id %d", it->second.proc_cleanup_timer_id);
-    //    Logger::pfcp().info( "pfcp_procedure trxn_id            %ld",
-    //    it->second.trxn_id); Logger::pfcp().info( "pfcp_procedure
-    //    initial_msg_type      %d", it->second.initial_msg_type);
-    //    Logger::pfcp().info( "pfcp_procedure triggered_msg_type    %d",
-    //    it->second.triggered_msg_type); Logger::pfcp().info( "pfcp_procedure
-    //    retry_count           %d", it->second.retry_count);
-
-    uint8_t check_initial_msg_type = it->second.triggered_msg_type;
-    if (!it->second.triggered_msg_type) {
-      check_initial_msg_type = it->second.initial_msg_type;
+  std::unique_lock lock(m_transactions);
+  trxn_id              = 0;
+  error                = true;
+  pfcp_procedure* sent = transactions.find(msg.get_sequence_number());
+  // Found a procedure we initiated concerning this message
+  if ((sent) && (not sent->received_request)) {
+    uint8_t check_initial_msg_type = sent->triggered_msg_type;
+    if (!sent->triggered_msg_type) {
+      check_initial_msg_type = sent->initial_msg_type;
     }
     // check_initial_msg_type now contains the Request type.
     if (pfcp_l4_stack::check_response_type(
             check_initial_msg_type, msg.get_message_type())) {
       // The msg response type is a valid response or triggered message
-      if (!it->second.triggered_msg_type) {
-        it->second.triggered_msg_type = msg.get_message_type();
-      }
       error   = false;
-      trxn_id = it->second.trxn_id;
-      if (it->second.retry_timer_id) {
-        stop_msg_retry_timer(it->second);
-      }
-      stop_proc_cleanup_timer(it->second);
-      trxn_id2seq_num.erase(trxn_id);
-      free_trxn_id(trxn_id);
-      pending_procedures.erase(it->first);
+      trxn_id = sent->trxn_id;
+      close_procedure(msg.get_sequence_number());
       Logger::pfcp().info(
           "Received Triggered PFCP msg type %d, seq %d, proc %" PRId64 "",
           msg.get_message_type(), msg.get_sequence_number(), trxn_id);
+      return;
+    }
+  }
+  // If procedure type is a request-like procedure
+  if (not pfcp_l4_stack::check_request_type(msg.get_message_type())) {
+    Logger::pfcp().info(
+        "Failed to check message type, Silently discarding PFCP msg type %d, "
+        "seq %d",
+        msg.get_message_type(), msg.get_sequence_number());
+    return;
+  }
+  // TS 29.244 6.4: a retransmitted request carries the sequence number of the
+  // original one, it is answered with the response already sent
+  const request_key request(remote_endpoint, msg.get_sequence_number());
+  uint32_t received_seq_num = 0;
+  if (transactions.find_request(request, received_seq_num)) {
+    pfcp_procedure* received = transactions.find(received_seq_num);
+    if ((received) && (received->retry_bytes.size())) {
+      const std::vector<uint8_t>& bytes = received->retry_bytes;
+      udp_s_registered.async_send_to(
+          reinterpret_cast<const char*>(bytes.data()), bytes.size(),
+          remote_endpoint);
+      Logger::pfcp().info(
+          "Received duplicated PFCP msg type %d, seq %d from %s, response sent "
+          "again",
+          msg.get_message_type(), msg.get_sequence_number(),
+          remote_endpoint.toString().c_str());
     } else {
       Logger::pfcp().info(
-          "Failed to check Triggered message type, Silently discarding PFCP "
-          "msg type %d, seq %d",
-          msg.get_message_type(), msg.get_sequence_number());
-      error = true;
+          "Received duplicated PFCP msg type %d, seq %d from %s, in progress "
+          "or response not cached, discarded",
+          msg.get_message_type(), msg.get_sequence_number(),
+          remote_endpoint.toString().c_str());
     }
+    return;
   }
+
+  uint32_t seq_num     = 0;
+  pfcp_procedure* proc = open_procedure(seq_num);
+  if (not proc) {
+    // the peer retransmits the request, it may be accepted then
+    Logger::pfcp().warn(
+        "Received Initial PFCP msg type %d, seq %d, %u procedures in "
+        "progress, discarded",
+        msg.get_message_type(), msg.get_sequence_number(),
+        transactions.size());
+    return;
+  }
+  proc->trxn_id          = generate_trxn_id();
+  proc->initial_msg_type = msg.get_message_type();
+  proc->remote_endpoint  = remote_endpoint;
+  proc->remote_seq_num   = msg.get_sequence_number();
+  proc->received_request = true;
+  // TODO later 13.3 Detection and handling of requests which have timed out
+  // at the originating entity if (msg_has_timestamp()) {
+  // start_proc_cleanup_timer(proc, (N3+1) x T3, task_id,
+  // msg.get_sequence_number()); } else
+  // the response is kept as long as the peer may retransmit the request
+  start_proc_cleanup_timer(
+      *proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id, seq_num);
+  transactions.bind_tx_id(seq_num, proc->trxn_id);
+  transactions.bind_request(seq_num, request);
+  error   = false;
+  trxn_id = proc->trxn_id;
+  Logger::pfcp().info(
+      "Received Initial PFCP msg type %d, seq %d, proc %" PRId64 "",
+      msg.get_message_type(), msg.get_sequence_number(), proc->trxn_id);
+}
+//------------------------------------------------------------------------------
+void pfcp_l4_stack::release_response_bytes(pfcp_procedure& p) {
+  response_cache_bytes -= p.retry_bytes.size();
+  p.retry_bytes.clear();
 }
 
+//------------------------------------------------------------------------------
+template <class M>
+uint32_t pfcp_l4_stack::send_request_bytes(
+    const endpoint& dest, pfcp_msg_header& h, const M& pfcp_ies,
+    const uint64_t l_seid, const task_id_t& task_id, const uint64_t trxn_id) {
+  std::unique_lock lock(m_transactions);
+  uint32_t seq_num     = 0;
+  pfcp_procedure* proc = open_procedure(seq_num);
+  if (not proc) {
+    Logger::pfcp().error(
+        "Sending %s, proc %" PRId64 " refused, %u procedures in progress",
+        pfcp_ies.get_msg_name(), trxn_id, transactions.size());
+    // the application aborts its procedure as if the peer was not responding
+    notify_ul_error(
+        dest, l_seid, M::msg_id, 0, trxn_id,
+        ::cause_value_e::REMOTE_PEER_NOT_RESPONDING);
+    return 0;
+  }
+  h.set_sequence_number(seq_num);
+  // the procedure owns the bytes, a retransmission sends them as they are
+  try {
+    pfcp_encoder::encode(pfcp_ies, h, proc->retry_bytes);
+  } catch (...) {
+    transactions.close(seq_num);
+    throw;
+  }
+  if (h.has_seid()) {
+    Logger::pfcp().trace(
+        "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
+        seq_num, h.get_seid());
+  } else {
+    Logger::pfcp().trace(
+        "Sending %s, seq %d", pfcp_ies.get_msg_name(), seq_num);
+  }
+  proc->initial_msg_type = M::msg_id;
+  proc->trxn_id          = trxn_id;
+  proc->local_seid       = l_seid;
+  proc->remote_endpoint  = dest;
+  start_msg_retry_timer(*proc, t1_ms, task_id, seq_num);
+  start_proc_cleanup_timer(
+      *proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id, seq_num);
+  transactions.bind_tx_id(seq_num, trxn_id);
+  udp_s_allocated.async_send_to(
+      reinterpret_cast<const char*>(proc->retry_bytes.data()),
+      proc->retry_bytes.size(), dest);
+  return seq_num;
+}
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
     const endpoint& dest, const pfcp_heartbeat_request& pfcp_ies,
     const task_id_t& task_id, const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d", pfcp_ies.get_msg_name(), msg.get_sequence_number());
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  return send_request_bytes(dest, h, pfcp_ies, 0, task_id, trxn_id);
 }
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
     const endpoint& dest, const pfcp_association_setup_request& pfcp_ies,
     const task_id_t& task_id, const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d", pfcp_ies.get_msg_name(), msg.get_sequence_number());
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  return send_request_bytes(dest, h, pfcp_ies, 0, task_id, trxn_id);
 }
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
     const endpoint& dest, const pfcp_association_release_request& pfcp_ies,
     const task_id_t& task_id, const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d", pfcp_ies.get_msg_name(), msg.get_sequence_number());
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  return send_request_bytes(dest, h, pfcp_ies, 0, task_id, trxn_id);
 }
 ////------------------------------------------------------------------------------
 // uint32_t pfcp_l4_stack::send_request(const endpoint& dest, const uint64_t
@@ -424,106 +438,26 @@ uint32_t pfcp_l4_stack::send_request(
     const endpoint& dest, const uint64_t seid,
     const pfcp_node_report_request& pfcp_ies, const task_id_t& task_id,
     const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d", pfcp_ies.get_msg_name(), msg.get_sequence_number());
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  return send_request_bytes(dest, h, pfcp_ies, 0, task_id, trxn_id);
 }
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
-    const endpoint& dest, const uint64_t seid,
+    const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
     const pfcp_session_establishment_request& pfcp_ies,
     const task_id_t& task_id, const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_seid(seid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-      msg.get_sequence_number(), seid);
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  return send_request_bytes(dest, h, pfcp_ies, l_seid, task_id, trxn_id);
 }
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
-    const endpoint& dest, const uint64_t seid,
-    const pfcp_session_modification_request& pfcp_ies, const task_id_t& task_id,
-    const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_seid(seid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-      msg.get_sequence_number(), seid);
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+    const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
+    const pfcp_session_modification_request& pfcp_ies,
+    const task_id_t& task_id, const uint64_t trxn_id) {
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  return send_request_bytes(dest, h, pfcp_ies, l_seid, task_id, trxn_id);
 }
 ////------------------------------------------------------------------------------
 // uint32_t pfcp_l4_stack::send_request(const endpoint& dest, const uint64_t
@@ -557,389 +491,188 @@ uint32_t pfcp_l4_stack::send_request(
 //}
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
-    const endpoint& dest, const uint64_t seid,
+    const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
     const pfcp_session_deletion_request& pfcp_ies, const task_id_t& task_id,
     const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_seid(seid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-      msg.get_sequence_number(), seid);
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  return send_request_bytes(dest, h, pfcp_ies, l_seid, task_id, trxn_id);
 }
 //------------------------------------------------------------------------------
 uint32_t pfcp_l4_stack::send_request(
-    const endpoint& dest, const uint64_t seid,
+    const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
     const pfcp_session_report_request& pfcp_ies, const task_id_t& task_id,
     const uint64_t trxn_id) {
-  std::ostringstream oss(std::ostringstream::binary);
-  pfcp_msg msg(pfcp_ies);
-  msg.set_seid(seid);
-  msg.set_sequence_number(get_next_seq_num());
-  msg.dump_to(oss);
-  // std::cout << string_to_hex(oss.str()) << std::endl;
-  // std::cout << std::hex << "msg length 0x" << msg.get_message_length() <<
-  // "msg seqnum 0x" << msg.get_sequence_number() << std::endl;
-  std::string bstream = oss.str();
-
-  Logger::pfcp().trace(
-      "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-      msg.get_sequence_number(), seid);
-  pfcp_procedure proc   = {};
-  proc.initial_msg_type = msg.get_message_type();
-  proc.trxn_id          = trxn_id;
-  proc.retry_msg        = std::make_shared<pfcp_msg>(msg);
-  proc.remote_endpoint  = dest;
-  start_msg_retry_timer(proc, t1_ms, task_id, msg.get_sequence_number());
-  start_proc_cleanup_timer(
-      proc, PFCP_PROC_TIME_OUT_MS(t1_ms, n1), task_id,
-      msg.get_sequence_number());
-  pending_procedures.insert(
-      std::pair<uint32_t, pfcp_procedure>(msg.get_sequence_number(), proc));
-  trxn_id2seq_num.insert(
-      std::pair<uint64_t, uint32_t>(proc.trxn_id, msg.get_sequence_number()));
-
-  udp_s_allocated.async_send_to(
-      reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-  return msg.get_sequence_number();
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  return send_request_bytes(dest, h, pfcp_ies, l_seid, task_id, trxn_id);
 }
 //------------------------------------------------------------------------------
-void pfcp_l4_stack::send_response(
-    const endpoint& dest, const pfcp_heartbeat_response& pfcp_ies,
+template <class M>
+void pfcp_l4_stack::send_response_bytes(
+    const endpoint& dest, pfcp_msg_header& h, const M& pfcp_ies,
     const uint64_t trxn_id, const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
+  std::unique_lock lock(m_transactions);
+  uint32_t seq_num     = 0;
+  pfcp_procedure* proc = nullptr;
+  if (transactions.find_tx_id(trxn_id, seq_num)) {
+    proc = transactions.find(seq_num);
+  }
+  if (not proc) {
+    Logger::pfcp().error(
+        "Sending %s, trxn_id %ld proc not found, discarded!",
+        pfcp_ies.get_msg_name(), trxn_id);
+    return;
+  }
+  bool cached = false;
+  if (proc->received_request) {
+    h.set_sequence_number(proc->remote_seq_num);
+    response_cache_bytes -= proc->retry_bytes.size();
+    proc->retry_bytes.clear();
+    cached = (response_cache_bytes < PFCP_RESPONSE_CACHE_MAX_BYTES);
+  } else {
+    h.set_sequence_number(seq_num);
+  }
+  std::vector<uint8_t>& bytes = cached ? proc->retry_bytes : response_bytes();
+  pfcp_encoder::encode(pfcp_ies, h, bytes);
+  if (cached) {
+    response_cache_bytes += bytes.size();
+  }
+  if (h.has_seid()) {
+    Logger::pfcp().trace(
+        "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
+        h.get_sequence_number(), h.get_seid());
+  } else {
     Logger::pfcp().trace(
         "Sending %s, seq %d", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number());
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
+        h.get_sequence_number());
+  }
+  udp_s_registered.async_send_to(
+      reinterpret_cast<const char*>(bytes.data()), bytes.size(), dest);
+
+  if (proc->received_request) {
+    // answered, from now on only kept for duplicated requests: until the
+    // cleanup timer a duplicate gets the cached response, or is dropped if
+    // the response could not be cached, it is never handled as a new request
+    transactions.retire(seq_num);
     if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        free_trxn_id(trxn_id);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
+      // the response stays for duplicated requests until the cleanup timer
+      transactions.unbind_tx_id(trxn_id);
+      free_trxn_id(trxn_id);
+      proc->trxn_id = 0;
     }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
+  } else if (a == DELETE_TX) {
+    close_procedure(seq_num);
   }
 }
 //------------------------------------------------------------------------------
+void pfcp_l4_stack::send_response(
+    const endpoint& dest, const pfcp_heartbeat_response& pfcp_ies,
+    const uint64_t trxn_id, const pfcp_transaction_action& a) {
+  pfcp_msg_header h;
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
+}
+//------------------------------------------------------------------------------
 void pfcp_l4_stack::send_response(
     const endpoint& dest, const pfcp_association_setup_response& pfcp_ies,
     const uint64_t trxn_id, const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::pfcp().trace(
-        "Sending %s, seq %d", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number());
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
-    if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
-    }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
-  }
+  pfcp_msg_header h;
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
 }
-
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::send_response(
     const endpoint& dest, const pfcp_association_release_response& pfcp_ies,
     const uint64_t trxn_id, const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::pfcp().trace(
-        "Sending %s, seq %d", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number());
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
-    if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
-    }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
-  }
+  pfcp_msg_header h;
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
 }
-
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::send_response(
     const endpoint& dest, const uint64_t seid,
     const pfcp_session_establishment_response& pfcp_ies, const uint64_t trxn_id,
     const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_seid(seid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::pfcp().trace(
-        "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number(), seid);
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
-    if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
-    }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
-  }
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
 }
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::send_response(
     const endpoint& dest, const uint64_t seid,
     const pfcp_session_modification_response& pfcp_ies, const uint64_t trxn_id,
     const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_seid(seid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::pfcp().trace(
-        "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number(), seid);
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
-    if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
-    }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
-  }
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
 }
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::send_response(
     const endpoint& dest, const uint64_t seid,
     const pfcp_session_deletion_response& pfcp_ies, const uint64_t trxn_id,
     const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_seid(seid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::pfcp().trace(
-        "Sending %s, seq %d seid " SEID_FMT " ", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number(), seid);
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
-    if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
-    }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
-  }
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
 }
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::send_response(
     const endpoint& dest, const uint64_t seid,
     const pfcp_session_report_response& pfcp_ies, const uint64_t trxn_id,
     const pfcp_transaction_action& a) {
-  std::map<uint64_t, uint32_t>::iterator it;
-  it = trxn_id2seq_num.find(trxn_id);
-  if (it != trxn_id2seq_num.end()) {
-    std::ostringstream oss(std::ostringstream::binary);
-    pfcp_msg msg(pfcp_ies);
-    msg.set_seid(seid);
-    msg.set_sequence_number(it->second);
-    msg.dump_to(oss);
-    std::string bstream = oss.str();
-    Logger::pfcp().trace(
-        "Sending %s, seq %d seid " SEID_FMT " to %s", pfcp_ies.get_msg_name(),
-        msg.get_sequence_number(), seid, dest.toString().c_str());
-    udp_s_registered.async_send_to(
-        reinterpret_cast<const char*>(bstream.c_str()), bstream.length(), dest);
-
-    // Not recommended in general to delete procedure as soon as sending resp.
-    if (a == DELETE_TX) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      if (it_proc != pending_procedures.end()) {
-        stop_proc_cleanup_timer(it_proc->second);
-        pending_procedures.erase(it_proc);
-      }
-      trxn_id2seq_num.erase(it);
-    }
-  } else {
-    Logger::pfcp().error(
-        "Sending %s, trxn_id %ld proc not found, discarded!",
-        pfcp_ies.get_msg_name(), trxn_id);
-  }
+  pfcp_msg_header h;
+  h.set_seid(seid);
+  send_response_bytes(dest, h, pfcp_ies, trxn_id, a);
 }
-
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::notify_ul_error(
-    const endpoint& remote_endpoint, const uint8_t message_type,
-    const uint32_t message_sequence_number, const uint64_t trxn_id,
-    const ::cause_value_e cause) {
+    const endpoint& remote_endpoint, const uint64_t l_seid,
+    const uint8_t message_type, const uint32_t message_sequence_number,
+    const uint64_t trxn_id, const ::cause_value_e cause) {
   Logger::pfcp().trace(
       "notify_ul_error proc %" PRId64 " cause %d", trxn_id, cause);
 }
 //------------------------------------------------------------------------------
 void pfcp_l4_stack::time_out_event(
     const uint32_t timer_id, const task_id_t& task_id, bool& handled) {
-  handled = false;
-  std::map<timer_id_t, uint32_t>::iterator it =
-      msg_out_retry_timers.find(timer_id);
-  if (it != msg_out_retry_timers.end()) {
-    std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-        pending_procedures.find(it->second);
-    msg_out_retry_timers.erase(it);
-    handled = true;
-    if (it_proc != pending_procedures.end()) {
-      if (it_proc->second.retry_count < n1) {
-        it_proc->second.retry_count++;
-        start_msg_retry_timer(
-            it_proc->second, t1_ms, task_id,
-            it_proc->second.retry_msg->get_sequence_number());
-        // send again message
-        Logger::pfcp().trace(
-            "Retry %d Sending msg type %d, seq %d", it_proc->second.retry_count,
-            it_proc->second.retry_msg->get_message_type(),
-            it_proc->second.retry_msg->get_sequence_number());
-        std::ostringstream oss(std::ostringstream::binary);
-        it_proc->second.retry_msg->dump_to(oss);
-        std::string bstream = oss.str();
-        udp_s_registered.async_send_to(
-            reinterpret_cast<const char*>(bstream.c_str()), bstream.length(),
-            it_proc->second.remote_endpoint);
-      } else {
-        // abort procedure
-        notify_ul_error(
-            it_proc->second.remote_endpoint,
-            it_proc->second.retry_msg->get_message_type(),
-            it_proc->second.retry_msg->get_sequence_number(),
-            it_proc->second.trxn_id,
-            ::cause_value_e::REMOTE_PEER_NOT_RESPONDING);
-      }
+  std::unique_lock lock(m_transactions);
+  handled          = false;
+  uint32_t seq_num = 0;
+  if (not transactions.find_timer(timer_id, seq_num)) {
+    return;
+  }
+  pfcp_procedure* proc = transactions.find(seq_num);
+  if (not proc) {
+    return;
+  }
+  handled = true;
+  transactions.unbind_timer(timer_id);
+  if (timer_id == proc->retry_timer_id) {
+    proc->retry_timer_id = ITTI_INVALID_TIMER_ID;
+    if (proc->retry_count < n1) {
+      proc->retry_count++;
+      start_msg_retry_timer(*proc, t1_ms, task_id, seq_num);
+      // send again the bytes encoded for the first transmission
+      Logger::pfcp().trace(
+          "Retry %d Sending msg type %d, seq %d", proc->retry_count,
+          proc->initial_msg_type, seq_num);
+      const std::vector<uint8_t>& bytes = proc->retry_bytes;
+      udp_s_registered.async_send_to(
+          reinterpret_cast<const char*>(bytes.data()), bytes.size(),
+          proc->remote_endpoint);
+    } else {
+      // abort procedure
+      notify_ul_error(
+          proc->remote_endpoint, proc->local_seid, proc->initial_msg_type,
+          seq_num, proc->trxn_id, ::cause_value_e::REMOTE_PEER_NOT_RESPONDING);
+      Logger::pfcp().trace(
+          "Delete proc %" PRId64 " Retry %d seq %d timer id %u", proc->trxn_id,
+          proc->retry_count, seq_num, timer_id);
+      close_procedure(seq_num);
     }
   } else {
-    it = proc_cleanup_timers.find(timer_id);
-    if (it != proc_cleanup_timers.end()) {
-      std::map<uint32_t, pfcp_procedure>::iterator it_proc =
-          pending_procedures.find(it->second);
-      trxn_id2seq_num.erase(it_proc->second.trxn_id);
-      free_trxn_id(it_proc->second.trxn_id);
-      proc_cleanup_timers.erase(it);
-      handled = true;
-      if (it_proc != pending_procedures.end()) {
-        it_proc->second.proc_cleanup_timer_id = 0;
-        Logger::pfcp().trace(
-            "Delete proc %" PRId64 " Retry %d seq %d timer id %u",
-            it_proc->second.trxn_id, it_proc->second.retry_count,
-            it_proc->first, timer_id);
-        pending_procedures.erase(it_proc);
-      }
-    }
+    proc->proc_cleanup_timer_id = 0;
+    Logger::pfcp().trace(
+        "Delete proc %" PRId64 " Retry %d seq %d timer id %u", proc->trxn_id,
+        proc->retry_count, seq_num, timer_id);
+    close_procedure(seq_num);
   }
 }
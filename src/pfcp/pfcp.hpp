@@ -31,16 +31,19 @@
 #include "3gpp_29.244.hpp"
 #include "3gpp_29.274.h"
 #include "itti.hpp"
+#include "transaction_table.hpp"
 #include "udp.hpp"
 #include "uint_generator.hpp"
 
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 #include "msg_pfcp.hpp"
+#include "pfcp_encoder.hpp"
 
 namespace pfcp {
 
@@ -48,40 +51,56 @@ static const uint16_t default_port = 8805;
 
 class pfcp_procedure {
  public:
-  std::shared_ptr<pfcp_msg> retry_msg;
+  std::vector<uint8_t> retry_bytes;  // message as sent, or response to replay
   endpoint remote_endpoint;
+  uint32_t remote_seq_num;  // of the request received from remote_endpoint
   timer_id_t retry_timer_id;
   timer_id_t proc_cleanup_timer_id;
   uint64_t trxn_id;
+  uint64_t local_seid;  // for peer not responding
   uint8_t initial_msg_type;    // sent or received
   uint8_t triggered_msg_type;  // sent or received
   uint8_t retry_count;
+  bool received_request;  // request sent by the peer
 
   pfcp_procedure()
-      : retry_msg(),
+      : retry_bytes(),
         remote_endpoint(),
+        remote_seq_num(0),
         retry_timer_id(0),
         proc_cleanup_timer_id(0),
         trxn_id(0),
+        local_seid(0),
         initial_msg_type(0),
         triggered_msg_type(0),
-        retry_count(0) {}
+        retry_count(0),
+        received_request(false) {}
 
   pfcp_procedure(const pfcp_procedure& p)
-      : retry_msg(p.retry_msg),
+      : retry_bytes(p.retry_bytes),
         remote_endpoint(p.remote_endpoint),
+        remote_seq_num(p.remote_seq_num),
         retry_timer_id(p.retry_timer_id),
         proc_cleanup_timer_id(p.proc_cleanup_timer_id),
         trxn_id(p.trxn_id),
+        local_seid(p.local_seid),
         initial_msg_type(p.initial_msg_type),
         triggered_msg_type(p.triggered_msg_type),
-        retry_count(p.retry_count) {}
+        retry_count(p.retry_count),
+        received_request(p.received_request) {}
+  pfcp_procedure(pfcp_procedure&& p) = default;
+  pfcp_procedure& operator=(const pfcp_procedure& p) = default;
+  pfcp_procedure& operator=(pfcp_procedure&& p) = default;
 };
 
 enum pfcp_transaction_action { DELETE_TX = 0, CONTINUE_TX };
 
 class pfcp_l4_stack : public UdpApplication {
 #define PFCP_PROC_TIME_OUT_MS(T, N) ((T) * (N + 1 + 1))
+// Beyond this amount of responses kept for duplicated requests, responses are
+// no longer kept: a duplicated request is still recognized until the cleanup
+// timer of its procedure, and silently discarded
+#define PFCP_RESPONSE_CACHE_MAX_BYTES (4 * 1024 * 1024)
 
  protected:
   uint32_t t1_ms;
@@ -90,19 +109,21 @@ class pfcp_l4_stack : public UdpApplication {
   udp_server udp_s_registered;
   udp_server udp_s_allocated;
 
-  // seems no need for std::atomic_uint32_t
-  uint32_t seq_num;
   uint32_t restart_counter;
-  // key is transaction id
-  std::map<uint64_t, uint32_t> trxn_id2seq_num;
-  std::map<timer_id_t, uint32_t> proc_cleanup_timers;
-  std::map<timer_id_t, uint32_t> msg_out_retry_timers;
-  // key is message sequence number,
-  std::map<uint32_t, pfcp_procedure> pending_procedures;
 
-  static const char* msg_type2cstr[256];
+  // Serializes the transaction tables below, they are shared by the UDP
+  // reader threads, the ITTI task of the stack and the PGW-C workers
+  std::mutex m_transactions;
+  // procedures by (24 bits) sequence number, also found by transaction id,
+  // timer id and (peer, sequence number of the peer) of a received request.
+  // A request received is given a local sequence number so that peers never
+  // collide.
+  util::transaction_table<pfcp_procedure, request_key, request_key::hash>
+      transactions;
+  // bytes of the responses kept in received procedures
+  std::size_t response_cache_bytes;
 
-  uint32_t get_next_seq_num();
+  static const char* msg_type2cstr[256];
 
   static uint64_t generate_trxn_id() {
     return util::uint_uid_generator<uint64_t>::get_instance().get_uid();
@@ -123,17 +144,49 @@ class pfcp_l4_stack : public UdpApplication {
   void stop_msg_retry_timer(pfcp_procedure& p);
   void stop_msg_retry_timer(timer_id_t& t);
   void stop_proc_cleanup_timer(pfcp_procedure& p);
+  /** \brief Open a procedure, once the table is full the oldest procedure
+   *  kept only for duplicated requests is reclaimed
+   *  @returns nullptr if every procedure is in progress
+   **/
+  pfcp_procedure* open_procedure(uint32_t& seq_num);
+  /** \brief Stop the timers of a procedure, release its ids and close it
+   **/
+  void close_procedure(const uint32_t seq_num);
+  /** \brief Open the procedure of a request, encode and send it
+   *  @returns the sequence number of the request, 0 if refused
+   **/
+  template <class M>
+  uint32_t send_request_bytes(
+      const endpoint& dest, pfcp_msg_header& h, const M& pfcp_ies,
+      const uint64_t l_seid, const task_id_t& task_id, const uint64_t trxn_id);
+  /** \brief Send the response to a request received, the bytes are kept by
+   *  the procedure to answer a duplicate of the request
+   **/
+  template <class M>
+  void send_response_bytes(
+      const endpoint& dest, pfcp_msg_header& h, const M& pfcp_ies,
+      const uint64_t trxn_id, const pfcp_transaction_action& a);
+  /** \brief Drop the response kept for duplicates of a received request, the
+   *  request itself is unbound from transactions when the procedure closes
+   **/
+  void release_response_bytes(pfcp_procedure& p);
   virtual void notify_ul_error(
-      const endpoint& remote_endpoint, const uint8_t message_type,
-      const uint32_t message_sequence_number, const uint64_t trxn_id,
-      const ::cause_value_e cause);
+      const endpoint& remote_endpoint, const uint64_t l_seid,
+      const uint8_t message_type, const uint32_t message_sequence_number,
+      const uint64_t trxn_id, const ::cause_value_e cause);
 
  public:
   static const uint8_t version = 2;
   pfcp_l4_stack(
       const uint32_t t1_milli_seconds, const uint32_t n1_retransmit,
       const std::string& ip_address, const unsigned short port_num,
-      const util::thread_sched_params& sched_params);
+      const util::thread_sched_params& sched_params,
+      const uint32_t num_workers = 1, const uint32_t udp_batch_size = 1,
+      const bool io_uring = false,
+      const uint32_t max_concurrent_procedures = 256);
+  /** \brief Stop the UDP endpoints, once the owner task is terminating
+   **/
+  void stop();
   virtual void handle_receive(
       char* recv_buffer, const std::size_t bytes_transferred,
       endpoint& remote_endpoint);
@@ -164,19 +217,19 @@ class pfcp_l4_stack : public UdpApplication {
 
   // session related messages
   virtual uint32_t send_request(
-      const endpoint& dest, const uint64_t seid,
+      const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
       const pfcp_session_establishment_request& pfcp_ies,
       const task_id_t& task_id, const uint64_t trxn_id);
   virtual uint32_t send_request(
-      const endpoint& dest, const uint64_t seid,
+      const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
       const pfcp_session_modification_request& pfcp_ies,
       const task_id_t& task_id, const uint64_t trxn_id);
   virtual uint32_t send_request(
-      const endpoint& dest, const uint64_t seid,
+      const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
       const pfcp_session_deletion_request& pfcp_ies, const task_id_t& task_id,
       const uint64_t trxn_id);
   virtual uint32_t send_request(
-      const endpoint& dest, const uint64_t seid,
+      const endpoint& dest, const uint64_t seid, const uint64_t l_seid,
       const pfcp_session_report_request& pfcp_ies, const task_id_t& task_id,
       const uint64_t trxn_id);
 
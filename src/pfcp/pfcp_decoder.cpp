@@ -0,0 +1,576 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file pfcp_decoder.cpp
+  \brief Single pass PFCP decoder
+*/
+#include "pfcp_decoder.hpp"
+
+#include <algorithm>
+
+namespace pfcp {
+namespace {
+
+//------------------------------------------------------------------------------
+// IE values, one overload per core type
+void decode_value(pfcp_view& v, cause_t& c) {
+  c.cause_value = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, offending_ie_t& o) {
+  o.offending_ie = v.be16();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, recovery_time_stamp_t& r) {
+  r.recovery_time_stamp = v.be32();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, sequence_number_t& s) {
+  s.sequence_number = v.be32();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, metric_t& m) {
+  m.metric = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, timer_t& t) {
+  const uint8_t b = v.u8();
+  t.timer_unit    = b >> 5;
+  t.timer_value   = b & 0x1F;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, oci_flags_t& o) {
+  o.aoci = v.u8() & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, pdr_id_t& p) {
+  p.rule_id = v.be16();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, traffic_endpoint_id_t& t) {
+  t.traffic_endpoint_id = v.u8();
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, report_type_t& r) {
+  const uint8_t b = v.u8();
+  r.dldr          = b & 0x01;
+  r.usar          = (b >> 1) & 0x01;
+  r.erir          = (b >> 2) & 0x01;
+  r.upir          = (b >> 3) & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, cp_function_features_t& f) {
+  const uint8_t b = v.u8();
+  f.load          = b & 0x01;
+  f.ovrl          = (b >> 1) & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, up_function_features_s& f) {
+  // 2 octets up to Rel-15, later releases append octets: take what is there
+  uint8_t o[6] = {};
+  v.need(2);
+  v.copy(o, std::min(v.size(), sizeof(o)));
+  f.bucp     = o[0] & 0x01;
+  f.ddnd     = (o[0] >> 1) & 0x01;
+  f.dlbd     = (o[0] >> 2) & 0x01;
+  f.trst     = (o[0] >> 3) & 0x01;
+  f.ftup     = (o[0] >> 4) & 0x01;
+  f.pfdm     = (o[0] >> 5) & 0x01;
+  f.heeu     = (o[0] >> 6) & 0x01;
+  f.treu     = (o[0] >> 7) & 0x01;
+  f.empu     = o[1] & 0x01;
+  f.pdiu     = (o[1] >> 1) & 0x01;
+  f.udbc     = (o[1] >> 2) & 0x01;
+  f.quoac    = (o[1] >> 3) & 0x01;
+  f.trace    = (o[1] >> 4) & 0x01;
+  f.frrt     = (o[1] >> 5) & 0x01;
+  f.pfde     = (o[1] >> 6) & 0x01;
+  f.epfar    = (o[1] >> 7) & 0x01;
+  f.dpdra    = o[2] & 0x01;
+  f.adpdp    = (o[2] >> 1) & 0x01;
+  f.ueip     = (o[2] >> 2) & 0x01;
+  f.sset     = (o[2] >> 3) & 0x01;
+  f.mnop     = (o[2] >> 4) & 0x01;
+  f.mte      = (o[2] >> 5) & 0x01;
+  f.bundl    = (o[2] >> 6) & 0x01;
+  f.gcom     = (o[2] >> 7) & 0x01;
+  f.mpas     = o[3] & 0x01;
+  f.rttl     = (o[3] >> 1) & 0x01;
+  f.vtime    = (o[3] >> 2) & 0x01;
+  f.norp     = (o[3] >> 3) & 0x01;
+  f.iptv     = (o[3] >> 4) & 0x01;
+  f.ip6pl    = (o[3] >> 5) & 0x01;
+  f.tscu     = (o[3] >> 6) & 0x01;
+  f.mptcp    = (o[3] >> 7) & 0x01;
+  f.atsss_ll = o[4] & 0x01;
+  f.qfqm     = (o[4] >> 1) & 0x01;
+  f.gpqm     = (o[4] >> 2) & 0x01;
+  f.mt_edt   = (o[4] >> 3) & 0x01;
+  f.ciot     = (o[4] >> 4) & 0x01;
+  f.ethar    = (o[4] >> 5) & 0x01;
+  f.ddds     = (o[4] >> 6) & 0x01;
+  f.rds      = (o[4] >> 7) & 0x01;
+  f.rttwp    = o[5] & 0x01;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, node_id_t& n) {
+  n.node_id_type = v.u8() & 0x0F;
+  switch (n.node_id_type) {
+    case NODE_ID_TYPE_IPV4_ADDRESS:
+      v.copy(&n.u1.ipv4_address, sizeof(n.u1.ipv4_address));
+      break;
+    case NODE_ID_TYPE_IPV6_ADDRESS:
+      v.copy(&n.u1.ipv6_address, sizeof(n.u1.ipv6_address));
+      break;
+    case NODE_ID_TYPE_FQDN:
+      // length prefixed labels to dotted name, bytes that cannot be a label
+      // length are kept as is (same leniency as pfcp_ie::dotted_to_string)
+      n.fqdn.clear();
+      while (not v.empty()) {
+        const uint8_t l = v.u8();
+        if (l < 64) {
+          v.need(l);
+          if (not n.fqdn.empty()) n.fqdn.push_back('.');
+          n.fqdn.append(reinterpret_cast<const char*>(v.data()), l);
+          v.skip(l);
+        } else {
+          n.fqdn.push_back(l);
+        }
+      }
+      break;
+    default:
+      throw pfcp_ie_value_exception(v.type(), "node_id_type");
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, fseid_t& f) {
+  const uint8_t b = v.u8();
+  f.v6            = b & 0x01;
+  f.v4            = (b >> 1) & 0x01;
+  f.seid          = v.be64();
+  if (f.v4) v.copy(&f.ipv4_address, sizeof(f.ipv4_address));
+  if (f.v6) v.copy(&f.ipv6_address, sizeof(f.ipv6_address));
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, fteid_t& f) {
+  const uint8_t b = v.u8();
+  f.v4            = b & 0x01;
+  f.v6            = (b >> 1) & 0x01;
+  f.ch            = (b >> 2) & 0x01;
+  f.chid          = (b >> 3) & 0x01;
+  if (f.ch) {
+    if (f.chid) f.choose_id = v.u8();
+  } else {
+    f.teid = v.be32();
+    if (f.v4) v.copy(&f.ipv4_address, sizeof(f.ipv4_address));
+    if (f.v6) v.copy(&f.ipv6_address, sizeof(f.ipv6_address));
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, failed_rule_id_t& f) {
+  f.rule_id_type = v.u8() & 0x1F;
+  switch (f.rule_id_type) {
+    case FAILED_RULE_ID_TYPE_PDR:
+      f.rule_id_value = v.be16();
+      break;
+    case FAILED_RULE_ID_TYPE_FAR:
+    case FAILED_RULE_ID_TYPE_QER:
+    case FAILED_RULE_ID_TYPE_URR:
+      f.rule_id_value = v.be32();
+      break;
+    case FAILED_RULE_ID_TYPE_BAR:
+      f.rule_id_value = v.u8();
+      break;
+    default:
+      throw pfcp_ie_value_exception(v.type(), "rule_id_type");
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, user_plane_ip_resource_information_t& u) {
+  const uint8_t b = v.u8();
+  u.v4            = b & 0x01;
+  u.v6            = (b >> 1) & 0x01;
+  u.teidri        = (b >> 2) & 0x07;
+  u.assoni        = (b >> 5) & 0x01;
+  u.assosi        = (b >> 6) & 0x01;
+  if (u.teidri) u.teid_range = v.u8();
+  if (u.v4) v.copy(&u.ipv4_address, sizeof(u.ipv4_address));
+  if (u.v6) v.copy(&u.ipv6_address, sizeof(u.ipv6_address));
+  if (u.assoni) {
+    // the network instance runs up to the source interface octet, the core
+    // type can only hold a 2 octets value
+    v.need(u.assosi);
+    const size_t ni_len = v.size() - u.assosi;
+    if (ni_len == sizeof(u.network_instance)) {
+      u.network_instance = v.be16();
+    } else {
+      v.skip(ni_len);
+    }
+  }
+  if (u.assosi) u.source_interface = v.u8() & 0x0F;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, downlink_data_service_information_t& d) {
+  const uint8_t b = v.u8();
+  d.ppi           = b & 0x01;
+  d.qfii          = (b >> 1) & 0x01;
+  if (d.ppi) d.Paging_Policy_Indication = v.u8() & 0x3F;
+  if (d.qfii) d.qfi = v.u8() & 0x3F;
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, additional_usage_reports_information_t& a) {
+  const uint16_t w                           = v.be16();
+  a.auri                                     = w >> 15;
+  a.number_of_additional_usage_reports_value = w & 0x7FFF;
+}
+
+// grouped IEs, below
+void decode_value(pfcp_view& v, created_pdr& c);
+void decode_value(pfcp_view& v, created_traffic_endpoint& c);
+void decode_value(pfcp_view& v, load_control_information& l);
+void decode_value(pfcp_view& v, overload_control_information& o);
+void decode_value(pfcp_view& v, downlink_data_report& d);
+void decode_value(pfcp_view& v, error_indication_report& e);
+
+//------------------------------------------------------------------------------
+template <class T>
+inline void decode_ie(pfcp_view& ie, std::pair<bool, T>& p) {
+  p.second = {};
+  decode_value(ie, p.second);
+  p.first = true;
+}
+//------------------------------------------------------------------------------
+template <class T>
+inline void decode_ie(pfcp_view& ie, std::vector<T>& l) {
+  l.emplace_back();
+  decode_value(ie, l.back());
+}
+
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, created_pdr& c) {
+  pfcp_view ie;
+  while (v.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_PACKET_DETECTION_RULE_ID:
+        decode_ie(ie, c.pdr_id);
+        break;
+      case PFCP_IE_F_TEID:
+        decode_ie(ie, c.local_fteid);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, created_traffic_endpoint& c) {
+  pfcp_view ie;
+  while (v.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_TRAFFIC_ENDPOINT_ID:
+        decode_ie(ie, c.traffic_endpoint_id);
+        break;
+      case PFCP_IE_F_TEID:
+        decode_ie(ie, c.local_fteid);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, load_control_information& l) {
+  pfcp_view ie;
+  while (v.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_SEQUENCE_NUMBER:
+        decode_ie(ie, l.load_control_sequence_number);
+        break;
+      case PFCP_IE_METRIC:
+        decode_ie(ie, l.load_metric);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, overload_control_information& o) {
+  pfcp_view ie;
+  while (v.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_SEQUENCE_NUMBER:
+        decode_ie(ie, o.overload_control_sequence_number);
+        break;
+      case PFCP_IE_METRIC:
+        decode_ie(ie, o.overload_reduction_metric);
+        break;
+      case PFCP_IE_TIMER:
+        decode_ie(ie, o.period_of_validity);
+        break;
+      case PFCP_IE_OCI_FLAGS:
+        decode_ie(ie, o.overload_control_information_flags);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, downlink_data_report& d) {
+  pfcp_view ie;
+  while (v.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_PACKET_DETECTION_RULE_ID:
+        decode_ie(ie, d.pdr_id);
+        break;
+      case PFCP_IE_DOWNLINK_DATA_SERVICE_INFORMATION:
+        decode_ie(ie, d.downlink_data_service_information);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void decode_value(pfcp_view& v, error_indication_report& e) {
+  pfcp_view ie;
+  while (v.next_ie(ie)) {
+    if (ie.type() == PFCP_IE_F_TEID) decode_ie(ie, e.remote_fteid);
+  }
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+bool pfcp_view::next_ie(pfcp_view& ie) {
+  if (empty()) return false;
+  const uint16_t t = be16();
+  const uint16_t l = be16();
+  if (size() < l) {
+    throw pfcp_tlv_bad_length_exception(t, l, __FILE__, __LINE__);
+  }
+  // vendor specific IEs (type bit 8 of octet 1 set) keep their Enterprise ID
+  // in the value, no decoder matches them
+  ie = pfcp_view(p, l, t);
+  p += l;
+  return true;
+}
+//------------------------------------------------------------------------------
+pfcp_view pfcp_decoder::decode_header(
+    const uint8_t* buf, const size_t len, pfcp_msg_header& h) {
+  if (len < PFCP_MSG_HEADER_MIN_SIZE) {
+    throw pfcp_msg_bad_length_exception(0, 0, len, 0, __FILE__, __LINE__);
+  }
+  pfcp_view v(buf, len);
+  const uint8_t flags = v.u8();
+  h.set_message_type(v.u8());
+  // message length excludes the first 4 octets
+  const uint16_t length   = v.be16();
+  const uint16_t hdr_tail = (flags & 0x01) ? 12 : 4;
+  if ((length < hdr_tail) || (length > len - 4)) {
+    throw pfcp_msg_bad_length_exception(
+        h.get_message_type(), length, len - 4, hdr_tail, __FILE__, __LINE__);
+  }
+  if (flags & 0x01) h.set_seid(v.be64());
+  h.set_sequence_number(v.be24());
+  v.skip(1);  // message priority, spare
+  h.set_message_length(length);
+  return pfcp_view(v.data(), length - hdr_tail);
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(pfcp_view ies, pfcp_heartbeat_request& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    if (ie.type() == PFCP_IE_RECOVERY_TIME_STAMP)
+      decode_ie(ie, s.recovery_time_stamp);
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(pfcp_view ies, pfcp_heartbeat_response& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    if (ie.type() == PFCP_IE_RECOVERY_TIME_STAMP)
+      decode_ie(ie, s.recovery_time_stamp);
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(pfcp_view ies, pfcp_association_setup_request& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_NODE_ID:
+        decode_ie(ie, s.node_id);
+        break;
+      case PFCP_IE_RECOVERY_TIME_STAMP:
+        decode_ie(ie, s.recovery_time_stamp);
+        break;
+      case PFCP_IE_UP_FUNCTION_FEATURES:
+        decode_ie(ie, s.up_function_features);
+        break;
+      case PFCP_IE_CP_FUNCTION_FEATURES:
+        decode_ie(ie, s.cp_function_features);
+        break;
+      case PFCP_IE_USER_PLANE_IP_RESOURCE_INFORMATION:
+        decode_ie(ie, s.user_plane_ip_resource_information);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(pfcp_view ies, pfcp_association_setup_response& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_NODE_ID:
+        decode_ie(ie, s.node_id);
+        break;
+      case PFCP_IE_CAUSE:
+        decode_ie(ie, s.cause);
+        break;
+      case PFCP_IE_RECOVERY_TIME_STAMP:
+        decode_ie(ie, s.recovery_time_stamp);
+        break;
+      case PFCP_IE_UP_FUNCTION_FEATURES:
+        decode_ie(ie, s.up_function_features);
+        break;
+      case PFCP_IE_CP_FUNCTION_FEATURES:
+        decode_ie(ie, s.cp_function_features);
+        break;
+      case PFCP_IE_USER_PLANE_IP_RESOURCE_INFORMATION:
+        decode_ie(ie, s.user_plane_ip_resource_information);
+        break;
+      default:;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(
+    pfcp_view ies, pfcp_session_establishment_response& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_NODE_ID:
+        decode_ie(ie, s.node_id);
+        break;
+      case PFCP_IE_CAUSE:
+        decode_ie(ie, s.cause);
+        break;
+      case PFCP_IE_OFFENDING_IE:
+        decode_ie(ie, s.offending_ie);
+        break;
+      case PFCP_IE_F_SEID:
+        decode_ie(ie, s.up_fseid);
+        break;
+      case PFCP_IE_CREATED_PDR:
+        decode_ie(ie, s.created_pdrs);
+        break;
+      case PFCP_IE_LOAD_CONTROL_INFORMATION:
+        decode_ie(ie, s.load_control_information);
+        break;
+      case PFCP_IE_OVERLOAD_CONTROL_INFORMATION:
+        decode_ie(ie, s.overload_control_information);
+        break;
+      case PFCP_IE_FAILED_RULE_ID:
+        decode_ie(ie, s.failed_rule_id);
+        break;
+      case PFCP_IE_CREATED_TRAFFIC_ENDPOINT:
+        decode_ie(ie, s.created_traffic_endpoint);
+        break;
+      default:;  // FQ-CSIDs are not used by the PGW-C
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(
+    pfcp_view ies, pfcp_session_modification_response& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_CAUSE:
+        decode_ie(ie, s.cause);
+        break;
+      case PFCP_IE_OFFENDING_IE:
+        decode_ie(ie, s.offending_ie);
+        break;
+      case PFCP_IE_CREATED_PDR:
+        decode_ie(ie, s.created_pdrs);
+        break;
+      case PFCP_IE_LOAD_CONTROL_INFORMATION:
+        decode_ie(ie, s.load_control_information);
+        break;
+      case PFCP_IE_OVERLOAD_CONTROL_INFORMATION:
+        decode_ie(ie, s.overload_control_information);
+        break;
+      case PFCP_IE_FAILED_RULE_ID:
+        decode_ie(ie, s.failed_rule_id);
+        break;
+      case PFCP_IE_ADDITIONAL_USAGE_REPORTS_INFORMATION:
+        decode_ie(ie, s.additional_usage_reports_information);
+        break;
+      case PFCP_IE_CREATED_TRAFFIC_ENDPOINT:
+        decode_ie(ie, s.created_traffic_endpoint);
+        break;
+      default:;  // usage reports are not used by the PGW-C
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(pfcp_view ies, pfcp_session_deletion_response& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_CAUSE:
+        decode_ie(ie, s.cause);
+        break;
+      case PFCP_IE_OFFENDING_IE:
+        decode_ie(ie, s.offending_ie);
+        break;
+      default:;  // load/overload control, usage reports
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void pfcp_decoder::decode(pfcp_view ies, pfcp_session_report_request& s) {
+  pfcp_view ie;
+  while (ies.next_ie(ie)) {
+    switch (ie.type()) {
+      case PFCP_IE_REPORT_TYPE:
+        decode_ie(ie, s.report_type);
+        break;
+      case PFCP_IE_DOWNLINK_DATA_REPORT:
+        decode_ie(ie, s.downlink_data_report);
+        break;
+      case PFCP_IE_ERROR_INDICATION_REPORT:
+        decode_ie(ie, s.error_indication_report);
+        break;
+      case PFCP_IE_LOAD_CONTROL_INFORMATION:
+        decode_ie(ie, s.load_control_information);
+        break;
+      case PFCP_IE_OVERLOAD_CONTROL_INFORMATION:
+        decode_ie(ie, s.overload_control_information);
+        break;
+      case PFCP_IE_ADDITIONAL_USAGE_REPORTS_INFORMATION:
+        decode_ie(ie, s.additional_usage_reports_information);
+        break;
+      default:;  // usage reports are not used by the PGW-C
+    }
+  }
+}
+
+}  // namespace pfcp
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file pfcp_decoder.hpp
+  \brief Single pass PFCP decoder, reads the received datagram in place and
+  fills the core containers of msg_pfcp.hpp
+*/
+#ifndef FILE_PFCP_DECODER_HPP_SEEN
+#define FILE_PFCP_DECODER_HPP_SEEN
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "3gpp_29.244.h"
+#include "3gpp_29.244.hpp"
+#include "msg_pfcp.hpp"
+
+namespace pfcp {
+
+//------------------------------------------------------------------------------
+// Bounds checked read cursor over a PFCP message or over the value part of an
+// IE, nothing is copied. Reading past the end throws
+// pfcp_tlv_bad_length_exception for the IE the view was opened on.
+class pfcp_view {
+ public:
+  pfcp_view(const uint8_t* buf, const size_t len, const uint16_t type = 0)
+      : p(buf), end(buf + len), ie_type(type) {}
+  pfcp_view() : p(nullptr), end(nullptr), ie_type(0) {}
+
+  size_t size() const { return end - p; }
+  bool empty() const { return p == end; }
+  uint16_t type() const { return ie_type; }
+  const uint8_t* data() const { return p; }
+
+  void need(const size_t n) const {
+    if (size() < n) {
+      throw pfcp_tlv_bad_length_exception(ie_type, size(), __FILE__, __LINE__);
+    }
+  }
+  void skip(const size_t n) {
+    need(n);
+    p += n;
+  }
+  uint8_t u8() {
+    need(1);
+    return *p++;
+  }
+  uint16_t be16() {
+    need(2);
+    uint16_t v = ((uint16_t) p[0] << 8) | p[1];
+    p += 2;
+    return v;
+  }
+  uint32_t be24() {
+    need(3);
+    uint32_t v = ((uint32_t) p[0] << 16) | ((uint32_t) p[1] << 8) | p[2];
+    p += 3;
+    return v;
+  }
+  uint32_t be32() {
+    need(4);
+    uint32_t v = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) |
+                 ((uint32_t) p[2] << 8) | p[3];
+    p += 4;
+    return v;
+  }
+  uint64_t be64() {
+    uint64_t v = be32();
+    return (v << 32) | be32();
+  }
+  // copy raw bytes (addresses stay in network byte order)
+  void copy(void* dst, const size_t n) {
+    need(n);
+    memcpy(dst, p, n);
+    p += n;
+  }
+
+  /** \brief Cut the next IE off the view
+   *  @param[out] ie value part of the IE, typed with the IE type
+   *  @returns false when the view is exhausted
+   **/
+  bool next_ie(pfcp_view& ie);
+
+ private:
+  const uint8_t* p;
+  const uint8_t* end;
+  uint16_t ie_type;
+};
+
+//------------------------------------------------------------------------------
+// Decodes the messages the PGW-C receives on Sxb. IEs are written straight
+// into the std::pair/std::vector members of the containers. IEs unknown or
+// not expected in a message are skipped, as TS 29.244 asks of a receiver.
+class pfcp_decoder {
+ public:
+  /** \brief Decode the message header of the datagram, check the message
+   *  length against the datagram size
+   *  @returns the view over the IEs of the message
+   **/
+  static pfcp_view decode_header(
+      const uint8_t* buf, const size_t len, pfcp_msg_header& h);
+
+  static void decode(pfcp_view ies, pfcp_heartbeat_request& s);
+  static void decode(pfcp_view ies, pfcp_heartbeat_response& s);
+  static void decode(pfcp_view ies, pfcp_association_setup_request& s);
+  static void decode(pfcp_view ies, pfcp_association_setup_response& s);
+  static void decode(pfcp_view ies, pfcp_session_establishment_response& s);
+  static void decode(pfcp_view ies, pfcp_session_modification_response& s);
+  static void decode(pfcp_view ies, pfcp_session_deletion_response& s);
+  static void decode(pfcp_view ies, pfcp_session_report_request& s);
+};
+
+}  // namespace pfcp
+
+#endif /* FILE_PFCP_DECODER_HPP_SEEN */
@@ -0,0 +1,578 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file pfcp_encoder.cpp
+  \brief Direct to buffer PFCP encoder
+*/
+#include "pfcp_encoder.hpp"
+
+namespace pfcp {
+namespace {
+
+//------------------------------------------------------------------------------
+// IE values, one overload per core type
+void encode_value(pfcp_writer& w, const cause_t& c) {
+  w.u8(c.cause_value);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const offending_ie_t& o) {
+  w.be16(o.offending_ie);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const recovery_time_stamp_t& r) {
+  w.be32(r.recovery_time_stamp);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const source_interface_t& s) {
+  w.u8(s.interface_value);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const destination_interface_t& d) {
+  w.u8(d.interface_value);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const pdr_id_t& p) {
+  w.be16(p.rule_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const far_id_t& f) {
+  w.be32(f.far_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const urr_id_t& u) {
+  w.be32(u.urr_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const qer_id_t& q) {
+  w.be32(q.qer_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const bar_id_t& b) {
+  w.u8(b.bar_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const precedence_t& p) {
+  w.be32(p.precedence);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const qfi_t& q) {
+  w.u8(q.qfi & 0x3F);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const outer_header_removal_t& o) {
+  w.u8(o.outer_header_removal_description);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const user_plane_inactivity_timer_t& u) {
+  w.be32(u.user_plane_inactivity_timer);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const cp_function_features_t& c) {
+  w.u8(c.load | (c.ovrl << 1));
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const up_function_features_s& u) {
+  w.u8(
+      u.bucp | (u.ddnd << 1) | (u.dlbd << 2) | (u.trst << 3) | (u.ftup << 4) |
+      (u.pfdm << 5) | (u.heeu << 6) | (u.treu << 7));
+  w.u8(
+      u.empu | (u.pdiu << 1) | (u.udbc << 2) | (u.quoac << 3) |
+      (u.trace << 4) | (u.frrt << 5) | (u.pfde << 6) | (u.epfar << 7));
+  w.u8(
+      u.dpdra | (u.adpdp << 1) | (u.ueip << 2) | (u.sset << 3) |
+      (u.mnop << 4) | (u.mte << 5) | (u.bundl << 6) | (u.gcom << 7));
+  w.u8(
+      u.mpas | (u.rttl << 1) | (u.vtime << 2) | (u.norp << 3) |
+      (u.iptv << 4) | (u.ip6pl << 5) | (u.tscu << 6) | (u.mptcp << 7));
+  w.u8(
+      u.atsss_ll | (u.qfqm << 1) | (u.gpqm << 2) | (u.mt_edt << 3) |
+      (u.ciot << 4) | (u.ethar << 5) | (u.ddds << 6) | (u.rds << 7));
+  w.u8(u.rttwp);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const apply_action_t& a) {
+  w.u8(
+      a.drop | (a.forw << 1) | (a.buff << 2) | (a.nocp << 3) | (a.dupl << 4));
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const report_type_t& r) {
+  w.u8(r.dldr | (r.usar << 1) | (r.erir << 2) | (r.upir << 3));
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const node_report_type_t& n) {
+  w.u8(n.upfr);
+}
+//------------------------------------------------------------------------------
+// labels of a dotted name, each one prefixed by its length
+void encode_dotted(pfcp_writer& w, const std::string& s) {
+  size_t label = 0;
+  while (true) {
+    const size_t dot = s.find('.', label);
+    const size_t len =
+        (dot == std::string::npos) ? s.size() - label : dot - label;
+    w.u8(len);
+    w.copy(s.data() + label, len);
+    if (dot == std::string::npos) break;
+    label = dot + 1;
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const network_instance_t& n) {
+  encode_dotted(w, n.network_instance);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const node_id_t& n) {
+  w.u8(n.node_id_type & 0x0F);
+  switch (n.node_id_type) {
+    case NODE_ID_TYPE_IPV4_ADDRESS:
+      w.copy(&n.u1.ipv4_address, sizeof(n.u1.ipv4_address));
+      break;
+    case NODE_ID_TYPE_IPV6_ADDRESS:
+      w.copy(&n.u1.ipv6_address, sizeof(n.u1.ipv6_address));
+      break;
+    case NODE_ID_TYPE_FQDN:
+      encode_dotted(w, n.fqdn);
+      break;
+    default:;
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const fseid_t& f) {
+  w.u8(f.v6 | (f.v4 << 1));
+  w.be64(f.seid);
+  if (f.v4) w.copy(&f.ipv4_address, sizeof(f.ipv4_address));
+  if (f.v6) w.copy(&f.ipv6_address, sizeof(f.ipv6_address));
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const fteid_t& f) {
+  if (f.ch) {
+    w.u8((f.ch << 2) | (f.chid << 3));
+    if (f.chid) w.u8(f.choose_id);
+  } else {
+    w.u8(f.v4 | (f.v6 << 1));
+    w.be32(f.teid);
+    if (f.v4) w.copy(&f.ipv4_address, sizeof(f.ipv4_address));
+    if (f.v6) w.copy(&f.ipv6_address, sizeof(f.ipv6_address));
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const ue_ip_address_t& u) {
+  const uint8_t ipv6d = u.v6 & u.ipv6d;
+  w.u8(u.v6 | (u.v4 << 1) | (u.sd << 2) | (ipv6d << 3));
+  if (u.v4) w.copy(&u.ipv4_address, sizeof(u.ipv4_address));
+  if (u.v6) w.copy(&u.ipv6_address, sizeof(u.ipv6_address));
+  if (ipv6d) w.u8(u.ipv6_prefix_delegation_bits);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const sdf_filter_t& s) {
+  if ((s.ttc) && (s.tos_traffic_class.size() != 2)) {
+    throw pfcp_ie_value_exception(PFCP_IE_SDF_FILTER, "tos_traffic_class");
+  }
+  if ((s.spi) && (s.security_parameter_index.size() != 4)) {
+    throw pfcp_ie_value_exception(
+        PFCP_IE_SDF_FILTER, "security_parameter_index");
+  }
+  if ((s.fl) && (s.flow_label.size() != 3)) {
+    throw pfcp_ie_value_exception(PFCP_IE_SDF_FILTER, "flow_label");
+  }
+  w.u8(s.fd | (s.ttc << 1) | (s.spi << 2) | (s.fl << 3) | (s.bid << 4));
+  w.u8(0);  // spare
+  if (s.fd) {
+    w.be16(s.flow_description.size());
+    w.copy(s.flow_description.data(), s.flow_description.size());
+  }
+  if (s.ttc) w.copy(s.tos_traffic_class.data(), 2);
+  if (s.spi) w.copy(s.security_parameter_index.data(), 4);
+  if (s.fl) w.copy(s.flow_label.data(), 3);
+  if (s.bid) w.be32(s.sdf_filter_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const application_id_t& a) {
+  w.copy(a.application_id.data(), a.application_id.size());
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const activate_predefined_rules_t& a) {
+  w.copy(a.predefined_rules_name.data(), a.predefined_rules_name.size());
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const outer_header_creation_t& o) {
+  const uint16_t d = o.outer_header_creation_description;
+  w.be16(d);
+  if (d & (OUTER_HEADER_CREATION_GTPU_UDP_IPV4 |
+           OUTER_HEADER_CREATION_GTPU_UDP_IPV6)) {
+    w.be32(o.teid);
+  }
+  if (d & (OUTER_HEADER_CREATION_GTPU_UDP_IPV4 |
+           OUTER_HEADER_CREATION_UDP_IPV4)) {
+    w.copy(&o.ipv4_address, sizeof(o.ipv4_address));
+  }
+  if (d & (OUTER_HEADER_CREATION_GTPU_UDP_IPV6 |
+           OUTER_HEADER_CREATION_UDP_IPV6)) {
+    w.copy(&o.ipv6_address, sizeof(o.ipv6_address));
+  }
+  if (d & (OUTER_HEADER_CREATION_UDP_IPV4 | OUTER_HEADER_CREATION_UDP_IPV6)) {
+    w.be16(o.port_number);
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const transport_level_marking_t& t) {
+  if (t.transport_level_marking.size() != 2) {
+    throw pfcp_tlv_bad_length_exception(
+        PFCP_IE_TRANSPORT_LEVEL_MARKING, t.transport_level_marking.size(),
+        __FILE__, __LINE__);
+  }
+  w.copy(t.transport_level_marking.data(), 2);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const forwarding_policy_t& f) {
+  w.u8(f.forwarding_policy_identifier.size());
+  w.copy(
+      f.forwarding_policy_identifier.data(),
+      f.forwarding_policy_identifier.size());
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const failed_rule_id_t& f) {
+  w.u8(f.rule_id_type & 0x1F);
+  switch (f.rule_id_type) {
+    case FAILED_RULE_ID_TYPE_PDR:
+      w.be16(f.rule_id_value);
+      break;
+    case FAILED_RULE_ID_TYPE_FAR:
+    case FAILED_RULE_ID_TYPE_QER:
+    case FAILED_RULE_ID_TYPE_URR:
+      w.be32(f.rule_id_value);
+      break;
+    case FAILED_RULE_ID_TYPE_BAR:
+      w.u8(f.rule_id_value);
+      break;
+    default:
+      throw pfcp_ie_value_exception(PFCP_IE_FAILED_RULE_ID, "rule_id_type");
+  }
+}
+//------------------------------------------------------------------------------
+void encode_value(
+    pfcp_writer& w, const user_plane_ip_resource_information_t& u) {
+  w.u8(
+      u.v4 | (u.v6 << 1) | (u.teidri << 2) | (u.assoni << 5) |
+      (u.assosi << 6));
+  if (u.teidri) w.u8(u.teid_range);
+  if (u.v4) w.copy(&u.ipv4_address, sizeof(u.ipv4_address));
+  if (u.v6) w.copy(&u.ipv6_address, sizeof(u.ipv6_address));
+  if (u.assoni) w.be16(u.network_instance);
+  if (u.assosi) w.u8(u.source_interface & 0x0F);
+}
+//------------------------------------------------------------------------------
+// TBCD digits, an odd number of digits is completed by the 0xF filler
+template <class T>
+void encode_tbcd(pfcp_writer& w, const T& t, const uint8_t max_digits) {
+  const uint8_t digits =
+      (t.num_digits < max_digits) ? t.num_digits : max_digits;
+  const uint8_t len    = (digits + 1) / 2;
+  w.u8(len);
+  w.copy(t.u1.b, digits / 2);
+  if (digits & 1) w.u8(t.u1.b[digits / 2] | 0xF0);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const user_id_t& u) {
+  w.u8(u.imsif | (u.imeif << 1) | (u.msisdnf << 2) | (u.naif << 3));
+  if (u.imsif) encode_tbcd(w, u.imsi, 15);
+  if (u.imeif) {
+    w.u8(u.imei.size());
+    w.copy(u.imei.data(), u.imei.size());
+  }
+  if (u.msisdnf) encode_tbcd(w, u.msisdn, 15);
+  if (u.naif) {
+    w.u8(u.nai.size());
+    w.copy(u.nai.data(), u.nai.size());
+  }
+}
+
+// grouped IEs, below
+void encode_value(pfcp_writer& w, const pdi& p);
+void encode_value(pfcp_writer& w, const forwarding_parameters& f);
+void encode_value(pfcp_writer& w, const update_forwarding_parameters& f);
+void encode_value(pfcp_writer& w, const duplicating_parameters& d);
+void encode_value(pfcp_writer& w, const create_pdr& c);
+void encode_value(pfcp_writer& w, const create_far& c);
+void encode_value(pfcp_writer& w, const create_urr& c);
+void encode_value(pfcp_writer& w, const create_qer& c);
+void encode_value(pfcp_writer& w, const create_traffic_endpoint& c);
+void encode_value(pfcp_writer& w, const created_pdr& c);
+void encode_value(pfcp_writer& w, const update_pdr& u);
+void encode_value(pfcp_writer& w, const update_far& u);
+void encode_value(pfcp_writer& w, const update_urr& u);
+void encode_value(pfcp_writer& w, const update_qer& u);
+void encode_value(pfcp_writer& w, const remove_pdr& r);
+void encode_value(pfcp_writer& w, const remove_far& r);
+void encode_value(pfcp_writer& w, const remove_urr& r);
+void encode_value(pfcp_writer& w, const remove_qer& r);
+void encode_value(pfcp_writer& w, const downlink_data_report& d);
+
+//------------------------------------------------------------------------------
+template <class T>
+inline void encode_ie(pfcp_writer& w, const uint16_t type, const T& v) {
+  const size_t value_offset = w.begin_ie(type);
+  encode_value(w, v);
+  w.end_ie(value_offset);
+}
+//------------------------------------------------------------------------------
+template <class T>
+inline void encode_ie(
+    pfcp_writer& w, const uint16_t type, const std::pair<bool, T>& p) {
+  if (p.first) encode_ie(w, type, p.second);
+}
+//------------------------------------------------------------------------------
+template <class T>
+inline void encode_ie(
+    pfcp_writer& w, const uint16_t type, const std::vector<T>& l) {
+  for (const auto& v : l) encode_ie(w, type, v);
+}
+
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const pdi& p) {
+  encode_ie(w, PFCP_IE_SOURCE_INTERFACE, p.source_interface);
+  encode_ie(w, PFCP_IE_F_TEID, p.local_fteid);
+  encode_ie(w, PFCP_IE_NETWORK_INSTANCE, p.network_instance);
+  encode_ie(w, PFCP_IE_UE_IP_ADDRESS, p.ue_ip_address);
+  encode_ie(w, PFCP_IE_SDF_FILTER, p.sdf_filter);
+  encode_ie(w, PFCP_IE_APPLICATION_ID, p.application_id);
+  encode_ie(w, PFCP_IE_QFI, p.qfi);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const forwarding_parameters& f) {
+  encode_ie(w, PFCP_IE_DESTINATION_INTERFACE, f.destination_interface);
+  encode_ie(w, PFCP_IE_NETWORK_INSTANCE, f.network_instance);
+  encode_ie(w, PFCP_IE_OUTER_HEADER_CREATION, f.outer_header_creation);
+  encode_ie(w, PFCP_IE_TRANSPORT_LEVEL_MARKING, f.transport_level_marking);
+  encode_ie(w, PFCP_IE_FORWARDING_POLICY, f.forwarding_policy);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const update_forwarding_parameters& f) {
+  encode_ie(w, PFCP_IE_DESTINATION_INTERFACE, f.destination_interface);
+  encode_ie(w, PFCP_IE_NETWORK_INSTANCE, f.network_instance);
+  encode_ie(w, PFCP_IE_OUTER_HEADER_CREATION, f.outer_header_creation);
+  encode_ie(w, PFCP_IE_TRANSPORT_LEVEL_MARKING, f.transport_level_marking);
+  encode_ie(w, PFCP_IE_FORWARDING_POLICY, f.forwarding_policy);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const create_pdr& c) {
+  encode_ie(w, PFCP_IE_PACKET_DETECTION_RULE_ID, c.pdr_id);
+  encode_ie(w, PFCP_IE_PRECEDENCE, c.precedence);
+  encode_ie(w, PFCP_IE_PDI, c.pdi);
+  encode_ie(w, PFCP_IE_OUTER_HEADER_REMOVAL, c.outer_header_removal);
+  encode_ie(w, PFCP_IE_FAR_ID, c.far_id);
+  encode_ie(w, PFCP_IE_URR_ID, c.urr_id);
+  encode_ie(w, PFCP_IE_QER_ID, c.qer_id);
+  encode_ie(
+      w, PFCP_IE_ACTIVATE_PREDEFINED_RULES, c.activate_predefined_rules);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const create_far& c) {
+  encode_ie(w, PFCP_IE_FAR_ID, c.far_id);
+  encode_ie(w, PFCP_IE_APPLY_ACTION, c.apply_action);
+  encode_ie(w, PFCP_IE_FORWARDING_PARAMETERS, c.forwarding_parameters);
+  encode_ie(w, PFCP_IE_DUPLICATING_PARAMETERS, c.duplicating_parameters);
+  encode_ie(w, PFCP_IE_BAR_ID, c.bar_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const update_far& u) {
+  encode_ie(w, PFCP_IE_FAR_ID, u.far_id);
+  encode_ie(w, PFCP_IE_APPLY_ACTION, u.apply_action);
+  encode_ie(
+      w, PFCP_IE_UPDATE_FORWARDING_PARAMETERS, u.update_forwarding_parameters);
+  encode_ie(w, PFCP_IE_BAR_ID, u.bar_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const created_pdr& c) {
+  encode_ie(w, PFCP_IE_PACKET_DETECTION_RULE_ID, c.pdr_id);
+  encode_ie(w, PFCP_IE_F_TEID, c.local_fteid);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const remove_pdr& r) {
+  encode_ie(w, PFCP_IE_PACKET_DETECTION_RULE_ID, r.pdr_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const remove_far& r) {
+  encode_ie(w, PFCP_IE_FAR_ID, r.far_id);
+}
+//------------------------------------------------------------------------------
+void encode_value(pfcp_writer& w, const downlink_data_report& d) {
+  encode_ie(w, PFCP_IE_PACKET_DETECTION_RULE_ID, d.pdr_id);
+}
+
+//------------------------------------------------------------------------------
+// grouped IEs sent empty, their content is not encoded by pfcp_msg either
+void encode_value(pfcp_writer& w, const duplicating_parameters& d) {}
+void encode_value(pfcp_writer& w, const create_urr& c) {}
+void encode_value(pfcp_writer& w, const create_qer& c) {}
+void encode_value(pfcp_writer& w, const create_traffic_endpoint& c) {}
+void encode_value(pfcp_writer& w, const update_pdr& u) {}
+void encode_value(pfcp_writer& w, const update_urr& u) {}
+void encode_value(pfcp_writer& w, const update_qer& u) {}
+void encode_value(pfcp_writer& w, const remove_urr& r) {}
+void encode_value(pfcp_writer& w, const remove_qer& r) {}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_header(
+    pfcp_writer& w, const uint8_t msg_type, const pfcp_msg_header& h) {
+  // version 1, S flag when the message carries a SEID
+  w.u8(0x20 | (h.has_seid() ? 0x01 : 0x00));
+  w.u8(msg_type);
+  w.be16(0);  // message length, see end_header()
+  if (h.has_seid()) w.be64(h.get_seid());
+  w.be24(h.get_sequence_number());
+  w.u8(0);  // message priority, spare
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::end_header(const pfcp_writer& w, uint8_t* buf) {
+  if (w.sizing()) return;
+  // message length excludes the first 4 octets
+  const size_t length = w.size() - 4;
+  buf[2]              = length >> 8;
+  buf[3]              = length;
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(pfcp_writer& w, const pfcp_heartbeat_request& s) {
+  encode_ie(w, PFCP_IE_RECOVERY_TIME_STAMP, s.recovery_time_stamp);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_heartbeat_response& s) {
+  encode_ie(w, PFCP_IE_RECOVERY_TIME_STAMP, s.recovery_time_stamp);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_association_setup_request& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+  encode_ie(w, PFCP_IE_RECOVERY_TIME_STAMP, s.recovery_time_stamp);
+  encode_ie(w, PFCP_IE_UP_FUNCTION_FEATURES, s.up_function_features);
+  encode_ie(w, PFCP_IE_CP_FUNCTION_FEATURES, s.cp_function_features);
+  encode_ie(
+      w, PFCP_IE_USER_PLANE_IP_RESOURCE_INFORMATION,
+      s.user_plane_ip_resource_information);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_association_setup_response& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+  encode_ie(w, PFCP_IE_CAUSE, s.cause);
+  encode_ie(w, PFCP_IE_RECOVERY_TIME_STAMP, s.recovery_time_stamp);
+  encode_ie(w, PFCP_IE_UP_FUNCTION_FEATURES, s.up_function_features);
+  encode_ie(w, PFCP_IE_CP_FUNCTION_FEATURES, s.cp_function_features);
+  encode_ie(
+      w, PFCP_IE_USER_PLANE_IP_RESOURCE_INFORMATION,
+      s.user_plane_ip_resource_information);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_association_release_request& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_association_release_response& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+  encode_ie(w, PFCP_IE_CAUSE, s.cause);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_node_report_request& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+  encode_ie(w, PFCP_IE_NODE_REPORT_TYPE, s.node_report_type);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_establishment_request& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+  encode_ie(w, PFCP_IE_F_SEID, s.cp_fseid);
+  encode_ie(w, PFCP_IE_CREATE_PDR, s.create_pdrs);
+  encode_ie(w, PFCP_IE_CREATE_FAR, s.create_fars);
+  encode_ie(w, PFCP_IE_CREATE_URR, s.create_urrs);
+  encode_ie(w, PFCP_IE_CREATE_QER, s.create_qers);
+  encode_ie(w, PFCP_IE_CREATE_TRAFFIC_ENDPOINT, s.create_traffic_endpoint);
+  encode_ie(
+      w, PFCP_IE_USER_PLANE_INACTIVITY_TIMER, s.user_plane_inactivity_timer);
+  encode_ie(w, PFCP_IE_USER_ID, s.user_id);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_establishment_response& s) {
+  encode_ie(w, PFCP_IE_NODE_ID, s.node_id);
+  encode_ie(w, PFCP_IE_CAUSE, s.cause);
+  encode_ie(w, PFCP_IE_OFFENDING_IE, s.offending_ie);
+  encode_ie(w, PFCP_IE_F_SEID, s.up_fseid);
+  encode_ie(w, PFCP_IE_CREATED_PDR, s.created_pdrs);
+  encode_ie(w, PFCP_IE_FAILED_RULE_ID, s.failed_rule_id);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_modification_request& s) {
+  encode_ie(w, PFCP_IE_F_SEID, s.cp_fseid);
+  encode_ie(w, PFCP_IE_REMOVE_PDR, s.remove_pdrs);
+  encode_ie(w, PFCP_IE_REMOVE_FAR, s.remove_fars);
+  encode_ie(w, PFCP_IE_REMOVE_URR, s.remove_urrs);
+  encode_ie(w, PFCP_IE_REMOVE_QER, s.remove_qers);
+  encode_ie(w, PFCP_IE_CREATE_PDR, s.create_pdrs);
+  encode_ie(w, PFCP_IE_CREATE_FAR, s.create_fars);
+  encode_ie(w, PFCP_IE_CREATE_URR, s.create_urrs);
+  encode_ie(w, PFCP_IE_CREATE_QER, s.create_qers);
+  encode_ie(w, PFCP_IE_CREATE_TRAFFIC_ENDPOINT, s.create_traffic_endpoint);
+  encode_ie(w, PFCP_IE_UPDATE_PDR, s.update_pdrs);
+  encode_ie(w, PFCP_IE_UPDATE_FAR, s.update_fars);
+  encode_ie(w, PFCP_IE_UPDATE_URR, s.update_urrs);
+  encode_ie(w, PFCP_IE_UPDATE_QER, s.update_qers);
+  encode_ie(
+      w, PFCP_IE_USER_PLANE_INACTIVITY_TIMER, s.user_plane_inactivity_timer);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_modification_response& s) {
+  encode_ie(w, PFCP_IE_CAUSE, s.cause);
+  encode_ie(w, PFCP_IE_OFFENDING_IE, s.offending_ie);
+  encode_ie(w, PFCP_IE_CREATED_PDR, s.created_pdrs);
+  encode_ie(w, PFCP_IE_FAILED_RULE_ID, s.failed_rule_id);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_deletion_request& s) {}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_deletion_response& s) {
+  encode_ie(w, PFCP_IE_CAUSE, s.cause);
+  encode_ie(w, PFCP_IE_OFFENDING_IE, s.offending_ie);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_report_request& s) {
+  encode_ie(w, PFCP_IE_REPORT_TYPE, s.report_type);
+  encode_ie(w, PFCP_IE_DOWNLINK_DATA_REPORT, s.downlink_data_report);
+}
+//------------------------------------------------------------------------------
+void pfcp_encoder::encode_ies(
+    pfcp_writer& w, const pfcp_session_report_response& s) {
+  encode_ie(w, PFCP_IE_CAUSE, s.cause);
+  encode_ie(w, PFCP_IE_OFFENDING_IE, s.offending_ie);
+}
+
+}  // namespace pfcp
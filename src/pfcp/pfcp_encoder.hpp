@@ -0,0 +1,195 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file pfcp_encoder.hpp
+  \brief Direct to buffer PFCP encoder, writes the core containers of
+  msg_pfcp.hpp into one contiguous buffer
+*/
+#ifndef FILE_PFCP_ENCODER_HPP_SEEN
+#define FILE_PFCP_ENCODER_HPP_SEEN
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "3gpp_29.244.h"
+#include "3gpp_29.244.hpp"
+#include "msg_pfcp.hpp"
+
+namespace pfcp {
+
+//------------------------------------------------------------------------------
+// Write cursor over a contiguous buffer. Constructed without a buffer it only
+// counts the bytes, this is the sizing pass. TLV lengths are patched in by
+// end_ie() once the value of the IE has been written.
+class pfcp_writer {
+ public:
+  pfcp_writer(uint8_t* buf, const size_t len, const uint8_t type = 0)
+      : start(buf), cap(len), pos(0), msg_type(type) {}
+  explicit pfcp_writer(const uint8_t type = 0)
+      : start(nullptr), cap(0), pos(0), msg_type(type) {}
+
+  size_t size() const { return pos; }
+  bool sizing() const { return start == nullptr; }
+
+  void u8(const uint8_t v) {
+    if (uint8_t* p = room(1)) p[0] = v;
+  }
+  void be16(const uint16_t v) {
+    if (uint8_t* p = room(2)) {
+      p[0] = v >> 8;
+      p[1] = v;
+    }
+  }
+  void be24(const uint32_t v) {
+    if (uint8_t* p = room(3)) {
+      p[0] = v >> 16;
+      p[1] = v >> 8;
+      p[2] = v;
+    }
+  }
+  void be32(const uint32_t v) {
+    if (uint8_t* p = room(4)) {
+      p[0] = v >> 24;
+      p[1] = v >> 16;
+      p[2] = v >> 8;
+      p[3] = v;
+    }
+  }
+  void be64(const uint64_t v) {
+    be32(v >> 32);
+    be32(v);
+  }
+  // copy raw bytes (addresses are already in network byte order)
+  void copy(const void* src, const size_t n) {
+    if (uint8_t* p = room(n)) memcpy(p, src, n);
+  }
+
+  /** \brief Open an IE, the length field is left for end_ie()
+   *  @returns the offset of the value part of the IE
+   **/
+  size_t begin_ie(const uint16_t type) {
+    be16(type);
+    be16(0);
+    return pos;
+  }
+  void end_ie(const size_t value_offset) {
+    if (start) {
+      const size_t len        = pos - value_offset;
+      start[value_offset - 2] = len >> 8;
+      start[value_offset - 1] = len;
+    }
+  }
+
+ private:
+  uint8_t* room(const size_t n) {
+    const size_t at = pos;
+    pos += n;
+    if (!start) return nullptr;
+    if (pos > cap) {
+      throw pfcp_msg_bad_length_exception(
+          msg_type, pos, cap, 0, __FILE__, __LINE__);
+    }
+    return start + at;
+  }
+
+  uint8_t* start;
+  size_t cap;
+  size_t pos;
+  uint8_t msg_type;
+};
+
+//------------------------------------------------------------------------------
+// Encodes the messages the PGW-C sends on Sxb, the header fields (SEID,
+// sequence number) are taken from a pfcp_msg_header. encoded_size() runs the
+// encoder without a buffer so that the caller can reserve the exact length.
+class pfcp_encoder {
+ public:
+  template <class M>
+  static size_t encoded_size(const M& s, const pfcp_msg_header& h) {
+    pfcp_writer w(M::msg_id);
+    encode_header(w, M::msg_id, h);
+    encode_ies(w, s);
+    return w.size();
+  }
+
+  /** \brief Encode a message into a caller supplied buffer
+   *  @returns the number of bytes written, throws
+   *  pfcp_msg_bad_length_exception if the buffer is too small
+   **/
+  template <class M>
+  static size_t encode(
+      const M& s, const pfcp_msg_header& h, uint8_t* buf, const size_t len) {
+    pfcp_writer w(buf, len, M::msg_id);
+    encode_header(w, M::msg_id, h);
+    encode_ies(w, s);
+    end_header(w, buf);
+    return w.size();
+  }
+
+  /** \brief Encode a message into bytes, resized to the message length
+   **/
+  template <class M>
+  static void encode(
+      const M& s, const pfcp_msg_header& h, std::vector<uint8_t>& bytes) {
+    bytes.resize(encoded_size(s, h));
+    encode(s, h, bytes.data(), bytes.size());
+  }
+
+ private:
+  static void encode_header(
+      pfcp_writer& w, const uint8_t msg_type, const pfcp_msg_header& h);
+  static void end_header(const pfcp_writer& w, uint8_t* buf);
+
+  static void encode_ies(pfcp_writer& w, const pfcp_heartbeat_request& s);
+  static void encode_ies(pfcp_writer& w, const pfcp_heartbeat_response& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_association_setup_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_association_setup_response& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_association_release_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_association_release_response& s);
+  static void encode_ies(pfcp_writer& w, const pfcp_node_report_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_establishment_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_establishment_response& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_modification_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_modification_response& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_deletion_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_deletion_response& s);
+  static void encode_ies(pfcp_writer& w, const pfcp_session_report_request& s);
+  static void encode_ies(
+      pfcp_writer& w, const pfcp_session_report_response& s);
+};
+
+}  // namespace pfcp
+
+#endif /* FILE_PFCP_ENCODER_HPP_SEEN */
@@ -0,0 +1,155 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file bench_bitmap_allocator.cpp
+  \brief Allocation and release of 1M integers in random order by
+  bitmap_allocator and sharded_bitmap_allocator, checked against a std::set
+*/
+#include "bitmap_allocator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+using util::bitmap_allocator;
+using util::sharded_bitmap_allocator;
+
+static bool alloc(bitmap_allocator& a, const uint32_t shard, uint32_t& pos) {
+  return a.alloc(pos);
+}
+// From shard 0, shards are tried in order and the lowest free integer of the
+// range is given
+static bool alloc(
+    sharded_bitmap_allocator& a, const uint32_t shard, uint32_t& pos) {
+  return a.alloc(shard, pos);
+}
+
+//------------------------------------------------------------------------------
+// Allocate the whole range, release it in random order, allocate it again,
+// then release half of it and churn: release a random allocated integer,
+// allocate one. Allocations rotate over the shards as the workers of the
+// PGW-C would. Returns ns per operation.
+template <class A>
+double run(A& a, const uint32_t range, const uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<uint32_t> live;
+  live.reserve(range);
+  uint32_t pos = 0;
+  auto start   = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < range; i++) {
+    if (!alloc(a, i, pos)) abort();
+    live.push_back(pos);
+  }
+  std::shuffle(live.begin(), live.end(), gen);
+  for (auto p : live) {
+    if (!a.free(p)) abort();
+  }
+  live.clear();
+  for (uint32_t i = 0; i < range; i++) {
+    if (!alloc(a, i, pos)) abort();
+    live.push_back(pos);
+  }
+  std::shuffle(live.begin(), live.end(), gen);
+  for (uint32_t i = 0; i < range / 2; i++) {
+    if (!a.free(live.back())) abort();
+    live.pop_back();
+  }
+  for (uint32_t i = 0; i < range; i++) {
+    const uint32_t k = gen() % live.size();
+    if (!a.free(live[k])) abort();
+    if (!alloc(a, i, live[k])) abort();
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / (uint64_t(range) * 4 + range / 2);
+}
+
+//------------------------------------------------------------------------------
+// Same sequence, each result compared with a std::set of the free integers
+template <class A>
+bool check(A& a, const uint32_t range, const uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::set<uint32_t> free_set;
+  for (uint32_t i = 0; i < range; i++) free_set.insert(i);
+  std::vector<uint32_t> live;
+  uint32_t pos = 0;
+
+  auto alloc_checked = [&](uint32_t& p) {
+    if (!alloc(a, 0, p)) return free_set.empty();
+    if (free_set.empty() || (p != *free_set.begin()) || !a.test(p)) {
+      return false;
+    }
+    free_set.erase(free_set.begin());
+    return true;
+  };
+  auto free_checked = [&](const uint32_t p) {
+    if (!a.free(p) || a.test(p) || a.free(p)) return false;
+    return free_set.insert(p).second;
+  };
+
+  for (int round = 0; round < 2; round++) {
+    for (uint32_t i = 0; i < range; i++) {
+      if (!alloc_checked(pos)) return false;
+      live.push_back(pos);
+    }
+    if (alloc(a, 0, pos) || !free_set.empty()) return false;
+    std::shuffle(live.begin(), live.end(), gen);
+    const uint32_t n = round ? range / 2 : range;
+    for (uint32_t i = 0; i < n; i++) {
+      if (!free_checked(live.back())) return false;
+      live.pop_back();
+    }
+  }
+  for (uint32_t i = 0; i < range; i++) {
+    const uint32_t k = gen() % live.size();
+    if (!free_checked(live[k])) return false;
+    if (!alloc_checked(live[k])) return false;
+  }
+  if (a.alloc_at(live[0]) || a.free(range) || a.test(range)) return false;
+  return free_set.size() == range - live.size();
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  const uint32_t range  = (argc > 1) ? atol(argv[1]) : (1 << 20);
+  const uint32_t shards = (argc > 2) ? atol(argv[2]) : 8;
+  const uint32_t seed   = 2020;
+
+  bitmap_allocator a(range);
+  sharded_bitmap_allocator s1(range, 1);
+  sharded_bitmap_allocator sn(range, shards);
+  printf("%u integers, random order\n", range);
+  printf("  bitmap_allocator           %6.1f ns/op\n", run(a, range, seed));
+  printf("  sharded_bitmap_allocator 1 %6.1f ns/op\n", run(s1, range, seed));
+  printf(
+      "  sharded_bitmap_allocator %u %6.1f ns/op\n", sn.num_shards(),
+      run(sn, range, seed));
+
+  bitmap_allocator ca(range);
+  sharded_bitmap_allocator csn(range, shards);
+  const bool ok = check(ca, range, seed) && check(csn, range, seed + 1);
+  printf("std::set model check %s\n", ok ? "passed" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file bench_gtpv2c_decode.cpp
+  \brief Decoding time of the GTPv2-C messages of corpus/gtpv2c, as received
+  by the SGW-C and the PGW-C, with the gtpv2c_msg stream parser and with the
+  zero-copy gtpv2c_decoder, both checked to give the same IEs
+*/
+#include "3gpp_29.274.hpp"
+#include "gtpv2c_decoder.hpp"
+#include "gtpv2c_encoder.hpp"
+
+#include <dirent.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef GTPV2C_CORPUS_DIR
+#define GTPV2C_CORPUS_DIR "corpus/gtpv2c"
+#endif
+
+using namespace gtpv2c;
+
+namespace {
+
+// gtpv2c_msg::load_from() then to_core_type(), as sgw_s11::handle_receive()
+// did before gtpv2c_decoder
+template <class M>
+void legacy_decode(const std::vector<uint8_t>& bytes, M& msg_ies_container) {
+  std::istringstream iss(std::istringstream::binary);
+  // only read from
+  iss.rdbuf()->pubsetbuf(
+      const_cast<char*>(reinterpret_cast<const char*>(bytes.data())),
+      bytes.size());
+  gtpv2c_msg msg = {};
+  msg.load_from(iss);
+  msg.to_core_type(msg_ies_container);
+}
+
+template <class M>
+void zero_copy_decode(
+    const std::vector<uint8_t>& bytes, M& msg_ies_container) {
+  gtpv2c_msg_header h = {};
+  gtpv2c_view ies =
+      gtpv2c_decoder::decode_header(bytes.data(), bytes.size(), h);
+  gtpv2c_decoder::decode(ies, msg_ies_container);
+}
+
+template <class M>
+void legacy_as(const std::vector<uint8_t>& bytes) {
+  M msg_ies_container = {};
+  legacy_decode(bytes, msg_ies_container);
+}
+
+template <class M>
+void zero_copy_as(const std::vector<uint8_t>& bytes) {
+  M msg_ies_container = {};
+  zero_copy_decode(bytes, msg_ies_container);
+}
+
+enum compare_e { SAME = 0, DIFFERENT, LEGACY_REJECTS };
+
+// Both containers are encoded again with the header of the message, equal
+// bytes mean both decoders kept the same IEs with the same values. A message
+// the stream parser throws on is only decoded by gtpv2c_decoder.
+template <class M>
+compare_e compare_as(const std::vector<uint8_t>& bytes, std::string& why) {
+  M legacy    = {};
+  M zero_copy = {};
+  try {
+    legacy_decode(bytes, legacy);
+  } catch (std::exception& e) {
+    why = e.what();
+    return LEGACY_REJECTS;
+  }
+  zero_copy_decode(bytes, zero_copy);
+  gtpv2c_msg_header h = {};
+  gtpv2c_decoder::decode_header(bytes.data(), bytes.size(), h);
+  std::vector<uint8_t> legacy_bytes    = {};
+  std::vector<uint8_t> zero_copy_bytes = {};
+  gtpv2c_encoder::encode(legacy, h, legacy_bytes);
+  gtpv2c_encoder::encode(zero_copy, h, zero_copy_bytes);
+  return (legacy_bytes == zero_copy_bytes) ? SAME : DIFFERENT;
+}
+
+struct codec {
+  uint8_t msg_type;
+  void (*legacy)(const std::vector<uint8_t>& bytes);
+  void (*zero_copy)(const std::vector<uint8_t>& bytes);
+  compare_e (*compare)(const std::vector<uint8_t>& bytes, std::string& why);
+};
+
+template <class M>
+codec codec_of() {
+  return {M::msg_id, legacy_as<M>, zero_copy_as<M>, compare_as<M>};
+}
+
+const codec* find_codec(const uint8_t msg_type) {
+  static const std::vector<codec> codecs = {
+      codec_of<gtpv2c_echo_request>(),
+      codec_of<gtpv2c_echo_response>(),
+      codec_of<gtpv2c_create_session_request>(),
+      codec_of<gtpv2c_create_session_response>(),
+      codec_of<gtpv2c_modify_bearer_request>(),
+      codec_of<gtpv2c_modify_bearer_response>(),
+      codec_of<gtpv2c_delete_session_request>(),
+      codec_of<gtpv2c_delete_session_response>(),
+      codec_of<gtpv2c_release_access_bearers_request>(),
+      codec_of<gtpv2c_release_access_bearers_response>(),
+      codec_of<gtpv2c_downlink_data_notification>(),
+      codec_of<gtpv2c_downlink_data_notification_acknowledge>()};
+  for (const auto& c : codecs) {
+    if (c.msg_type == msg_type) return &c;
+  }
+  return nullptr;
+}
+
+struct corpus_entry {
+  std::string name;
+  std::vector<uint8_t> bytes;
+  const codec* c;
+  compare_e compared;
+};
+
+//------------------------------------------------------------------------------
+// One GTPv2-C message per .bin file, the UDP payload of a captured datagram
+bool load_corpus(const std::string& dir, std::vector<corpus_entry>& corpus) {
+  DIR* d = opendir(dir.c_str());
+  if (!d) {
+    perror(dir.c_str());
+    return false;
+  }
+  std::vector<std::string> names = {};
+  while (struct dirent* de = readdir(d)) {
+    std::string name = de->d_name;
+    if ((name.size() > 4) && (name.compare(name.size() - 4, 4, ".bin") == 0)) {
+      names.push_back(name);
+    }
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+
+  for (const auto& name : names) {
+    std::string path = dir + "/" + name;
+    FILE* f          = fopen(path.c_str(), "rb");
+    if (!f) {
+      perror(path.c_str());
+      return false;
+    }
+    corpus_entry e = {name.substr(0, name.size() - 4), {}, nullptr, SAME};
+    uint8_t buf[4096];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+      e.bytes.insert(e.bytes.end(), buf, buf + n);
+    }
+    fclose(f);
+    if (e.bytes.size() > 1) e.c = find_codec(e.bytes[1]);
+    if (!e.c) {
+      fprintf(stderr, "%s: no decoder for this message type\n", path.c_str());
+      return false;
+    }
+    corpus.push_back(e);
+  }
+  return true;
+}
+
+double ns_per_msg(
+    void (*decode)(const std::vector<uint8_t>& bytes),
+    const std::vector<uint8_t>& bytes, const long iterations) {
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    decode(bytes);
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------
+// bench_gtpv2c_decode [iterations] [corpus directory]
+int main(int argc, char** argv) {
+  const long iterations = (argc > 1) ? atol(argv[1]) : 100000;
+  const std::string dir = (argc > 2) ? argv[2] : GTPV2C_CORPUS_DIR;
+  std::vector<corpus_entry> corpus = {};
+  if ((!load_corpus(dir, corpus)) || (corpus.empty())) {
+    fprintf(stderr, "no GTPv2-C message in %s\n", dir.c_str());
+    return 1;
+  }
+
+  int mismatches = 0;
+  for (auto& e : corpus) {
+    std::string why = {};
+    e.compared      = e.c->compare(e.bytes, why);
+    if (e.compared == DIFFERENT) {
+      fprintf(stderr, "%s: the decoders disagree\n", e.name.c_str());
+      mismatches++;
+    } else if (e.compared == LEGACY_REJECTS) {
+      printf("%s: gtpv2c_msg rejects it, %s\n", e.name.c_str(), why.c_str());
+    }
+  }
+  if (mismatches) return 1;
+
+  printf(
+      "%-44s %5s %12s %12s\n", "message", "bytes", "istream ns",
+      "zero-copy ns");
+  for (auto& e : corpus) {
+    double zero_copy = ns_per_msg(e.c->zero_copy, e.bytes, iterations);
+    if (e.compared == LEGACY_REJECTS) {
+      printf(
+          "%-44s %5zu %12s %12.1f\n", e.name.c_str(), e.bytes.size(), "-",
+          zero_copy);
+      continue;
+    }
+    double legacy = ns_per_msg(e.c->legacy, e.bytes, iterations);
+    printf(
+        "%-44s %5zu %12.1f %12.1f\n", e.name.c_str(), e.bytes.size(), legacy,
+        zero_copy);
+  }
+  return 0;
+}
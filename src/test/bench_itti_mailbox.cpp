@@ -0,0 +1,116 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file bench_itti_mailbox.cpp
+  \brief Producer throughput of itti_mailbox against a mutex + condition
+  variable queue, the ITTI task queue it replaced
+*/
+#include "itti.hpp"
+#include "logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <thread>
+#include <vector>
+
+itti_mw* itti_inst = nullptr;
+
+//------------------------------------------------------------------------------
+// Former ITTI task queue: std::queue guarded by a mutex, consumer parked on a
+// condition variable.
+class locked_queue {
+ public:
+  bool push(std::shared_ptr<itti_msg> message) {
+    std::unique_lock<std::mutex> lock(m);
+    q.push(message);
+    c.notify_one();
+    return true;
+  }
+  std::shared_ptr<itti_msg> wait_pop() {
+    std::unique_lock<std::mutex> lock(m);
+    while (q.empty()) c.wait(lock);
+    std::shared_ptr<itti_msg> message = q.front();
+    q.pop();
+    return message;
+  }
+
+ private:
+  std::queue<std::shared_ptr<itti_msg>> q;
+  std::mutex m;
+  std::condition_variable c;
+};
+
+//------------------------------------------------------------------------------
+// Returns millions of messages per second moved from producers to one consumer
+template <class Q, class PUSH>
+double run(Q& q, PUSH push, const int producers, const long per_producer) {
+  std::shared_ptr<itti_msg> message = std::make_shared<itti_msg>();
+  auto start                        = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.emplace_back([&] {
+      for (long i = 0; i < per_producer; i++) {
+        while (!push(q, message)) std::this_thread::yield();
+      }
+    });
+  }
+  const long total = producers * per_producer;
+  for (long i = 0; i < total; i++) {
+    if (!q.wait_pop()) abort();
+  }
+  for (auto& t : threads) t.join();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return total / elapsed.count() / 1e6;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  const long messages = (argc > 1) ? atol(argv[1]) : 2000000;
+  Logger::init("bench", false, false);
+  itti_inst = new itti_mw();
+
+  for (int producers : {1, 4, 16}) {
+    const long per_producer = messages / producers;
+    locked_queue lq;
+    itti_mailbox mailbox(itti_mailbox::kDefaultCapacity);
+    double locked = run(
+        lq,
+        [](locked_queue& q, std::shared_ptr<itti_msg> m) { return q.push(m); },
+        producers, per_producer);
+    double lock_free = run(
+        mailbox,
+        [](itti_mailbox& q, std::shared_ptr<itti_msg> m) {
+          if (!q.push(m)) return false;
+          q.notify();
+          return true;
+        },
+        producers, per_producer);
+    printf(
+        "producers %2d: mutex+condvar %6.2f Mmsg/s, itti_mailbox %6.2f "
+        "Mmsg/s\n",
+        producers, locked, lock_free);
+  }
+  delete itti_inst;
+  return 0;
+}
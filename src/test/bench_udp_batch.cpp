@@ -0,0 +1,111 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file bench_udp_batch.cpp
+  \brief Loopback round trips of udp_server with per datagram recvfrom() and
+  sendto() against batched recvmmsg() and sendmmsg()
+*/
+#include "logger.hpp"
+#include "udp.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+itti_mw* itti_inst = nullptr;
+
+//------------------------------------------------------------------------------
+// Counts received datagrams, echoes them back when echo is set
+class bench_application : public UdpApplication {
+ public:
+  explicit bench_application(udp_server* echo) : received(0), echo(echo) {}
+
+  void handle_receive(
+      char* recv_buffer, const std::size_t bytes_transferred,
+      const endpoint& r_endpoint) override {
+    received.fetch_add(1, std::memory_order_relaxed);
+    if (echo) echo->async_send_to(recv_buffer, bytes_transferred, r_endpoint);
+  }
+
+  std::atomic<uint64_t> received;
+  udp_server* echo;
+};
+
+//------------------------------------------------------------------------------
+// Returns round trips per second, a client keeps up to kWindow datagrams in
+// flight towards an echo server
+double run(const uint32_t batch_size, const uint16_t port, const long count) {
+  static const long kWindow = 256;
+  util::thread_sched_params sched_params;
+  sched_params.cpu_id         = -1;
+  sched_params.sched_policy   = SCHED_OTHER;
+  sched_params.sched_priority = 0;
+
+  udp_server server("127.0.0.1", port);
+  udp_server client("127.0.0.1", port + 1);
+  bench_application server_app(&server);
+  bench_application client_app(nullptr);
+  server.start_receive(&server_app, sched_params, 1, batch_size);
+  client.start_receive(&client_app, sched_params, 1, batch_size);
+
+  struct sockaddr_in dest = {};
+  dest.sin_family         = AF_INET;
+  dest.sin_port           = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr);
+  char message[200] = {};
+
+  auto start    = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::seconds(30);
+  for (long i = 0; i < count; i++) {
+    client.async_send_to(message, sizeof(message), dest);
+    while ((i - (long) client_app.received.load() > kWindow) &&
+           (std::chrono::steady_clock::now() < deadline)) {
+      std::this_thread::yield();
+    }
+  }
+  // Loopback may still drop a few datagrams when socket buffers overflow
+  while (((long) client_app.received.load() < count * 99 / 100) &&
+         (std::chrono::steady_clock::now() < deadline)) {
+    std::this_thread::yield();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  uint64_t received = client_app.received.load();
+  server.stop();
+  client.stop();
+  printf(
+      "batch %2u: %lu/%ld round trips in %.3f s, %.0f msg/s\n", batch_size,
+      received, count, elapsed.count(), received / elapsed.count());
+  return received / elapsed.count();
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  const long count = (argc > 1) ? atol(argv[1]) : 400000;
+  Logger::init("bench", false, false);
+  itti_inst = new itti_mw();
+
+  double single  = run(1, 32123, count);
+  double batched = run(UDP_MAX_BATCH_SIZE, 32125, count);
+  printf("batched/per datagram: %.2f\n", batched / single);
+  delete itti_inst;
+  return 0;
+}
@@ -0,0 +1,94 @@
+#/*
+# * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+# * contributor license agreements.  See the NOTICE file distributed with
+# * this work for additional information regarding copyright ownership.
+# * The OpenAirInterface Software Alliance licenses this file to You under
+# * the OAI Public License, Version 1.1  (the "License"); you may not use this file
+# * except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# *	  http://www.openairinterface.org/?page_id=698
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# *-------------------------------------------------------------------------------
+# * For more information about the OpenAirInterface (OAI) Software Alliance:
+# *	  contact@openairinterface.org
+# */
+
+# Writes the GTPv2-C messages (UDP port 2123) of a capture as the .bin files
+# of corpus/gtpv2c, one UDP payload per file:
+#   pcap_to_bin.py <capture.pcap> <corpus directory> [port]
+# Only the classic pcap format is read (tcpdump -w, or editcap -F pcap), on
+# Ethernet, Linux cooked or raw IP links.
+
+import os
+import struct
+import sys
+
+LINK_HEADER = {1: 14, 101: 0, 113: 16}
+
+def udp_payload(frame, port):
+	# IPv4 or IPv6 header, then UDP
+	if (len(frame) < 1):
+		return None
+	version = frame[0] >> 4
+	if (version == 4):
+		ihl = (frame[0] & 0x0f) * 4
+		proto = frame[9]
+		udp = frame[ihl:]
+	elif (version == 6):
+		proto = frame[6]
+		udp = frame[40:]
+	else:
+		return None
+	if (proto != 17) or (len(udp) < 8):
+		return None
+	sport, dport, length = struct.unpack('!HHH', udp[0:6])
+	if (sport != port) and (dport != port):
+		return None
+	return udp[8:length]
+
+def main():
+	if (len(sys.argv) < 3):
+		print('usage: pcap_to_bin.py <capture.pcap> <corpus directory> [port]')
+		sys.exit(1)
+	port = int(sys.argv[3]) if (len(sys.argv) > 3) else 2123
+	prefix = os.path.splitext(os.path.basename(sys.argv[1]))[0]
+	with open(sys.argv[1], 'rb') as f:
+		data = f.read()
+	magic = struct.unpack('<I', data[0:4])[0]
+	if (magic == 0xa1b2c3d4) or (magic == 0xa1b23c4d):
+		endian = '<'
+	elif (magic == 0xd4c3b2a1) or (magic == 0x4d3cb2a1):
+		endian = '>'
+	else:
+		print(sys.argv[1] + ': not a classic pcap file')
+		sys.exit(1)
+	link = struct.unpack(endian + 'I', data[20:24])[0]
+	if (link not in LINK_HEADER):
+		print(sys.argv[1] + ': link type ' + str(link) + ' not handled')
+		sys.exit(1)
+	offset = 24
+	frame_num = 0
+	written = 0
+	while (offset + 16 <= len(data)):
+		caplen = struct.unpack(endian + 'I', data[offset + 8:offset + 12])[0]
+		frame = data[offset + 16:offset + 16 + caplen]
+		offset += 16 + caplen
+		frame_num += 1
+		payload = udp_payload(frame[LINK_HEADER[link]:], port)
+		# GTPv2-C: version 2 in the first octet, message type in the second
+		if (not payload) or (len(payload) < 8) or ((payload[0] >> 5) != 2):
+			continue
+		name = '%s_%d_type%d.bin' % (prefix, frame_num, payload[1])
+		with open(os.path.join(sys.argv[2], name), 'wb') as out:
+			out.write(payload)
+		written += 1
+	print('%d GTPv2-C messages written to %s' % (written, sys.argv[2]))
+
+if __name__ == '__main__':
+	main()
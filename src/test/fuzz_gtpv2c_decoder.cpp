@@ -0,0 +1,88 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file fuzz_gtpv2c_decoder.cpp
+  \brief libFuzzer target of the GTPv2-C decoder: header, then the IEs of the
+  message type found in the header, as done on S11 and S5-S8 reception
+*/
+#include "gtpv2c_decoder.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace gtpv2c;
+
+//------------------------------------------------------------------------------
+template <class M>
+static void decode_as(gtpv2c_view ies) {
+  M msg_ies_container = {};
+  gtpv2c_decoder::decode(ies, msg_ies_container);
+}
+
+//------------------------------------------------------------------------------
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  try {
+    gtpv2c_msg_header h = {};
+    gtpv2c_view ies     = gtpv2c_decoder::decode_header(data, size, h);
+    switch (h.get_message_type()) {
+      case GTP_ECHO_REQUEST:
+        decode_as<gtpv2c_echo_request>(ies);
+        break;
+      case GTP_ECHO_RESPONSE:
+        decode_as<gtpv2c_echo_response>(ies);
+        break;
+      case GTP_CREATE_SESSION_REQUEST:
+        decode_as<gtpv2c_create_session_request>(ies);
+        break;
+      case GTP_CREATE_SESSION_RESPONSE:
+        decode_as<gtpv2c_create_session_response>(ies);
+        break;
+      case GTP_MODIFY_BEARER_REQUEST:
+        decode_as<gtpv2c_modify_bearer_request>(ies);
+        break;
+      case GTP_MODIFY_BEARER_RESPONSE:
+        decode_as<gtpv2c_modify_bearer_response>(ies);
+        break;
+      case GTP_DELETE_SESSION_REQUEST:
+        decode_as<gtpv2c_delete_session_request>(ies);
+        break;
+      case GTP_DELETE_SESSION_RESPONSE:
+        decode_as<gtpv2c_delete_session_response>(ies);
+        break;
+      case GTP_RELEASE_ACCESS_BEARERS_REQUEST:
+        decode_as<gtpv2c_release_access_bearers_request>(ies);
+        break;
+      case GTP_RELEASE_ACCESS_BEARERS_RESPONSE:
+        decode_as<gtpv2c_release_access_bearers_response>(ies);
+        break;
+      case GTP_DOWNLINK_DATA_NOTIFICATION:
+        decode_as<gtpv2c_downlink_data_notification>(ies);
+        break;
+      case GTP_DOWNLINK_DATA_NOTIFICATION_ACKNOWLEDGE:
+        decode_as<gtpv2c_downlink_data_notification_acknowledge>(ies);
+        break;
+      default:;
+    }
+  } catch (gtpc_exception& e) {
+    // malformed input is expected to be rejected this way
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file test_pfcp_response_cache.cpp
+  \brief A request retransmitted by the peer after the response cache of the
+  PFCP stack is full must not reach the application task again
+*/
+#include "itti.hpp"
+#include "logger.hpp"
+#include "pfcp.hpp"
+
+#include <arpa/inet.h>
+#include <cstdio>
+
+itti_mw* itti_inst = nullptr;
+
+static const unsigned short kPort       = 32200;
+static const unsigned short kPeerPort   = 32201;
+static const uint32_t kMaxProcedures    = 4096;
+static const uint32_t kPdrsPerResponse  = 100;
+
+//------------------------------------------------------------------------------
+class test_stack : public pfcp::pfcp_l4_stack {
+ public:
+  test_stack()
+      : pfcp::pfcp_l4_stack(
+            1000, 2, "127.0.0.1", kPort, util::thread_sched_params(), 1, 1,
+            false, kMaxProcedures) {
+    peer_address.s_addr = htonl(INADDR_LOOPBACK);
+    peer                = endpoint(peer_address, kPeerPort);
+  }
+
+  std::size_t cached_bytes() const { return response_cache_bytes; }
+
+  /** \brief Receive a Session Establishment Request of the peer
+   *  @returns true if it is handed to the application task
+   **/
+  bool receive(const uint32_t seq_num, uint64_t& trxn_id) {
+    pfcp::pfcp_msg_header h;
+    h.set_message_type(PFCP_SESSION_ESTABLISHMENT_REQUEST);
+    h.set_seid(0);
+    h.set_sequence_number(seq_num);
+    pfcp::pfcp_msg msg(h);
+    bool error = true;
+    handle_receive_message_cb(msg, peer, TASK_PGWC_SX, error, trxn_id);
+    return not error;
+  }
+
+  void answer(const uint64_t trxn_id, const uint64_t seid) {
+    pfcp::pfcp_session_establishment_response r = {};
+    pfcp::cause_t cause = {.cause_value = pfcp::CAUSE_VALUE_REQUEST_ACCEPTED};
+    r.set(cause);
+    for (uint32_t i = 0; i < kPdrsPerResponse; i++) {
+      pfcp::created_pdr pdr = {};
+      pfcp::pdr_id_t pdr_id = {};
+      pdr_id.rule_id        = i + 1;
+      pdr.set(pdr_id);
+      pfcp::fteid_t fteid = {};
+      fteid.teid          = i + 1;
+      fteid.v4            = 1;
+      fteid.ipv4_address  = peer_address;
+      pdr.set(fteid);
+      r.created_pdrs.push_back(pdr);
+    }
+    send_response(peer, seid, r, trxn_id);
+  }
+
+  struct in_addr peer_address;
+  endpoint peer;
+};
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Logger::init("test", false, false);
+  itti_inst = new itti_mw();
+  itti_inst->start(util::thread_sched_params());
+  test_stack stack;
+
+  // answer requests until the cache is full, and some more
+  uint32_t seq_num         = 0;
+  uint32_t first_uncached  = 0;
+  uint64_t trxn_id         = 0;
+  while ((not first_uncached) || (seq_num < first_uncached + 10)) {
+    seq_num++;
+    if (not stack.receive(seq_num, trxn_id)) {
+      printf("FAILED: request %u not handed to the application\n", seq_num);
+      return 1;
+    }
+    if ((not first_uncached) &&
+        (stack.cached_bytes() >= PFCP_RESPONSE_CACHE_MAX_BYTES)) {
+      first_uncached = seq_num;
+    }
+    stack.answer(trxn_id, seq_num);
+    if (seq_num >= kMaxProcedures) {
+      printf("FAILED: cache not full after %u responses\n", seq_num);
+      return 1;
+    }
+  }
+  printf(
+      "%u responses, %zu bytes cached, from request %u responses not "
+      "cached\n",
+      seq_num, stack.cached_bytes(), first_uncached);
+
+  // duplicates of requests answered from the cache and beyond it
+  const uint32_t duplicates[] = {1, first_uncached - 1, first_uncached,
+                                 seq_num};
+  for (auto d : duplicates) {
+    if (stack.receive(d, trxn_id)) {
+      printf("FAILED: duplicate of request %u handed to the application\n", d);
+      return 1;
+    }
+  }
+  if (not stack.receive(seq_num + 1, trxn_id)) {
+    printf("FAILED: new request not handed to the application\n");
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
@@ -28,8 +28,20 @@
 
 #include "udp.hpp"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cstdlib>
 
+// io_uring completions: type in the upper 32 bits of user_data, send slot in
+// the lower ones
+#define UDP_URING_RECV (1ULL << 32)
+#define UDP_URING_EVENT (2ULL << 32)
+#define UDP_URING_SEND (3ULL << 32)
+#define UDP_URING_ENTRIES 512
+#define UDP_URING_RECV_BUFS 256
+
 //------------------------------------------------------------------------------
 void UdpApplication::handle_receive(
     char* recv_buffer, const std::size_t bytes_transferred,
@@ -59,24 +71,333 @@ static std::string string_to_hex(const std::string& input) {
 }
 //------------------------------------------------------------------------------
 void udp_server::udp_read_loop(const util::thread_sched_params& sched_params) {
-  endpoint r_endpoint   = {};
-  size_t bytes_received = 0;
+  endpoint r_endpoint    = {};
+  ssize_t bytes_received = 0;
+  // one buffer per reader thread
+  char recv_buffer[UDP_RECV_BUFFER_SIZE];
 
   sched_params.apply(TASK_NONE, Logger::udp());
 
-  while (1) {
+  while (running_) {
     r_endpoint.addr_storage_len = sizeof(struct sockaddr_storage);
     if ((bytes_received = recvfrom(
-             socket_, recv_buffer_, UDP_RECV_BUFFER_SIZE, 0,
+             socket_, recv_buffer, UDP_RECV_BUFFER_SIZE, 0,
              (struct sockaddr*) &r_endpoint.addr_storage,
              &r_endpoint.addr_storage_len)) > 0) {
-      app_->handle_receive(recv_buffer_, bytes_received, r_endpoint);
-    } else {
+      app_->handle_receive(recv_buffer, bytes_received, r_endpoint);
+    } else if (running_) {
       Logger::udp().error("Recvfrom failed %s\n", strerror(errno));
     }
   }
 }
 //------------------------------------------------------------------------------
+void udp_server::udp_read_loop_batched(
+    const util::thread_sched_params& sched_params) {
+  // per reader thread ring of batch_size_ buffers, refilled by each recvmmsg()
+  std::vector<char> recv_buffers(batch_size_ * UDP_RECV_BUFFER_SIZE);
+  std::vector<struct mmsghdr> msgs(batch_size_);
+  std::vector<struct iovec> iovecs(batch_size_);
+  std::vector<endpoint> r_endpoints(batch_size_);
+
+  sched_params.apply(TASK_NONE, Logger::udp());
+
+  while (running_) {
+    for (uint32_t i = 0; i < batch_size_; i++) {
+      iovecs[i].iov_base          = &recv_buffers[i * UDP_RECV_BUFFER_SIZE];
+      iovecs[i].iov_len           = UDP_RECV_BUFFER_SIZE;
+      msgs[i].msg_hdr             = {};
+      msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+      msgs[i].msg_hdr.msg_iovlen  = 1;
+      msgs[i].msg_hdr.msg_name    = &r_endpoints[i].addr_storage;
+      msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+      msgs[i].msg_len             = 0;
+    }
+    // block for the first datagram, then take what is already queued
+    int num_msgs =
+        recvmmsg(socket_, msgs.data(), batch_size_, MSG_WAITFORONE, nullptr);
+    if (num_msgs > 0) {
+      for (int i = 0; i < num_msgs; i++) {
+        r_endpoints[i].addr_storage_len = msgs[i].msg_hdr.msg_namelen;
+        app_->handle_receive(
+            (char*) iovecs[i].iov_base, msgs[i].msg_len, r_endpoints[i]);
+      }
+    } else if (running_) {
+      Logger::udp().error("Recvmmsg failed %s\n", strerror(errno));
+    }
+  }
+}
+//------------------------------------------------------------------------------
+void udp_server::send_to(
+    const char* send_buffer, const ssize_t num_bytes,
+    const struct sockaddr* addr, const socklen_t addr_len) {
+  if (is_send_queued()) {
+    uint32_t slot = UDP_SEND_SLOTS;
+    if (num_bytes <= UDP_RECV_BUFFER_SIZE) {
+      std::unique_lock lock(m_send_queue);
+      if (!free_send_slots_.empty()) {
+        slot = free_send_slots_.back();
+        free_send_slots_.pop_back();
+      }
+    }
+    if (slot < UDP_SEND_SLOTS) {
+      udp_datagram_t& datagram = send_slots_[slot];
+      memcpy(send_payload(slot), send_buffer, num_bytes);
+      memcpy(&datagram.addr, addr, addr_len);
+      datagram.addr_len = addr_len;
+      datagram.length   = num_bytes;
+      bool wake_up      = false;
+      {
+        std::unique_lock lock(m_send_queue);
+        // the sender takes the whole queue at once, wake it up only once
+        wake_up = send_queue_.empty();
+        send_queue_.push_back(slot);
+      }
+      if (wake_up) {
+        if (event_fd_ >= 0) {
+          eventfd_write(event_fd_, 1);
+        } else {
+          cv_send_queue.notify_one();
+        }
+      }
+      return;
+    }
+    // no free slot or larger than a slot, sent now from the caller thread
+  }
+  ssize_t bytes_written =
+      sendto(socket_, send_buffer, num_bytes, 0, addr, addr_len);
+  if (bytes_written != num_bytes) {
+    Logger::udp().error("sendto failed(%d:%s)\n", errno, strerror(errno));
+  }
+}
+//------------------------------------------------------------------------------
+void udp_server::init_send_slots() {
+  send_buffers_.resize(UDP_SEND_SLOTS * UDP_RECV_BUFFER_SIZE);
+  send_slots_.resize(UDP_SEND_SLOTS);
+  free_send_slots_.clear();
+  free_send_slots_.reserve(UDP_SEND_SLOTS);
+  for (uint32_t i = 0; i < UDP_SEND_SLOTS; i++) {
+    free_send_slots_.push_back(UDP_SEND_SLOTS - 1 - i);
+  }
+  send_queue_.clear();
+  send_queue_.reserve(UDP_SEND_SLOTS);
+}
+//------------------------------------------------------------------------------
+void udp_server::release_send_slots(std::vector<uint32_t>& slots) {
+  {
+    std::unique_lock lock(m_send_queue);
+    free_send_slots_.insert(free_send_slots_.end(), slots.begin(), slots.end());
+  }
+  slots.clear();
+}
+//------------------------------------------------------------------------------
+void udp_server::udp_send_loop(const util::thread_sched_params& sched_params) {
+  // swapped with send_queue_, both keep the capacity of all the slots
+  std::vector<uint32_t> datagrams;
+  datagrams.reserve(UDP_SEND_SLOTS);
+  std::vector<struct mmsghdr> msgs(batch_size_);
+  std::vector<struct iovec> iovecs(batch_size_);
+
+  sched_params.apply(TASK_NONE, Logger::udp());
+
+  while (1) {
+    {
+      std::unique_lock lock(m_send_queue);
+      cv_send_queue.wait(
+          lock, [this] { return !send_queue_.empty() || !running_; });
+      // take all the queued datagrams, producers keep on filling an empty
+      // queue while this thread is in sendmmsg()
+      datagrams.swap(send_queue_);
+    }
+    if (datagrams.empty() && !running_) {
+      return;
+    }
+    size_t sent = 0;
+    while (sent < datagrams.size()) {
+      uint32_t num_msgs =
+          std::min((size_t) batch_size_, datagrams.size() - sent);
+      for (uint32_t i = 0; i < num_msgs; i++) {
+        const uint32_t slot         = datagrams[sent + i];
+        udp_datagram_t& d           = send_slots_[slot];
+        iovecs[i].iov_base          = send_payload(slot);
+        iovecs[i].iov_len           = d.length;
+        msgs[i].msg_hdr             = {};
+        msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+        msgs[i].msg_hdr.msg_name    = &d.addr;
+        msgs[i].msg_hdr.msg_namelen = d.addr_len;
+      }
+      int ret = sendmmsg(socket_, msgs.data(), num_msgs, 0);
+      if (ret > 0) {
+        sent += ret;
+      } else {
+        // drop the datagram that could not be sent, retransmission is up to
+        // the protocol stack
+        Logger::udp().error("sendmmsg failed(%d:%s)\n", errno, strerror(errno));
+        sent++;
+      }
+    }
+    release_send_slots(datagrams);
+  }
+}
+#if UDP_URING_SUPPORTED
+//------------------------------------------------------------------------------
+void udp_server::udp_uring_loop(
+    const util::thread_sched_params& sched_params, const uint32_t ring_index) {
+  udp_uring& ring        = *rings_[ring_index];
+  const bool sender      = (ring_index == 0);
+  endpoint r_endpoint    = {};
+  uint64_t event_count   = 0;
+  bool recv_armed        = false;
+  bool event_armed       = false;
+  struct msghdr recv_hdr = {};
+  recv_hdr.msg_namelen   = sizeof(struct sockaddr_storage);
+  // send slots taken from the send queue, waiting for a submission entry,
+  // and send slots sent, to give back to send_to()
+  std::vector<uint32_t> pending;
+  std::vector<uint32_t> sent;
+  pending.reserve(sender ? UDP_SEND_SLOTS : 0);
+  sent.reserve(sender ? UDP_SEND_SLOTS : 0);
+  size_t pending_index = 0;
+  uint32_t in_flight   = 0;
+  std::vector<struct msghdr> send_msgs(sender ? UDP_SEND_SLOTS : 0);
+  std::vector<struct iovec> send_iovs(sender ? UDP_SEND_SLOTS : 0);
+
+  sched_params.apply(TASK_NONE, Logger::udp());
+
+  // on stop, the sender still flushes what was queued
+  while (running_ || in_flight || (pending_index < pending.size())) {
+    if ((!recv_armed) && running_) {
+      struct io_uring_sqe* sqe = ring.get_sqe();
+      if (sqe) {
+        sqe->opcode    = IORING_OP_RECVMSG;
+        sqe->fd        = socket_;
+        sqe->addr      = (uint64_t)(uintptr_t) &recv_hdr;
+        sqe->ioprio    = IORING_RECV_MULTISHOT;
+        sqe->flags     = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = ring.get_bgid();
+        sqe->user_data = UDP_URING_RECV;
+        recv_armed     = true;
+      }
+    }
+    if (sender && (!event_armed) && running_) {
+      struct io_uring_sqe* sqe = ring.get_sqe();
+      if (sqe) {
+        sqe->opcode    = IORING_OP_READ;
+        sqe->fd        = event_fd_;
+        sqe->addr      = (uint64_t)(uintptr_t) &event_count;
+        sqe->len       = sizeof(event_count);
+        sqe->user_data = UDP_URING_EVENT;
+        event_armed    = true;
+      }
+    }
+    // batch all the pending sends in this submission
+    while (pending_index < pending.size()) {
+      struct io_uring_sqe* sqe = ring.get_sqe();
+      if (!sqe) break;
+      const uint32_t slot   = pending[pending_index++];
+      udp_datagram_t& d     = send_slots_[slot];
+      struct msghdr& msg    = send_msgs[slot];
+      send_iovs[slot]       = {send_payload(slot), d.length};
+      msg                   = {};
+      msg.msg_name          = &d.addr;
+      msg.msg_namelen       = d.addr_len;
+      msg.msg_iov           = &send_iovs[slot];
+      msg.msg_iovlen        = 1;
+      sqe->opcode           = IORING_OP_SENDMSG;
+      sqe->fd               = socket_;
+      sqe->addr             = (uint64_t)(uintptr_t) &msg;
+      sqe->user_data        = UDP_URING_SEND | slot;
+      in_flight++;
+    }
+    if (pending_index == pending.size()) {
+      pending.clear();
+      pending_index = 0;
+    }
+
+    int ret = ring.submit_and_wait(1);
+    if ((ret < 0) && (ret != -EINTR)) {
+      Logger::udp().error("io_uring_enter failed %s\n", strerror(-ret));
+    }
+
+    struct io_uring_cqe* cqe = nullptr;
+    while ((cqe = ring.peek_cqe())) {
+      const uint64_t user_data = cqe->user_data;
+      const int32_t res        = cqe->res;
+      const uint32_t flags     = cqe->flags;
+      ring.cqe_seen();
+      switch (user_data & 0xFFFFFFFF00000000ULL) {
+        case UDP_URING_RECV:
+          if ((res > 0) && (flags & IORING_CQE_F_BUFFER)) {
+            uint16_t bid = flags >> IORING_CQE_BUFFER_SHIFT;
+            char* buf    = ring.get_buf(bid);
+            struct io_uring_recvmsg_out* out =
+                (struct io_uring_recvmsg_out*) buf;
+            char* name    = buf + sizeof(struct io_uring_recvmsg_out);
+            char* payload = name + recv_hdr.msg_namelen;
+            r_endpoint.addr_storage_len =
+                std::min((socklen_t) out->namelen, recv_hdr.msg_namelen);
+            memcpy(
+                &r_endpoint.addr_storage, name, r_endpoint.addr_storage_len);
+            app_->handle_receive(payload, out->payloadlen, r_endpoint);
+            ring.recycle_buf(bid);
+          } else if ((res < 0) && (res != -ENOBUFS) && running_) {
+            Logger::udp().error("io_uring recvmsg failed %s\n", strerror(-res));
+          }
+          // multishot receive stops when running out of buffers
+          if (!(flags & IORING_CQE_F_MORE)) {
+            recv_armed = false;
+          }
+          break;
+        case UDP_URING_EVENT: {
+          event_armed = false;
+          // drop the slots already submitted, pending stays within its capacity
+          pending.erase(pending.begin(), pending.begin() + pending_index);
+          pending_index = 0;
+          std::unique_lock lock(m_send_queue);
+          pending.insert(pending.end(), send_queue_.begin(), send_queue_.end());
+          send_queue_.clear();
+        } break;
+        case UDP_URING_SEND: {
+          if (res < 0) {
+            Logger::udp().error("io_uring sendmsg failed %s\n", strerror(-res));
+          }
+          sent.push_back(user_data & 0xFFFFFFFF);
+          in_flight--;
+        } break;
+        default:;
+      }
+    }
+    if (!sent.empty()) {
+      release_send_slots(sent);
+    }
+  }
+}
+#endif
+//------------------------------------------------------------------------------
+void udp_server::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  // wakes up the readers blocked in recvfrom(), recvmmsg() or io_uring, even
+  // on this unconnected socket
+  shutdown(socket_, SHUT_RD);
+  if (event_fd_ >= 0) {
+    eventfd_write(event_fd_, 1);
+  }
+  cv_send_queue.notify_all();
+  for (auto& t : threads_) {
+    if (t.joinable()) t.join();
+  }
+  threads_.clear();
+  if (event_fd_ >= 0) {
+    close(event_fd_);
+    event_fd_ = -1;
+  }
+#if UDP_URING_SUPPORTED
+  rings_.clear();
+#endif
+}
+//------------------------------------------------------------------------------
 int udp_server::create_socket(
     const struct in_addr& address, const uint16_t port) {
   struct sockaddr_in addr = {};
@@ -174,9 +495,64 @@ int udp_server::create_socket(const char* address, const uint16_t port_num) {
 }
 //------------------------------------------------------------------------------
 void udp_server::start_receive(
-    UdpApplication* app, const util::thread_sched_params& sched_params) {
+    UdpApplication* app, const util::thread_sched_params& sched_params,
+    const uint32_t num_threads, const uint32_t batch_size,
+    const bool io_uring) {
   app_ = app;
-  Logger::udp().trace("udp_server::start_receive");
-  thread_ = std::thread(&udp_server::udp_read_loop, this, sched_params);
-  thread_.detach();
+  batch_size_ =
+      std::max(1u, std::min(batch_size, (uint32_t) UDP_MAX_BATCH_SIZE));
+  running_ = true;
+  if ((batch_size_ > 1) || io_uring) {
+    init_send_slots();
+  }
+#if UDP_URING_SUPPORTED
+  if (io_uring && udp_uring::is_supported()) {
+    event_fd_ = eventfd(0, EFD_CLOEXEC);
+    io_uring_ = (event_fd_ >= 0);
+    for (uint32_t i = 0; io_uring_ && (i < num_threads); i++) {
+      rings_.push_back(std::make_unique<udp_uring>());
+      io_uring_ = rings_.back()->init(
+          UDP_URING_ENTRIES, 0, UDP_URING_RECV_BUFS,
+          sizeof(struct io_uring_recvmsg_out) +
+              sizeof(struct sockaddr_storage) + UDP_RECV_BUFFER_SIZE);
+    }
+    if (io_uring_) {
+      Logger::udp().info(
+          "udp_server::start_receive port %" PRIu16 " %u io_uring thread(s)",
+          port_, num_threads);
+      for (uint32_t i = 0; i < num_threads; i++) {
+        threads_.push_back(std::thread(
+            &udp_server::udp_uring_loop, this, sched_params, i));
+      }
+      return;
+    }
+    rings_.clear();
+    if (event_fd_ >= 0) {
+      close(event_fd_);
+      event_fd_ = -1;
+    }
+  }
+#endif
+  if (io_uring) {
+    Logger::udp().warn(
+        "udp_server::start_receive port %" PRIu16
+        " io_uring not supported, falling back to blocking sockets",
+        port_);
+  }
+  Logger::udp().trace(
+      "udp_server::start_receive port %" PRIu16 " %u thread(s) batch %u",
+      port_, num_threads, batch_size_);
+  for (uint32_t i = 0; i < num_threads; i++) {
+    if (batch_size_ > 1) {
+      threads_.push_back(
+          std::thread(&udp_server::udp_read_loop_batched, this, sched_params));
+    } else {
+      threads_.push_back(
+          std::thread(&udp_server::udp_read_loop, this, sched_params));
+    }
+  }
+  if (batch_size_ > 1) {
+    threads_.push_back(
+        std::thread(&udp_server::udp_send_loop, this, sched_params));
+  }
 }
\ No newline at end of file
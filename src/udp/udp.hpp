@@ -32,15 +32,19 @@
 #include "endpoint.hpp"
 #include "itti.hpp"
 #include "thread_sched.hpp"
+#include "udp_uring.hpp"
 
 #include <arpa/inet.h>
 #include <inttypes.h>
 #include <sys/socket.h>
 
 #include <stdint.h>
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <thread>
@@ -56,10 +60,25 @@ class UdpApplication {
       UdpApplication* gtp_stack, const util::thread_sched_params& sched_params);
 };
 
+// Maximum number of datagrams received by one recvmmsg() or sent by one
+// sendmmsg() call
+#define UDP_MAX_BATCH_SIZE 64
+// Size of a receive buffer, and of a send slot
+#define UDP_RECV_BUFFER_SIZE 8192
+// Number of preallocated buffers of outgoing datagrams in the batched and
+// io_uring modes, a datagram is sent by the caller when all are in use
+#define UDP_SEND_SLOTS 512
+
 class udp_server {
  public:
   udp_server(const struct in_addr& address, const uint16_t port_num)
-      : app_(nullptr), port_(port_num) {
+      : app_(nullptr),
+        port_(port_num),
+        batch_size_(1),
+        io_uring_(false),
+        running_(false),
+        event_fd_(-1),
+        send_queue_() {
     socket_ = create_socket(address, port_);
     if (socket_ > 0) {
       Logger::udp().debug(
@@ -77,7 +96,13 @@ class udp_server {
   }
 
   udp_server(const struct in6_addr& address, const uint16_t port_num)
-      : app_(nullptr), port_(port_num) {
+      : app_(nullptr),
+        port_(port_num),
+        batch_size_(1),
+        io_uring_(false),
+        running_(false),
+        event_fd_(-1),
+        send_queue_() {
     socket_ = create_socket(address, port_);
     if (socket_ > 0) {
       Logger::udp().debug(
@@ -95,7 +120,13 @@ class udp_server {
   }
 
   udp_server(const char* address, const uint16_t port_num)
-      : app_(nullptr), port_(port_num) {
+      : app_(nullptr),
+        port_(port_num),
+        batch_size_(1),
+        io_uring_(false),
+        running_(false),
+        event_fd_(-1),
+        send_queue_() {
     socket_ = create_socket(address, port_);
     if (socket_ > 0) {
       Logger::udp().debug("udp_server::udp_server(%s:%d)", address, port_);
@@ -107,48 +138,62 @@ class udp_server {
     }
   }
 
-  ~udp_server() { close(socket_); }
+  ~udp_server() {
+    stop();
+    close(socket_);
+  }
 
   uint16_t get_port() const { return port_; }
 
   void udp_read_loop(const util::thread_sched_params& thread_sched_params);
 
+  void udp_read_loop_batched(
+      const util::thread_sched_params& thread_sched_params);
+
   void async_send_to(
       const char* send_buffer, const ssize_t num_bytes,
       const endpoint& r_endpoint) {
-    ssize_t bytes_written = sendto(
-        socket_, send_buffer, num_bytes, 0,
-        (struct sockaddr*) &r_endpoint.addr_storage,
+    send_to(
+        send_buffer, num_bytes, (struct sockaddr*) &r_endpoint.addr_storage,
         r_endpoint.addr_storage_len);
-    if (bytes_written != num_bytes) {
-      Logger::udp().error("sendto failed(%d:%s)\n", errno, strerror(errno));
-    }
   }
 
   void async_send_to(
       const char* send_buffer, const ssize_t num_bytes,
       const struct sockaddr_in& r_endpoint) {
-    ssize_t bytes_written = sendto(
-        socket_, send_buffer, num_bytes, 0, (struct sockaddr*) &r_endpoint,
+    send_to(
+        send_buffer, num_bytes, (struct sockaddr*) &r_endpoint,
         sizeof(struct sockaddr_in));
-    if (bytes_written != num_bytes) {
-      Logger::udp().error("sendto failed(%d:%s)\n", errno, strerror(errno));
-    }
   }
 
   void async_send_to(
       const char* send_buffer, const ssize_t num_bytes,
       const struct sockaddr_in6& r_endpoint) {
-    ssize_t bytes_written = sendto(
-        socket_, send_buffer, num_bytes, 0, (struct sockaddr*) &r_endpoint,
+    send_to(
+        send_buffer, num_bytes, (struct sockaddr*) &r_endpoint,
         sizeof(struct sockaddr_in6));
-    if (bytes_written != num_bytes) {
-      Logger::udp().error("sendto failed(%d:%s)\n", errno, strerror(errno));
-    }
   }
 
+  /** \brief Start num_threads reader threads sharing the socket, the kernel
+   *  hands each datagram to one of them, so the decoding done by the
+   *  application in handle_receive() runs in parallel.
+   *  With a batch_size greater than 1, readers use recvmmsg() and outgoing
+   *  datagrams are copied in preallocated send slots, queued and flushed by a
+   *  sender thread with sendmmsg().
+   *  With io_uring, each reader drives its own io_uring ring with a multishot
+   *  receive into provided buffers, the first one also submitting the
+   *  queued datagrams. It falls back to the other modes if the kernel does
+   *  not support it.
+   **/
   void start_receive(
-      UdpApplication* gtp_stack, const util::thread_sched_params& sched_params);
+      UdpApplication* gtp_stack, const util::thread_sched_params& sched_params,
+      const uint32_t num_threads = 1, const uint32_t batch_size = 1,
+      const bool io_uring = false);
+
+  /** \brief Stop and join the reader and sender threads, queued datagrams are
+   *  flushed first
+   **/
+  void stop();
 
  protected:
   int create_socket(const struct in_addr& address, const uint16_t port);
@@ -161,13 +206,51 @@ class udp_server {
       const char*, /*buffer*/
       const int& /*error*/, std::size_t /*bytes_transferred*/) {}
 
+  void send_to(
+      const char* send_buffer, const ssize_t num_bytes,
+      const struct sockaddr* addr, const socklen_t addr_len);
+  void udp_send_loop(const util::thread_sched_params& sched_params);
+  bool is_send_queued() const { return (batch_size_ > 1) || io_uring_; }
+  void init_send_slots();
+  void release_send_slots(std::vector<uint32_t>& slots);
+  char* send_payload(const uint32_t slot) {
+    return &send_buffers_[slot * UDP_RECV_BUFFER_SIZE];
+  }
+#if UDP_URING_SUPPORTED
+  void udp_uring_loop(
+      const util::thread_sched_params& sched_params, const uint32_t ring_index);
+#endif
+
+  // destination and length of the payload of a send slot
+  typedef struct udp_datagram_s {
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    uint32_t length;
+  } udp_datagram_t;
+
   UdpApplication* app_;
-  std::thread thread_;
+  std::vector<std::thread> threads_;
   int socket_;
   uint16_t port_;
   sa_family_t sa_family;
-#define UDP_RECV_BUFFER_SIZE 8192
-  char recv_buffer_[UDP_RECV_BUFFER_SIZE];
+  uint32_t batch_size_;
+  bool io_uring_;
+  std::atomic<bool> running_;
+  // wakes up the io_uring sender when the send queue gets datagrams
+  int event_fd_;
+#if UDP_URING_SUPPORTED
+  std::vector<std::unique_ptr<udp_uring>> rings_;
+#endif
+  // send slots (batched and io_uring modes): UDP_SEND_SLOTS payloads of
+  // UDP_RECV_BUFFER_SIZE bytes, allocated once by start_receive()
+  std::vector<char> send_buffers_;
+  std::vector<udp_datagram_t> send_slots_;
+  // slots free and slots waiting for the sender thread, both reserved for
+  // all the slots and guarded by m_send_queue
+  std::vector<uint32_t> free_send_slots_;
+  std::vector<uint32_t> send_queue_;
+  std::mutex m_send_queue;
+  std::condition_variable cv_send_queue;
 };
 
 #endif /* FILE_UDP_HPP_SEEN */
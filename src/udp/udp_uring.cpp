@@ -0,0 +1,244 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file udp_uring.cpp
+  \brief Minimal io_uring ring used by the io_uring backend of udp_server
+*/
+
+#include "udp_uring.hpp"
+
+#if UDP_URING_SUPPORTED
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+
+//------------------------------------------------------------------------------
+static int sys_io_uring_setup(uint32_t entries, struct io_uring_params* p) {
+  return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+//------------------------------------------------------------------------------
+static int sys_io_uring_enter(
+    int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return (int) syscall(
+      __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+//------------------------------------------------------------------------------
+udp_uring::udp_uring()
+    : ring_fd(-1),
+      sq_ptr(MAP_FAILED),
+      sq_size(0),
+      cq_ptr(MAP_FAILED),
+      cq_size(0),
+      sqes((struct io_uring_sqe*) MAP_FAILED),
+      sqes_size(0),
+      sq_head(nullptr),
+      sq_tail(nullptr),
+      sq_array(nullptr),
+      sq_mask(0),
+      sq_entries(0),
+      sqe_tail(0),
+      cq_head(nullptr),
+      cq_tail(nullptr),
+      cqes(nullptr),
+      cq_mask(0),
+      bgid(0),
+      buf_size(0),
+      bufs(),
+      recycled_bids() {}
+
+//------------------------------------------------------------------------------
+udp_uring::~udp_uring() { release(); }
+
+//------------------------------------------------------------------------------
+void udp_uring::release() {
+  if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+  if ((cq_ptr != MAP_FAILED) && (cq_ptr != sq_ptr)) munmap(cq_ptr, cq_size);
+  if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_size);
+  if (ring_fd >= 0) close(ring_fd);
+  sqes    = (struct io_uring_sqe*) MAP_FAILED;
+  cq_ptr  = MAP_FAILED;
+  sq_ptr  = MAP_FAILED;
+  ring_fd = -1;
+}
+
+//------------------------------------------------------------------------------
+bool udp_uring::init(
+    const uint32_t entries, const uint16_t buf_group_id,
+    const uint32_t num_bufs, const uint32_t buf_sz) {
+  struct io_uring_params p = {};
+  ring_fd                  = sys_io_uring_setup(entries, &p);
+  if (ring_fd < 0) {
+    return false;
+  }
+  sq_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+  cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    sq_size = cq_size = std::max(sq_size, cq_size);
+  }
+  sq_ptr = mmap(
+      nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ptr == MAP_FAILED) {
+    release();
+    return false;
+  }
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    cq_ptr = sq_ptr;
+  } else {
+    cq_ptr = mmap(
+        nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        ring_fd, IORING_OFF_CQ_RING);
+    if (cq_ptr == MAP_FAILED) {
+      release();
+      return false;
+    }
+  }
+  sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  sqes      = (struct io_uring_sqe*) mmap(
+      nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring_fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    release();
+    return false;
+  }
+  sq_head    = (uint32_t*) ((char*) sq_ptr + p.sq_off.head);
+  sq_tail    = (uint32_t*) ((char*) sq_ptr + p.sq_off.tail);
+  sq_array   = (uint32_t*) ((char*) sq_ptr + p.sq_off.array);
+  sq_mask    = *(uint32_t*) ((char*) sq_ptr + p.sq_off.ring_mask);
+  sq_entries = p.sq_entries;
+  sqe_tail   = *sq_tail;
+  cq_head    = (uint32_t*) ((char*) cq_ptr + p.cq_off.head);
+  cq_tail    = (uint32_t*) ((char*) cq_ptr + p.cq_off.tail);
+  cq_mask    = *(uint32_t*) ((char*) cq_ptr + p.cq_off.ring_mask);
+  cqes       = (struct io_uring_cqe*) ((char*) cq_ptr + p.cq_off.cqes);
+
+  // provided once here, then one by one as they are given back
+  bgid     = buf_group_id;
+  buf_size = buf_sz;
+  bufs.resize((size_t) num_bufs * buf_size);
+  if (!provide_bufs(0, num_bufs)) {
+    release();
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool udp_uring::provide_bufs(const uint16_t bid, const uint32_t num_bufs) {
+  struct io_uring_sqe* sqe = get_sqe();
+  if (!sqe) {
+    return false;
+  }
+  sqe->opcode    = IORING_OP_PROVIDE_BUFFERS;
+  sqe->fd        = num_bufs;
+  sqe->addr      = (uint64_t)(uintptr_t) get_buf(bid);
+  sqe->len       = buf_size;
+  sqe->off       = bid;
+  sqe->buf_group = bgid;
+  if (submit_and_wait(1) < 0) {
+    return false;
+  }
+  struct io_uring_cqe* cqe = peek_cqe();
+  bool provided            = cqe && (cqe->res >= 0);
+  if (cqe) cqe_seen();
+  return provided;
+}
+
+//------------------------------------------------------------------------------
+struct io_uring_sqe* udp_uring::get_sqe() {
+  uint32_t head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+  if ((sqe_tail - head) >= sq_entries) {
+    return nullptr;
+  }
+  struct io_uring_sqe* sqe = &sqes[sqe_tail & sq_mask];
+  sq_array[sqe_tail & sq_mask] = sqe_tail & sq_mask;
+  sqe_tail++;
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+//------------------------------------------------------------------------------
+int udp_uring::submit_and_wait(const uint32_t wait_nr) {
+  while (!recycled_bids.empty()) {
+    struct io_uring_sqe* sqe = get_sqe();
+    if (!sqe) break;
+    sqe->opcode    = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd        = 1;
+    sqe->addr      = (uint64_t)(uintptr_t) get_buf(recycled_bids.back());
+    sqe->len       = buf_size;
+    sqe->off       = recycled_bids.back();
+    sqe->buf_group = bgid;
+    recycled_bids.pop_back();
+  }
+  uint32_t to_submit = sqe_tail - *sq_tail;
+  __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+  int ret = sys_io_uring_enter(
+      ring_fd, to_submit, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0);
+  return (ret < 0) ? -errno : ret;
+}
+
+//------------------------------------------------------------------------------
+struct io_uring_cqe* udp_uring::peek_cqe() {
+  uint32_t head = *cq_head;
+  if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+    return nullptr;
+  }
+  return &cqes[head & cq_mask];
+}
+
+//------------------------------------------------------------------------------
+void udp_uring::cqe_seen() {
+  __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+void udp_uring::recycle_buf(const uint16_t bid) {
+  recycled_bids.push_back(bid);
+}
+
+//------------------------------------------------------------------------------
+bool udp_uring::is_supported() {
+  static std::once_flag once;
+  static bool supported = false;
+  std::call_once(once, [] {
+    // multishot recvmsg needs Linux 6.0
+    struct utsname u = {};
+    int major = 0, minor = 0;
+    if ((uname(&u) != 0) || (sscanf(u.release, "%d.%d", &major, &minor) != 2) ||
+        (major < 6)) {
+      return;
+    }
+    udp_uring probe;
+    supported = probe.init(4, 0, 1, 64);
+  });
+  return supported;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the OAI Public License, Version 1.1  (the "License"); you may not use this
+ * file except in compliance with the License. You may obtain a copy of the
+ * License at
+ *
+ *      http://www.openairinterface.org/?page_id=698
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file udp_uring.hpp
+  \brief Minimal io_uring ring used by the io_uring backend of udp_server
+*/
+#ifndef FILE_UDP_URING_HPP_SEEN
+#define FILE_UDP_URING_HPP_SEEN
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+// multishot receive came with Linux 6.0 headers
+#if defined(IORING_RECV_MULTISHOT)
+#define UDP_URING_SUPPORTED 1
+#else
+#define UDP_URING_SUPPORTED 0
+#endif
+
+#if UDP_URING_SUPPORTED
+// Submission and completion rings of one io_uring instance, set up with the
+// raw system calls, plus one group of receive buffers provided to the kernel
+// (picked by multishot receive).
+class udp_uring {
+ public:
+  udp_uring();
+  ~udp_uring();
+  udp_uring(udp_uring const&) = delete;
+  void operator=(udp_uring const&) = delete;
+
+  /** \brief Create the rings and provide num_bufs receive buffers of
+   *  buf_size bytes in buffer group bgid
+   *  @returns false if the kernel does not support it (io_uring disabled, no
+   *  provided buffers)
+   **/
+  bool init(
+      const uint32_t entries, const uint16_t bgid, const uint32_t num_bufs,
+      const uint32_t buf_size);
+
+  /** \brief Next free submission queue entry, zeroed, nullptr if the
+   *  submission queue is full
+   **/
+  struct io_uring_sqe* get_sqe();
+
+  /** \brief Submit the queued entries, buffers given back included, and
+   *  wait for at least wait_nr completions
+   **/
+  int submit_and_wait(const uint32_t wait_nr);
+
+  struct io_uring_cqe* peek_cqe();
+  void cqe_seen();
+
+  char* get_buf(const uint16_t bid) { return &bufs[bid * buf_size]; }
+  uint32_t get_buf_size() const { return buf_size; }
+  uint16_t get_bgid() const { return bgid; }
+  /** \brief Give back a provided buffer to the kernel, on next submission.
+   *  Its completion has a zero user_data.
+   **/
+  void recycle_buf(const uint16_t bid);
+
+  /** \brief Checks once that the running kernel accepts everything used by
+   *  udp_server in io_uring mode
+   **/
+  static bool is_supported();
+
+ private:
+  int ring_fd;
+
+  void* sq_ptr;
+  size_t sq_size;
+  void* cq_ptr;
+  size_t cq_size;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t* sq_array;
+  uint32_t sq_mask;
+  uint32_t sq_entries;
+  uint32_t sqe_tail;  // entries prepared, not yet published
+
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  struct io_uring_cqe* cqes;
+  uint32_t cq_mask;
+
+  uint16_t bgid;
+  uint32_t buf_size;
+  std::vector<char> bufs;
+  std::vector<uint16_t> recycled_bids;  // not provided again yet, SQ full
+
+  void release();
+  bool provide_bufs(const uint16_t bid, const uint32_t num_bufs);
+};
+#endif
+
+#endif /* FILE_UDP_URING_HPP_SEEN */